@@ -19,6 +19,7 @@ int main() {
   machine::TaskListener                  task_listener(&tsm);
   machine::WaterRefillingListener        water_refilling_listener(&tsm);
   machine::DisinfectantRefillingListener disinfectant_refilling_listener(&tsm);
+  ConfigReloader                         config_reloader;
   auto logger_window = std::make_shared<gui::LoggerWindowMT>();
 
   // initialize logger
@@ -48,6 +49,15 @@ int main() {
 
   auto* state = State::get();
 
+  // telemetry is optional, the machine runs without it
+  if (FlightRecorder::create(fs::path(LOGS_DIR) / flight::file_name) ==
+      ATM_ERR) {
+    LOG_WARN("Failed to initialize flight recorder");
+  }
+
+  // bundles the telemetry and log lines of every fault
+  PostMortem::create(fs::path(LOGS_DIR));
+
   LOG_INFO("Booting up...");
 
   // initialization
@@ -74,6 +84,7 @@ int main() {
   task_listener.start();
   water_refilling_listener.start();
   disinfectant_refilling_listener.start();
+  config_reloader.start();
 
   ui_manager.name(Config::get()->name());
   ui_manager.init();
@@ -99,6 +110,7 @@ int main() {
 
   ui_manager.add_window(logger_window);
   ui_manager.add_window<gui::SystemInfoWindow>();
+  ui_manager.add_window<gui::StepJitterWindow>();
   ui_manager.add_window<gui::FaultWindow>(&tsm);
   ui_manager.add_window<gui::MetadataWindow>();
   ui_manager.add_window<gui::MovementWindow>();
@@ -122,6 +134,7 @@ int main() {
   task_listener.stop();
   water_refilling_listener.stop();
   disinfectant_refilling_listener.stop();
+  config_reloader.stop();
 
   // stopping ui
   ui_manager.exit();
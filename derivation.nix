@@ -7,6 +7,7 @@
 , mesa_drivers
 , doxygen
 , glfw3
+, zlib
 }:
 
 let
@@ -30,6 +31,7 @@ in
     buildInputs            = [
       glfw3
       doxygen
+      zlib
     ];
 
     cmakeFlags             = [
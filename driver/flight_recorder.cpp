@@ -0,0 +1,47 @@
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#include <libcore/core.hpp>
+#include <libutil/util.hpp>
+
+USE_NAMESPACE;
+
+// forward declarations
+static int throw_message(const fs::path& path);
+
+static int throw_message(const fs::path& path) {
+  std::cerr << "Failed to read flight recorder " << path.string()
+            << ", something is wrong" << std::endl;
+  return ATM_ERR;
+}
+
+/**
+ * Export flight recorder file to CSV
+ *
+ * Usage: flight_recorder [file] [csv]
+ *
+ * File defaults to LOGS_DIR/flight.bin, CSV is written to stdout if it is not
+ * given
+ */
+int main(int argc, char* argv[]) {
+  const fs::path path =
+      argc > 1 ? fs::path(argv[1]) : fs::path(LOGS_DIR) / flight::file_name;
+
+  std::vector<flight::record> records;
+
+  if (flight::load(path, records) == ATM_ERR) {
+    return throw_message(path);
+  }
+
+  if (argc > 2) {
+    std::ofstream file(argv[2]);
+    flight::write_csv(file, records);
+  } else {
+    flight::write_csv(std::cout, records);
+  }
+
+  std::cerr << records.size() << " records are exported" << std::endl;
+
+  return ATM_OK;
+}
@@ -0,0 +1,83 @@
+#include <iostream>
+#include <vector>
+
+#include <libcore/core.hpp>
+#include <libutil/util.hpp>
+
+USE_NAMESPACE;
+
+// forward declarations
+static int throw_message(const char* message);
+
+static int throw_message(const char* message) {
+  std::cerr << "Flight recorder fault check failed: " << message << std::endl;
+  return ATM_ERR;
+}
+
+/**
+ * Check that fault reason is cleared after restart
+ *
+ * Usage: flight_recorder_fault [directory]
+ *
+ * Records fault -> restart -> normal operation into a fresh file in the
+ * directory (defaults to /tmp) and expects records after the restart to carry
+ * no fault
+ */
+int main(int argc, char* argv[]) {
+  const fs::path directory =
+      argc > 1 ? fs::path(argv[1]) : fs::temp_directory_path();
+  const fs::path path = directory / flight::file_name;
+
+  fs::remove(path);
+
+  if (Logger::create() == ATM_ERR) {
+    return ATM_ERR;
+  }
+
+  if (FlightRecorder::create(path) == ATM_ERR) {
+    return throw_message("cannot create recorder");
+  }
+
+  auto* recorder = FlightRecorder::get();
+
+  recorder->state(flight::state::spraying);
+  recorder->motion({1, 2, 3}, {1.0f, 2.0f, 3.0f});
+  recorder->fault(flight::fault::e_stop);
+  recorder->state(flight::state::fault);
+  recorder->motion({1, 2, 3}, {0.0f, 0.0f, 0.0f});
+  // restart
+  recorder->state(flight::state::no_task);
+  recorder->motion({4, 5, 6}, {1.0f, 2.0f, 3.0f});
+
+  std::vector<flight::record> records;
+
+  if (flight::load(path, records) == ATM_ERR) {
+    return throw_message("cannot load records");
+  }
+
+  flight::write_csv(std::cout, records);
+
+  const auto reason = [](const flight::record& r) {
+    return static_cast<flight::fault>(r.fault);
+  };
+
+  // boot, state, motion, fault, state, motion, state, motion
+  if (records.size() != 8) {
+    return throw_message("unexpected number of records");
+  }
+
+  if (reason(records[2]) != flight::fault::none ||
+      reason(records[3]) != flight::fault::e_stop ||
+      reason(records[5]) != flight::fault::e_stop) {
+    return throw_message("fault is not recorded");
+  }
+
+  if (reason(records[6]) != flight::fault::none ||
+      reason(records[7]) != flight::fault::none) {
+    return throw_message("fault is not cleared after restart");
+  }
+
+  std::cerr << "Fault is cleared after restart" << std::endl;
+
+  return ATM_OK;
+}
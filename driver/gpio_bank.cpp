@@ -0,0 +1,154 @@
+#include <array>
+#include <iostream>
+#include <memory>
+
+#include <libcore/core.hpp>
+#include <libdevice/device.hpp>
+#include <libutil/util.hpp>
+
+USE_NAMESPACE;
+
+// forward declarations
+static ATM_STATUS init();
+static void       shutdown_hook();
+static int        throw_message();
+static void       report(const char* name, time_unit elapsed, uint64_t count);
+static uint64_t   accesses();
+
+static const std::array<PI_PIN, 3> step_pins = {6, 19, 26};
+static const std::array<PI_PIN, 6> input_pins = {4, 5, 12, 16, 20, 21};
+static const long                  iterations = 1000000;
+
+static ATM_STATUS init() {
+  // initialize logger
+  if (Logger::create() == ATM_ERR) {
+    return ATM_ERR;
+  }
+
+  if (gpioInitialise() < 0) {
+    return ATM_ERR;
+  }
+
+  return ATM_OK;
+}
+
+static void shutdown_hook() {
+  std::cout << "Shutting down..." << std::endl;
+  destroy_device();
+  destroy_core();
+  std::cout << "Shutting down is completed!" << std::endl;
+}
+
+static int throw_message() {
+  std::cerr << "Failed to initialize GPIO, something is wrong" << std::endl;
+  return ATM_ERR;
+}
+
+static void report(const char* name, time_unit elapsed, uint64_t count) {
+  std::cout << name << ": " << iterations << " iterations in " << elapsed
+            << " us, "
+            << (1e+3 * static_cast<double>(elapsed) /
+                static_cast<double>(iterations))
+            << " ns each";
+#ifdef MOCK_GPIO
+  std::cout << ", " << (count / static_cast<uint64_t>(iterations))
+            << " GPIO accesses each";
+#else
+  (void)count;
+#endif
+  std::cout << std::endl;
+}
+
+static uint64_t accesses() {
+#ifdef MOCK_GPIO
+  return gpioMockAccesses();
+#else
+  return 0;
+#endif
+}
+
+int main() {
+  ATM_STATUS status = ATM_OK;
+
+  status = init();
+  if (status == ATM_ERR) {
+    return throw_message();
+  }
+
+  std::array<std::shared_ptr<device::DigitalOutputDevice>, step_pins.size()>
+      steps;
+  for (std::size_t i = 0; i < step_pins.size(); ++i) {
+    steps[i] = device::DigitalOutputDevice::create(step_pins[i]);
+  }
+
+  std::array<std::shared_ptr<device::DigitalInputDevice>, input_pins.size()>
+      inputs;
+  device::DigitalInputBank bank;
+  for (std::size_t i = 0; i < input_pins.size(); ++i) {
+    // mix both active states like limit switches and PLC inputs do
+    inputs[i] = device::DigitalInputDevice::create(input_pins[i], i % 2 == 0,
+                                                   PI_PUD_DOWN);
+    bank.add(inputs[i]);
+  }
+
+  // 1. step edges of every axis, one gpioWrite per pin
+  uint64_t  count = accesses();
+  time_unit start = micros();
+  for (long i = 0; i < iterations; ++i) {
+    for (const auto& step : steps) {
+      step->write(device::digital::value::high);
+    }
+    for (const auto& step : steps) {
+      step->write(device::digital::value::low);
+    }
+  }
+  report("step edges, per pin", micros() - start, accesses() - count);
+
+  // 2. step edges of every axis, one register write per edge
+  count = accesses();
+  start = micros();
+  for (long i = 0; i < iterations; ++i) {
+    device::DigitalOutputBatch batch;
+    for (const auto& step : steps) {
+      batch.write(step, device::digital::value::high);
+    }
+    batch.commit();
+    for (const auto& step : steps) {
+      batch.write(step, device::digital::value::low);
+    }
+    batch.commit();
+  }
+  report("step edges, bank", micros() - start, accesses() - count);
+
+  // 3. poll every input, one gpioRead per pin
+  long high = 0;
+  count = accesses();
+  start = micros();
+  for (long i = 0; i < iterations; ++i) {
+    for (const auto& input : inputs) {
+      high += input->read_bool() ? 1 : 0;
+    }
+  }
+  report("inputs, per pin", micros() - start, accesses() - count);
+
+  // 4. poll every input from a single snapshot
+  long bank_high = 0;
+  count = accesses();
+  start = micros();
+  for (long i = 0; i < iterations; ++i) {
+    const auto levels = bank.read();
+    for (const auto& input : inputs) {
+      bank_high += levels.high(input) ? 1 : 0;
+    }
+  }
+  report("inputs, bank", micros() - start, accesses() - count);
+
+  if (high != bank_high) {
+    std::cerr << "Bank snapshot does not match per pin reads" << std::endl;
+    status = ATM_ERR;
+  }
+
+  shutdown_hook();
+
+  return status;
+}
@@ -62,6 +62,7 @@ static ATM_STATUS init() {
 static void shutdown_hook() {
   stop = true;
   std::cout << "Shutting down..." << std::endl;
+  destroy_mechanism();
   auto&& movement = mechanism::movement_mechanism();
   if (movement != nullptr) {
     movement->disable_motors();
@@ -85,6 +86,9 @@ static void do_spraying() {
   auto*  shift_register = device::ShiftRegister::get();
   auto&& movement = mechanism::movement_mechanism();
 
+  // whole job runs on the same config revision
+  const auto settings = Config::get()->snapshot();
+
   shift_register->write(device::id::comm::pi::spraying_ready(),
                         device::digital::value::low);
   shift_register->write(device::id::comm::pi::spraying_running(),
@@ -92,7 +96,7 @@ static void do_spraying() {
   shift_register->write(device::id::comm::pi::spraying_complete(),
                         device::digital::value::low);
 
-  movement->homing();
+  movement->homing(*settings);
 
   shift_register->write(device::id::comm::pi::spraying_ready(),
                         device::digital::value::high);
@@ -105,7 +109,7 @@ static void do_spraying() {
   shift_register->write(device::id::comm::pi::spraying_running(),
                         device::digital::value::high);
 
-  movement->move_to_spraying_position();
+  movement->move_to_spraying_position(*settings);
 
   sleep_for<time_units::millis>(3000);
 
@@ -113,11 +117,11 @@ static void do_spraying() {
 
   sleep_for<time_units::millis>(3000);
 
-  movement->follow_spraying_paths();
+  movement->follow_spraying_paths(*settings);
 
   shift_register->write(device::id::spray(), device::digital::value::low);
 
-  movement->homing();
+  movement->homing(*settings);
 
   shift_register->write(device::id::comm::pi::spraying_ready(),
                         device::digital::value::high);
@@ -137,6 +141,9 @@ static void do_tending() {
   auto*  shift_register = device::ShiftRegister::get();
   auto&& movement = mechanism::movement_mechanism();
 
+  // whole job runs on the same config revision
+  const auto settings = Config::get()->snapshot();
+
   shift_register->write(device::id::comm::pi::tending_ready(),
                         device::digital::value::low);
   shift_register->write(device::id::comm::pi::tending_running(),
@@ -144,7 +151,7 @@ static void do_tending() {
   shift_register->write(device::id::comm::pi::tending_complete(),
                         device::digital::value::low);
 
-  movement->homing();
+  movement->homing(*settings);
 
   shift_register->write(device::id::comm::pi::tending_ready(),
                         device::digital::value::high);
@@ -158,22 +165,22 @@ static void do_tending() {
   shift_register->write(device::id::comm::pi::tending_running(),
                         device::digital::value::high);
 
-  movement->move_to_tending_position();
+  movement->move_to_tending_position(*settings);
   sleep_for<time_units::millis>(3000);
-  movement->move_finger_down();
+  movement->move_finger_down(*settings);
   sleep_for<time_units::millis>(1000);
-  movement->follow_tending_paths_edge();
+  movement->follow_tending_paths_edge(*settings);
   sleep_for<time_units::millis>(1000);
 
-  movement->rotate_finger();
+  movement->rotate_finger(*settings);
 
   sleep_for<time_units::millis>(1000);
-  movement->follow_tending_paths_zigzag();
+  movement->follow_tending_paths_zigzag(*settings);
   sleep_for<time_units::millis>(1000);
 
-  movement->stop_finger();
+  movement->stop_finger(*settings);
 
-  movement->homing();
+  movement->homing(*settings);
 
   shift_register->write(device::id::comm::pi::tending_ready(),
                         device::digital::value::high);
@@ -198,7 +205,11 @@ static void do_cleaning() {
   auto&& movement = mechanism::movement_mechanism();
 
   auto&& sonicator_relay =
-      output_registry->get(device::id::sonicator_relay());
+      output_registry->get(device::key::sonicator_relay);
+
+  // whole job runs on the same config revision
+  const auto  settings = config->snapshot();
+  const auto& stations = settings->mechanisms.cleaning.stations;
 
   shift_register->write(device::id::comm::pi::spraying_ready(),
                         device::digital::value::low);
@@ -208,17 +219,19 @@ static void do_cleaning() {
   state->tending_ready(false);
   state->cleaning_ready(true);
 
-  movement->homing();
+  movement->homing(*settings);
 
   state->cleaning_running(true);
-  movement->homing_finger();
+  movement->homing_finger(*settings);
+
+  for (std::size_t idx = 0; idx < stations.size(); ++idx) {
+    const auto& [x, y, time, sonicator] = stations[idx];
 
-  for (const auto& [x, y, time, sonicator] : config->cleaning_stations()) {
     LOG_INFO("Moving to cleaning station with x:{} y:{}", x, y);
-    movement->move<mechanism::movement::unit::mm>(x, y, 0.0);
+    movement->move_to_cleaning_station(*settings, idx);
 
     LOG_INFO("Moving finger down");
-    movement->move_finger_down();
+    movement->move_finger_down(*settings);
 
     if (sonicator) {
       LOG_INFO("Turning on the sonicator relay");
@@ -231,7 +244,7 @@ static void do_cleaning() {
     sleep_for<time_units::seconds>(time);
 
     LOG_INFO("Moving finger up");
-    movement->move_finger_up();
+    movement->move_finger_up(*settings);
 
     if (sonicator) {
       LOG_INFO("Turning off the sonicator relay");
@@ -247,7 +260,7 @@ static void do_cleaning() {
 
   state->cleaning_complete(false);
 
-  movement->homing();
+  movement->homing(*settings);
 
   shift_register->write(device::id::comm::pi::spraying_ready(),
                         device::digital::value::high);
@@ -272,10 +285,12 @@ static bool menu() {
   auto*  input_registry = device::DigitalInputDeviceRegistry::get();
   auto&& movement = mechanism::movement_mechanism();
 
+  const auto settings = config->snapshot();
+
   auto&& spraying_tending_height =
-      input_registry->get(device::id::comm::plc::spraying_tending_height());
+      input_registry->get(device::key::comm::plc::spraying_tending_height);
   auto&& cleaning_height =
-      input_registry->get(device::id::comm::plc::cleaning_height());
+      input_registry->get(device::key::comm::plc::cleaning_height);
 
   shift_register->write(device::id::comm::pi::spraying_ready(),
                         device::digital::value::low);
@@ -322,9 +337,9 @@ static bool menu() {
   } else if (choice == 4) {
     do_cleaning();
   } else if (choice == 5) {
-    movement->homing();
+    movement->homing(*settings);
   } else if (choice == 6) {
-    auto&& stepper_x = stepper_registry->get(device::id::stepper::x());
+    auto&& stepper_x = stepper_registry->get(device::key::stepper::x);
     stepper_x->enable();
     for (size_t i = 0; i < 2; ++i) {
       stepper_x->move(10000);
@@ -333,7 +348,7 @@ static bool menu() {
     }
     stepper_x->disable();
   } else if (choice == 7) {
-    auto&& stepper_y = stepper_registry->get(device::id::stepper::y());
+    auto&& stepper_y = stepper_registry->get(device::key::stepper::y);
     stepper_y->enable();
     for (size_t i = 0; i < 2; ++i) {
       stepper_y->move(10000);
@@ -342,7 +357,7 @@ static bool menu() {
     }
     stepper_y->disable();
   } else if (choice == 8) {
-    auto&& stepper_z = stepper_registry->get(device::id::stepper::z());
+    auto&& stepper_z = stepper_registry->get(device::key::stepper::z);
     stepper_z->enable();
     for (size_t i = 0; i < 2; ++i) {
       stepper_z->move(500);
@@ -387,7 +402,7 @@ static bool menu() {
     }
     state->reset_coordinate();
   } else if (choice == 12) {
-    movement->homing_finger();
+    movement->homing_finger(*settings);
   } else if (choice == 13) {
     std::string   speed_str;
     config::speed speed_profile = config::speed::normal;
@@ -0,0 +1,111 @@
+#include <iostream>
+
+#include <libcore/core.hpp>
+#include <libutil/util.hpp>
+
+USE_NAMESPACE;
+
+// forward declarations
+static ATM_STATUS init();
+static void       shutdown_hook();
+static int        throw_message();
+static void       report(const char* name, time_unit elapsed);
+template <typename Log>
+static time_unit measure(Log&& log);
+
+static const long iterations = 102400;
+static const long burst = 1024;
+
+static ATM_STATUS init() {
+  // initialize logger
+  if (Logger::create() == ATM_ERR) {
+    return ATM_ERR;
+  }
+
+  // console only shows info, records below go to the log file
+  Logger::get()->init("logging", false);
+
+  return ATM_OK;
+}
+
+static void shutdown_hook() {
+  std::cout << "Shutting down..." << std::endl;
+  destroy_core();
+  std::cout << "Shutting down is completed!" << std::endl;
+}
+
+static int throw_message() {
+  std::cerr << "Failed to initialize logger, something is wrong" << std::endl;
+  return ATM_ERR;
+}
+
+static void report(const char* name, time_unit elapsed) {
+  std::cout << name << ": " << iterations << " records in " << elapsed
+            << " us, "
+            << (1e+3 * static_cast<double>(elapsed) /
+                static_cast<double>(iterations))
+            << " ns each" << std::endl;
+}
+
+template <typename Log>
+static time_unit measure(Log&& log) {
+  time_unit elapsed = 0;
+
+  for (long i = 0; i < iterations; i += burst) {
+    const time_unit start = micros();
+    for (long j = i; j < i + burst; ++j) {
+      log(j);
+    }
+    elapsed += micros() - start;
+
+    // let logger threads catch up, so the ring never drops a record
+    sleep_for<time_units::millis>(logger::drain_period);
+  }
+
+  return elapsed;
+}
+
+int main() {
+  ATM_STATUS status = ATM_OK;
+
+  status = init();
+  if (status == ATM_ERR) {
+    return throw_message();
+  }
+
+  auto* logger = Logger::get();
+
+  const long   steps = 1600;
+  const double position = 12.5;
+
+  // 1. format on the caller, flush every record (previous behaviour)
+  logger->logger()->flush_on(spdlog::level::trace);
+  report("eager, flush every record", measure([&](long i) {
+           LOG_DEBUG("Current X {}, Next X {}, steps {}", position,
+                     position + 1.0, steps + i);
+         }));
+
+  // 2. format on the caller, flush by batch
+  logger->logger()->flush_on(spdlog::level::err);
+  report("eager, flush by batch", measure([&](long i) {
+           LOG_DEBUG("Current X {}, Next X {}, steps {}", position,
+                     position + 1.0, steps + i);
+         }));
+
+  // 3. copy arguments into the ring, format on the drain thread
+  report("deferred", measure([&](long i) {
+           LOG_DEFER_DEBUG("Current X {}, Next X {}, steps {}", position,
+                           position + 1.0, steps + i);
+         }));
+
+  // 4. level is disabled at runtime
+  logger->set_level(spdlog::level::info);
+  report("deferred, level disabled", measure([&](long i) {
+           LOG_DEFER_DEBUG("Current X {}, Next X {}, steps {}", position,
+                           position + 1.0, steps + i);
+         }));
+
+  shutdown_hook();
+
+  return status;
+}
@@ -0,0 +1,147 @@
+#include <ctime>
+#include <iostream>
+#include <vector>
+
+#include <libcore/core.hpp>
+#include <libdevice/device.hpp>
+#include <libutil/util.hpp>
+
+USE_NAMESPACE;
+
+// forward declarations
+static ATM_STATUS init();
+static void       shutdown_hook();
+static int        throw_message();
+static void benchmark(const std::shared_ptr<device::StepperDevice>& stepper,
+                      const device::stepper::backend&               backend,
+                      long                                          steps);
+
+static const PI_PIN                step_pin = 6;
+static const PI_PIN                dir_pin = 13;
+static const PI_PIN                enable_pin = 9;
+static const long                  steps = 8000;
+static const device::stepper::step microsteps = 8;
+
+static ATM_STATUS init() {
+  // initialize logger
+  if (Logger::create() == ATM_ERR) {
+    return ATM_ERR;
+  }
+
+  if (gpioInitialise() < 0) {
+    return ATM_ERR;
+  }
+
+  if (device::Wave::create() == ATM_ERR) {
+    return ATM_ERR;
+  }
+
+  return ATM_OK;
+}
+
+static void shutdown_hook() {
+  std::cout << "Shutting down..." << std::endl;
+  device::Wave::get()->stop();
+  destroy_device();
+  destroy_core();
+  std::cout << "Shutting down is completed!" << std::endl;
+}
+
+static int throw_message() {
+  std::cerr << "Failed to initialize wave, something is wrong" << std::endl;
+  return ATM_ERR;
+}
+
+static void benchmark(const std::shared_ptr<device::StepperDevice>& stepper,
+                      const device::stepper::backend&               backend,
+                      long                                          steps) {
+  stepper->backend(backend);
+
+  const std::clock_t cpu_start = std::clock();
+  const time_unit    start = micros();
+
+  stepper->start_move(steps);
+  if (backend == device::stepper::backend::wave) {
+    time_unit interval;
+    while ((interval = stepper->next()) != 0) {
+      // CPU is free until the next chunk is needed
+      sleep_for<time_units::micros>(interval);
+    }
+  } else {
+    while (stepper->next() != 0) {
+      // noop
+    }
+  }
+
+  const time_unit    elapsed = micros() - start;
+  const std::clock_t cpu = std::clock() - cpu_start;
+
+  std::cout << (backend == device::stepper::backend::wave ? "wave" : "bitbang")
+            << ": " << steps << " steps in " << elapsed << " us, cpu "
+            << (1e+6 * static_cast<double>(cpu) / CLOCKS_PER_SEC) << " us"
+            << std::endl;
+}
+
+int main() {
+  ATM_STATUS status = ATM_OK;
+
+  status = init();
+  if (status == ATM_ERR) {
+    return throw_message();
+  }
+
+  std::shared_ptr<device::StepperDevice> stepper =
+      device::LinearSpeedA4988Device::create(step_pin, dir_pin, enable_pin);
+  stepper->microsteps(microsteps);
+  stepper->rpm(3000);
+  stepper->acceleration(4500);
+  stepper->deceleration(4500);
+  stepper->enable();
+
+  benchmark(stepper, device::stepper::backend::bitbang, steps);
+
+#ifdef MOCK_GPIO
+  gpioMockWaveRecordClear();
+#endif
+
+  benchmark(stepper, device::stepper::backend::wave, steps);
+
+#ifdef MOCK_GPIO
+  // verify recorded pulse train
+  std::vector<gpioPulse_t> record(gpioMockWaveRecordSize());
+  gpioMockWaveRecord(record.data(), static_cast<unsigned>(record.size()));
+
+  const uint32_t mask = static_cast<uint32_t>(1) << step_pin;
+  long           rising_edges = 0;
+  time_unit      tick = 0;
+  time_unit      last_edge = 0;
+  time_unit      min_interval = 0;
+
+  for (const auto& pulse : record) {
+    if (pulse.gpioOn & mask) {
+      if (rising_edges > 0 &&
+          (min_interval == 0 || tick - last_edge < min_interval)) {
+        min_interval = tick - last_edge;
+      }
+      last_edge = tick;
+      ++rising_edges;
+    }
+    tick += pulse.usDelay;
+  }
+
+  std::cout << "recorded " << record.size() << " pulses, " << rising_edges
+            << " steps, min step interval " << min_interval << " us"
+            << std::endl;
+
+  if (rising_edges != steps) {
+    std::cerr << "expected " << steps << " steps" << std::endl;
+    status = ATM_ERR;
+  }
+#endif
+
+  stepper->disable();
+
+  shutdown_hook();
+
+  return status;
+}
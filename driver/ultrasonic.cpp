@@ -82,14 +82,15 @@ static bool menu() {
       ultrasonic_device_registry->get(device::id::ultrasonic::water_level());
   auto&& disinfectant_level = ultrasonic_device_registry->get(
       device::id::ultrasonic::disinfectant_level());
+  const double water_max_range = config->ultrasonic().water_level.max_range;
+  const double disinfectant_max_range =
+      config->ultrasonic().disinfectant_level.max_range;
 
   time_unit start = seconds();
   if (choice == 1) {
     while (true) {
-      LOG_DEBUG("Distance {} cm", water_level
-                                      ->distance(config->ultrasonic<double>(
-                                          "water-level", "max-range"))
-                                      .value_or(-99.0));
+      LOG_DEBUG("Distance {} cm",
+                water_level->distance(water_max_range).value_or(-99.0));
       sleep_for<time_units::millis>(10);
 
       if ((seconds() - start) == duration) {
@@ -98,10 +99,9 @@ static bool menu() {
     }
   } else if (choice == 2) {
     while (true) {
-      LOG_DEBUG("Distance {} cm", disinfectant_level
-                                      ->distance(config->ultrasonic<double>(
-                                          "disinfectant-level", "max-range"))
-                                      .value_or(-99.0));
+      LOG_DEBUG(
+          "Distance {} cm",
+          disinfectant_level->distance(disinfectant_max_range).value_or(-99.0));
       sleep_for<time_units::millis>(10);
 
       if ((seconds() - start) == duration) {
@@ -112,13 +112,8 @@ static bool menu() {
     while (true) {
       LOG_DEBUG(
           "Water Level {} cm, Disinfectant Level {} cm",
-          water_level
-              ->distance(config->ultrasonic<double>("water-level", "max-range"))
-              .value_or(-99.0),
-          disinfectant_level
-              ->distance(
-                  config->ultrasonic<double>("disinfectant-level", "max-range"))
-              .value_or(-99.0));
+          water_level->distance(water_max_range).value_or(-99.0),
+          disinfectant_level->distance(disinfectant_max_range).value_or(-99.0));
       sleep_for<time_units::millis>(10);
 
       if ((seconds() - start) == duration) {
@@ -9,6 +9,8 @@
  */
 
 // 1. STL
+#include <array>
+#include <atomic>
 #include <cstddef>
 #include <functional>
 #include <future>
@@ -38,4 +40,8 @@
 #include "thread_pool.hpp"
 #include "thread_pool.inline.hpp"
 
+// 4.3. SPSC Queue
+#include "spsc_queue.hpp"
+#include "spsc_queue.inline.hpp"
+
 #endif  // LIB_ALGO_ALGO_HPP_
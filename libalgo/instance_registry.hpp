@@ -7,17 +7,67 @@
  * Singleton registry class to hold specific class instances
  */
 
+#include <cstdint>
+#include <limits>
 #include <map>
 #include <memory>
 #include <string>
 #include <type_traits>
 #include <unordered_map>
+#include <vector>
 
 #include <libcore/core.hpp>
 
 NAMESPACE_BEGIN
 
 namespace algo {
+namespace registry {
+/** Index of instance in the registry */
+typedef uint32_t index;
+
+/** Index of an instance that is not registered */
+constexpr index invalid = std::numeric_limits<index>::max();
+
+/**
+ * @brief Handle of registered instance.
+ *
+ * Trivially copyable index into the dense instances container, so resolving
+ * an instance costs neither allocation nor hashing
+ *
+ * @tparam T type of the instance
+ */
+template <typename T>
+struct handle {
+  /** index of the instance */
+  index value = invalid;
+
+  /**
+   * Check whether handle refers to an instance or not
+   *
+   * @return true if the handle is valid
+   */
+  constexpr bool valid() const { return value != invalid; }
+  /**
+   * Compare handles
+   */
+  constexpr bool operator==(const handle&) const = default;
+};
+
+/**
+ * @brief Compile-time key of well-known instance.
+ *
+ * Id of the instance is only known once the config is loaded, key is bound
+ * to the instance on creation and resolves in O(1) afterwards
+ *
+ * @tparam T type of the instance
+ */
+template <typename T>
+struct key {
+  /** slot of the key, unique for the type */
+  index slot;
+};
+}  // namespace registry
+
 // forward declaration
 namespace impl {
 template <typename T>
@@ -34,7 +84,9 @@ namespace impl {
  *        This is a class wrapper that should not be instantiated and accessed
  * publicly.
  *
- * Instance registry will create, hold, and destroy all the instances
+ * Instance registry will create, hold, and destroy all the instances.
+ * Instances are stored densely in order of creation, the string id is only
+ * used to resolve a registry::handle (or bind a registry::key) once
  *
  * @tparam T any type to hold the instances
  *
@@ -64,6 +116,43 @@ class InstanceRegistryImpl : public StackObj {
             typename... Args,
             typename = std::enable_if_t<std::is_base_of<T, U>::value>>
   inline ATM_STATUS create(const std::string& id, Args&&... args);
+  /**
+   * Create new instance of T and bind it to compile-time key
+   *
+   * This method is only enabled if U is base of T or T itself
+   *
+   * @tparam U     factory class which is base of T or T itself
+   * @tparam Args  variadic template for arguments
+   *
+   * @param  key   compile-time key of instance
+   * @param  id    unique identifier of instance
+   * @param  args  arguments to pass to constructor of U
+   *
+   * @return status ATM_ERR or ATM_OK
+   */
+  template <typename U = T,
+            typename... Args,
+            typename = std::enable_if_t<std::is_base_of<T, U>::value>>
+  inline ATM_STATUS create(const registry::key<T>& key,
+                           const std::string&      id,
+                           Args&&... args);
+  /**
+   * Create new instance of T
+   *
+   * This method is only enabled if U is base of T or T itself
+   *
+   * @tparam U     factory class which is base of T or T itself
+   * @tparam Args  variadic template for arguments
+   *
+   * @param  id    unique identifier of instance
+   * @param  args  arguments to pass to constructor of U
+   *
+   * @return handle of the instance, invalid if id is not unique
+   */
+  template <typename U = T,
+            typename... Args,
+            typename = std::enable_if_t<std::is_base_of<T, U>::value>>
+  inline registry::handle<T> emplace(const std::string& id, Args&&... args);
   /**
    * Create multiple instances of T
    *
@@ -82,21 +171,58 @@ class InstanceRegistryImpl : public StackObj {
   inline ATM_STATUS create(
       const std::map<const std::string&, Args&&...>& initializers);
   /**
-   * Get instance of T with unique id (const)
+   * Bind compile-time key to existing instance
+   *
+   * @param  key     compile-time key of instance
+   * @param  handle  handle of the instance
+   *
+   * @return status ATM_ERR or ATM_OK
+   */
+  inline ATM_STATUS bind(const registry::key<T>&    key,
+                         const registry::handle<T>& handle);
+  /**
+   * Resolve handle of instance with unique id
+   *
+   * Hashes the id, resolve once and keep the handle
    *
    * @param  id    unique identifier of instance
    *
-   * @return instance of given id or fail
+   * @return handle of the instance, invalid if it does not exist
    */
-  inline const std::shared_ptr<T>& get(const std::string& id) const;
+  inline registry::handle<T> handle(const std::string& id) const;
+  /**
+   * Resolve handle of instance with compile-time key
+   *
+   * @param  key   compile-time key of instance
+   *
+   * @return handle of the instance, invalid if key is not bound
+   */
+  inline registry::handle<T> handle(const registry::key<T>& key) const;
+  /**
+   * Get instance of T with handle
+   *
+   * @param  handle  handle of instance
+   *
+   * @return instance of given handle or nullptr
+   */
+  inline const std::shared_ptr<T>& get(
+      const registry::handle<T>& handle) const;
+  /**
+   * Get instance of T with compile-time key
+   *
+   * @param  key   compile-time key of instance
+   *
+   * @return instance bound to given key or nullptr
+   */
+  inline const std::shared_ptr<T>& get(const registry::key<T>& key) const;
   /**
    * Get instance of T with unique id
    *
    * @param  id    unique identifier of instance
    *
-   * @return instance of given id or fail
+   * @return instance of given id or nullptr
    */
-  inline std::shared_ptr<T>& get(const std::string& id);
+  inline const std::shared_ptr<T>& get(const std::string& id) const;
   /**
    * Check instance of T with unique id
    *
@@ -105,6 +231,12 @@ class InstanceRegistryImpl : public StackObj {
    * @return exist or not
    */
   inline bool exist(const std::string& id) const;
+  /**
+   * Get number of instances
+   *
+   * @return number of instances
+   */
+  inline std::size_t size() const { return instances_.size(); }
 
  private:
   /**
@@ -120,9 +252,21 @@ class InstanceRegistryImpl : public StackObj {
 
  private:
   /**
-   * Instances container
+   * Instances container, indexed by registry::handle
+   */
+  std::vector<std::shared_ptr<T>> instances_;
+  /**
+   * Handles of instances by unique id
+   */
+  std::unordered_map<std::string, registry::handle<T>> index_;
+  /**
+   * Handles of instances by registry::key slot
+   */
+  std::vector<registry::handle<T>> keys_;
+  /**
+   * Instance returned for invalid handles
    */
-  std::unordered_map<std::string, std::shared_ptr<T>> container_;
+  static inline const std::shared_ptr<T> null_{};
 };
 }  // namespace impl
 }  // namespace algo
@@ -3,7 +3,6 @@
 
 #include "instance_registry.hpp"
 
-#include <stdexcept>
 #include <type_traits>
 #include <utility>
 
@@ -21,14 +20,38 @@ template <typename T>
 template <typename U, typename... Args, typename>
 inline ATM_STATUS InstanceRegistryImpl<T>::create(const std::string& id,
                                                   Args&&... args) {
-  massert(container_.count(id) == 0, "instance id must be unique");
-  if (container_.count(id) > 0) {
+  const registry::handle<T> handle =
+      emplace<U>(id, std::forward<Args>(args)...);
+  return handle.valid() ? ATM_OK : ATM_ERR;
+}
+
+template <typename T>
+template <typename U, typename... Args, typename>
+inline ATM_STATUS InstanceRegistryImpl<T>::create(
+    const registry::key<T>& key, const std::string& id, Args&&... args) {
+  const registry::handle<T> handle =
+      emplace<U>(id, std::forward<Args>(args)...);
+  if (!handle.valid()) {
     return ATM_ERR;
   }
+  return bind(key, handle);
+}
+
+template <typename T>
+template <typename U, typename... Args, typename>
+inline registry::handle<T> InstanceRegistryImpl<T>::emplace(
+    const std::string& id, Args&&... args) {
+  massert(index_.count(id) == 0, "instance id must be unique");
+  if (index_.count(id) > 0) {
+    return registry::handle<T>{};
+  }
   DEBUG_ONLY(
       LOG_DEBUG("InstanceRegistryImpl::create instance with key {}", id));
-  container_[id] = U::create(std::forward<Args>(args)...);
-  return ATM_OK;
+  const registry::handle<T> handle{
+      static_cast<registry::index>(instances_.size())};
+  instances_.push_back(U::create(std::forward<Args>(args)...));
+  index_.emplace(id, handle);
+  return handle;
 }
 
 template <typename T>
@@ -47,29 +70,67 @@ inline ATM_STATUS InstanceRegistryImpl<T>::create(
 }
 
 template <typename T>
-inline const std::shared_ptr<T>& InstanceRegistryImpl<T>::get(
+inline ATM_STATUS InstanceRegistryImpl<T>::bind(
+    const registry::key<T>&    key,
+    const registry::handle<T>& handle) {
+  massert(handle.value < instances_.size(), "sanity");
+  if (handle.value >= instances_.size()) {
+    return ATM_ERR;
+  }
+  if (key.slot >= keys_.size()) {
+    keys_.resize(key.slot + 1);
+  }
+  massert(!keys_[key.slot].valid(), "instance key must be unique");
+  if (keys_[key.slot].valid()) {
+    return ATM_ERR;
+  }
+  keys_[key.slot] = handle;
+  return ATM_OK;
+}
+
+template <typename T>
+inline registry::handle<T> InstanceRegistryImpl<T>::handle(
     const std::string& id) const {
-  try {
-    return container_.at(id);
-  } catch ([[maybe_unused]] const std::out_of_range& e) {
-    return nullptr;
+  auto it = index_.find(id);
+  if (it == index_.end()) {
+    return registry::handle<T>{};
   }
+  return it->second;
 }
 
 template <typename T>
-inline std::shared_ptr<T>& InstanceRegistryImpl<T>::get(const std::string& id) {
-  massert(exist(id), "sanity");
-  return container_.at(id);
+inline registry::handle<T> InstanceRegistryImpl<T>::handle(
+    const registry::key<T>& key) const {
+  if (key.slot >= keys_.size()) {
+    return registry::handle<T>{};
+  }
+  return keys_[key.slot];
 }
 
 template <typename T>
-inline bool InstanceRegistryImpl<T>::exist(const std::string& id) const {
-  try {
-    [[maybe_unused]] auto instance = container_.at(id);
-    return true;
-  } catch ([[maybe_unused]] const std::out_of_range& e) {
-    return false;
+inline const std::shared_ptr<T>& InstanceRegistryImpl<T>::get(
+    const registry::handle<T>& handle) const {
+  if (handle.value >= instances_.size()) {
+    return null_;
   }
+  return instances_[handle.value];
+}
+
+template <typename T>
+inline const std::shared_ptr<T>& InstanceRegistryImpl<T>::get(
+    const registry::key<T>& key) const {
+  return get(handle(key));
+}
+
+template <typename T>
+inline const std::shared_ptr<T>& InstanceRegistryImpl<T>::get(
+    const std::string& id) const {
+  return get(handle(id));
+}
+
+template <typename T>
+inline bool InstanceRegistryImpl<T>::exist(const std::string& id) const {
+  return index_.count(id) > 0;
 }
 }  // namespace impl
 }  // namespace algo
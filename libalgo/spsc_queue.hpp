@@ -0,0 +1,99 @@
+#ifndef LIB_ALGO_SPSC_QUEUE_HPP_
+#define LIB_ALGO_SPSC_QUEUE_HPP_
+
+/** @file spsc_queue.hpp
+ *  @brief Single-producer single-consumer queue class definition
+ *
+ * Bounded lock-free ring buffer for one producer and one consumer thread
+ */
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+#include <libcore/core.hpp>
+
+NAMESPACE_BEGIN
+
+namespace algo {
+namespace spsc_queue {
+/** Assumed cache line size to keep producer and consumer index apart */
+constexpr std::size_t cache_line = 64;
+}  // namespace spsc_queue
+
+/**
+ * @brief Single-producer single-consumer queue implementation.
+ *
+ * Fixed capacity ring buffer, neither push nor pop allocates or locks.
+ * Producer only writes tail and consumer only writes head, so both sides only
+ * need acquire/release ordering on the other side's index.
+ *
+ * Only one thread may push and only one thread may pop at the same time
+ *
+ * @tparam T         element type, must be default constructible and movable
+ * @tparam Capacity  number of slots, must be a power of two
+ */
+template <typename T, std::size_t Capacity>
+class SpscQueue : public StackObj {
+  static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                "capacity must be a power of two");
+
+ public:
+  /**
+   * SpscQueue Constructor
+   */
+  SpscQueue();
+  /**
+   * Push element to the queue (producer only)
+   *
+   * @param value  element to push
+   *
+   * @return false if the queue is full
+   */
+  bool push(T&& value);
+  /**
+   * Pop element from the queue (consumer only)
+   *
+   * @param value  popped element
+   *
+   * @return false if the queue is empty
+   */
+  bool pop(T& value);
+  /**
+   * Check whether the queue is empty or not
+   *
+   * Only a snapshot if called while the other side is running
+   *
+   * @return empty or not
+   */
+  bool empty() const;
+  /**
+   * Get queue capacity
+   *
+   * @return number of slots
+   */
+  inline static constexpr std::size_t capacity() { return Capacity; }
+
+ private:
+  /**
+   * Index mask
+   */
+  static constexpr std::size_t mask_ = Capacity - 1;
+  /**
+   * Elements
+   */
+  std::array<T, Capacity> buffer_;
+  /**
+   * Index of next element to pop, written by consumer
+   */
+  alignas(spsc_queue::cache_line) std::atomic<std::size_t> head_;
+  /**
+   * Index of next element to push, written by producer
+   */
+  alignas(spsc_queue::cache_line) std::atomic<std::size_t> tail_;
+};
+}  // namespace algo
+
+NAMESPACE_END
+
+#endif  // LIB_ALGO_SPSC_QUEUE_HPP_
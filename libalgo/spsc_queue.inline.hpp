@@ -0,0 +1,49 @@
+#ifndef LIB_ALGO_SPSC_QUEUE_INLINE_HPP_
+#define LIB_ALGO_SPSC_QUEUE_INLINE_HPP_
+
+#include "spsc_queue.hpp"
+
+#include <utility>
+
+NAMESPACE_BEGIN
+
+namespace algo {
+template <typename T, std::size_t Capacity>
+SpscQueue<T, Capacity>::SpscQueue() : head_{0}, tail_{0} {}
+
+template <typename T, std::size_t Capacity>
+bool SpscQueue<T, Capacity>::push(T&& value) {
+  const std::size_t tail = tail_.load(std::memory_order_relaxed);
+
+  if (tail - head_.load(std::memory_order_acquire) == Capacity) {
+    return false;
+  }
+
+  buffer_[tail & mask_] = std::move(value);
+  tail_.store(tail + 1, std::memory_order_release);
+  return true;
+}
+
+template <typename T, std::size_t Capacity>
+bool SpscQueue<T, Capacity>::pop(T& value) {
+  const std::size_t head = head_.load(std::memory_order_relaxed);
+
+  if (head == tail_.load(std::memory_order_acquire)) {
+    return false;
+  }
+
+  value = std::move(buffer_[head & mask_]);
+  head_.store(head + 1, std::memory_order_release);
+  return true;
+}
+
+template <typename T, std::size_t Capacity>
+bool SpscQueue<T, Capacity>::empty() const {
+  return head_.load(std::memory_order_acquire) ==
+         tail_.load(std::memory_order_acquire);
+}
+}  // namespace algo
+
+NAMESPACE_END
+
+#endif  // LIB_ALGO_SPSC_QUEUE_INLINE_HPP_
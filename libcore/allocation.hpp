@@ -118,6 +118,9 @@ class StaticObj {
   /**
    * Singleton initialization
    *
+   * If T has `bool valid() const`, it is checked after construction so T can
+   * report errors that are found in its constructor
+   *
    * @param  args    arguments are same with typename T constructor
    * @return T pointer
    */
@@ -129,6 +132,14 @@ class StaticObj {
    * @return T pointer that has been initialized
    */
   inline static T* get();
+  /**
+   * Check whether the singleton has been created
+   *
+   * For optional singletons, get() asserts that it has been created
+   *
+   * @return true if create() has been called
+   */
+  inline static bool created() { return instance_ != nullptr; }
 
  private:
   /**
@@ -39,10 +39,14 @@ inline ATM_STATUS StaticObj<T>::create(Args&&... args) {
   }
   if (instance_ == nullptr) {
     return ATM_ERR;
-  } else {
-    massert(instance_ != nullptr, "sanity check");
-    return ATM_OK;
   }
+  if constexpr (requires(const T& instance) { instance.valid(); }) {
+    if (!instance_->valid()) {
+      return ATM_ERR;
+    }
+  }
+  massert(instance_ != nullptr, "sanity check");
+  return ATM_OK;
 }
 
 template <typename T>
@@ -2,6 +2,9 @@
 
 #include "config.hpp"
 
+#include <exception>
+#include <stdexcept>
+#include <tuple>
 #include <utility>
 
 namespace toml {
@@ -17,6 +20,7 @@ struct from<ns(config::Speed)> {
     sc.rpm = find<double>(v, "rpm");
     sc.acceleration = find<double>(v, "acceleration");
     sc.deceleration = find<double>(v, "deceleration");
+    sc.jerk = find<double>(v, "jerk");
     return sc;
   }
 };
@@ -73,11 +77,12 @@ Speed::Speed() {
   rpm = 0.0;
   acceleration = 0.0;
   deceleration = 0.0;
+  jerk = 0.0;
 }
 
 DEBUG_ONLY_DEFINITION(void Speed::print(std::ostream& os) const {
   os << "[rpm: " << rpm << ", accel: " << acceleration
-     << ", decel: " << deceleration << "]";
+     << ", decel: " << deceleration << ", jerk: " << jerk << "]";
 })
 
 MechanismSpeed::MechanismSpeed() {
@@ -91,6 +96,16 @@ DEBUG_ONLY_DEFINITION(void MechanismSpeed::print(std::ostream& os) const {
 
 SpeedProfile::SpeedProfile() {}
 
+const MechanismSpeed& SpeedProfile::get(const speed& speed_profile) const {
+  if (speed_profile == speed::slow) {
+    return slow;
+  } else if (speed_profile == speed::normal) {
+    return normal;
+  } else {
+    return fast;
+  }
+}
+
 DEBUG_ONLY_DEFINITION(void SpeedProfile::print(std::ostream& os) const {
   os << "[slow: " << slow;
   os << ", normal: " << normal;
@@ -98,201 +113,684 @@ DEBUG_ONLY_DEFINITION(void SpeedProfile::print(std::ostream& os) const {
 })
 }  // namespace config
 
-namespace impl {
-ConfigImpl::ConfigImpl(const std::string& config_path)
-    : config_{toml::parse(config_path)}, config_path_{std::move(config_path)} {
-  DEBUG_ONLY_DEFINITION(obj_name_ = "ConfigImpl");
-  load_speed_profiles();
+namespace {
+/**
+ * Compile TOML string into enum value
+ *
+ * Throws std::out_of_range if the string is not one of the names
+ *
+ * @param v      TOML table
+ * @param key    key of the string in the table
+ * @param path   key of the value in the TOML config
+ * @param names  accepted names and their values
+ *
+ * @return enum value
+ */
+template <typename E, std::size_t N>
+E compile_enum(const toml::value&                        v,
+               const std::string&                        key,
+               const std::string&                        path,
+               const std::pair<const char*, E> (&names)[N]) {
+  const auto value = toml::find<std::string>(v, key);
+
+  std::string expected;
+  for (std::size_t i = 0; i < N; ++i) {
+    if (value == names[i].first) {
+      return names[i].second;
+    }
+    const char* separator = i == 0 ? "" : (i + 1 == N ? " or " : ", ");
+    expected += fmt::format("{}\"{}\"", separator, names[i].first);
+  }
+
+  throw std::out_of_range(
+      fmt::format("{}: must be {} (got \"{}\")", path, expected, value));
 }
 
-std::string ConfigImpl::name() const {
-  if (config().contains("general") && config().at("general").contains("name")) {
-    return find<std::string>("general", "name");
-  }
+/**
+ * Compile TOML table into configuration struct
+ *
+ * Throws toml::type_error or std::out_of_range on missing key, wrong type or
+ * unknown name
+ */
+void compile(const toml::value& v, config::Digital& digital) {
+  digital.key = toml::find<std::string>(v, "key");
+  digital.pin = toml::find<int>(v, "pin");
+  digital.active_state = toml::find<bool>(v, "active-state");
+}
 
-  return "Emmerich Automated Tending";
+void compile(const toml::value& v, config::Brake& brake) {
+  compile(v, static_cast<config::Digital&>(brake));
+  brake.duration = toml::find<unsigned long>(v, "duration");
 }
 
-bool ConfigImpl::debug() const {
-  if (config().contains("general") &&
-      config().at("general").contains("debug")) {
-    return find<bool>("general", "debug");
-  }
+void compile(const toml::value& v, config::Stepper& stepper) {
+  stepper.key = toml::find<std::string>(v, "key");
+  stepper.step_pin = toml::find<int>(v, "step-pin");
+  stepper.step_active_state = toml::find<bool>(v, "step-active-state");
+  stepper.dir_pin = toml::find<int>(v, "dir-pin");
+  stepper.dir_active_state = toml::find<bool>(v, "dir-active-state");
+  stepper.enable_pin = toml::find<int>(v, "enable-pin");
+  stepper.enable_active_state = toml::find<bool>(v, "enable-active-state");
+  stepper.steps_per_mm = toml::find<long>(v, "steps-per-mm");
+  stepper.microsteps = toml::find<long>(v, "microsteps");
+}
 
-  return false;
+void compile(const toml::value& v, config::Steppers& steppers) {
+  steppers.type = toml::find<std::string>(v, "type");
+  const std::pair<const char*, device::stepper::speed> speeds[] = {
+      {"linear", device::stepper::speed::linear},
+      {"scurve", device::stepper::speed::scurve},
+  };
+  const std::pair<const char*, device::stepper::backend> backends[] = {
+      {"bitbang", device::stepper::backend::bitbang},
+      {"wave", device::stepper::backend::wave},
+  };
+  steppers.speed = compile_enum(v, "speed", "devices.stepper.speed", speeds);
+  steppers.backend =
+      compile_enum(v, "backend", "devices.stepper.backend", backends);
+  steppers.wave_chunk_duration =
+      toml::find<time_unit>(v, "wave-chunk-duration");
+  compile(toml::find(v, "x"), steppers.x);
+  compile(toml::find(v, "y"), steppers.y);
+  compile(toml::find(v, "z"), steppers.z);
 }
 
-unsigned int ConfigImpl::timeout() const {
-  if (config().contains("mechanisms") &&
-      config().at("mechanisms").contains("fault") &&
-      config().at("mechanisms").at("fault").contains("timeout")) {
-    return find<unsigned int>("mechanisms", "fault", "timeout");
-  }
+void compile(const toml::value& v, config::ShiftRegisterOutput& output) {
+  output.key = toml::find<std::string>(v, "key");
+  output.address = toml::find<byte>(v, "address");
+  output.active_state = toml::find<bool>(v, "active-state");
+}
+
+void compile(const toml::value& v, config::ShiftRegister& shift_register) {
+  const std::pair<const char*, device::shift_register::backend> backends[] = {
+      {"gpio", device::shift_register::backend::gpio},
+      {"spi", device::shift_register::backend::spi},
+  };
+  shift_register.backend = compile_enum(
+      v, "backend", "devices.shift-register.backend", backends);
+  shift_register.latch_pin = toml::find<int>(v, "latch-pin");
+  shift_register.clock_pin = toml::find<int>(v, "clock-pin");
+  shift_register.data_pin = toml::find<int>(v, "data-pin");
+  shift_register.spi_channel = toml::find<unsigned int>(v, "spi-channel");
+  shift_register.spi_baud = toml::find<unsigned int>(v, "spi-baud");
+  shift_register.flush_period = toml::find<time_unit>(v, "flush-period");
+  compile(toml::find(v, "water-in"), shift_register.water_in);
+  compile(toml::find(v, "water-out"), shift_register.water_out);
+  compile(toml::find(v, "disinfectant-in"), shift_register.disinfectant_in);
+  compile(toml::find(v, "disinfectant-out"), shift_register.disinfectant_out);
+  compile(toml::find(v, "sonicator-relay"), shift_register.sonicator_relay);
+  compile(toml::find(v, "tending-ready"), shift_register.tending_ready);
+  compile(toml::find(v, "spraying-ready"), shift_register.spraying_ready);
+  compile(toml::find(v, "tending-running"), shift_register.tending_running);
+  compile(toml::find(v, "spraying-running"), shift_register.spraying_running);
+  compile(toml::find(v, "tending-complete"), shift_register.tending_complete);
+  compile(toml::find(v, "spraying-complete"),
+          shift_register.spraying_complete);
+  compile(toml::find(v, "spray"), shift_register.spray);
+}
 
-  return 60;  // default to 60s
+void compile(const toml::value& v, config::Ultrasonic& ultrasonic) {
+  ultrasonic.key = toml::find<std::string>(v, "key");
+  ultrasonic.echo_pin = toml::find<int>(v, "echo-pin");
+  ultrasonic.echo_active_state = toml::find<bool>(v, "echo-active-state");
+  ultrasonic.trigger_pin = toml::find<int>(v, "trigger-pin");
+  ultrasonic.trigger_active_state =
+      toml::find<bool>(v, "trigger-active-state");
+  ultrasonic.max_range = toml::find<double>(v, "max-range");
 }
 
-const ConfigImpl::coordinate& ConfigImpl::spraying_position() {
-  if (util::pair_empty(spraying_position_)) {
-    spraying_position_ =
-        find<ConfigImpl::coordinate>("mechanisms", "spraying", "position");
+void compile(const toml::value& v, config::Devices& devices) {
+  compile(toml::find(v, "stepper"), devices.stepper);
+
+  const auto& finger = toml::find(v, "finger");
+  compile(toml::find(finger, "motor"), devices.finger.motor);
+  compile(toml::find(finger, "brake"), devices.finger.brake);
+  compile(toml::find(finger, "infrared"), devices.finger.infrared);
+
+  const auto& limit_switch = toml::find(v, "limit-switch");
+  compile(toml::find(limit_switch, "x"), devices.limit_switch.x);
+  compile(toml::find(limit_switch, "y"), devices.limit_switch.y);
+  compile(toml::find(limit_switch, "z1"), devices.limit_switch.z1);
+  compile(toml::find(limit_switch, "z2"), devices.limit_switch.z2);
+  compile(toml::find(limit_switch, "finger-protection"),
+          devices.limit_switch.finger_protection);
+
+  const auto& plc_to_pi = toml::find(v, "plc-to-pi");
+  compile(toml::find(plc_to_pi, "spraying-tending-height"),
+          devices.plc_to_pi.spraying_tending_height);
+  compile(toml::find(plc_to_pi, "cleaning-height"),
+          devices.plc_to_pi.cleaning_height);
+  compile(toml::find(plc_to_pi, "reset"), devices.plc_to_pi.reset);
+  compile(toml::find(plc_to_pi, "e-stop"), devices.plc_to_pi.e_stop);
+
+  compile(toml::find(v, "shift-register"), devices.shift_register);
+
+  // ultrasonic devices are not installed on every machine
+  if (v.contains("ultrasonic")) {
+    const auto& ultrasonic = toml::find(v, "ultrasonic");
+    compile(toml::find(ultrasonic, "water-level"),
+            devices.ultrasonic.water_level);
+    compile(toml::find(ultrasonic, "disinfectant-level"),
+            devices.ultrasonic.disinfectant_level);
   }
-  return spraying_position_;
+
+  const auto& float_sensor = toml::find(v, "float-sensor");
+  compile(toml::find(float_sensor, "water-level"),
+          devices.float_sensor.water_level);
+  compile(toml::find(float_sensor, "disinfectant-level"),
+          devices.float_sensor.disinfectant_level);
+
+  compile(toml::find(v, "sonicator-relay"), devices.sonicator_relay);
 }
 
-const ConfigImpl::coordinate& ConfigImpl::tending_position() {
-  if (util::pair_empty(tending_position_)) {
-    tending_position_ =
-        find<ConfigImpl::coordinate>("mechanisms", "tending", "position");
+void compile(const toml::value& v, config::Mechanisms& mechanisms) {
+  const auto& movement = toml::find(v, "movement");
+  const std::pair<const char*, mechanism::movement::mode> modes[] = {
+      {"independent", mechanism::movement::mode::independent},
+      {"interpolated", mechanism::movement::mode::interpolated},
+  };
+  mechanisms.movement.mode =
+      compile_enum(movement, "mode", "mechanisms.movement.mode", modes);
+  mechanisms.movement.look_ahead = toml::find<bool>(movement, "look-ahead");
+  mechanisms.movement.junction_deviation =
+      toml::find<double>(movement, "junction-deviation");
+  mechanisms.movement.executor.priority =
+      toml::find<int>(movement, "executor", "priority");
+  mechanisms.movement.executor.cpu =
+      toml::find<int>(movement, "executor", "cpu");
+  mechanisms.movement.executor.lock_memory =
+      toml::find<bool>(movement, "executor", "lock-memory");
+
+  const auto& homing = toml::find(v, "homing");
+  mechanisms.homing.backoff = toml::find<double>(homing, "backoff");
+  mechanisms.homing.approach_ratio =
+      toml::find<double>(homing, "approach-ratio");
+  mechanisms.homing.speed = toml::get<config::SpeedProfile>(homing);
+
+  const auto& fault = toml::find(v, "fault");
+  if (fault.contains("timeout")) {
+    mechanisms.fault.timeout = toml::find<unsigned int>(fault, "timeout");
   }
-  return tending_position_;
+  mechanisms.fault.manual.x =
+      toml::find<double>(fault, "manual", "movement", "x");
+  mechanisms.fault.manual.y =
+      toml::find<double>(fault, "manual", "movement", "y");
+  mechanisms.fault.manual.z =
+      toml::find<double>(fault, "manual", "movement", "z");
+  mechanisms.fault.speed =
+      toml::find<config::SpeedProfile>(fault, "manual");
+
+  const auto& spraying = toml::find(v, "spraying");
+  mechanisms.spraying.position =
+      toml::find<config::coordinate>(spraying, "position");
+  mechanisms.spraying.path =
+      toml::find<config::path_container>(spraying, "path");
+  mechanisms.spraying.speed = toml::get<config::SpeedProfile>(spraying);
+
+  const auto& tending = toml::find(v, "tending");
+  mechanisms.tending.position =
+      toml::find<config::coordinate>(tending, "position");
+  mechanisms.tending.path_edge =
+      toml::find<config::path_container>(tending, "path", "edge");
+  mechanisms.tending.path_zigzag =
+      toml::find<config::path_container>(tending, "path", "zigzag");
+  mechanisms.tending.speed = toml::get<config::SpeedProfile>(tending);
+
+  const auto& cleaning = toml::find(v, "cleaning");
+  mechanisms.cleaning.stations =
+      toml::find<config::cleaning_container>(cleaning, "stations");
+  mechanisms.cleaning.speed = toml::get<config::SpeedProfile>(cleaning);
+
+  const auto& liquid_refilling = toml::find(v, "liquid-refilling");
+  mechanisms.liquid_refilling.water_draining_time =
+      toml::find<unsigned int>(liquid_refilling, "water", "draining-time");
+  mechanisms.liquid_refilling.disinfectant_draining_time =
+      toml::find<unsigned int>(liquid_refilling, "disinfectant",
+                               "draining-time");
 }
 
-const ConfigImpl::path_container& ConfigImpl::spraying_path() {
-  if (spraying_path_.empty()) {
-    spraying_path_ =
-        find<ConfigImpl::path_container>("mechanisms", "spraying", "path");
+void compile(const toml::value& v, config::Settings& settings) {
+  if (v.contains("general")) {
+    const auto& general = toml::find(v, "general");
+    if (general.contains("name")) {
+      settings.general.name = toml::find<std::string>(general, "name");
+    }
+    if (general.contains("debug")) {
+      settings.general.debug = toml::find<bool>(general, "debug");
+    }
   }
-  return spraying_path_;
+
+  compile(toml::find(v, "devices"), settings.devices);
+  compile(toml::find(v, "mechanisms"), settings.mechanisms);
 }
+}  // namespace
+
+namespace config {
+namespace {
+/** Number of GPIO pins of RaspberryPI */
+constexpr int gpio_pins = 54;
+
+/**
+ * @brief Collects validation errors of config::Settings.
+ */
+class Validator {
+ public:
+  /**
+   * Check condition
+   *
+   * @param condition  condition that must hold
+   * @param path       key of the value in the TOML config
+   * @param message    what is expected
+   */
+  template <typename T>
+  void expect(bool               condition,
+              const std::string& path,
+              const std::string& message,
+              const T&           value) {
+    if (!condition) {
+      errors_.push_back(fmt::format("{}: {} (got {})", path, message, value));
+    }
+  }
+  /**
+   * Check GPIO pin, pin must be unique unless it is shared
+   *
+   * @param path    key of the pin in the TOML config
+   * @param pin     GPIO pin
+   * @param shared  pin may be used by several devices
+   */
+  void pin(const std::string& path, int pin, bool shared = false) {
+    expect(pin >= 0 && pin < gpio_pins, path,
+           fmt::format("must be a GPIO pin between 0 and {}", gpio_pins - 1),
+           pin);
+    for (const auto& [other_path, other_pin, other_shared] : pins_) {
+      if (other_pin == pin && !(shared && other_shared)) {
+        errors_.push_back(
+            fmt::format("{}: pin {} is already used by {}", path, pin,
+                        other_path));
+        break;
+      }
+    }
+    pins_.emplace_back(path, pin, shared);
+  }
+  /**
+   * Check registry id, id must not be empty and must be unique
+   *
+   * @param path  key of the id in the TOML config
+   * @param key   registry id
+   */
+  void key(const std::string& path, const std::string& key) {
+    expect(!key.empty(), path, "must not be empty", "\"\"");
+    for (const auto& [other_path, other_key] : keys_) {
+      if (!key.empty() && other_key == key) {
+        errors_.push_back(fmt::format("{}: key \"{}\" is already used by {}",
+                                      path, key, other_path));
+        break;
+      }
+    }
+    keys_.emplace_back(path, key);
+  }
+  /**
+   * Check digital device
+   *
+   * @param path     key of the device in the TOML config
+   * @param digital  digital device configuration
+   */
+  void digital(const std::string& path, const Digital& digital) {
+    key(path + ".key", digital.key);
+    pin(path + ".pin", digital.pin);
+  }
+  /**
+   * Check speed profile of every axis
+   *
+   * @param path     key of the speed profile in the TOML config
+   * @param profile  speed profile
+   * @param scurve   steppers follow the S-curve profile, jerk is required
+   */
+  void speed(const std::string&  path,
+             const SpeedProfile& profile,
+             bool                scurve) {
+    const std::pair<const char*, const MechanismSpeed*> speeds[] = {
+        {"slow", &profile.slow},
+        {"normal", &profile.normal},
+        {"fast", &profile.fast},
+    };
+    for (const auto& [name, mechanism] : speeds) {
+      const std::pair<const char*, const Speed*> axes[] = {
+          {"x", &mechanism->x},
+          {"y", &mechanism->y},
+          {"z", &mechanism->z},
+      };
+      for (const auto& [axis, speed] : axes) {
+        const std::string prefix = fmt::format("{}.speed.{}.{}", path, name,
+                                               axis);
+        expect(speed->rpm > 0.0, prefix + ".rpm", "must be positive",
+               speed->rpm);
+        expect(speed->acceleration > 0.0, prefix + ".acceleration",
+               "must be positive", speed->acceleration);
+        expect(speed->deceleration > 0.0, prefix + ".deceleration",
+               "must be positive", speed->deceleration);
+        if (scurve) {
+          expect(speed->jerk > 0.0, prefix + ".jerk",
+                 "must be positive for \"scurve\" speed", speed->jerk);
+        } else {
+          expect(speed->jerk >= 0.0, prefix + ".jerk", "must not be negative",
+                 speed->jerk);
+        }
+      }
+      expect(mechanism->duty_cycle <= 255,
+             fmt::format("{}.speed.{}.duty-cycle", path, name),
+             "must be between 0 and 255", mechanism->duty_cycle);
+    }
+  }
+  /**
+   * Get collected errors
+   *
+   * @return validation errors
+   */
+  inline std::vector<std::string>& errors() { return errors_; }
+
+ private:
+  /**
+   * Collected errors
+   */
+  std::vector<std::string> errors_;
+  /**
+   * Checked pins (path, pin, shared)
+   */
+  std::vector<std::tuple<std::string, int, bool>> pins_;
+  /**
+   * Checked registry ids (path, id)
+   */
+  std::vector<std::pair<std::string, std::string>> keys_;
+};
+}  // namespace
+
+std::vector<std::string> validate(const Settings& settings) {
+  Validator validator;
+
+  // steppers
+  const auto& stepper = settings.devices.stepper;
+  validator.expect(stepper.backend != device::stepper::backend::wave ||
+                       stepper.wave_chunk_duration > 0,
+                   "devices.stepper.wave-chunk-duration", "must be positive",
+                   stepper.wave_chunk_duration);
+
+  const std::pair<const char*, const Stepper*> steppers[] = {
+      {"x", &stepper.x},
+      {"y", &stepper.y},
+      {"z", &stepper.z},
+  };
+  for (const auto& [axis, axis_stepper] : steppers) {
+    const std::string path = fmt::format("devices.stepper.{}", axis);
+    validator.key(path + ".key", axis_stepper->key);
+    validator.pin(path + ".step-pin", axis_stepper->step_pin);
+    validator.pin(path + ".dir-pin", axis_stepper->dir_pin);
+    // drivers may share enable pin
+    validator.pin(path + ".enable-pin", axis_stepper->enable_pin, true);
+    validator.expect(axis_stepper->steps_per_mm > 0, path + ".steps-per-mm",
+                     "must be positive", axis_stepper->steps_per_mm);
+    const long microsteps = axis_stepper->microsteps;
+    validator.expect(microsteps > 0 && microsteps <= 16 &&
+                         (microsteps & (microsteps - 1)) == 0,
+                     path + ".microsteps", "must be 1, 2, 4, 8, or 16",
+                     microsteps);
+  }
 
-const ConfigImpl::path_container& ConfigImpl::tending_path_edge() {
-  if (tending_path_edge_.empty()) {
-    tending_path_edge_ = find<ConfigImpl::path_container>(
-        "mechanisms", "tending", "path", "edge");
+  // finger
+  validator.digital("devices.finger.motor", settings.devices.finger.motor);
+  validator.digital("devices.finger.brake", settings.devices.finger.brake);
+  validator.digital("devices.finger.infrared",
+                    settings.devices.finger.infrared);
+
+  // limit switches
+  const auto& limit_switch = settings.devices.limit_switch;
+  validator.digital("devices.limit-switch.x", limit_switch.x);
+  validator.digital("devices.limit-switch.y", limit_switch.y);
+  validator.digital("devices.limit-switch.z1", limit_switch.z1);
+  validator.digital("devices.limit-switch.z2", limit_switch.z2);
+  validator.digital("devices.limit-switch.finger-protection",
+                    limit_switch.finger_protection);
+
+  // PLC to PI
+  const auto& plc_to_pi = settings.devices.plc_to_pi;
+  validator.digital("devices.plc-to-pi.spraying-tending-height",
+                    plc_to_pi.spraying_tending_height);
+  validator.digital("devices.plc-to-pi.cleaning-height",
+                    plc_to_pi.cleaning_height);
+  validator.digital("devices.plc-to-pi.reset", plc_to_pi.reset);
+  validator.digital("devices.plc-to-pi.e-stop", plc_to_pi.e_stop);
+
+  // shift register
+  const auto& shift_register = settings.devices.shift_register;
+  validator.pin("devices.shift-register.latch-pin", shift_register.latch_pin);
+  if (shift_register.backend != device::shift_register::backend::spi) {
+    validator.pin("devices.shift-register.clock-pin",
+                  shift_register.clock_pin);
+    validator.pin("devices.shift-register.data-pin", shift_register.data_pin);
+  } else {
+    validator.expect(shift_register.spi_channel <= 1,
+                     "devices.shift-register.spi-channel", "must be 0 or 1",
+                     shift_register.spi_channel);
+    // main SPI takes its pins over once it is opened
+    const std::string path = "devices.shift-register.spi-channel";
+    validator.pin(fmt::format("{} (CE{})", path, shift_register.spi_channel),
+                  shift_register.spi_channel == 1 ? 7 : 8);
+    validator.pin(path + " (MISO)", 9);
+    validator.pin(path + " (MOSI)", 10);
+    validator.pin(path + " (SCLK)", 11);
+  }
+
+  const std::pair<const char*, const ShiftRegisterOutput*> outputs[] = {
+      {"water-in", &shift_register.water_in},
+      {"water-out", &shift_register.water_out},
+      {"disinfectant-in", &shift_register.disinfectant_in},
+      {"disinfectant-out", &shift_register.disinfectant_out},
+      {"sonicator-relay", &shift_register.sonicator_relay},
+      {"tending-ready", &shift_register.tending_ready},
+      {"spraying-ready", &shift_register.spraying_ready},
+      {"tending-running", &shift_register.tending_running},
+      {"spraying-running", &shift_register.spraying_running},
+      {"tending-complete", &shift_register.tending_complete},
+      {"spraying-complete", &shift_register.spraying_complete},
+      {"spray", &shift_register.spray},
+  };
+  std::vector<std::string> addresses(ShiftRegister::outputs);
+  for (const auto& [name, output] : outputs) {
+    const std::string path = fmt::format("devices.shift-register.{}", name);
+    validator.key(path + ".key", output->key);
+    const unsigned int address = output->address;
+    validator.expect(address < ShiftRegister::outputs, path + ".address",
+                     fmt::format("must be between 0 and {}",
+                                 ShiftRegister::outputs - 1),
+                     address);
+    if (address >= ShiftRegister::outputs) {
+      continue;
+    }
+    validator.expect(addresses[address].empty(), path + ".address",
+                     fmt::format("is already used by {}", addresses[address]),
+                     address);
+    addresses[address] = path;
   }
-  return tending_path_edge_;
+
+  // optional ultrasonic devices
+  const auto& ultrasonic = settings.devices.ultrasonic;
+  const std::pair<const char*, const Ultrasonic*> ultrasonics[] = {
+      {"water-level", &ultrasonic.water_level},
+      {"disinfectant-level", &ultrasonic.disinfectant_level},
+  };
+  for (const auto& [name, device] : ultrasonics) {
+    if (device->key.empty()) {
+      continue;
+    }
+    const std::string path = fmt::format("devices.ultrasonic.{}", name);
+    validator.key(path + ".key", device->key);
+    validator.pin(path + ".echo-pin", device->echo_pin);
+    validator.pin(path + ".trigger-pin", device->trigger_pin);
+    validator.expect(device->max_range > 0.0, path + ".max-range",
+                     "must be positive", device->max_range);
+  }
+
+  // float sensors and sonicator relay
+  validator.digital("devices.float-sensor.water-level",
+                    settings.devices.float_sensor.water_level);
+  validator.digital("devices.float-sensor.disinfectant-level",
+                    settings.devices.float_sensor.disinfectant_level);
+  validator.digital("devices.sonicator-relay",
+                    settings.devices.sonicator_relay);
+
+  // mechanisms
+  const auto& mechanisms = settings.mechanisms;
+  validator.expect(mechanisms.movement.junction_deviation >= 0.0,
+                   "mechanisms.movement.junction-deviation",
+                   "must not be negative",
+                   mechanisms.movement.junction_deviation);
+  validator.expect(mechanisms.homing.backoff >= 0.0,
+                   "mechanisms.homing.backoff", "must not be negative",
+                   mechanisms.homing.backoff);
+  validator.expect(mechanisms.homing.approach_ratio > 0.0 &&
+                       mechanisms.homing.approach_ratio <= 1.0,
+                   "mechanisms.homing.approach-ratio",
+                   "must be in (0, 1]", mechanisms.homing.approach_ratio);
+  validator.expect(mechanisms.fault.timeout > 0, "mechanisms.fault.timeout",
+                   "must be positive", mechanisms.fault.timeout);
+  validator.expect(!mechanisms.spraying.path.empty(),
+                   "mechanisms.spraying.path", "must not be empty",
+                   mechanisms.spraying.path.size());
+  validator.expect(!mechanisms.tending.path_edge.empty(),
+                   "mechanisms.tending.path.edge", "must not be empty",
+                   mechanisms.tending.path_edge.size());
+  validator.expect(!mechanisms.tending.path_zigzag.empty(),
+                   "mechanisms.tending.path.zigzag", "must not be empty",
+                   mechanisms.tending.path_zigzag.size());
+
+  const bool scurve = stepper.speed == device::stepper::speed::scurve;
+  validator.speed("mechanisms.fault.manual", mechanisms.fault.speed, scurve);
+  validator.speed("mechanisms.homing", mechanisms.homing.speed, scurve);
+  validator.speed("mechanisms.spraying", mechanisms.spraying.speed, scurve);
+  validator.speed("mechanisms.tending", mechanisms.tending.speed, scurve);
+  validator.speed("mechanisms.cleaning", mechanisms.cleaning.speed, scurve);
+
+  return std::move(validator.errors());
 }
+}  // namespace config
+
+namespace impl {
+ConfigImpl::ConfigImpl(const std::string& config_path)
+    : config_path_{config_path} {
+  DEBUG_ONLY_DEFINITION(obj_name_ = "ConfigImpl");
+
+  try {
+    compile(toml::parse(config_path_), settings_);
+  } catch (const std::exception& e) {
+    errors_.emplace_back(e.what());
+  }
+
+  if (errors_.empty()) {
+    errors_ = config::validate(settings_);
+  }
 
-const ConfigImpl::cleaning_container& ConfigImpl::cleaning_stations() {
-  if (cleaning_stations_.empty()) {
-    cleaning_stations_ = find<ConfigImpl::cleaning_container>(
-        "mechanisms", "cleaning", "stations");
+  for (const auto& error : errors_) {
+    LOG_ERROR("Config {}: {}", config_path_, error);
   }
-  return cleaning_stations_;
+
+  snapshot_.store(std::make_shared<const config::Settings>(settings_),
+                  std::memory_order_release);
 }
 
-const ConfigImpl::path_container& ConfigImpl::tending_path_zigzag() {
-  if (tending_path_zigzag_.empty()) {
-    tending_path_zigzag_ = find<ConfigImpl::path_container>(
-        "mechanisms", "tending", "path", "zigzag");
+ATM_STATUS ConfigImpl::reload() {
+  std::lock_guard<std::mutex> lock(reload_mutex_);
+
+  config::Settings         settings;
+  std::vector<std::string> errors;
+
+  try {
+    compile(toml::parse(config_path_), settings);
+  } catch (const std::exception& e) {
+    errors.emplace_back(e.what());
+  }
+
+  if (errors.empty()) {
+    errors = config::validate(settings);
   }
-  return tending_path_zigzag_;
+
+  if (!errors.empty()) {
+    for (const auto& error : errors) {
+      LOG_ERROR("Config {}: {}", config_path_, error);
+    }
+    LOG_ERROR("Config {} is not reloaded, keeping revision {}", config_path_,
+              revision());
+    return ATM_ERR;
+  }
+
+  // devices are initialized once, so only mechanisms are taken
+  auto next = std::make_shared<config::Settings>(settings_);
+  next->mechanisms = std::move(settings.mechanisms);
+  next->revision = revision() + 1;
+
+  const unsigned int next_revision = next->revision;
+
+  snapshot_.store(std::move(next), std::memory_order_release);
+
+  LOG_INFO("Config {} is reloaded, revision {}", config_path_, next_revision);
+
+  return ATM_OK;
 }
 
-const ConfigImpl::coordinate ConfigImpl::spraying_path(size_t idx) {
-  const auto paths = spraying_path();
+ConfigImpl::coordinate ConfigImpl::spraying_path(size_t idx) const {
+  const auto settings = snapshot();
+  const auto& paths = settings->mechanisms.spraying.path;
   massert(idx < paths.size(), "sanity");
   return paths[idx];
 }
 
-const ConfigImpl::coordinate ConfigImpl::tending_path_edge(size_t idx) {
-  const auto paths = tending_path_edge();
+ConfigImpl::coordinate ConfigImpl::tending_path_edge(size_t idx) const {
+  const auto settings = snapshot();
+  const auto& paths = settings->mechanisms.tending.path_edge;
   massert(idx < paths.size(), "sanity");
   return paths[idx];
 }
 
-const ConfigImpl::coordinate ConfigImpl::tending_path_zigzag(size_t idx) {
-  const auto paths = tending_path_zigzag();
+ConfigImpl::coordinate ConfigImpl::tending_path_zigzag(size_t idx) const {
+  const auto settings = snapshot();
+  const auto& paths = settings->mechanisms.tending.path_zigzag;
   massert(idx < paths.size(), "sanity");
   return paths[idx];
 }
 
-const ConfigImpl::cleaning& ConfigImpl::cleaning_station(size_t idx) {
-  const auto& cleanings = cleaning_stations();
+ConfigImpl::cleaning ConfigImpl::cleaning_station(size_t idx) const {
+  const auto settings = snapshot();
+  const auto& cleanings = settings->mechanisms.cleaning.stations;
   massert(idx < cleanings.size(), "sanity");
   return cleanings[idx];
 }
 
-void ConfigImpl::load_speed_profiles() {
-  // Fault speed profile
-  fault_speed_profile_ =
-      find<config::SpeedProfile>("mechanisms", "fault", "manual");
-  // DEBUG_ONLY(std::cout << "Fault Speed Profile " << fault_speed_profile_
-  // << std::endl);
-
-  // Homing speed profile
-  homing_speed_profile_ = find<config::SpeedProfile>("mechanisms", "homing");
-  // DEBUG_ONLY(std::cout << "Homing Speed Profile " << homing_speed_profile_
-  // << std::endl);
-
-  // Spraying speed profile
-  spraying_speed_profile_ =
-      find<config::SpeedProfile>("mechanisms", "spraying");
-  // DEBUG_ONLY(std::cout << "Spraying Speed Profile " <<
-  // spraying_speed_profile_
-  // << std::endl);
-
-  // Tending speed profile
-  tending_speed_profile_ = find<config::SpeedProfile>("mechanisms", "tending");
-  // DEBUG_ONLY(std::cout << "Tending Speed Profile " << tending_speed_profile_
-  // << std::endl);
-
-  // Cleaning speed profile
-  cleaning_speed_profile_ =
-      find<config::SpeedProfile>("mechanisms", "cleaning");
-  // DEBUG_ONLY(std::cout << "Cleaning Speed Profile " <<
-  // cleaning_speed_profile_
-  // << std::endl);
-}
-
-const config::MechanismSpeed& ConfigImpl::fault_speed_profile(
+config::MechanismSpeed ConfigImpl::fault_speed_profile(
     const config::speed& speed_profile) const {
-  if (speed_profile == config::speed::slow) {
-    return fault_speed_profile_.slow;
-  } else if (speed_profile == config::speed::normal) {
-    return fault_speed_profile_.normal;
-  } else {
-    return fault_speed_profile_.fast;
-  }
+  return snapshot()->mechanisms.fault.speed.get(speed_profile);
 }
 
-const config::MechanismSpeed& ConfigImpl::homing_speed_profile(
+config::MechanismSpeed ConfigImpl::homing_speed_profile(
     const config::speed& speed_profile) const {
-  if (speed_profile == config::speed::slow) {
-    return homing_speed_profile_.slow;
-  } else if (speed_profile == config::speed::normal) {
-    return homing_speed_profile_.normal;
-  } else {
-    return homing_speed_profile_.fast;
-  }
+  return snapshot()->mechanisms.homing.speed.get(speed_profile);
 }
 
-const config::SpeedProfile& ConfigImpl::homing_speed_profile() const {
-  return homing_speed_profile_;
+config::SpeedProfile ConfigImpl::homing_speed_profile() const {
+  return snapshot()->mechanisms.homing.speed;
 }
 
-const config::MechanismSpeed& ConfigImpl::spraying_speed_profile(
+config::MechanismSpeed ConfigImpl::spraying_speed_profile(
     const config::speed& speed_profile) const {
-  if (speed_profile == config::speed::slow) {
-    return spraying_speed_profile_.slow;
-  } else if (speed_profile == config::speed::normal) {
-    return spraying_speed_profile_.normal;
-  } else {
-    return spraying_speed_profile_.fast;
-  }
+  return snapshot()->mechanisms.spraying.speed.get(speed_profile);
 }
 
-const config::MechanismSpeed& ConfigImpl::tending_speed_profile(
+config::MechanismSpeed ConfigImpl::tending_speed_profile(
     const config::speed& speed_profile) const {
-  if (speed_profile == config::speed::slow) {
-    return tending_speed_profile_.slow;
-  } else if (speed_profile == config::speed::normal) {
-    return tending_speed_profile_.normal;
-  } else {
-    return tending_speed_profile_.fast;
-  }
+  return snapshot()->mechanisms.tending.speed.get(speed_profile);
 }
 
-const config::MechanismSpeed& ConfigImpl::cleaning_speed_profile(
-    const config::speed& speed) const {
-  if (speed == config::speed::slow) {
-    return cleaning_speed_profile_.slow;
-  } else if (speed == config::speed::normal) {
-    return cleaning_speed_profile_.normal;
-  } else {
-    return cleaning_speed_profile_.fast;
-  }
+config::MechanismSpeed ConfigImpl::cleaning_speed_profile(
+    const config::speed& speed_profile) const {
+  return snapshot()->mechanisms.cleaning.speed.get(speed_profile);
 }
 }  // namespace impl
 
@@ -7,8 +7,10 @@
  * Project's configuration
  */
 
+#include <atomic>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <tuple>
 #include <utility>
@@ -29,16 +31,60 @@ namespace config {
 struct Speed;
 struct MechanismSpeed;
 struct SpeedProfile;
+struct Settings;
 }  // namespace config
 
 namespace impl {
 class ConfigImpl;
 }  // namespace impl
 
+// settings that select an implementation are kept as the enums of the
+// libraries that implement them
+namespace device {
+namespace stepper {
+/** Speed mode */
+enum class speed {
+  constant, /**< constant speed */
+  linear,   /**< linear speed using equation */
+  scurve,   /**< jerk-limited speed (S-curve) */
+};
+
+/** Pulse generation backend */
+enum class backend {
+  bitbang, /**< bit-bang each pulse with GPIO write */
+  wave,    /**< stream pulses through DMA, see device::Wave */
+};
+}  // namespace stepper
+
+namespace shift_register {
+/**
+ * How the frame is pushed into the cascade
+ */
+enum class backend {
+  gpio, /**< bit-bang data and clock pins */
+  spi,  /**< single spiWrite transaction, data on MOSI and clock on SCLK */
+};
+}  // namespace shift_register
+}  // namespace device
+
+namespace mechanism {
+namespace movement {
+/**
+ * Movement mode
+ *
+ * independent  : every stepper runs its own speed profile and timer
+ * interpolated : single master step clock, see mechanism::Interpolator
+ */
+enum class mode { independent, interpolated };
+}  // namespace movement
+}  // namespace mechanism
+
 /** impl::ConfigImpl singleton class using StaticObj */
 using Config = StaticObj<impl::ConfigImpl>;
 
 namespace config {
+enum class speed { slow, normal, fast };
+
 /**
  * @brief Speed implementation.
  *
@@ -54,6 +100,7 @@ struct Speed {
   double rpm;
   double acceleration;
   double deceleration;
+  double jerk;
 };
 
 /**
@@ -89,9 +136,420 @@ struct SpeedProfile {
   MechanismSpeed slow;
   MechanismSpeed normal;
   MechanismSpeed fast;
+
+  /**
+   * Get mechanism speed of the speed profile
+   *
+   * @param speed_profile type of speed
+   *
+   * @return mechanism speed
+   */
+  const MechanismSpeed& get(const speed& speed_profile) const;
 };
 
-enum class speed { slow, normal, fast };
+/** Coordinate (x, y) in mm */
+typedef std::pair<double, double> coordinate;
+/** Movement path */
+typedef std::vector<coordinate> path_container;
+/** Cleaning station (x, y, wait in seconds, sonicator state) */
+typedef std::tuple<double, double, unsigned int, bool> cleaning;
+/** Cleaning stations */
+typedef std::vector<cleaning> cleaning_container;
+
+/**
+ * @brief Digital device configuration.
+ *
+ * Device that is wired to a single GPIO pin
+ */
+struct Digital {
+  /** registry id */
+  std::string key;
+  /** GPIO pin */
+  int pin = 0;
+  /** level of the pin when the device is active */
+  bool active_state = true;
+};
+
+/**
+ * @brief Brake device configuration.
+ */
+struct Brake : public Digital {
+  /** how long the brake is held in ms */
+  unsigned long duration = 0;
+};
+
+/**
+ * @brief Stepper device configuration of an axis.
+ */
+struct Stepper {
+  /** registry id */
+  std::string key;
+  /** step GPIO pin */
+  int step_pin = 0;
+  /** level of step pin on pulse */
+  bool step_active_state = true;
+  /** dir GPIO pin */
+  int dir_pin = 0;
+  /** level of dir pin on forward direction */
+  bool dir_active_state = true;
+  /** enable GPIO pin */
+  int enable_pin = 0;
+  /** level of enable pin when the driver is enabled */
+  bool enable_active_state = true;
+  /** conversion of mm to steps */
+  long steps_per_mm = 0;
+  /** microsteps of the driver */
+  long microsteps = 1;
+};
+
+/**
+ * @brief Stepper devices configuration.
+ */
+struct Steppers {
+  /** driver type */
+  std::string type;
+  /** speed profile, "linear" or "scurve" */
+  device::stepper::speed speed = device::stepper::speed::linear;
+  /** pulse backend, "bitbang" or "wave" */
+  device::stepper::backend backend = device::stepper::backend::bitbang;
+  /** duration of wave chunk in micros */
+  time_unit wave_chunk_duration = 0;
+  /** x-axis */
+  Stepper x;
+  /** y-axis */
+  Stepper y;
+  /** z-axis */
+  Stepper z;
+};
+
+/**
+ * @brief Finger devices configuration.
+ */
+struct Finger {
+  /** PWM motor */
+  Digital motor;
+  /** motor brake */
+  Brake brake;
+  /** infrared sensor */
+  Digital infrared;
+};
+
+/**
+ * @brief Limit switches configuration.
+ */
+struct LimitSwitches {
+  /** x-axis */
+  Digital x;
+  /** y-axis */
+  Digital y;
+  /** z-axis upper bound */
+  Digital z1;
+  /** z-axis lower bound */
+  Digital z2;
+  /** finger protection */
+  Digital finger_protection;
+};
+
+/**
+ * @brief PLC to RaspberryPI inputs configuration.
+ */
+struct PLCToPI {
+  /** spraying / tending height is reached */
+  Digital spraying_tending_height;
+  /** cleaning height is reached */
+  Digital cleaning_height;
+  /** reset button */
+  Digital reset;
+  /** emergency stop */
+  Digital e_stop;
+};
+
+/**
+ * @brief Shift register output configuration.
+ */
+struct ShiftRegisterOutput {
+  /** shift register id */
+  std::string key;
+  /** bit of the output */
+  byte address = 0;
+  /** level of the output when it is active */
+  bool active_state = true;
+};
+
+/**
+ * @brief Shift register configuration.
+ */
+struct ShiftRegister {
+  /** outputs of the cascaded shift registers */
+  static constexpr unsigned int outputs = 16;
+
+  /** frame backend, "gpio" or "spi" */
+  device::shift_register::backend backend =
+      device::shift_register::backend::gpio;
+  /** latch GPIO pin */
+  int latch_pin = 0;
+  /** clock GPIO pin */
+  int clock_pin = 0;
+  /** data GPIO pin */
+  int data_pin = 0;
+  /** SPI channel */
+  unsigned int spi_channel = 0;
+  /** SPI baud rate */
+  unsigned int spi_baud = 0;
+  /** flush period in millis */
+  time_unit flush_period = 0;
+  /** water in valve */
+  ShiftRegisterOutput water_in;
+  /** water out valve */
+  ShiftRegisterOutput water_out;
+  /** disinfectant in valve */
+  ShiftRegisterOutput disinfectant_in;
+  /** disinfectant out valve */
+  ShiftRegisterOutput disinfectant_out;
+  /** sonicator relay */
+  ShiftRegisterOutput sonicator_relay;
+  /** tending ready signal to PLC */
+  ShiftRegisterOutput tending_ready;
+  /** spraying ready signal to PLC */
+  ShiftRegisterOutput spraying_ready;
+  /** tending running signal to PLC */
+  ShiftRegisterOutput tending_running;
+  /** spraying running signal to PLC */
+  ShiftRegisterOutput spraying_running;
+  /** tending complete signal to PLC */
+  ShiftRegisterOutput tending_complete;
+  /** spraying complete signal to PLC */
+  ShiftRegisterOutput spraying_complete;
+  /** spray valve */
+  ShiftRegisterOutput spray;
+};
+
+/**
+ * @brief Ultrasonic device configuration.
+ */
+struct Ultrasonic {
+  /** registry id */
+  std::string key;
+  /** echo GPIO pin */
+  int echo_pin = 0;
+  /** level of echo pin when it is active */
+  bool echo_active_state = true;
+  /** trigger GPIO pin */
+  int trigger_pin = 0;
+  /** level of trigger pin when it is active */
+  bool trigger_active_state = true;
+  /** max range in cm */
+  double max_range = 0.0;
+};
+
+/**
+ * @brief Ultrasonic devices configuration.
+ *
+ * Optional, empty if "devices.ultrasonic" does not exist
+ */
+struct Ultrasonics {
+  /** water level */
+  Ultrasonic water_level;
+  /** disinfectant level */
+  Ultrasonic disinfectant_level;
+};
+
+/**
+ * @brief Float sensors configuration.
+ */
+struct FloatSensors {
+  /** water level */
+  Digital water_level;
+  /** disinfectant level */
+  Digital disinfectant_level;
+};
+
+/**
+ * @brief Devices configuration.
+ */
+struct Devices {
+  /** stepper devices */
+  Steppers stepper;
+  /** finger devices */
+  Finger finger;
+  /** limit switches */
+  LimitSwitches limit_switch;
+  /** PLC to RaspberryPI inputs */
+  PLCToPI plc_to_pi;
+  /** shift register */
+  ShiftRegister shift_register;
+  /** ultrasonic devices */
+  Ultrasonics ultrasonic;
+  /** float sensors */
+  FloatSensors float_sensor;
+  /** sonicator relay */
+  Digital sonicator_relay;
+};
+
+/**
+ * @brief Motion executor configuration.
+ */
+struct Executor {
+  /** realtime priority, 0 keeps the default scheduler */
+  int priority = 0;
+  /** CPU to pin the executor to, -1 does not pin */
+  int cpu = -1;
+  /** lock memory of the process */
+  bool lock_memory = false;
+};
+
+/**
+ * @brief Movement mechanism configuration.
+ */
+struct Movement {
+  /** "independent" or "interpolated" */
+  mechanism::movement::mode mode = mechanism::movement::mode::independent;
+  /** blend consecutive segments of the path */
+  bool look_ahead = false;
+  /** max deviation from sharp corner in mm */
+  double junction_deviation = 0.0;
+  /** motion executor */
+  Executor executor;
+};
+
+/**
+ * @brief Homing mechanism configuration.
+ */
+struct Homing {
+  /** back off distance from limit switch in mm */
+  double backoff = 0.0;
+  /** ratio of the second approach speed */
+  double approach_ratio = 1.0;
+  /** speed profile */
+  SpeedProfile speed;
+};
+
+/**
+ * @brief Manual movement distance of each axis in mm.
+ */
+struct ManualMovement {
+  /** x-axis */
+  double x = 0.0;
+  /** y-axis */
+  double y = 0.0;
+  /** z-axis */
+  double z = 0.0;
+};
+
+/**
+ * @brief Fault mechanism configuration.
+ */
+struct Fault {
+  /** task timeout in seconds */
+  unsigned int timeout = 60;
+  /** manual movement distance */
+  ManualMovement manual;
+  /** manual movement speed profile */
+  SpeedProfile speed;
+};
+
+/**
+ * @brief Spraying mechanism configuration.
+ */
+struct Spraying {
+  /** spraying position */
+  coordinate position;
+  /** spraying path */
+  path_container path;
+  /** speed profile */
+  SpeedProfile speed;
+};
+
+/**
+ * @brief Tending mechanism configuration.
+ */
+struct Tending {
+  /** tending position */
+  coordinate position;
+  /** edge pattern path */
+  path_container path_edge;
+  /** zigzag pattern path */
+  path_container path_zigzag;
+  /** speed profile */
+  SpeedProfile speed;
+};
+
+/**
+ * @brief Cleaning mechanism configuration.
+ */
+struct Cleaning {
+  /** cleaning stations */
+  cleaning_container stations;
+  /** speed profile */
+  SpeedProfile speed;
+};
+
+/**
+ * @brief Liquid refilling mechanism configuration.
+ */
+struct LiquidRefilling {
+  /** water draining time in seconds */
+  unsigned int water_draining_time = 0;
+  /** disinfectant draining time in seconds */
+  unsigned int disinfectant_draining_time = 0;
+};
+
+/**
+ * @brief Mechanisms configuration.
+ */
+struct Mechanisms {
+  /** movement */
+  Movement movement;
+  /** homing */
+  Homing homing;
+  /** fault */
+  Fault fault;
+  /** spraying */
+  Spraying spraying;
+  /** tending */
+  Tending tending;
+  /** cleaning */
+  Cleaning cleaning;
+  /** liquid refilling */
+  LiquidRefilling liquid_refilling;
+};
+
+/**
+ * @brief General configuration.
+ */
+struct General {
+  /** application name */
+  std::string name = "Emmerich Automated Tending";
+  /** log debugging messages */
+  bool debug = false;
+};
+
+/**
+ * @brief Compiled configuration.
+ *
+ * Parsed from the TOML config and validated, every value is a plain field
+ * afterwards. Never modified once it is published, a reload publishes a new
+ * one instead
+ */
+struct Settings {
+  /** revision, bumped on every reload */
+  unsigned int revision = 0;
+  /** general */
+  General general;
+  /** devices */
+  Devices devices;
+  /** mechanisms */
+  Mechanisms mechanisms;
+};
+
+/**
+ * Validate compiled configuration
+ *
+ * @param settings compiled configuration
+ *
+ * @return every error that is found, empty if settings are valid
+ */
+std::vector<std::string> validate(const Settings& settings);
 }  // namespace config
 
 template <class T>
@@ -108,6 +566,18 @@ namespace impl {
  *
  * Machine's configuration that contains all the information the machine needed
  *
+ * TOML config is compiled into config::Settings and validated on load, so
+ * every accessor is a plain field read.
+ *
+ * Mechanisms section (speed profiles, paths, stations) can be reloaded while
+ * the machine is running. Every reload publishes a new immutable snapshot with
+ * an atomic pointer swap (read-copy-update), readers never block and a job
+ * that holds snapshot() keeps reading its revision until it finishes. General
+ * and devices sections are read once on boot, devices are not re-initialized
+ *
+ * Mechanisms accessors copy their value out of the current snapshot, so paths,
+ * stations and whole sections are only read through snapshot()
+ *
  * @author Ray Andrew
  * @date   April 2020
  */
@@ -117,18 +587,64 @@ class ConfigImpl : public StackObj {
   friend ATM_STATUS StaticObj<ConfigImpl>::create(Args&&... args);
 
  public:
-  typedef std::pair<double, double>                      coordinate;
-  typedef std::vector<coordinate>                        path_container;
-  typedef std::tuple<double, double, unsigned int, bool> cleaning;
-  typedef std::vector<cleaning>                          cleaning_container;
+  typedef config::coordinate         coordinate;
+  typedef config::path_container     path_container;
+  typedef config::cleaning           cleaning;
+  typedef config::cleaning_container cleaning_container;
+  /**
+   * Check whether config has been loaded and validated or not
+   *
+   * Checked by StaticObj::create, so Config::create returns ATM_ERR on
+   * invalid config
+   *
+   * @return true if there is no error
+   */
+  inline bool valid() const { return errors_.empty(); }
+  /**
+   * Get errors found while loading config
+   *
+   * @return load and validation errors
+   */
+  inline const std::vector<std::string>& errors() const { return errors_; }
+  /**
+   * Get active configuration
+   *
+   * Hold the snapshot to read several values of the same revision, it stays
+   * alive while it is held even if a newer one is published
+   *
+   * @return active configuration snapshot
+   */
+  inline std::shared_ptr<const config::Settings> snapshot() const {
+    return snapshot_.load(std::memory_order_acquire);
+  }
+  /**
+   * Get revision of active configuration
+   *
+   * @return revision, 0 is the configuration loaded on boot
+   */
+  inline unsigned int revision() const { return snapshot()->revision; }
+  /**
+   * Get config file path
+   *
+   * @return config file path
+   */
+  inline const std::string& path() const { return config_path_; }
+  /**
+   * Re-parse and validate config file, then publish its mechanisms section
+   *
+   * Active configuration is kept if the file cannot be loaded
+   *
+   * @return ATM_OK if new revision is published, otherwise ATM_ERR
+   */
+  ATM_STATUS reload();
   /**
    * Get name of app from config
    *
-   * It should be in key "general.app"
+   * It should be in key "general.name"
    *
    * @return application name
    */
-  std::string name() const;
+  inline const std::string& name() const { return settings_.general.name; }
   /**
    * Get debug status of logging message
    *
@@ -136,15 +652,17 @@ class ConfigImpl : public StackObj {
    *
    * @return debug status
    */
-  bool debug() const;
+  inline bool debug() const { return settings_.general.debug; }
   /**
    * Get task timeout
    *
-   * It should be in key "mechanism.fault.timeout"
-
+   * It should be in key "mechanisms.fault.timeout"
+   *
    * @return task timeout
    */
-  unsigned int timeout() const;
+  inline unsigned int timeout() const {
+    return snapshot()->mechanisms.fault.timeout;
+  }
   /**
    * Get speed Profile of Fault mechanism
    *
@@ -152,14 +670,14 @@ class ConfigImpl : public StackObj {
    *
    * @return fault speed profile
    */
-  const config::MechanismSpeed& fault_speed_profile(
+  config::MechanismSpeed fault_speed_profile(
       const config::speed& speed_profile) const;
   /**
    * Get speed Profile of Homing mechanism
    *
    * @return homing speed profile
    */
-  const config::SpeedProfile& homing_speed_profile() const;
+  config::SpeedProfile homing_speed_profile() const;
   /**
    * Get speed Profile of Homing mechanism
    *
@@ -167,7 +685,7 @@ class ConfigImpl : public StackObj {
    *
    * @return homing speed profile
    */
-  const config::MechanismSpeed& homing_speed_profile(
+  config::MechanismSpeed homing_speed_profile(
       const config::speed& speed_profile) const;
   /**
    * Get speed Profile of Spraying mechanism
@@ -176,7 +694,7 @@ class ConfigImpl : public StackObj {
    *
    * @return spraying speed profile
    */
-  const config::MechanismSpeed& spraying_speed_profile(
+  config::MechanismSpeed spraying_speed_profile(
       const config::speed& speed_profile) const;
   /**
    * Get speed Profile of Tending mechanism
@@ -185,7 +703,7 @@ class ConfigImpl : public StackObj {
    *
    * @return spraying speed profile
    */
-  const config::MechanismSpeed& tending_speed_profile(
+  config::MechanismSpeed tending_speed_profile(
       const config::speed& speed_profile) const;
   /**
    * Get speed Profile of Cleaning mechanism
@@ -194,454 +712,291 @@ class ConfigImpl : public StackObj {
    *
    * @return cleaning speed profile
    */
-  const config::MechanismSpeed& cleaning_speed_profile(
+  config::MechanismSpeed cleaning_speed_profile(
       const config::speed& speed_profile) const;
+  /**
+   * Get stepper device info that is shared between axes
+   *
+   * It should be in key "devices.stepper"
+   *
+   * @return stepper info
+   */
+  inline const config::Steppers& stepper() const {
+    return settings_.devices.stepper;
+  }
   /**
    * Get stepper x-axis device info
    *
    * It should be in key "devices.stepper.x"
    *
-   * @tparam T     type of config value
-   * @tparam Keys  variadic args for keys (should be string)
-   *
-   * @return stepper x-axis info with type T
+   * @return stepper x-axis info
    */
-  template <typename T, typename... Keys>
-  inline T stepper_x(Keys&&... keys) const {
-    return find<T>("devices", "stepper", "x", std::forward<Keys>(keys)...);
+  inline const config::Stepper& stepper_x() const {
+    return settings_.devices.stepper.x;
   }
   /**
    * Get stepper y-axis device info
    *
    * It should be in key "devices.stepper.y"
    *
-   * @tparam T     type of config value
-   * @tparam Keys  variadic args for keys (should be string)
-   *
-   * @return stepper y-axis info with type T
+   * @return stepper y-axis info
    */
-  template <typename T, typename... Keys>
-  inline T stepper_y(Keys&&... keys) const {
-    return find<T>("devices", "stepper", "y", std::forward<Keys>(keys)...);
+  inline const config::Stepper& stepper_y() const {
+    return settings_.devices.stepper.y;
   }
   /**
    * Get stepper z-axis device info
    *
    * It should be in key "devices.stepper.z"
    *
-   * @tparam T     type of config value
-   * @tparam Keys  variadic args for keys (should be string)
-   *
-   * @return stepper z-axis info with type T
+   * @return stepper z-axis info
    */
-  template <typename T, typename... Keys>
-  inline T stepper_z(Keys&&... keys) const {
-    return find<T>("devices", "stepper", "z", std::forward<Keys>(keys)...);
+  inline const config::Stepper& stepper_z() const {
+    return settings_.devices.stepper.z;
   }
   /**
    * Get limit switch x-axis device info
    *
    * It should be in key "devices.limit-switch.x"
    *
-   * @tparam T     type of config value
-   * @tparam Keys  variadic args for keys (should be string)
-   *
-   * @return limit switch x-axis info with type T
+   * @return limit switch x-axis info
    */
-  template <typename T, typename... Keys>
-  inline T limit_switch_x(Keys&&... keys) const {
-    return find<T>("devices", "limit-switch", "x", std::forward<Keys>(keys)...);
+  inline const config::Digital& limit_switch_x() const {
+    return settings_.devices.limit_switch.x;
   }
   /**
    * Get limit switch y-axis device info
    *
    * It should be in key "devices.limit-switch.y"
    *
-   * @tparam T     type of config value
-   * @tparam Keys  variadic args for keys (should be string)
-   *
-   * @return limit switch y-axis info with type T
+   * @return limit switch y-axis info
    */
-  template <typename T, typename... Keys>
-  inline T limit_switch_y(Keys&&... keys) const {
-    return find<T>("devices", "limit-switch", "y", std::forward<Keys>(keys)...);
+  inline const config::Digital& limit_switch_y() const {
+    return settings_.devices.limit_switch.y;
   }
   /**
    * Get limit switch upper bound z-axis device info
    *
    * It should be in key "devices.limit-switch.z1"
    *
-   * @tparam T     type of config value
-   * @tparam Keys  variadic args for keys (should be string)
-   *
-   * @return limit switch upper bound z-axis info with type T
+   * @return limit switch upper bound z-axis info
    */
-  template <typename T, typename... Keys>
-  inline T limit_switch_z1(Keys&&... keys) const {
-    return find<T>("devices", "limit-switch", "z1",
-                   std::forward<Keys>(keys)...);
+  inline const config::Digital& limit_switch_z1() const {
+    return settings_.devices.limit_switch.z1;
   }
   /**
    * Get limit switch lower bound z-axis device info
    *
    * It should be in key "devices.limit-switch.z2"
    *
-   * @tparam T     type of config value
-   * @tparam Keys  variadic args for keys (should be string)
-   *
-   * @return limit switch lower bound z-axis info with type T
+   * @return limit switch lower bound z-axis info
    */
-  template <typename T, typename... Keys>
-  inline T limit_switch_z2(Keys&&... keys) const {
-    return find<T>("devices", "limit-switch", "z2",
-                   std::forward<Keys>(keys)...);
+  inline const config::Digital& limit_switch_z2() const {
+    return settings_.devices.limit_switch.z2;
   }
   /**
    * Get limit switch finger protection device info
    *
    * It should be in key "devices.limit-switch.finger-protection"
    *
-   * @tparam T     type of config value
-   * @tparam Keys  variadic args for keys (should be string)
-   *
-   * @return limit switch finger protection info with type T
+   * @return limit switch finger protection info
    */
-  template <typename T, typename... Keys>
-  inline T limit_switch_finger_protection(Keys&&... keys) const {
-    return find<T>("devices", "limit-switch", "finger-protection",
-                   std::forward<Keys>(keys)...);
+  inline const config::Digital& limit_switch_finger_protection() const {
+    return settings_.devices.limit_switch.finger_protection;
   }
   /**
    * Get finger motor device info
    *
    * It should be in key "devices.finger.motor"
    *
-   * @tparam T     type of config value
-   * @tparam Keys  variadic args for keys (should be string)
-   *
-   * @return finger device info with type T
+   * @return finger device info
    */
-  template <typename T, typename... Keys>
-  inline T finger(Keys&&... keys) const {
-    return find<T>("devices", "finger", "motor", std::forward<Keys>(keys)...);
+  inline const config::Digital& finger() const {
+    return settings_.devices.finger.motor;
   }
   /**
    * Get finger brake device info
    *
    * It should be in key "devices.finger.brake"
    *
-   * @tparam T     type of config value
-   * @tparam Keys  variadic args for keys (should be string)
-   *
-   * @return finger device info with type T
+   * @return finger brake device info
    */
-  template <typename T, typename... Keys>
-  inline T finger_brake(Keys&&... keys) const {
-    return find<T>("devices", "finger", "brake", std::forward<Keys>(keys)...);
+  inline const config::Brake& finger_brake() const {
+    return settings_.devices.finger.brake;
   }
   /**
    * Get finger infrared device info
    *
    * It should be in key "devices.finger.infrared"
    *
-   * @tparam T     type of config value
-   * @tparam Keys  variadic args for keys (should be string)
-   *
-   * @return finger device info with type T
-   */
-  template <typename T, typename... Keys>
-  inline T finger_infrared(Keys&&... keys) const {
-    return find<T>("devices", "finger", "infrared",
-                   std::forward<Keys>(keys)...);
-    }
-    /**
-     * Get analog device info
-     *
-     * It should be in key "devices.analog"
-     *
-     * @tparam T     type of config value
-     * @tparam Keys  variadic args for keys (should be string)
-     *
-     * @return stepper x-axis info with type T
-     */
-    template <typename T, typename... Keys>
-    inline T analog(Keys && ... keys) const {
-      return find<T>("devices", "analog", std::forward<Keys>(keys)...);
-    }
-    /**
-     * Get spraying position
-     *
-     * It should be in key "mechanisms.spraying.position"
-     *
-     * @return spraying position
-     */
-    const coordinate& spraying_position();
-    /**
-     * Get spraying movement path
-     *
-     * It should be in key "mechanisms.spraying.path"
-     *
-     * @return spraying movement path
-     */
-    const path_container& spraying_path();
-    /**
-     * Get spraying movement path coordinate at specified index
-     *
-     * @param idx index to get
-     *
-     * @return spraying movement path at specified index
-     */
-    const coordinate spraying_path(size_t idx);
-    /**
-     * Get tending position
-     *
-     * It should be in key "mechanisms.tending.position"
-     *
-     * @return tending position
-     */
-    const coordinate& tending_position();
-    /**
-     * Get tending edge movement path
-     *
-     * It should be in key "mechanisms.tending.path.edge"
-     *
-     * @return tending edge movement path
-     */
-    const path_container& tending_path_edge();
-    /**
-     * Get tending edge movement path coordinate at specified index
-     *
-     * @param idx index to get
-     *
-     * @return tending edge movement path at specified index
-     */
-    const coordinate tending_path_edge(size_t idx);
-    /**
-     * Get tending zigzag movement path
-     *
-     * It should be in key "mechanisms.tending.path.zigzag"
-     *
-     * @return tending zigzag movement path
-     */
-    const path_container& tending_path_zigzag();
-    /**
-     * Get tending zigzag movement path coordinate at specified index
-     *
-     * @param idx index to get
-     *
-     * @return tending movement path at specified index
-     */
-    const coordinate tending_path_zigzag(size_t idx);
-    /**
-     * Get cleaning stations
-     *
-     * It should be in key "mechanisms.cleaning.stations"
-     *
-     * @return tending zigzag movement path
-     */
-    const cleaning_container& cleaning_stations();
-    /**
-     * Get cleaning station at specified index
-     *
-     * @param idx index to get
-     *
-     * @return cleaning station at specified index
-     */
-    const cleaning& cleaning_station(size_t idx);
-    /**
-     * Get mechanisms fault manual mode movement
-     *
-     * It should be in key "mechanisms.fault.manual.movement"
-     *
-     * @tparam T     type of config value
-     * @tparam Keys  variadic args for keys (should be string)
-     *
-     * @return manual mode config
-     */
-    template <typename T, typename... Keys>
-    inline T fault_manual_movement(Keys && ... keys) const {
-      return find<T>("mechanisms", "fault", "manual", "movement",
-                     std::forward<Keys>(keys)...);
-    }
-    /**
-     * Get shift register device configuration
-     *
-     * It should be in key "devices.shift-register"
-     *
-     * @tparam T     type of config value
-     * @tparam Keys  variadic args for keys (should be string)
-     *
-     * @return shift register device configuration
-     */
-    template <typename T, typename... Keys>
-    inline T shift_register(Keys && ... keys) const {
-      return find<T>("devices", "shift-register", std::forward<Keys>(keys)...);
-    }
-    /**
-     * Get communication device from PLC to RaspberryPI
-     *
-     * It should be in key "devices.plc-to-pi"
-     *
-     * @tparam T     type of config value
-     * @tparam Keys  variadic args for keys (should be string)
-     *
-     * @return communication device info from PLC to RaspberryPI with type T
-     */
-    template <typename T, typename... Keys>
-    inline T plc_to_pi(Keys && ... keys) const {
-      return find<T>("devices", "plc-to-pi", std::forward<Keys>(keys)...);
-    }
-    /**
-     * Get ultrasonic device
-     *
-     * It should be in key "devices.ultrasonic"
-     *
-     * @tparam T     type of config value
-     * @tparam Keys  variadic args for keys (should be string)
-     *
-     * @return ultrasonic device
-     */
-    template <typename T, typename... Keys>
-    inline T ultrasonic(Keys && ... keys) const {
-      return find<T>("devices", "ultrasonic", std::forward<Keys>(keys)...);
-    }
-    /**
-     * Get sonicator relay device
-     *
-     * It should be in key "devices.sonicator-relay"
-     *
-     * @tparam T     type of config value
-     * @tparam Keys  variadic args for keys (should be string)
-     *
-     * @return sonicator relay device
-     */
-    template <typename T, typename... Keys>
-    inline T sonicator_relay(Keys&& ... keys) const {
-      return find<T>("devices", "sonicator-relay", std::forward<Keys>(keys)...);
-    }
-    /**
-     * Get float sensor device
-     *
-     * It should be in key "devices.float-sensor"
-     *
-     * @tparam T     type of config value
-     * @tparam Keys  variadic args for keys (should be string)
-     *
-     * @return float sensor device
-     */
-    template <typename T, typename... Keys>
-    inline T float_sensor(Keys && ... keys) const {
-      return find<T>("devices", "float-sensor", std::forward<Keys>(keys)...);
-    }
-    /**
-     * Get liquid refilling config
-     *
-     * It should be in key "mechanisms.liquid-refilling"
-     *
-     * @tparam T     type of config value
-     * @tparam Keys  variadic args for keys (should be string)
-     *
-     * @return liquid refilling mechanisms
-     */
-    template <typename T, typename... Keys>
-    inline T liquid_refilling(Keys&&... keys) const {
-      return find<T>("mechanisms", "liquid-refilling",
-                     std::forward<Keys>(keys)...);
-    }
-
-   private:
-    /**
-     * ConfigImpl Constructor
-     *
-     * Initialize YAML-CPP and load yaml config file for this project
-     *
-     * @param config_path   config file path
-     */
-    explicit ConfigImpl(const std::string& config_path);
-    /**
-     * ConfigImpl Destructor
-     *
-     * Noop
-     *
-     */
-    ~ConfigImpl() = default;
-    /**
-     * Get TOML Config
-     *
-     * @return config tree
-     */
-    inline const toml::value& config() const { return config_; }
-    /**
-     * Find key in the TOML config
-     *
-     * @tparam T     type of config value
-     * @tparam Keys  variadic args for keys (should be string)
-     *
-     * @return config value with type T
-     */
-    template <typename T, typename... Keys>
-    inline T find(Keys && ... keys) const {
-      return toml::find<T>(config(), std::forward<Keys>(keys)...);
-    }
-    /**
-     * Load speed profile for all mechanisms
-     */
-    void load_speed_profiles();
-
-   private:
-    /**
-     * TOML config data
-     */
-    const toml::value config_;
-    /**
-     * Config file
-     */
-    const std::string config_path_;
-    /**
-     * Spraying movement path
-     */
-    path_container spraying_path_;
-    /**
-     * Spraying position
-     */
-    coordinate spraying_position_;
-    /**
-     * Tending movement path for edge pattern
-     */
-    path_container tending_path_edge_;
-    /**
-     * Tending movement path for zigzag pattern
-     */
-    path_container tending_path_zigzag_;
-    /**
-     * Tending position
-     */
-    coordinate tending_position_;
-    /**
-     * Cleaning container
-     */
-    cleaning_container cleaning_stations_;
-    /**
-     * Fault speed profile
-     */
-    config::SpeedProfile fault_speed_profile_;
-    /**
-     * Homing speed profile
-     */
-    config::SpeedProfile homing_speed_profile_;
-    /**
-     * Tending speed profile
-     */
-    config::SpeedProfile tending_speed_profile_;
-    /**
-     * Spraying speed profile
-     */
-    config::SpeedProfile spraying_speed_profile_;
-    /**
-     * Cleaning speed profile
-     */
-    config::SpeedProfile cleaning_speed_profile_;
-  };
+   * @return finger infrared device info
+   */
+  inline const config::Digital& finger_infrared() const {
+    return settings_.devices.finger.infrared;
+  }
+  /**
+   * Get spraying position
+   *
+   * It should be in key "mechanisms.spraying.position"
+   *
+   * @return spraying position
+   */
+  inline coordinate spraying_position() const {
+    return snapshot()->mechanisms.spraying.position;
+  }
+  /**
+   * Get spraying movement path coordinate at specified index
+   *
+   * @param idx index to get
+   *
+   * @return spraying movement path at specified index
+   */
+  coordinate spraying_path(size_t idx) const;
+  /**
+   * Get tending position
+   *
+   * It should be in key "mechanisms.tending.position"
+   *
+   * @return tending position
+   */
+  inline coordinate tending_position() const {
+    return snapshot()->mechanisms.tending.position;
+  }
+  /**
+   * Get tending edge movement path coordinate at specified index
+   *
+   * @param idx index to get
+   *
+   * @return tending edge movement path at specified index
+   */
+  coordinate tending_path_edge(size_t idx) const;
+  /**
+   * Get tending zigzag movement path coordinate at specified index
+   *
+   * @param idx index to get
+   *
+   * @return tending movement path at specified index
+   */
+  coordinate tending_path_zigzag(size_t idx) const;
+  /**
+   * Get cleaning station at specified index
+   *
+   * @param idx index to get
+   *
+   * @return cleaning station at specified index
+   */
+  cleaning cleaning_station(size_t idx) const;
+  /**
+   * Get mechanisms fault manual mode movement
+   *
+   * It should be in key "mechanisms.fault.manual.movement"
+   *
+   * @return manual mode config
+   */
+  inline config::ManualMovement fault_manual_movement() const {
+    return snapshot()->mechanisms.fault.manual;
+  }
+  /**
+   * Get shift register device configuration
+   *
+   * It should be in key "devices.shift-register"
+   *
+   * @return shift register device configuration
+   */
+  inline const config::ShiftRegister& shift_register() const {
+    return settings_.devices.shift_register;
+  }
+  /**
+   * Get communication device from PLC to RaspberryPI
+   *
+   * It should be in key "devices.plc-to-pi"
+   *
+   * @return communication device info from PLC to RaspberryPI
+   */
+  inline const config::PLCToPI& plc_to_pi() const {
+    return settings_.devices.plc_to_pi;
+  }
+  /**
+   * Get ultrasonic device
+   *
+   * It should be in key "devices.ultrasonic"
+   *
+   * @return ultrasonic device
+   */
+  inline const config::Ultrasonics& ultrasonic() const {
+    return settings_.devices.ultrasonic;
+  }
+  /**
+   * Get sonicator relay device
+   *
+   * It should be in key "devices.sonicator-relay"
+   *
+   * @return sonicator relay device
+   */
+  inline const config::Digital& sonicator_relay() const {
+    return settings_.devices.sonicator_relay;
+  }
+  /**
+   * Get float sensor device
+   *
+   * It should be in key "devices.float-sensor"
+   *
+   * @return float sensor device
+   */
+  inline const config::FloatSensors& float_sensor() const {
+    return settings_.devices.float_sensor;
+  }
+  /**
+   * Get liquid refilling config
+   *
+   * It should be in key "mechanisms.liquid-refilling"
+   *
+   * @return liquid refilling mechanisms
+   */
+  inline config::LiquidRefilling liquid_refilling() const {
+    return snapshot()->mechanisms.liquid_refilling;
+  }
+
+ private:
+  /**
+   * ConfigImpl Constructor
+   *
+   * Parse TOML config file, compile and validate it
+   *
+   * @param config_path   config file path
+   */
+  explicit ConfigImpl(const std::string& config_path);
+  /**
+   * ConfigImpl Destructor
+   *
+   * Noop
+   *
+   */
+  ~ConfigImpl() = default;
+
+ private:
+  /**
+   * Config file
+   */
+  const std::string config_path_;
+  /**
+   * Configuration loaded on boot, general and devices sections are read from
+   * it
+   */
+  config::Settings settings_;
+  /**
+   * Active configuration
+   */
+  std::atomic<std::shared_ptr<const config::Settings>> snapshot_;
+  /**
+   * Serialize reloads
+   */
+  std::mutex reload_mutex_;
+  /**
+   * Load and validation errors
+   */
+  std::vector<std::string> errors_;
+};
 }  // namespace impl
 
 NAMESPACE_END
@@ -34,6 +34,7 @@
 #include <spdlog/fmt/bundled/chrono.h>
 
 #include <spdlog/async.h>
+#include <spdlog/sinks/ringbuffer_sink.h>
 #include <spdlog/sinks/rotating_file_sink.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/spdlog.h>
@@ -57,7 +58,11 @@
 
 #include "config.hpp"
 #include "listener.hpp"
+#include "log_ring.hpp"
 #include "logger.hpp"
+#include "postmortem.hpp"
+#include "recorder.hpp"
+#include "reloader.hpp"
 #include "state.hpp"
 
 #endif
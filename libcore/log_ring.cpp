@@ -0,0 +1,56 @@
+#include "core.hpp"
+
+#include "log_ring.hpp"
+
+NAMESPACE_BEGIN
+
+LogRing::LogRing() : tail_{0}, head_{0} {
+  DEBUG_ONLY_DEFINITION(obj_name_ = "LogRing");
+
+  for (std::size_t idx = 0; idx < cells_.size(); ++idx) {
+    cells_[idx].sequence.store(idx, std::memory_order_relaxed);
+  }
+}
+
+bool LogRing::push(const logger::record& r) {
+  std::size_t pos = tail_.load(std::memory_order_relaxed);
+
+  for (;;) {
+    cell&       c = cells_[pos & mask_];
+    std::size_t sequence = c.sequence.load(std::memory_order_acquire);
+    auto diff = static_cast<std::ptrdiff_t>(sequence) -
+                static_cast<std::ptrdiff_t>(pos);
+
+    if (diff == 0) {
+      // slot is free, claim its index
+      if (tail_.compare_exchange_weak(pos, pos + 1,
+                                      std::memory_order_relaxed)) {
+        c.record = r;
+        c.sequence.store(pos + 1, std::memory_order_release);
+        return true;
+      }
+    } else if (diff < 0) {
+      // consumer has not popped the slot of the previous lap
+      return false;
+    } else {
+      pos = tail_.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+bool LogRing::pop(logger::record& r) {
+  cell& c = cells_[head_ & mask_];
+
+  if (c.sequence.load(std::memory_order_acquire) != head_ + 1) {
+    return false;
+  }
+
+  r = c.record;
+  // free the slot for the next lap
+  c.sequence.store(head_ + logger::ring_size, std::memory_order_release);
+  ++head_;
+
+  return true;
+}
+
+NAMESPACE_END
@@ -0,0 +1,205 @@
+#ifndef LIB_CORE_LOG_RING_HPP_
+#define LIB_CORE_LOG_RING_HPP_
+
+/** @file log_ring.hpp
+ *  @brief Deferred log ring class definition
+ *
+ * Log records whose arguments are copied as bytes, so they are formatted on
+ * the logger thread instead of the caller
+ */
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <spdlog/fmt/fmt.h>
+#include <spdlog/spdlog.h>
+
+#include <libutil/util.hpp>
+
+#include "common.hpp"
+
+#include "allocation.hpp"
+
+NAMESPACE_BEGIN
+
+namespace logger {
+/** Number of records in the ring, power of two */
+constexpr std::size_t ring_size = 4096;
+/** Bytes of arguments of a record */
+constexpr std::size_t payload_size = 64;
+/** Assumed cache line size to keep producers and consumer apart */
+constexpr std::size_t cache_line = 64;
+/** Flush sinks after this many deferred records */
+constexpr std::size_t flush_batch = 256;
+/** Flush sinks at least this often (ms) */
+constexpr time_unit flush_period = 1000;
+/** Period (ms) to drain the ring while it is empty */
+constexpr time_unit drain_period = 10;
+/** Number of latest formatted lines kept in memory */
+constexpr std::size_t recent_size = 512;
+
+/**
+ * @brief Deferred log record.
+ *
+ * Arguments are kept as bytes in the payload, formatter knows their types
+ */
+struct record {
+  /** log level */
+  spdlog::level::level_enum level;
+  /** time of the log call */
+  spdlog::log_clock::time_point time;
+  /** fmt::fmt format, string literal */
+  const char* format;
+  /** format the record, instantiated for the argument types */
+  std::string (*formatter)(const record&);
+  /** arguments */
+  alignas(std::max_align_t) unsigned char payload[payload_size];
+};
+
+/**
+ * Get offset of every argument in the payload
+ *
+ * @tparam Args argument types
+ *
+ * @return offsets
+ */
+template <typename... Args>
+constexpr std::array<std::size_t, sizeof...(Args)> offsets() {
+  std::array<std::size_t, sizeof...(Args)> retval{};
+  std::size_t                              offset = 0;
+  std::size_t                              idx = 0;
+  ((retval[idx++] = offset, offset += sizeof(Args)), ...);
+  return retval;
+}
+
+/**
+ * Format record
+ *
+ * @tparam Args argument types of the record
+ *
+ * @param r record
+ *
+ * @return formatted message
+ */
+template <typename... Args>
+std::string format(const record& r) {
+  constexpr auto      offset = offsets<Args...>();
+  std::tuple<Args...> args;
+
+  std::apply(
+      [&r, &offset](Args&... arg) {
+        std::size_t idx = 0;
+        ((std::memcpy(&arg, r.payload + offset[idx++], sizeof(Args))), ...);
+      },
+      args);
+
+  return std::apply(
+      [&r](const Args&... arg) {
+        return fmt::vformat(r.format, fmt::make_format_args(arg...));
+      },
+      args);
+}
+
+/**
+ * Fill record with arguments
+ *
+ * Only arithmetic arguments can be deferred, anything else may not be alive
+ * once the record is formatted
+ *
+ * @param r       record to fill
+ * @param level   log level
+ * @param format  fmt::fmt format, string literal
+ * @param args    arguments
+ */
+template <typename... Args>
+void encode(record&                   r,
+            spdlog::level::level_enum level,
+            const char*               format,
+            const Args&... args) {
+  static_assert((std::is_arithmetic_v<Args> && ...),
+                "only arithmetic arguments can be deferred");
+  static_assert((sizeof(Args) + ... + 0) <= payload_size,
+                "deferred arguments do not fit in a record");
+
+  constexpr auto offset = offsets<Args...>();
+  std::size_t    idx = 0;
+
+  r.level = level;
+  r.time = spdlog::log_clock::now();
+  r.format = format;
+  r.formatter = &logger::format<Args...>;
+  ((std::memcpy(r.payload + offset[idx++], &args, sizeof(Args))), ...);
+}
+}  // namespace logger
+
+/**
+ * @brief Deferred log ring implementation.
+ *
+ * Bounded lock-free ring of log records for many producers and a single
+ * consumer. Every slot has a sequence number that tells whether it is free
+ * for the producer that claimed its index or filled for the consumer, so
+ * neither push nor pop locks or allocates.
+ *
+ * Push never waits, the record is dropped if the ring is full
+ */
+class LogRing : public StackObj {
+ public:
+  /**
+   * LogRing Constructor
+   */
+  LogRing();
+  /**
+   * Push record (any thread)
+   *
+   * @param r record
+   *
+   * @return false if the ring is full
+   */
+  bool push(const logger::record& r);
+  /**
+   * Pop record (consumer only)
+   *
+   * @param r popped record
+   *
+   * @return false if the ring is empty
+   */
+  bool pop(logger::record& r);
+
+ private:
+  /**
+   * @brief Slot of the ring.
+   */
+  struct cell {
+    /** index of the slot when it is free, index + 1 when it is filled */
+    std::atomic<std::size_t> sequence;
+    /** record */
+    logger::record record;
+  };
+
+  /**
+   * Index mask
+   */
+  static constexpr std::size_t mask_ = logger::ring_size - 1;
+  /**
+   * Slots
+   */
+  std::array<cell, logger::ring_size> cells_;
+  /**
+   * Index of next record to push, claimed by producers
+   */
+  alignas(logger::cache_line) std::atomic<std::size_t> tail_;
+  /**
+   * Index of next record to pop, written by consumer
+   */
+  alignas(logger::cache_line) std::size_t head_;
+};
+
+NAMESPACE_END
+
+#endif  // LIB_CORE_LOG_RING_HPP_
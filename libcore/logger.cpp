@@ -6,28 +6,45 @@
 
 #include <spdlog/async.h>
 #include <spdlog/fmt/fmt.h>
+#include <spdlog/sinks/ringbuffer_sink.h>
 #include <spdlog/sinks/rotating_file_sink.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 
 NAMESPACE_BEGIN
 
 namespace impl {
-LoggerImpl::LoggerImpl() : logger_{spdlog::default_logger()} {
+LoggerImpl::LoggerImpl()
+    : logger_{spdlog::default_logger()},
+      recent_{std::make_shared<spdlog::sinks::ringbuffer_sink_mt>(
+          logger::recent_size)},
+      dropped_{0},
+      draining_{false} {
   DEBUG_ONLY_DEFINITION(obj_name_ = "LoggerImpl");
 }
 
 LoggerImpl::~LoggerImpl() {
+  // write what is left in the ring before the sinks are gone
+  draining_ = false;
+  if (drain_thread_.joinable()) {
+    drain_thread_.join();
+  }
+
   spdlog::drop_all();
   spdlog::shutdown();
 }
 
 void LoggerImpl::init(const impl::ConfigImpl*              config,
                       const std::vector<spdlog::sink_ptr>& additional_sinks) {
+  init(config->name(), config->debug(), additional_sinks);
+}
+
+void LoggerImpl::init(const std::string&                   name,
+                      bool                                 debug,
+                      const std::vector<spdlog::sink_ptr>& additional_sinks) {
   spdlog::init_thread_pool(8192, 1);
 
   auto stdout_sink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
-  stdout_sink->set_level(config->debug() ? spdlog::level::debug
-                                         : spdlog::level::info);
+  stdout_sink->set_level(debug ? spdlog::level::debug : spdlog::level::info);
 
   fs::create_directory(LOGS_DIR);
 
@@ -36,15 +53,17 @@ void LoggerImpl::init(const impl::ConfigImpl*              config,
       path, 1024 * 1024 * 15, 3);
   rotating_sink->set_level(spdlog::level::trace);
 
-  std::vector<spdlog::sink_ptr> sinks{stdout_sink, rotating_sink};
+  recent_->set_level(spdlog::level::trace);
+
+  std::vector<spdlog::sink_ptr> sinks{stdout_sink, rotating_sink, recent_};
 
   sinks.insert(sinks.end(), std::make_move_iterator(additional_sinks.begin()),
                std::make_move_iterator(additional_sinks.end()));
 
-  logger_ = spdlog::get(config->name());
+  logger_ = spdlog::get(name);
   if (!logger_) {
     logger_ = std::make_shared<spdlog::async_logger>(
-        config->name(), begin(sinks), end(sinks), spdlog::thread_pool(),
+        name, begin(sinks), end(sinks), spdlog::thread_pool(),
         spdlog::async_overflow_policy::block);
 
     spdlog::register_logger(logger_);
@@ -53,7 +72,51 @@ void LoggerImpl::init(const impl::ConfigImpl*              config,
   logger_->set_pattern("[%d/%m/%C %T][%n][%^%l%$] %v");
 
   logger_->set_level(spdlog::level::trace);
-  logger_->flush_on(spdlog::level::trace);
+  // flushing every record costs a write syscall each, the drain thread
+  // flushes by batch instead
+  logger_->flush_on(spdlog::level::err);
+
+  if (!draining_) {
+    draining_ = true;
+    drain_thread_ = std::thread(&LoggerImpl::drain, this);
+  }
+}
+
+void LoggerImpl::drain() {
+  logger::record r;
+  std::size_t    batch = 0;
+  time_unit      flushed = millis();
+
+  for (bool running = true; running;) {
+    // read the flag first, so records pushed before stopping are drained
+    running = draining_;
+
+    while (ring_.pop(r)) {
+      logger_->log(r.time, spdlog::source_loc{}, r.level, r.formatter(r));
+
+      if (++batch >= logger::flush_batch) {
+        logger_->flush();
+        batch = 0;
+        flushed = millis();
+      }
+    }
+
+    if (std::size_t dropped = dropped_.exchange(0); dropped > 0) {
+      logger_->warn("Deferred log ring is full, {} records are dropped",
+                    dropped);
+    }
+
+    // eager records are flushed here as well, only errors flush themselves
+    if (!running || millis() - flushed >= logger::flush_period) {
+      logger_->flush();
+      batch = 0;
+      flushed = millis();
+    }
+
+    if (running) {
+      sleep_for<time_units::millis>(logger::drain_period);
+    }
+  }
 }
 }  // namespace impl
 
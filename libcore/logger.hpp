@@ -7,12 +7,15 @@
  * Project's logger
  */
 
+#include <atomic>
 #include <memory>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
 #include <spdlog/fmt/fmt.h>
+#include <spdlog/sinks/ringbuffer_sink.h>
 #include <spdlog/spdlog.h>
 
 #include <libutil/util.hpp>
@@ -22,6 +25,22 @@
 #include "allocation.hpp"
 
 #include "config.hpp"
+#include "log_ring.hpp"
+
+#ifndef LOG_ACTIVE_LEVEL
+#ifdef PROJECT_DEBUG
+/**
+ * @def LOG_ACTIVE_LEVEL
+ *
+ * Lowest level that is compiled, calls of any lower level are removed
+ * together with their arguments. Debug stays compiled in release since it
+ * can be enabled from config
+ */
+#define LOG_ACTIVE_LEVEL SPDLOG_LEVEL_TRACE
+#else
+#define LOG_ACTIVE_LEVEL SPDLOG_LEVEL_DEBUG
+#endif
+#endif
 
 /**
  * @def LOGGER
@@ -31,18 +50,24 @@
 #define LOGGER ns(Logger::get())
 
 /**
- * @def LOG_DEBUG
+ * @def LOG_TRACE
  *
  * @see impl::LoggerImpl::trace
  *
  * @param args any fmt::fmt format
  */
+#if LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_TRACE
 #define LOG_TRACE(...)              \
   do {                              \
     if (LOGGER != nullptr) {        \
       (LOGGER)->trace(__VA_ARGS__); \
     }                               \
   } while (0)
+#else
+#define LOG_TRACE(...) \
+  do {                 \
+  } while (0)
+#endif
 
 /**
  * @def LOG_DEBUG
@@ -51,12 +76,18 @@
  *
  * @param args any fmt::fmt format
  */
+#if LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_DEBUG
 #define LOG_DEBUG(...)              \
   do {                              \
     if (LOGGER != nullptr) {        \
       (LOGGER)->debug(__VA_ARGS__); \
     }                               \
   } while (0)
+#else
+#define LOG_DEBUG(...) \
+  do {                 \
+  } while (0)
+#endif
 
 /**
  * @def LOG_INFO
@@ -65,12 +96,18 @@
  *
  * @param args any fmt::fmt format
  */
+#if LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_INFO
 #define LOG_INFO(...)              \
   do {                             \
     if (LOGGER != nullptr) {       \
       (LOGGER)->info(__VA_ARGS__); \
     }                              \
   } while (0)
+#else
+#define LOG_INFO(...) \
+  do {                \
+  } while (0)
+#endif
 
 /**
  * @def LOG_WARN
@@ -79,12 +116,18 @@
  *
  * @param args any fmt::fmt format
  */
+#if LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_WARN
 #define LOG_WARN(...)              \
   do {                             \
     if (LOGGER != nullptr) {       \
       (LOGGER)->warn(__VA_ARGS__); \
     }                              \
   } while (0)
+#else
+#define LOG_WARN(...) \
+  do {                \
+  } while (0)
+#endif
 
 /**
  * @def LOG_ERROR
@@ -93,12 +136,18 @@
  *
  * @param args any fmt::fmt format
  */
+#if LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_ERROR
 #define LOG_ERROR(...)              \
   do {                              \
     if (LOGGER != nullptr) {        \
       (LOGGER)->error(__VA_ARGS__); \
     }                               \
   } while (0)
+#else
+#define LOG_ERROR(...) \
+  do {                 \
+  } while (0)
+#endif
 
 /**
  * @def LOG_CRITICAL
@@ -107,12 +156,114 @@
  *
  * @param args any fmt::fmt format
  */
+#if LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_CRITICAL
 #define LOG_CRITICAL(...)              \
   do {                                 \
     if (LOGGER != nullptr) {           \
       (LOGGER)->critical(__VA_ARGS__); \
     }                                  \
   } while (0)
+#else
+#define LOG_CRITICAL(...) \
+  do {                    \
+  } while (0)
+#endif
+
+/**
+ * @def LOG_DEFER_TRACE
+ *
+ * Log in trace level without formatting on the caller, for hot paths
+ *
+ * @see impl::LoggerImpl::defer
+ *
+ * @param format  fmt::fmt format, must be a string literal
+ * @param args    arithmetic arguments
+ */
+#if LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_TRACE
+#define LOG_DEFER_TRACE(format, ...)                                 \
+  do {                                                               \
+    if (LOGGER != nullptr) {                                         \
+      (LOGGER)->defer(spdlog::level::trace, "" format __VA_OPT__(, ) \
+                      __VA_ARGS__);                                  \
+    }                                                                \
+  } while (0)
+#else
+#define LOG_DEFER_TRACE(format, ...) \
+  do {                               \
+  } while (0)
+#endif
+
+/**
+ * @def LOG_DEFER_DEBUG
+ *
+ * Log in debug level without formatting on the caller, for hot paths
+ *
+ * @see impl::LoggerImpl::defer
+ *
+ * @param format  fmt::fmt format, must be a string literal
+ * @param args    arithmetic arguments
+ */
+#if LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_DEBUG
+#define LOG_DEFER_DEBUG(format, ...)                                 \
+  do {                                                               \
+    if (LOGGER != nullptr) {                                         \
+      (LOGGER)->defer(spdlog::level::debug, "" format __VA_OPT__(, ) \
+                      __VA_ARGS__);                                  \
+    }                                                                \
+  } while (0)
+#else
+#define LOG_DEFER_DEBUG(format, ...) \
+  do {                               \
+  } while (0)
+#endif
+
+/**
+ * @def LOG_DEFER_INFO
+ *
+ * Log in info level without formatting on the caller, for hot paths
+ *
+ * @see impl::LoggerImpl::defer
+ *
+ * @param format  fmt::fmt format, must be a string literal
+ * @param args    arithmetic arguments
+ */
+#if LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_INFO
+#define LOG_DEFER_INFO(format, ...)                                 \
+  do {                                                              \
+    if (LOGGER != nullptr) {                                        \
+      (LOGGER)->defer(spdlog::level::info, "" format __VA_OPT__(, ) \
+                      __VA_ARGS__);                                 \
+    }                                                               \
+  } while (0)
+#else
+#define LOG_DEFER_INFO(format, ...) \
+  do {                              \
+  } while (0)
+#endif
+
+/**
+ * @def LOG_DEFER_WARN
+ *
+ * Log in warn level without formatting on the caller, for hot paths
+ *
+ * @see impl::LoggerImpl::defer
+ *
+ * @param format  fmt::fmt format, must be a string literal
+ * @param args    arithmetic arguments
+ */
+#if LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_WARN
+#define LOG_DEFER_WARN(format, ...)                                 \
+  do {                                                              \
+    if (LOGGER != nullptr) {                                        \
+      (LOGGER)->defer(spdlog::level::warn, "" format __VA_OPT__(, ) \
+                      __VA_ARGS__);                                 \
+    }                                                               \
+  } while (0)
+#else
+#define LOG_DEFER_WARN(format, ...) \
+  do {                              \
+  } while (0)
+#endif
 
 NAMESPACE_BEGIN
 
@@ -148,6 +299,16 @@ class LoggerImpl : public StackObj {
    */
   void init(const impl::ConfigImpl*              config,
             const std::vector<spdlog::sink_ptr>& additional_sinks = {});
+  /**
+   * Initialize logger without config
+   *
+   * @param name             logger name
+   * @param debug            output debug level to console
+   * @param additional_sinks additional sinks to add
+   */
+  void init(const std::string&                   name,
+            bool                                 debug,
+            const std::vector<spdlog::sink_ptr>& additional_sinks = {});
   /**
    * Get shared_ptr of spdlog logger (const)
    *
@@ -174,6 +335,17 @@ class LoggerImpl : public StackObj {
   inline void set_level(const spdlog::level::level_enum& log_level) {
     logger()->set_level(log_level);
   }
+  /**
+   * Get the latest formatted lines of every level
+   *
+   * Lines are kept in memory by a sink of their own, they reach it once the
+   * async logger has written them
+   *
+   * @return lines, oldest first
+   */
+  inline std::vector<std::string> recent() const {
+    return recent_->last_formatted();
+  }
   /**
    * Output log message in trace level
    *
@@ -240,6 +412,36 @@ class LoggerImpl : public StackObj {
   inline void critical(fmt::basic_string_view<char> fmt, const Args&... args) {
     logger_->critical(fmt, args...);
   }
+  /**
+   * Output log message without formatting it on the caller
+   *
+   * Arguments are copied into a record of the deferred ring, the message is
+   * formatted and written by the drain thread. Record keeps the time of the
+   * call. If the ring is full, the record is dropped and counted instead of
+   * blocking the caller
+   *
+   * @param level   log level
+   * @param format  fmt::fmt format, must outlive the logger (string literal)
+   * @param args    arithmetic arguments
+   */
+  template <typename... Args>
+  inline void defer(spdlog::level::level_enum level,
+                    const char*               format,
+                    const Args&... args) {
+    if (!logger_->should_log(level)) {
+      return;
+    }
+
+    logger::record r;
+    logger::encode(r, level, format, args...);
+
+    if (!draining_.load(std::memory_order_relaxed)) {
+      // not initialized yet, nobody would drain the ring
+      logger_->log(r.level, r.formatter(r));
+    } else if (!ring_.push(r)) {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
 
  private:
   /**
@@ -254,12 +456,36 @@ class LoggerImpl : public StackObj {
    * Will destroy all the spdlog logger instances
    */
   ~LoggerImpl();
+  /**
+   * Format deferred records and flush sinks by batch
+   */
+  void drain();
 
  private:
   /**
    * Shared pointer of spdlog logger
    */
   std::shared_ptr<spdlog::logger> logger_;
+  /**
+   * Latest formatted lines
+   */
+  std::shared_ptr<spdlog::sinks::ringbuffer_sink_mt> recent_;
+  /**
+   * Deferred records
+   */
+  LogRing ring_;
+  /**
+   * Number of dropped deferred records
+   */
+  std::atomic<std::size_t> dropped_;
+  /**
+   * Drain thread is running
+   */
+  std::atomic<bool> draining_;
+  /**
+   * Drain thread
+   */
+  std::thread drain_thread_;
 };
 }  // namespace impl
 
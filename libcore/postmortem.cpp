@@ -0,0 +1,241 @@
+#include "core.hpp"
+
+#include "postmortem.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <sstream>
+#include <system_error>
+
+#include <zlib.h>
+
+#include "config.hpp"
+#include "logger.hpp"
+
+NAMESPACE_BEGIN
+
+namespace postmortem {
+/**
+ * Get wall clock time
+ *
+ * @return time (us since epoch)
+ */
+static uint64_t wall_micros() {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::system_clock::now().time_since_epoch())
+          .count());
+}
+
+/**
+ * Check whether file name belongs to a bundle
+ *
+ * @param name file name
+ *
+ * @return true if it is a bundle
+ */
+static bool is_bundle(const std::string& name) {
+  const std::string ext{extension};
+
+  return name.rfind(prefix, 0) == 0 && name.size() > ext.size() &&
+         name.compare(name.size() - ext.size(), ext.size(), ext) == 0;
+}
+
+ATM_STATUS list(const fs::path& directory, std::vector<bundle>& bundles) {
+  std::error_code ec;
+
+  bundles.clear();
+
+  for (const auto& item : fs::directory_iterator(directory, ec)) {
+    if (!item.is_regular_file(ec) ||
+        !is_bundle(item.path().filename().string())) {
+      continue;
+    }
+
+    bundles.push_back({item.path(), item.file_size(ec)});
+  }
+
+  if (ec) {
+    return ATM_ERR;
+  }
+
+  // names start with the time of the fault
+  std::sort(bundles.begin(), bundles.end(),
+            [](const bundle& lhs, const bundle& rhs) {
+              return lhs.path.filename() > rhs.path.filename();
+            });
+
+  return ATM_OK;
+}
+}  // namespace postmortem
+
+namespace impl {
+PostMortemImpl::PostMortemImpl(const fs::path& directory)
+    : directory_{directory}, running_{true}, written_{0}, pending_{0} {
+  DEBUG_ONLY_DEFINITION(obj_name_ = "PostMortemImpl");
+
+  // faults come one at a time, the fault path should not allocate
+  entries_.reserve(8);
+  thread_ = std::thread(&PostMortemImpl::run, this);
+}
+
+PostMortemImpl::~PostMortemImpl() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    running_ = false;
+  }
+  cv_.notify_one();
+
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+void PostMortemImpl::request(flight::fault reason) {
+  entry e{};
+  e.reason = reason;
+  e.time = postmortem::wall_micros();
+  e.state = flight::state::initial;
+
+  if (FlightRecorder::created()) {
+    auto* recorder = FlightRecorder::get();
+    e.sequence = recorder->head();
+    e.state = recorder->current_state();
+  }
+
+  if (State::created()) {
+    e.coordinate = State::get()->coordinate();
+  }
+
+  if (Config::created()) {
+    e.revision = Config::get()->revision();
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.push_back(e);
+  }
+  pending_.fetch_add(1, std::memory_order_release);
+  cv_.notify_one();
+}
+
+void PostMortemImpl::run() {
+  std::vector<entry> entries;
+  entries.reserve(8);
+
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this] { return !running_ || !entries_.empty(); });
+
+      if (!running_ && entries_.empty()) {
+        return;
+      }
+
+      entries.swap(entries_);
+    }
+
+    for (const auto& e : entries) {
+      if (dump(e) == ATM_OK) {
+        written_.fetch_add(1, std::memory_order_release);
+        prune();
+      }
+      pending_.fetch_sub(1, std::memory_order_release);
+    }
+
+    entries.clear();
+  }
+}
+
+ATM_STATUS PostMortemImpl::dump(const entry& e) {
+  // let the fault settle, so the bundle shows what happened right after it
+  const uint64_t ready = e.time + postmortem::settle * 1000;
+  if (const uint64_t now = postmortem::wall_micros(); now < ready) {
+    sleep_for<time_units::millis>((ready - now) / 1000);
+  }
+
+  std::vector<flight::record> records;
+  uint64_t                    head = 0;
+
+  if (FlightRecorder::created()) {
+    auto* recorder = FlightRecorder::get();
+    head = recorder->head();
+    recorder->read(e.time - postmortem::window * 1000000, head, records);
+  }
+
+  const std::vector<std::string> lines = Logger::get()->recent();
+
+  const auto seconds = static_cast<std::time_t>(e.time / 1000000);
+  const auto millis = (e.time / 1000) % 1000;
+  const auto local = fmt::localtime(seconds);
+  const auto path =
+      directory_ / fmt::format("{}{:%Y%m%d-%H%M%S}-{:03}-{}{}",
+                               postmortem::prefix, local, millis,
+                               flight::to_string(e.reason),
+                               postmortem::extension);
+
+  std::ostringstream os;
+
+  os << "[fault]\n";
+  os << fmt::format("reason = {}\n", flight::to_string(e.reason));
+  os << fmt::format("time = {:%Y-%m-%d %H:%M:%S}.{:03}\n", local, millis);
+  os << fmt::format("time_us = {}\n", e.time);
+  os << fmt::format("state = {}\n", flight::to_string(e.state));
+  os << fmt::format("x = {}\ny = {}\nz = {}\n", e.coordinate.x,
+                    e.coordinate.y, e.coordinate.z);
+  os << fmt::format("config_revision = {}\n", e.revision);
+  os << fmt::format("flight_sequence = {}\n", e.sequence);
+  os << fmt::format("flight_head = {}\n", head);
+  os << fmt::format("window_s = {}\n", postmortem::window);
+  os << "\n[telemetry]\n";
+  flight::write_csv(os, records);
+  os << "\n[log]\n";
+  for (const auto& line : lines) {
+    os << line;
+    if (line.empty() || line.back() != '\n') {
+      os << '\n';
+    }
+  }
+
+  const std::string content = os.str();
+
+  std::error_code ec;
+  fs::create_directories(directory_, ec);
+
+  gzFile file = gzopen(path.c_str(), "wb");
+  if (file == nullptr) {
+    LOG_ERROR("Failed to open post-mortem bundle {}", path.string());
+    return ATM_ERR;
+  }
+
+  const int size = static_cast<int>(content.size());
+  const int written =
+      gzwrite(file, content.data(), static_cast<unsigned>(content.size()));
+
+  if (gzclose(file) != Z_OK || written != size) {
+    LOG_ERROR("Failed to write post-mortem bundle {}", path.string());
+    return ATM_ERR;
+  }
+
+  LOG_INFO("Post-mortem bundle {} is written, {} records and {} log lines",
+           path.string(), records.size(), lines.size());
+
+  return ATM_OK;
+}
+
+void PostMortemImpl::prune() {
+  std::vector<postmortem::bundle> bundles;
+
+  if (postmortem::list(directory_, bundles) == ATM_ERR) {
+    return;
+  }
+
+  for (std::size_t idx = postmortem::keep; idx < bundles.size(); ++idx) {
+    std::error_code ec;
+    fs::remove(bundles[idx].path, ec);
+  }
+}
+}  // namespace impl
+
+NAMESPACE_END
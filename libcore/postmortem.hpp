@@ -0,0 +1,208 @@
+#ifndef LIB_CORE_POSTMORTEM_HPP_
+#define LIB_CORE_POSTMORTEM_HPP_
+
+/** @file postmortem.hpp
+ *  @brief Post-mortem singleton class definition
+ *
+ * Bundle of what the machine was doing when a fault is raised
+ */
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <libutil/util.hpp>
+
+#include "common.hpp"
+
+#include "allocation.hpp"
+
+#include "recorder.hpp"
+#include "state.hpp"
+
+NAMESPACE_BEGIN
+
+namespace impl {
+class PostMortemImpl;
+}
+
+/** impl::PostMortemImpl singleton class using StaticObj */
+using PostMortem = StaticObj<impl::PostMortemImpl>;
+
+namespace postmortem {
+/** Telemetry kept before the fault (s) */
+constexpr time_unit window = 30;
+/** Wait after the fault (ms), so its log lines and transition are bundled */
+constexpr time_unit settle = 500;
+/** Number of bundles kept in the directory, older ones are removed */
+constexpr std::size_t keep = 20;
+/** Prefix of bundle file names */
+constexpr const char* prefix = "postmortem-";
+/** Extension of bundle file names, gzip compressed text */
+constexpr const char* extension = ".txt.gz";
+
+/**
+ * @brief Post-mortem bundle file.
+ */
+struct bundle {
+  /** file path */
+  fs::path path;
+  /** file size (bytes) */
+  std::uintmax_t size;
+};
+
+/**
+ * List bundles in a directory
+ *
+ * @param directory directory of the bundles
+ * @param bundles   bundles, newest first
+ *
+ * @return ATM_OK or ATM_ERR if the directory cannot be read
+ */
+ATM_STATUS list(const fs::path& directory, std::vector<bundle>& bundles);
+}  // namespace postmortem
+
+namespace impl {
+/**
+ * @brief Post-mortem implementation.
+ *        This is a class wrapper that should not be instantiated and accessed
+ * publicly.
+ *
+ * Fault path only takes a few values that are gone afterwards and wakes up the
+ * writer thread. Writer collects the telemetry of the last postmortem::window
+ * seconds from the flight recorder, the latest log lines, the machine state,
+ * and the config revision, then writes them into a timestamped gzip file
+ */
+class PostMortemImpl : public StackObj {
+  template <class PostMortemImpl>
+  template <typename... Args>
+  friend ATM_STATUS StaticObj<PostMortemImpl>::create(Args&&... args);
+
+ public:
+  /**
+   * Request bundle of a fault (any thread)
+   *
+   * Never does I/O, bundle is written by the writer thread
+   *
+   * @param reason fault reason
+   */
+  void request(flight::fault reason);
+  /**
+   * Get directory of the bundles
+   *
+   * @return directory
+   */
+  inline const fs::path& directory() const { return directory_; }
+  /**
+   * Get number of bundles written since boot
+   *
+   * @return number of bundles
+   */
+  inline std::size_t written() const {
+    return written_.load(std::memory_order_acquire);
+  }
+  /**
+   * Check whether a bundle is being written
+   *
+   * @return true if a requested bundle has not been written yet
+   */
+  inline bool pending() const {
+    return pending_.load(std::memory_order_acquire) > 0;
+  }
+
+ private:
+  /**
+   * @brief Bundle request.
+   *
+   * Values that change right after the fault is raised
+   */
+  struct entry {
+    /** fault reason */
+    flight::fault reason;
+    /** wall clock time (us since epoch) */
+    uint64_t time;
+    /** sequence of the latest flight record */
+    uint64_t sequence;
+    /** state of the state machine */
+    flight::state state;
+    /** machine coordinate */
+    Coordinate coordinate;
+    /** config revision */
+    unsigned int revision;
+  };
+
+  /**
+   * PostMortemImpl Constructor
+   *
+   * Start writer thread
+   *
+   * @param directory directory of the bundles
+   */
+  explicit PostMortemImpl(const fs::path& directory);
+  /**
+   * PostMortemImpl Destructor
+   *
+   * Write requested bundles and stop writer thread
+   */
+  ~PostMortemImpl();
+  /**
+   * Write requested bundles until it is stopped
+   */
+  void run();
+  /**
+   * Write bundle
+   *
+   * @param e bundle request
+   *
+   * @return ATM_OK or ATM_ERR if the file cannot be written
+   */
+  ATM_STATUS dump(const entry& e);
+  /**
+   * Remove bundles beyond postmortem::keep
+   */
+  void prune();
+
+ private:
+  /**
+   * Directory of the bundles
+   */
+  const fs::path directory_;
+  /**
+   * Requests mutex
+   */
+  std::mutex mutex_;
+  /**
+   * Wakes up writer thread
+   */
+  std::condition_variable cv_;
+  /**
+   * Requested bundles
+   */
+  std::vector<entry> entries_;
+  /**
+   * Writer thread is running
+   */
+  bool running_;
+  /**
+   * Number of bundles written
+   */
+  std::atomic<std::size_t> written_;
+  /**
+   * Number of bundles requested but not written
+   */
+  std::atomic<std::size_t> pending_;
+  /**
+   * Writer thread
+   */
+  std::thread thread_;
+};
+}  // namespace impl
+
+NAMESPACE_END
+
+#endif  // LIB_CORE_POSTMORTEM_HPP_
@@ -0,0 +1,361 @@
+#include "core.hpp"
+
+#include "recorder.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "logger.hpp"
+
+NAMESPACE_BEGIN
+
+namespace flight {
+/**
+ * Get size of a flight recorder file
+ *
+ * @return size in bytes
+ */
+static constexpr std::size_t file_size() {
+  return sizeof(header) + capacity * sizeof(record);
+}
+
+/**
+ * Check whether header belongs to a file of the current layout
+ *
+ * @param h header
+ *
+ * @return true if the layout is the same
+ */
+static bool compatible(const header& h) {
+  return h.magic == magic && h.version == version &&
+         h.record_size == sizeof(record) && h.capacity == capacity;
+}
+
+const char* to_string(kind value) {
+  switch (value) {
+    case kind::boot:
+      return "boot";
+    case kind::motion:
+      return "motion";
+    case kind::state:
+      return "state";
+    case kind::inputs:
+      return "inputs";
+    case kind::fault:
+      return "fault";
+  }
+  return "unknown";
+}
+
+const char* to_string(state value) {
+  switch (value) {
+    case state::initial:
+      return "initial";
+    case state::no_task:
+      return "no_task";
+    case state::spraying:
+      return "spraying";
+    case state::tending:
+      return "tending";
+    case state::cleaning:
+      return "cleaning";
+    case state::fault:
+      return "fault";
+    case state::fault_manual:
+      return "fault_manual";
+    case state::terminated:
+      return "terminated";
+  }
+  return "unknown";
+}
+
+bool faulted(state value) {
+  return value == state::fault || value == state::fault_manual;
+}
+
+const char* to_string(fault value) {
+  switch (value) {
+    case fault::none:
+      return "none";
+    case fault::e_stop:
+      return "e_stop";
+    case fault::limit_switch:
+      return "limit_switch";
+    case fault::limit_switch_x:
+      return "limit_switch_x";
+    case fault::limit_switch_y:
+      return "limit_switch_y";
+    case fault::spraying_tending_height:
+      return "spraying_tending_height";
+    case fault::finger_protection:
+      return "finger_protection";
+    case fault::cleaning_height:
+      return "cleaning_height";
+    case fault::timeout:
+      return "timeout";
+    case fault::manual:
+      return "manual";
+  }
+  return "unknown";
+}
+
+ATM_STATUS load(const fs::path& path, std::vector<record>& records) {
+  std::ifstream file(path, std::ios::binary);
+  header        h;
+
+  if (!file.read(reinterpret_cast<char*>(&h), sizeof(h)) || !compatible(h)) {
+    return ATM_ERR;
+  }
+
+  records.clear();
+  records.reserve(capacity);
+
+  for (std::size_t idx = 0; idx < capacity; ++idx) {
+    record r;
+
+    if (!file.read(reinterpret_cast<char*>(&r), sizeof(r))) {
+      return ATM_ERR;
+    }
+
+    // unwritten, torn, or from a previous lap of a slot that has been
+    // claimed again
+    if (r.sequence == 0 || (r.sequence - 1) % capacity != idx ||
+        r.sequence > h.head) {
+      continue;
+    }
+
+    records.push_back(r);
+  }
+
+  std::sort(records.begin(), records.end(),
+            [](const record& lhs, const record& rhs) {
+              return lhs.sequence < rhs.sequence;
+            });
+
+  return ATM_OK;
+}
+
+void write_csv(std::ostream& os, const std::vector<record>& records) {
+  os << "sequence,time_us,kind,state,fault,steps_x,steps_y,steps_z,speed_x,"
+        "speed_y,speed_z,inputs,shift_register\n";
+
+  for (const auto& r : records) {
+    os << fmt::format(
+        "{},{},{},{},{},{},{},{},{:.3f},{:.3f},{:.3f},0x{:08x},0x{:08x}\n",
+        r.sequence, r.time, to_string(static_cast<kind>(r.kind)),
+        to_string(static_cast<state>(r.state)),
+        to_string(static_cast<fault>(r.fault)), r.steps[0], r.steps[1],
+        r.steps[2], r.speed[0], r.speed[1], r.speed[2], r.inputs,
+        r.shift_register);
+  }
+}
+}  // namespace flight
+
+namespace impl {
+FlightRecorderImpl::FlightRecorderImpl(const fs::path& path)
+    : path_{path},
+      fd_{-1},
+      header_{nullptr},
+      records_{nullptr},
+      epoch_{0},
+      state_{static_cast<uint16_t>(flight::state::initial)},
+      inputs_{0},
+      shift_register_{0},
+      fault_{static_cast<uint8_t>(flight::fault::none)} {
+  DEBUG_ONLY_DEFINITION(obj_name_ = "FlightRecorderImpl");
+
+  const auto wall = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::system_clock::now().time_since_epoch());
+  epoch_ = static_cast<uint64_t>(wall.count()) - micros();
+
+  if (path_.has_parent_path()) {
+    fs::create_directories(path_.parent_path());
+  }
+
+  fd_ = open(path_.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+
+  if (fd_ < 0) {
+    LOG_ERROR("Failed to open flight recorder {}: {}", path_.string(),
+              std::strerror(errno));
+    return;
+  }
+
+  if (ftruncate(fd_, static_cast<off_t>(flight::file_size())) < 0) {
+    LOG_ERROR("Failed to resize flight recorder {}: {}", path_.string(),
+              std::strerror(errno));
+    return;
+  }
+
+  void* mapping = mmap(nullptr, flight::file_size(), PROT_READ | PROT_WRITE,
+                       MAP_SHARED, fd_, 0);
+
+  if (mapping == MAP_FAILED) {
+    LOG_ERROR("Failed to map flight recorder {}: {}", path_.string(),
+              std::strerror(errno));
+    return;
+  }
+
+  header_ = static_cast<flight::header*>(mapping);
+
+  if (!flight::compatible(*header_)) {
+    // new file or another layout, records cannot be read anyway
+    std::memset(mapping, 0, flight::file_size());
+    header_->magic = flight::magic;
+    header_->version = flight::version;
+    header_->record_size = sizeof(flight::record);
+    header_->capacity = flight::capacity;
+    header_->head = 0;
+  }
+
+  records_ = reinterpret_cast<flight::record*>(header_ + 1);
+
+  LOG_INFO("Flight recorder {} is mapped, {} records so far", path_.string(),
+           header_->head);
+
+  flight::record r{};
+  r.kind = static_cast<uint8_t>(flight::kind::boot);
+  write(r);
+}
+
+FlightRecorderImpl::~FlightRecorderImpl() {
+  if (header_ != nullptr) {
+    munmap(header_, flight::file_size());
+  }
+
+  if (fd_ >= 0) {
+    close(fd_);
+  }
+}
+
+void FlightRecorderImpl::motion(const std::array<int64_t, 3>& steps,
+                                const std::array<float, 3>&   speed) {
+  flight::record r;
+  r.kind = static_cast<uint8_t>(flight::kind::motion);
+  r.steps = steps;
+  r.speed = speed;
+  write(r);
+}
+
+void FlightRecorderImpl::state(flight::state value) {
+  const auto previous = static_cast<flight::state>(
+      state_.exchange(static_cast<uint16_t>(value), std::memory_order_relaxed));
+
+  // fault is over once the machine has been restarted out of it
+  if (flight::faulted(previous) && !flight::faulted(value)) {
+    fault_.store(static_cast<uint8_t>(flight::fault::none),
+                 std::memory_order_relaxed);
+  }
+
+  flight::record r{};
+  r.kind = static_cast<uint8_t>(flight::kind::state);
+  write(r);
+}
+
+void FlightRecorderImpl::inputs(uint32_t value) {
+  if (inputs_.exchange(value, std::memory_order_relaxed) == value) {
+    return;
+  }
+
+  flight::record r{};
+  r.kind = static_cast<uint8_t>(flight::kind::inputs);
+  write(r);
+}
+
+void FlightRecorderImpl::fault(flight::fault reason) {
+  fault_.store(static_cast<uint8_t>(reason), std::memory_order_relaxed);
+
+  flight::record r{};
+  r.kind = static_cast<uint8_t>(flight::kind::fault);
+  write(r);
+}
+
+uint64_t FlightRecorderImpl::head() const {
+  if (!valid()) {
+    return 0;
+  }
+
+  return std::atomic_ref<uint64_t>(header_->head)
+      .load(std::memory_order_acquire);
+}
+
+void FlightRecorderImpl::read(uint64_t                     since,
+                              uint64_t                     until,
+                              std::vector<flight::record>& records) const {
+  records.clear();
+
+  if (!valid()) {
+    return;
+  }
+
+  const uint64_t oldest =
+      until > flight::capacity ? until - flight::capacity + 1 : 1;
+
+  // walk back from the newest record, slots behind the writers are stable
+  for (uint64_t sequence = until; sequence >= oldest && sequence > 0;
+       --sequence) {
+    const flight::record& slot = records_[(sequence - 1) % flight::capacity];
+    std::atomic_ref<uint64_t> slot_sequence(
+        const_cast<uint64_t&>(slot.sequence));
+
+    if (slot_sequence.load(std::memory_order_acquire) != sequence) {
+      // claimed again by a writer of a later lap, or not written yet
+      continue;
+    }
+
+    flight::record r;
+    std::memcpy(&r, &slot, sizeof(r));
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    if (slot_sequence.load(std::memory_order_relaxed) != sequence) {
+      continue;
+    }
+
+    r.sequence = sequence;
+
+    if (r.time < since) {
+      break;
+    }
+
+    records.push_back(r);
+  }
+
+  std::reverse(records.begin(), records.end());
+}
+
+void FlightRecorderImpl::write(flight::record& r) {
+  if (!valid()) {
+    return;
+  }
+
+  // sequence 0 marks a slot that has never been written
+  const uint64_t sequence =
+      std::atomic_ref<uint64_t>(header_->head)
+          .fetch_add(1, std::memory_order_relaxed) +
+      1;
+
+  r.time = epoch_ + micros();
+  r.inputs = inputs_.load(std::memory_order_relaxed);
+  r.shift_register = shift_register_.load(std::memory_order_relaxed);
+  r.state = state_.load(std::memory_order_relaxed);
+  r.fault = fault_.load(std::memory_order_relaxed);
+
+  flight::record& slot = records_[(sequence - 1) % flight::capacity];
+
+  // readers skip the slot while its sequence is 0, even after a crash
+  std::atomic_ref<uint64_t>(slot.sequence).store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  std::memcpy(reinterpret_cast<char*>(&slot) + sizeof(slot.sequence),
+              reinterpret_cast<const char*>(&r) + sizeof(r.sequence),
+              sizeof(r) - sizeof(r.sequence));
+  std::atomic_ref<uint64_t>(slot.sequence)
+      .store(sequence, std::memory_order_release);
+}
+}  // namespace impl
+
+NAMESPACE_END
@@ -0,0 +1,333 @@
+#ifndef LIB_CORE_RECORDER_HPP_
+#define LIB_CORE_RECORDER_HPP_
+
+/** @file recorder.hpp
+ *  @brief Flight recorder singleton class definition
+ *
+ * Binary telemetry of motion and machine in a memory-mapped ring file
+ */
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <libutil/util.hpp>
+
+#include "common.hpp"
+
+#include "allocation.hpp"
+
+NAMESPACE_BEGIN
+
+namespace impl {
+class FlightRecorderImpl;
+}
+
+/** impl::FlightRecorderImpl singleton class using StaticObj */
+using FlightRecorder = StaticObj<impl::FlightRecorderImpl>;
+
+namespace flight {
+/** Number of records in the ring file, 4 MiB */
+constexpr std::size_t capacity = 1 << 16;
+/** Version of the file layout */
+constexpr uint32_t version = 1;
+/** Name of the file under LOGS_DIR */
+constexpr const char* file_name = "flight.bin";
+/** Magic number of the file */
+constexpr uint64_t magic = 0x3130544c464d5441;  // "ATMFLT01"
+
+/** Why a record has been written */
+enum class kind : uint8_t { boot, motion, state, inputs, fault };
+
+/** State of the tending state machine */
+enum class state : uint16_t {
+  initial,
+  no_task,
+  spraying,
+  tending,
+  cleaning,
+  fault,
+  fault_manual,
+  terminated
+};
+
+/** Fault reason */
+enum class fault : uint8_t {
+  none,
+  e_stop,
+  limit_switch,
+  limit_switch_x,
+  limit_switch_y,
+  spraying_tending_height,
+  finger_protection,
+  cleaning_height,
+  timeout,
+  manual
+};
+
+/**
+ * @brief Flight record.
+ *
+ * Fixed-size record, latest state, inputs, shift register frame and fault are
+ * carried by every record, steps and speed only by motion records
+ */
+struct record {
+  /** sequence of the record, 0 while the record is being written */
+  uint64_t sequence;
+  /** wall clock time (us since epoch) */
+  uint64_t time;
+  /** absolute steps of x, y, and z axis */
+  std::array<int64_t, 3> steps;
+  /** speed of x, y, and z axis (mm/s) */
+  std::array<float, 3> speed;
+  /** levels of input bank, bit n is GPIO n */
+  uint32_t inputs;
+  /** latched shift register frame, bit n is pin n of the cascade */
+  uint32_t shift_register;
+  /** flight::state */
+  uint16_t state;
+  /** flight::kind */
+  uint8_t kind;
+  /** flight::fault */
+  uint8_t fault;
+};
+
+static_assert(sizeof(record) == 64, "record must be a cache line");
+
+/**
+ * @brief Flight recorder file header.
+ */
+struct header {
+  /** flight::magic */
+  uint64_t magic;
+  /** flight::version */
+  uint32_t version;
+  /** size of a record */
+  uint32_t record_size;
+  /** number of records */
+  uint64_t capacity;
+  /** sequence of next record */
+  uint64_t head;
+  /** reserved */
+  uint64_t reserved[4];
+};
+
+static_assert(sizeof(header) == sizeof(record), "header must be a record");
+
+/**
+ * Get name of record kind
+ *
+ * @param value record kind
+ *
+ * @return name
+ */
+const char* to_string(kind value);
+/**
+ * Get name of machine state
+ *
+ * @param value machine state
+ *
+ * @return name
+ */
+const char* to_string(state value);
+/**
+ * Check whether machine state is one of the fault states
+ *
+ * @param value machine state
+ *
+ * @return true if fault or fault_manual
+ */
+bool faulted(state value);
+/**
+ * Get name of fault reason
+ *
+ * @param value fault reason
+ *
+ * @return name
+ */
+const char* to_string(fault value);
+/**
+ * Load every record of a flight recorder file
+ *
+ * Records that have been overwritten or have not been completely written
+ * are skipped
+ *
+ * @param path     flight recorder file
+ * @param records  records ordered by sequence
+ *
+ * @return ATM_OK or ATM_ERR if the file is not a flight recorder file
+ */
+ATM_STATUS load(const fs::path& path, std::vector<record>& records);
+/**
+ * Write records as CSV, one line per record with a header line
+ *
+ * @param os       output stream
+ * @param records  records
+ */
+void write_csv(std::ostream& os, const std::vector<record>& records);
+}  // namespace flight
+
+namespace impl {
+/**
+ * @brief Flight recorder implementation.
+ *        This is a class wrapper that should not be instantiated and accessed
+ * publicly.
+ *
+ * Writes records into a ring in a file that is mapped with mmap. Writing a
+ * record claims its sequence with an atomic increment and copies it into the
+ * mapping, there is no lock and no syscall. Kernel owns the pages, so the
+ * records survive a crash of the process.
+ *
+ * Records of a previous run are kept, new records are appended after them
+ */
+class FlightRecorderImpl : public StackObj {
+  template <class FlightRecorderImpl>
+  template <typename... Args>
+  friend ATM_STATUS StaticObj<FlightRecorderImpl>::create(Args&&... args);
+
+ public:
+  /**
+   * Check whether the file is mapped or not
+   *
+   * @return true if records can be written
+   */
+  inline bool valid() const { return records_ != nullptr; }
+  /**
+   * Get path of the file
+   *
+   * @return path
+   */
+  inline const fs::path& path() const { return path_; }
+  /**
+   * Write motion record
+   *
+   * @param steps absolute steps of each axis
+   * @param speed speed of each axis (mm/s)
+   */
+  void motion(const std::array<int64_t, 3>& steps,
+              const std::array<float, 3>&   speed);
+  /**
+   * Write state record
+   *
+   * Leaving fault or fault_manual resets the fault reason to none
+   *
+   * @param value new state
+   */
+  void state(flight::state value);
+  /**
+   * Write inputs record if the levels have changed
+   *
+   * @param value levels of input bank
+   */
+  void inputs(uint32_t value);
+  /**
+   * Set latched shift register frame, it is carried by the next record
+   *
+   * @param value latched frame
+   */
+  inline void shift_register(uint32_t value) {
+    shift_register_.store(value, std::memory_order_relaxed);
+  }
+  /**
+   * Write fault record
+   *
+   * @param reason fault reason
+   */
+  void fault(flight::fault reason);
+  /**
+   * Get latest state
+   *
+   * @return state of the state machine
+   */
+  inline flight::state current_state() const {
+    return static_cast<flight::state>(state_.load(std::memory_order_relaxed));
+  }
+  /**
+   * Get sequence of the latest record
+   *
+   * @return sequence, 0 if nothing has been written
+   */
+  uint64_t head() const;
+  /**
+   * Read the latest records from the mapping (any thread)
+   *
+   * Slots that are being written while they are read are skipped, so the
+   * writers are never blocked
+   *
+   * @param since    oldest wall clock time to read (us since epoch)
+   * @param until    sequence of the newest record to read
+   * @param records  records ordered by sequence
+   */
+  void read(uint64_t                     since,
+            uint64_t                     until,
+            std::vector<flight::record>& records) const;
+
+ private:
+  /**
+   * FlightRecorderImpl Constructor
+   *
+   * Map the file, create it if it does not exist or its layout is different
+   *
+   * @param path flight recorder file
+   */
+  explicit FlightRecorderImpl(const fs::path& path);
+  /**
+   * FlightRecorderImpl Destructor
+   *
+   * Unmap the file
+   */
+  ~FlightRecorderImpl();
+  /**
+   * Write record
+   *
+   * @param r record, sequence and every latest value are filled in
+   */
+  void write(flight::record& r);
+
+ private:
+  /**
+   * File path
+   */
+  const fs::path path_;
+  /**
+   * File descriptor
+   */
+  int fd_;
+  /**
+   * Mapped header
+   */
+  flight::header* header_;
+  /**
+   * Mapped records
+   */
+  flight::record* records_;
+  /**
+   * Wall clock time of micros() == 0 (us)
+   */
+  uint64_t epoch_;
+  /**
+   * Latest state
+   */
+  std::atomic<uint16_t> state_;
+  /**
+   * Latest input levels
+   */
+  std::atomic<uint32_t> inputs_;
+  /**
+   * Latest latched shift register frame
+   */
+  std::atomic<uint32_t> shift_register_;
+  /**
+   * Latest fault reason
+   */
+  std::atomic<uint8_t> fault_;
+};
+}  // namespace impl
+
+NAMESPACE_END
+
+#endif  // LIB_CORE_RECORDER_HPP_
@@ -0,0 +1,120 @@
+#include "core.hpp"
+
+#include "reloader.hpp"
+
+#include <cstring>
+
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include "config.hpp"
+#include "logger.hpp"
+
+NAMESPACE_BEGIN
+
+namespace {
+/**
+ * Read pending inotify events
+ *
+ * @param fd   inotify file descriptor
+ * @param name watched file name
+ *
+ * @return true if any event is about the watched file
+ */
+bool changed(int fd, const std::string& name) {
+  alignas(struct inotify_event) char buffer[4096];
+  bool                               retval = false;
+
+  for (;;) {
+    const ssize_t length = read(fd, buffer, sizeof(buffer));
+
+    if (length <= 0) {
+      break;
+    }
+
+    for (const char* ptr = buffer; ptr < buffer + length;) {
+      const auto* event = reinterpret_cast<const struct inotify_event*>(ptr);
+
+      if (event->len > 0 && name == event->name) {
+        retval = true;
+      }
+
+      ptr += sizeof(struct inotify_event) + event->len;
+    }
+  }
+
+  return retval;
+}
+}  // namespace
+
+ConfigReloader::ConfigReloader() {}
+
+ConfigReloader::~ConfigReloader() {
+  running_ = false;
+  if (thread().joinable()) {
+    thread().join();
+  }
+}
+
+void ConfigReloader::start() {
+  std::lock_guard<std::mutex> lock(mutex());
+
+  if (!running()) {
+    LOG_INFO("Starting config reloader");
+    running_ = true;
+    thread_ = std::thread(&ConfigReloader::execute, this);
+  }
+}
+
+void ConfigReloader::stop() {
+  std::lock_guard<std::mutex> lock(mutex());
+
+  if (running()) {
+    LOG_INFO("Stopping config reloader");
+    running_ = false;
+  }
+}
+
+void ConfigReloader::execute() {
+  massert(Config::get() != nullptr, "sanity");
+
+  auto* config = Config::get();
+
+  const fs::path    path = fs::absolute(config->path());
+  const std::string name = path.filename().string();
+
+  const int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+  if (fd < 0) {
+    LOG_ERROR("Failed to watch config {}: {}", path.string(),
+              std::strerror(errno));
+    return;
+  }
+
+  if (inotify_add_watch(fd, path.parent_path().c_str(),
+                        IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+    LOG_ERROR("Failed to watch config {}: {}", path.string(),
+              std::strerror(errno));
+    close(fd);
+    return;
+  }
+
+  struct pollfd pfd = {fd, POLLIN, 0};
+
+  while (running()) {
+    if (poll(&pfd, 1, reloader::poll_period) <= 0 || !changed(fd, name)) {
+      continue;
+    }
+
+    // a save may come as several events, reload once
+    sleep_for<time_units::millis>(reloader::settle_period);
+    changed(fd, name);
+
+    config->reload();
+  }
+
+  close(fd);
+}
+
+NAMESPACE_END
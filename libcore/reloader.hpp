@@ -0,0 +1,75 @@
+#ifndef LIB_CORE_RELOADER_HPP_
+#define LIB_CORE_RELOADER_HPP_
+
+/** @file reloader.hpp
+ *  @brief Config reloader class definition
+ *
+ * Reload config when the config file is changed
+ */
+
+#include <mutex>
+
+#include <libutil/util.hpp>
+
+#include "common.hpp"
+
+#include "listener.hpp"
+
+NAMESPACE_BEGIN
+
+namespace reloader {
+/** Period (ms) to check whether the reloader has been stopped */
+constexpr int poll_period = 500;
+/** Period (ms) to wait for the rest of the same save */
+constexpr time_unit settle_period = 100;
+}  // namespace reloader
+
+/**
+ * @brief Config reloader.
+ *
+ * Watches directory of the config file with inotify, editors usually save by
+ * renaming a temporary file, so the file itself cannot be watched. Config is
+ * re-parsed and validated on the reloader thread, a new revision is published
+ * by Config::reload() only if it is valid
+ */
+class ConfigReloader : public Listener {
+ public:
+  /**
+   * Config reloader constructor
+   */
+  ConfigReloader();
+  /**
+   * Config reloader destructor
+   */
+  virtual ~ConfigReloader() override;
+  /**
+   * Start listener
+   */
+  virtual void start() override;
+  /**
+   * Stop listener
+   */
+  virtual void stop() override;
+
+ private:
+  /**
+   * Get mutex
+   *
+   * @return mutex
+   */
+  inline std::mutex& mutex() { return mutex_; }
+  /**
+   * Execute listener tasks
+   */
+  void execute();
+
+ private:
+  /**
+   * Mutex
+   */
+  std::mutex mutex_;
+};
+
+NAMESPACE_END
+
+#endif  // LIB_CORE_RELOADER_HPP_
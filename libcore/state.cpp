@@ -62,11 +62,13 @@ StateImpl::StateImpl()
     : speed_profile_{config::speed::normal},
       running_{false},
       coordinate_{0.0, 0.0, 0.0},
+      position_source_{nullptr},
       tending_{},
       spraying_{},
       cleaning_{},
       manual_mode_{false},
       homing_{false},
+      homing_duration_{0},
       water_refilling_{},
       disinfectant_refilling_{} {
   DEBUG_ONLY_DEFINITION(obj_name_ = "StateImpl");
@@ -117,14 +119,20 @@ void StateImpl::running(bool run) {
 void StateImpl::coordinate(const Coordinate& coordinate) {
   {
     const StateImpl::StateLock lock(mutex());
-    coordinate_.x = coordinate.x;
-    coordinate_.y = coordinate.y;
-    coordinate_.z = coordinate.z;
+    if (position_source_ != nullptr) {
+      position_source_->position(coordinate);
+    } else {
+      coordinate_ = coordinate;
+    }
   }
   notify_all();
 }
 
-const Coordinate& StateImpl::coordinate() {
+Coordinate StateImpl::coordinate() {
+  const StateImpl::StateLock lock(mutex());
+  if (position_source_ != nullptr) {
+    return position_source_->position();
+  }
   return coordinate_;
 }
 
@@ -135,90 +143,72 @@ void StateImpl::reset_coordinate() {
 void StateImpl::x(const Point& x) {
   {
     const StateImpl::StateLock lock(mutex());
-    coordinate_.x = x;
-  }
-  notify_all();
-}
-
-void StateImpl::inc_x() {
-  {
-    const StateImpl::StateLock lock(mutex());
-    coordinate_.x += 1.0;
-  }
-  notify_all();
-}
-
-void StateImpl::dec_x() {
-  {
-    const StateImpl::StateLock lock(mutex());
-    coordinate_.x -= 1.0;
+    if (position_source_ != nullptr) {
+      Coordinate coordinate = position_source_->position();
+      coordinate.x = x;
+      position_source_->position(coordinate);
+    } else {
+      coordinate_.x = x;
+    }
   }
   notify_all();
 }
 
-const Point& StateImpl::x() {
-  const StateImpl::StateLock lock(mutex());
-  return coordinate_.x;
+Point StateImpl::x() {
+  return coordinate().x;
 }
 
 void StateImpl::y(const Point& y) {
   {
     const StateImpl::StateLock lock(mutex());
-    coordinate_.y = y;
-  }
-  notify_all();
-}
-
-void StateImpl::inc_y() {
-  {
-    const StateImpl::StateLock lock(mutex());
-    coordinate_.y += 1.0;
-  }
-  notify_all();
-}
-
-void StateImpl::dec_y() {
-  {
-    const StateImpl::StateLock lock(mutex());
-    coordinate_.y -= 1.0;
+    if (position_source_ != nullptr) {
+      Coordinate coordinate = position_source_->position();
+      coordinate.y = y;
+      position_source_->position(coordinate);
+    } else {
+      coordinate_.y = y;
+    }
   }
   notify_all();
 }
 
-const Point& StateImpl::y() {
-  const StateImpl::StateLock lock(mutex());
-  return coordinate_.y;
+Point StateImpl::y() {
+  return coordinate().y;
 }
 
 void StateImpl::z(const Point& z) {
   {
     const StateImpl::StateLock lock(mutex());
-    coordinate_.z = z;
+    if (position_source_ != nullptr) {
+      Coordinate coordinate = position_source_->position();
+      coordinate.z = z;
+      position_source_->position(coordinate);
+    } else {
+      coordinate_.z = z;
+    }
   }
   notify_all();
 }
 
-void StateImpl::inc_z() {
-  {
-    const StateImpl::StateLock lock(mutex());
-    coordinate_.z += 1.0;
-  }
-  notify_all();
+Point StateImpl::z() {
+  return coordinate().z;
 }
 
-void StateImpl::dec_z() {
+void StateImpl::position_source(PositionSource* source) {
   {
     const StateImpl::StateLock lock(mutex());
-    coordinate_.z -= 1.0;
+    // keep the last known coordinate when the source is detached
+    if (position_source_ != nullptr) {
+      coordinate_ = position_source_->position();
+    }
+    position_source_ = source;
+    if (position_source_ != nullptr) {
+      position_source_->position(coordinate_);
+    }
   }
   notify_all();
 }
 
-const Point& StateImpl::z() {
-  const StateImpl::StateLock lock(mutex());
-  return coordinate_.z;
-}
-
 const Task& StateImpl ::spraying() {
   const StateImpl::StateLock lock(mutex());
   return spraying_;
@@ -390,6 +380,19 @@ bool StateImpl::homing() {
   return homing_;
 }
 
+void StateImpl::homing_duration(time_unit duration) {
+  {
+    const StateImpl::StateLock lock(mutex());
+    homing_duration_ = duration;
+  }
+  notify_all();
+}
+
+time_unit StateImpl::homing_duration() {
+  const StateImpl::StateLock lock(mutex());
+  return homing_duration_;
+}
+
 void StateImpl::speed_profile(const config::speed& speed_profile) {
   {
     const StateImpl::StateLock lock(mutex());
@@ -59,6 +59,32 @@ struct Coordinate {
   Point z;
 };
 
+/**
+ * @brief Position source abstract class
+ *
+ * Keeps track of the position outside of the state (e.g. step counters of the
+ * motion layer), the coordinate is derived when it is read
+ */
+class PositionSource : public StackObj {
+ public:
+  /**
+   * PositionSource destructor
+   */
+  virtual ~PositionSource() = default;
+  /**
+   * Read current position
+   *
+   * @return current coordinate
+   */
+  virtual Coordinate position() const = 0;
+  /**
+   * Overwrite current position
+   *
+   * @param coordinate new coordinate
+   */
+  virtual void position(const Coordinate& coordinate) = 0;
+};
+
 /**
  * @brief Task
  *
@@ -224,7 +250,7 @@ class StateImpl : public StackObj {
    *
    * @return current coordinate
    */
-  const Coordinate& coordinate();
+  Coordinate coordinate();
   /**
    * Reset coordinate
    */
@@ -235,60 +261,45 @@ class StateImpl : public StackObj {
    * @param x set new x-axis coordinate
    */
   void x(const Point& x);
-  /**
-   * Increment x-axis coordinate
-   */
-  void inc_x();
-  /**
-   * Decrement x-axis coordinate
-   */
-  void dec_x();
   /**
    * Get x-axis coordinate
    *
    * @return  x-axis coordinate
    */
-  const Point& x();
+  Point x();
   /**
    * Set y-axis coordinate
    *
    * @param y set new y-axis coordinate
    */
   void y(const Point& y);
-  /**
-   * Increment y-axis coordinate
-   */
-  void inc_y();
-  /**
-   * Decrement y-axis coordinate
-   */
-  void dec_y();
   /**
    * Get y-axis coordinate
    *
    * @return  y-axis coordinate
    */
-  const Point& y();
+  Point y();
   /**
    * Set z-axis coordinate
    *
    * @param z set new x-axis coordinate
    */
   void z(const Point& z);
-  /**
-   * Increment z-axis coordinate
-   */
-  void inc_z();
-  /**
-   * Decrement z-axis coordinate
-   */
-  void dec_z();
   /**
    * Get x-axis coordinate
    *
    * @return  x-axis coordinate
    */
-  const Point& z();
+  Point z();
+  /**
+   * Set position source
+   *
+   * Coordinate is read from and written to the source instead of being kept
+   * in the state, nullptr detaches the source
+   *
+   * @param source position source
+   */
+  void position_source(PositionSource* source);
   /**
    * Get spraying task
    *
@@ -451,6 +462,18 @@ class StateImpl : public StackObj {
    * @return status of homing
    */
   bool homing();
+  /**
+   * Set duration of last homing
+   *
+   * @param duration duration in millis
+   */
+  void homing_duration(time_unit duration);
+  /**
+   * Duration of last homing
+   *
+   * @return duration in millis
+   */
+  time_unit homing_duration();
   /**
    * Set profile speed
    */
@@ -599,6 +622,10 @@ class StateImpl : public StackObj {
    * Current coordinate
    */
   Coordinate coordinate_;
+  /**
+   * Position source, coordinate_ is used if there is none
+   */
+  PositionSource* position_source_;
   /**
    * State read mutex
    */
@@ -631,6 +658,10 @@ class StateImpl : public StackObj {
    * Homing
    */
   bool homing_;
+  /**
+   * Duration of last homing in millis
+   */
+  time_unit homing_duration_;
   /**
    * Water refilling
    */
@@ -25,6 +25,9 @@ using ConstantSpeedA4988Device = A4988Device<stepper::speed::constant>;
 /** Linear speed specific implementation for Pololu A4988 Device */
 using LinearSpeedA4988Device = A4988Device<stepper::speed::linear>;
 
+/** S-curve speed specific implementation for Pololu A4988 Device */
+using ScurveSpeedA4988Device = A4988Device<stepper::speed::scurve>;
+
 template <stepper::speed Speed>
 class A4988Device : public impl::StepperDeviceImpl<Speed> {
  public:
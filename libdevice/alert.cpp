@@ -0,0 +1,119 @@
+#include "device.hpp"
+
+#include "alert.hpp"
+
+#include <algorithm>
+
+NAMESPACE_BEGIN
+
+namespace device {
+namespace impl {
+InputAlertImpl::InputAlertImpl() : next_id_{1} {
+  DEBUG_ONLY_DEFINITION(obj_name_ = "InputAlertImpl");
+}
+
+InputAlertImpl::~InputAlertImpl() {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  for (const auto& subscriber : subscribers_) {
+    gpioSetAlertFuncEx(static_cast<unsigned>(subscriber.pin), nullptr,
+                       nullptr);
+  }
+
+  subscribers_.clear();
+}
+
+alert::subscription InputAlertImpl::subscribe(
+    const std::shared_ptr<DigitalInputDevice>& device,
+    alert::edge                                edge,
+    alert::callback                            callback) {
+  if (!device || !device->active() || device->pin() > PI_MAX_USER_GPIO) {
+    LOG_ERROR("Cannot watch edges of input device");
+    return 0;
+  }
+
+  const PI_PIN pin = static_cast<PI_PIN>(device->pin());
+
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  if (subscribers(pin) == 0 &&
+      gpioSetAlertFuncEx(static_cast<unsigned>(pin),
+                         &InputAlertImpl::on_alert, this) != PI_OK) {
+    LOG_ERROR("Cannot register alert function of pin {}", pin);
+    return 0;
+  }
+
+  const alert::subscription id = next_id_++;
+
+  subscribers_.push_back(
+      {id, pin, device->active_state(), edge, std::move(callback)});
+
+  return id;
+}
+
+void InputAlertImpl::unsubscribe(alert::subscription id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  const auto it = std::find_if(
+      subscribers_.begin(), subscribers_.end(),
+      [id](const subscriber& subscriber) { return subscriber.id == id; });
+
+  if (it == subscribers_.end()) {
+    return;
+  }
+
+  const PI_PIN pin = it->pin;
+
+  subscribers_.erase(it);
+
+  if (subscribers(pin) == 0) {
+    gpioSetAlertFuncEx(static_cast<unsigned>(pin), nullptr, nullptr);
+  }
+}
+
+void InputAlertImpl::on_alert(int      gpio,
+                              int      level,
+                              uint32_t tick,
+                              void*    userdata) {
+  static_cast<InputAlertImpl*>(userdata)->dispatch(gpio, level, tick);
+}
+
+void InputAlertImpl::dispatch(int gpio, int level, uint32_t tick) {
+  if (level == PI_TIMEOUT) {
+    // watchdog, level has not changed
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  for (const auto& subscriber : subscribers_) {
+    if (subscriber.pin != gpio) {
+      continue;
+    }
+
+    const digital::value value = ((level == PI_HIGH) == subscriber.active_state)
+                                     ? digital::value::high
+                                     : digital::value::low;
+
+    if ((subscriber.edge == alert::edge::rising &&
+         value != digital::value::high) ||
+        (subscriber.edge == alert::edge::falling &&
+         value != digital::value::low)) {
+      continue;
+    }
+
+    subscriber.callback({gpio, value, tick});
+  }
+}
+
+std::size_t InputAlertImpl::subscribers(PI_PIN pin) const {
+  return static_cast<std::size_t>(
+      std::count_if(subscribers_.begin(), subscribers_.end(),
+                    [pin](const subscriber& subscriber) {
+                      return subscriber.pin == pin;
+                    }));
+}
+}  // namespace impl
+}  // namespace device
+
+NAMESPACE_END
@@ -0,0 +1,179 @@
+#ifndef LIB_DEVICE_ALERT_HPP_
+#define LIB_DEVICE_ALERT_HPP_
+
+/** @file alert.hpp
+ *  @brief Input alert engine class definition
+ *
+ * Edge-triggered input events using Pigpio alert functions
+ */
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <libutil/util.hpp>
+
+#include <libcore/core.hpp>
+
+#include "digital.hpp"
+#include "gpio.hpp"
+
+NAMESPACE_BEGIN
+
+namespace device {
+// forward declaration
+namespace impl {
+class InputAlertImpl;
+}
+
+/** impl::InputAlertImpl singleton class using StaticObj */
+using InputAlert = StaticObj<impl::InputAlertImpl>;
+
+namespace alert {
+/**
+ * Edge to subscribe, after applying active state of the device
+ *
+ * rising  : device becomes digital::value::high
+ * falling : device becomes digital::value::low
+ * either  : both
+ */
+enum class edge { rising, falling, either };
+
+/**
+ * @brief Edge event.
+ */
+struct event {
+  /** GPIO pin */
+  PI_PIN pin;
+  /** value of the device after the edge (active state applied) */
+  digital::value value;
+  /** Pigpio tick of the edge in micros, wraps around every ~72 minutes */
+  uint32_t tick;
+};
+
+/** Edge callback */
+typedef std::function<void(const event&)> callback;
+
+/** Subscription identifier */
+typedef std::size_t subscription;
+}  // namespace alert
+
+namespace impl {
+/**
+ * @brief Input alert engine implementation.
+ *
+ * Pigpio samples the GPIO levels in its own thread and calls the alert
+ * function of a pin on every level change with the timestamp of the edge.
+ * The engine registers a single alert function per pin and fans the edges
+ * out to the subscribers, so nobody has to poll the inputs.
+ *
+ * Callbacks run on the Pigpio alert thread while the engine is locked, they
+ * must be short (set a flag, halt a stepper, notify a thread) and must not
+ * subscribe or unsubscribe. Once unsubscribe() returns the callback is never
+ * called again.
+ *
+ * With MOCK_GPIO the edges are injected with gpioMockEdge()
+ */
+class InputAlertImpl : public StackObj {
+  template <class InputAlertImpl>
+  template <typename... Args>
+  friend ATM_STATUS StaticObj<InputAlertImpl>::create(Args&&... args);
+
+ public:
+  /**
+   * Subscribe to edges of input device
+   *
+   * @param device    input device
+   * @param edge      edge to subscribe
+   * @param callback  callback that is called on every matching edge
+   *
+   * @return subscription identifier, 0 if the pin cannot be watched
+   */
+  alert::subscription subscribe(
+      const std::shared_ptr<DigitalInputDevice>& device,
+      alert::edge                                edge,
+      alert::callback                            callback);
+  /**
+   * Unsubscribe
+   *
+   * @param id subscription identifier
+   */
+  void unsubscribe(alert::subscription id);
+
+ private:
+  /**
+   * InputAlertImpl Constructor
+   */
+  InputAlertImpl();
+  /**
+   * InputAlertImpl Destructor
+   *
+   * Unregister every alert function
+   */
+  ~InputAlertImpl();
+  /**
+   * Alert function that is registered to Pigpio
+   *
+   * @param gpio      GPIO pin
+   * @param level     new level, PI_TIMEOUT on watchdog timeout
+   * @param tick      tick of the edge in micros
+   * @param userdata  instance of InputAlertImpl
+   */
+  static void on_alert(int gpio, int level, uint32_t tick, void* userdata);
+  /**
+   * Deliver edge to subscribers of the pin
+   *
+   * @param gpio   GPIO pin
+   * @param level  new level
+   * @param tick   tick of the edge in micros
+   */
+  void dispatch(int gpio, int level, uint32_t tick);
+  /**
+   * Count subscribers of the pin
+   *
+   * Must be called with mutex held
+   *
+   * @param pin GPIO pin
+   *
+   * @return number of subscribers
+   */
+  std::size_t subscribers(PI_PIN pin) const;
+
+ private:
+  /**
+   * @brief Subscriber of an edge
+   */
+  struct subscriber {
+    /** subscription identifier */
+    alert::subscription id;
+    /** GPIO pin */
+    PI_PIN pin;
+    /** active state of the device */
+    bool active_state;
+    /** edge to subscribe */
+    alert::edge edge;
+    /** callback */
+    alert::callback callback;
+  };
+
+  /**
+   * Subscribers
+   */
+  std::vector<subscriber> subscribers_;
+  /**
+   * Next subscription identifier
+   */
+  alert::subscription next_id_;
+  /**
+   * Guard subscribers
+   */
+  mutable std::mutex mutex_;
+};
+}  // namespace impl
+}  // namespace device
+
+NAMESPACE_END
+
+#endif  // LIB_DEVICE_ALERT_HPP_
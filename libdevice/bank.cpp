@@ -0,0 +1,111 @@
+#include "device.hpp"
+
+#include "bank.hpp"
+
+NAMESPACE_BEGIN
+
+namespace device {
+namespace bank {
+bool snapshot::high(const std::shared_ptr<DigitalInputDevice>& device) const {
+  const bits pin = bit(device->pin());
+
+  if ((mask & pin) == 0) {
+    return device->read_bool();
+  }
+
+  return (values & pin) != 0;
+}
+}  // namespace bank
+
+DigitalInputBank::DigitalInputBank() : mask_{0}, inverted_{0} {}
+
+DigitalInputBank::DigitalInputBank(
+    std::initializer_list<std::shared_ptr<DigitalInputDevice>> devices)
+    : DigitalInputBank() {
+  for (const auto& device : devices) {
+    add(device);
+  }
+}
+
+void DigitalInputBank::add(const std::shared_ptr<DigitalInputDevice>& device) {
+  // inactive devices are left to bank::snapshot::high()
+  if (!device->active()) {
+    return;
+  }
+
+  const bank::bits pin = bank::bit(device->pin());
+
+  mask_ |= pin;
+
+  if (!device->active_state()) {
+    inverted_ |= pin;
+  }
+}
+
+bank::snapshot DigitalInputBank::read() const {
+  bank::snapshot retval;
+
+  retval.mask = mask_;
+  retval.values =
+      (mask_ == 0) ? 0 : (gpioRead_Bits_0_31() ^ inverted_) & mask_;
+
+  return retval;
+}
+
+DigitalOutputBatch::DigitalOutputBatch() : set_{0}, clear_{0} {}
+
+ATM_STATUS DigitalOutputBatch::write(
+    const std::shared_ptr<DigitalOutputDevice>& device,
+    const digital::value&                       level) {
+  const bank::bits pin = bank::bit(device->pin());
+
+  if (pin == 0) {
+    return device->write(level);
+  }
+
+  if (!device->active()) {
+    LOG_DEBUG(
+        "[FAILED] DigitalOutputBatch::write with pin {}, device is not "
+        "active!",
+        device->pin());
+    return ATM_ERR;
+  }
+
+  // respect active state of the device
+  const bool high = (level == digital::value::high) == device->active_state();
+
+  if (high) {
+    set_ |= pin;
+    clear_ &= ~pin;
+  } else {
+    clear_ |= pin;
+    set_ &= ~pin;
+  }
+
+  return ATM_OK;
+}
+
+ATM_STATUS DigitalOutputBatch::commit() {
+  PI_RES res = PI_OK;
+
+  if (set_ != 0) {
+    res = gpioWrite_Bits_0_31_Set(set_);
+  }
+
+  if (res == PI_OK && clear_ != 0) {
+    res = gpioWrite_Bits_0_31_Clear(clear_);
+  }
+
+  set_ = 0;
+  clear_ = 0;
+
+  if (res == PI_OK) {
+    return ATM_OK;
+  }
+
+  LOG_DEBUG("[FAILED] DigitalOutputBatch::commit, result = {}", res);
+  return ATM_ERR;
+}
+}  // namespace device
+
+NAMESPACE_END
@@ -0,0 +1,171 @@
+#ifndef LIB_DEVICE_BANK_HPP_
+#define LIB_DEVICE_BANK_HPP_
+
+/** @file bank.hpp
+ *  @brief GPIO bank class definition
+ *
+ * Read and write several digital devices of GPIO bank 0 at once
+ */
+
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+
+#include <libutil/util.hpp>
+
+#include <libcore/core.hpp>
+
+#include "digital.hpp"
+#include "gpio.hpp"
+
+NAMESPACE_BEGIN
+
+namespace device {
+namespace bank {
+/** Levels of GPIO bank 0 (GPIO 0-31), one bit per pin */
+typedef uint32_t bits;
+
+/** Number of pins in GPIO bank 0 */
+constexpr unsigned int size = 32;
+
+/**
+ * Get bit of pin in GPIO bank 0
+ *
+ * @param pin GPIO pin
+ *
+ * @return bit of the pin, 0 if the pin is not in bank 0
+ */
+inline constexpr bits bit(unsigned int pin) {
+  return (pin < size) ? static_cast<bits>(1) << pin : 0;
+}
+
+/**
+ * @brief Levels of input devices read at once.
+ *
+ * Active state of every device is already applied, so a set bit means
+ * digital::value::high
+ */
+struct snapshot {
+  /** pins of the devices in the snapshot */
+  bits mask;
+  /** values of the devices in the snapshot */
+  bits values;
+
+  /**
+   * Get value of device
+   *
+   * Devices that are not in the snapshot are read on their own
+   *
+   * @param device input device
+   *
+   * @return true if the device is digital::value::high
+   */
+  bool high(const std::shared_ptr<DigitalInputDevice>& device) const;
+};
+}  // namespace bank
+
+/**
+ * @brief Input devices of GPIO bank 0.
+ *
+ * Reads every device with a single gpioRead_Bits_0_31, instead of one
+ * gpioRead per device. Devices of inactive pins are never reported high,
+ * devices outside bank 0 are read on their own by bank::snapshot::high()
+ */
+class DigitalInputBank : public StackObj {
+ public:
+  /**
+   * DigitalInputBank Constructor
+   */
+  DigitalInputBank();
+  /**
+   * DigitalInputBank Constructor
+   *
+   * @param devices input devices
+   */
+  DigitalInputBank(
+      std::initializer_list<std::shared_ptr<DigitalInputDevice>> devices);
+  /**
+   * Add input device
+   *
+   * @param device input device
+   */
+  void add(const std::shared_ptr<DigitalInputDevice>& device);
+  /**
+   * Read every device at once
+   *
+   * @return levels of the devices
+   */
+  bank::snapshot read() const;
+  /**
+   * Get pins of the devices
+   *
+   * @return bank mask
+   */
+  inline bank::bits mask() const { return mask_; }
+
+ private:
+  /**
+   * Pins of the devices
+   */
+  bank::bits mask_;
+  /**
+   * Pins of the devices with low active state
+   */
+  bank::bits inverted_;
+};
+
+/**
+ * @brief Batched writes of output devices of GPIO bank 0.
+ *
+ * Collects levels and writes them with gpioWrite_Bits_0_31_Set and
+ * gpioWrite_Bits_0_31_Clear on commit(), so every pin that is set (or
+ * cleared) changes in a single register write. Devices outside bank 0 are
+ * written right away.
+ *
+ * Lives on the stack and does not allocate, so it can be used in the step
+ * loop
+ */
+class DigitalOutputBatch : public StackObj {
+ public:
+  /**
+   * DigitalOutputBatch Constructor
+   */
+  DigitalOutputBatch();
+  /**
+   * Queue level of output device
+   *
+   * @param device output device
+   * @param level  HIGH/LOW
+   *
+   * @return ATM_OK or ATM_ERR if the device is not active
+   */
+  ATM_STATUS write(const std::shared_ptr<DigitalOutputDevice>& device,
+                   const digital::value&                       level);
+  /**
+   * Write queued levels and clear the batch
+   *
+   * @return ATM_OK or ATM_ERR, but not both
+   */
+  ATM_STATUS commit();
+  /**
+   * Check whether any level is queued or not
+   *
+   * @return true if nothing is queued
+   */
+  inline bool empty() const { return set_ == 0 && clear_ == 0; }
+
+ private:
+  /**
+   * Pins to set
+   */
+  bank::bits set_;
+  /**
+   * Pins to clear
+   */
+  bank::bits clear_;
+};
+}  // namespace device
+
+NAMESPACE_END
+
+#endif  // LIB_DEVICE_BANK_HPP_
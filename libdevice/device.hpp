@@ -48,7 +48,14 @@
 #include "digital.inline.hpp"
 #include "pwm.hpp"
 
+#include "bank.hpp"
+
+#include "alert.hpp"
+
 // 4.3. Stepper Device
+#include "jitter.hpp"
+#include "wave.hpp"
+
 #include "stepper.hpp"
 #include "stepper.inline.hpp"
 
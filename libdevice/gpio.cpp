@@ -4,6 +4,104 @@
 
 #ifdef MOCK_GPIO
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <libutil/util.hpp>
+
+namespace {
+/**
+ * Mocked waveform, pulses are already merged
+ */
+struct mock_wave {
+  std::vector<gpioPulse_t> pulses;
+  time_unit                length;
+};
+
+std::mutex                              wave_mutex;
+std::vector<gpioPulse_t>                wave_pending;
+std::unordered_map<unsigned, mock_wave> wave_container;
+std::deque<unsigned>                    wave_tx_queue;
+time_unit                               wave_tx_start = 0;
+unsigned                                wave_next_id = 0;
+std::vector<gpioPulse_t>                wave_record;
+
+/**
+ * Mocked alert function
+ */
+struct mock_alert {
+  gpioAlertFuncEx_t func;
+  void*             userdata;
+};
+
+std::array<std::atomic<int>, PI_MAX_GPIO + 1> gpio_level{};
+std::atomic<uint64_t>                          gpio_accesses{0};
+
+std::mutex        spi_mutex;
+std::vector<char> spi_record;
+std::mutex                                     alert_mutex;
+std::array<mock_alert, PI_MAX_USER_GPIO + 1>   alert_container{};
+
+time_unit wave_length(const std::vector<gpioPulse_t>& pulses) {
+  time_unit length = 0;
+  for (const auto& pulse : pulses) {
+    length += pulse.usDelay;
+  }
+  return length;
+}
+
+// merge pulses by their timestamp the same way PIGPIO does
+void wave_merge(const gpioPulse_t* pulses, unsigned num_pulses) {
+  std::map<time_unit, std::pair<uint32_t, uint32_t>> edges;
+  time_unit                                          end = 0;
+
+  const auto add = [&edges, &end](const gpioPulse_t* p, std::size_t size) {
+    time_unit tick = 0;
+    for (std::size_t i = 0; i < size; ++i) {
+      auto& edge = edges[tick];
+      edge.first |= p[i].gpioOn;
+      edge.second |= p[i].gpioOff;
+      tick += p[i].usDelay;
+    }
+    end = std::max(end, tick);
+  };
+
+  add(wave_pending.data(), wave_pending.size());
+  add(pulses, num_pulses);
+
+  wave_pending.clear();
+  for (auto it = edges.begin(); it != edges.end(); ++it) {
+    auto      next = std::next(it);
+    time_unit until = (next == edges.end()) ? end : next->first;
+    wave_pending.push_back({it->second.first, it->second.second,
+                            static_cast<uint32_t>(until - it->first)});
+  }
+}
+
+// pop every wave that should have been finished by now
+void wave_tx_advance() {
+  const time_unit now = micros();
+  while (!wave_tx_queue.empty()) {
+    const auto it = wave_container.find(wave_tx_queue.front());
+    if (it != wave_container.end() &&
+        now - wave_tx_start < it->second.length) {
+      break;
+    }
+    if (it != wave_container.end()) {
+      wave_tx_start += it->second.length;
+    }
+    wave_tx_queue.pop_front();
+  }
+}
+}  // namespace
+
 // General
 int gpioInitialise(void) {
   return PI_OK;
@@ -11,16 +109,113 @@ int gpioInitialise(void) {
 
 void gpioTerminate(void) {}
 
+uint32_t gpioTick(void) {
+  return static_cast<uint32_t>(micros());
+}
+
 // Digital
 int gpioSetMode([[maybe_unused]] int gpio, [[maybe_unused]] int mode) {
   return PI_OK;
 }
 
-int gpioRead([[maybe_unused]] int gpio) {
+int gpioRead(int gpio) {
+  if (gpio < 0 || gpio > PI_MAX_GPIO) {
+    return PI_BAD_GPIO;
+  }
+  gpio_accesses.fetch_add(1, std::memory_order_relaxed);
+  return gpio_level[static_cast<std::size_t>(gpio)].load(
+      std::memory_order_relaxed);
+}
+
+int gpioWrite(int gpio, int level) {
+  if (gpio < 0 || gpio > PI_MAX_GPIO) {
+    return PI_BAD_GPIO;
+  }
+  gpio_accesses.fetch_add(1, std::memory_order_relaxed);
+  gpio_level[static_cast<std::size_t>(gpio)].store(
+      level ? PI_HIGH : PI_LOW, std::memory_order_relaxed);
   return PI_OK;
 }
 
-int gpioWrite([[maybe_unused]] int gpio, [[maybe_unused]] int level) {
+// Bank 0
+uint32_t gpioRead_Bits_0_31(void) {
+  gpio_accesses.fetch_add(1, std::memory_order_relaxed);
+  uint32_t bits = 0;
+  for (unsigned gpio = 0; gpio <= PI_MAX_USER_GPIO; ++gpio) {
+    if (gpio_level[gpio].load(std::memory_order_relaxed) != PI_LOW) {
+      bits |= static_cast<uint32_t>(1) << gpio;
+    }
+  }
+  return bits;
+}
+
+int gpioWrite_Bits_0_31_Clear(uint32_t bits) {
+  gpio_accesses.fetch_add(1, std::memory_order_relaxed);
+  for (; bits != 0; bits &= bits - 1) {
+    gpio_level[static_cast<std::size_t>(std::countr_zero(bits))].store(
+        PI_LOW, std::memory_order_relaxed);
+  }
+  return PI_OK;
+}
+
+int gpioWrite_Bits_0_31_Set(uint32_t bits) {
+  gpio_accesses.fetch_add(1, std::memory_order_relaxed);
+  for (; bits != 0; bits &= bits - 1) {
+    gpio_level[static_cast<std::size_t>(std::countr_zero(bits))].store(
+        PI_HIGH, std::memory_order_relaxed);
+  }
+  return PI_OK;
+}
+
+uint64_t gpioMockAccesses(void) {
+  return gpio_accesses.load(std::memory_order_relaxed);
+}
+
+// Alert
+int gpioSetAlertFuncEx(unsigned          user_gpio,
+                       gpioAlertFuncEx_t f,
+                       void*             userdata) {
+  if (user_gpio > PI_MAX_USER_GPIO) {
+    return PI_BAD_USER_GPIO;
+  }
+  std::lock_guard<std::mutex> lock(alert_mutex);
+  alert_container[user_gpio] = {f, userdata};
+  return PI_OK;
+}
+
+int gpioGlitchFilter(unsigned user_gpio, [[maybe_unused]] unsigned steady) {
+  if (user_gpio > PI_MAX_USER_GPIO) {
+    return PI_BAD_USER_GPIO;
+  }
+  return PI_OK;
+}
+
+// Edge source
+int gpioMockEdge(unsigned gpio, unsigned level) {
+  if (gpio > PI_MAX_GPIO) {
+    return PI_BAD_GPIO;
+  }
+
+  const int value = level ? PI_HIGH : PI_LOW;
+  if (gpio_level[gpio].exchange(value, std::memory_order_relaxed) == value) {
+    // no edge
+    return PI_OK;
+  }
+
+  if (gpio > PI_MAX_USER_GPIO) {
+    return PI_OK;
+  }
+
+  mock_alert alert;
+  {
+    std::lock_guard<std::mutex> lock(alert_mutex);
+    alert = alert_container[gpio];
+  }
+
+  if (alert.func != nullptr) {
+    alert.func(static_cast<int>(gpio), value, gpioTick(), alert.userdata);
+  }
+
   return PI_OK;
 }
 
@@ -56,6 +251,35 @@ int i2cReadByte([[maybe_unused]] unsigned int handle) {
   return PI_OK;
 }
 
+int spiOpen(unsigned int spiChan,
+            [[maybe_unused]] unsigned int baud,
+            [[maybe_unused]] unsigned int spiFlags) {
+  if (spiChan > 2) {
+    return PI_BAD_SPI_CHANNEL;
+  }
+  return static_cast<int>(spiChan);
+}
+
+int spiClose([[maybe_unused]] unsigned int handle) {
+  return PI_OK;
+}
+
+int spiWrite([[maybe_unused]] unsigned int handle,
+             char*                         buf,
+             unsigned int                  count) {
+  gpio_accesses.fetch_add(1, std::memory_order_relaxed);
+  std::lock_guard<std::mutex> lock(spi_mutex);
+  spi_record.assign(buf, buf + count);
+  return static_cast<int>(count);
+}
+
+int gpioMockSpiRecord(char* buf, unsigned int count) {
+  std::lock_guard<std::mutex> lock(spi_mutex);
+  const auto size = std::min<std::size_t>(count, spi_record.size());
+  std::copy_n(spi_record.begin(), size, buf);
+  return static_cast<int>(spi_record.size());
+}
+
 // PWM
 
 int gpioPWM([[maybe_unused]] unsigned int user_gpio,
@@ -100,4 +324,127 @@ int gpioSetPullUpDown([[maybe_unused]] unsigned gpio,
   return PI_OK;
 }
 
+// Waveform
+int gpioWaveClear(void) {
+  std::lock_guard<std::mutex> lock(wave_mutex);
+  wave_pending.clear();
+  wave_container.clear();
+  wave_tx_queue.clear();
+  return PI_OK;
+}
+
+int gpioWaveAddNew(void) {
+  std::lock_guard<std::mutex> lock(wave_mutex);
+  wave_pending.clear();
+  return PI_OK;
+}
+
+int gpioWaveAddGeneric(unsigned numPulses, gpioPulse_t* pulses) {
+  std::lock_guard<std::mutex> lock(wave_mutex);
+  if (numPulses > 0 && pulses == nullptr) {
+    return PI_BAD_POINTER;
+  }
+  wave_merge(pulses, numPulses);
+  if (wave_pending.size() > PI_WAVE_MAX_PULSES) {
+    return PI_TOO_MANY_PULSES;
+  }
+  return static_cast<int>(wave_pending.size());
+}
+
+int gpioWaveCreate(void) {
+  std::lock_guard<std::mutex> lock(wave_mutex);
+  if (wave_pending.empty()) {
+    return PI_EMPTY_WAVEFORM;
+  }
+  const unsigned wave_id = wave_next_id++;
+  wave_container[wave_id] = {wave_pending, wave_length(wave_pending)};
+  wave_pending.clear();
+  return static_cast<int>(wave_id);
+}
+
+int gpioWaveCreatePad([[maybe_unused]] int pctCB,
+                      [[maybe_unused]] int pctBOOL,
+                      [[maybe_unused]] int pctTOOL) {
+  return gpioWaveCreate();
+}
+
+int gpioWaveDelete(unsigned wave_id) {
+  std::lock_guard<std::mutex> lock(wave_mutex);
+  if (wave_container.erase(wave_id) == 0) {
+    return PI_BAD_WAVE_ID;
+  }
+  return PI_OK;
+}
+
+int gpioWaveTxSend(unsigned wave_id, unsigned wave_mode) {
+  std::lock_guard<std::mutex> lock(wave_mutex);
+  const auto it = wave_container.find(wave_id);
+  if (it == wave_container.end()) {
+    return PI_BAD_WAVE_ID;
+  }
+  if (wave_mode > PI_WAVE_MODE_REPEAT_SYNC) {
+    return PI_BAD_WAVE_MODE;
+  }
+
+  wave_tx_advance();
+
+  // repeating waves are recorded once, it is enough for verification
+  if (wave_mode == PI_WAVE_MODE_ONE_SHOT || wave_mode == PI_WAVE_MODE_REPEAT) {
+    wave_tx_queue.clear();
+  }
+  if (wave_tx_queue.empty()) {
+    wave_tx_start = micros();
+  }
+  wave_tx_queue.push_back(wave_id);
+  wave_record.insert(wave_record.end(), it->second.pulses.begin(),
+                     it->second.pulses.end());
+
+  return static_cast<int>(it->second.pulses.size());
+}
+
+int gpioWaveTxAt(void) {
+  std::lock_guard<std::mutex> lock(wave_mutex);
+  wave_tx_advance();
+  if (wave_tx_queue.empty()) {
+    return PI_NO_TX_WAVE;
+  }
+  return static_cast<int>(wave_tx_queue.front());
+}
+
+int gpioWaveTxBusy(void) {
+  std::lock_guard<std::mutex> lock(wave_mutex);
+  wave_tx_advance();
+  return wave_tx_queue.empty() ? 0 : 1;
+}
+
+int gpioWaveTxStop(void) {
+  std::lock_guard<std::mutex> lock(wave_mutex);
+  wave_tx_queue.clear();
+  return PI_OK;
+}
+
+int gpioWaveGetMicros(void) {
+  std::lock_guard<std::mutex> lock(wave_mutex);
+  return static_cast<int>(wave_length(wave_pending));
+}
+
+// Waveform recorder
+unsigned gpioMockWaveRecordSize(void) {
+  std::lock_guard<std::mutex> lock(wave_mutex);
+  return static_cast<unsigned>(wave_record.size());
+}
+
+unsigned gpioMockWaveRecord(gpioPulse_t* pulses, unsigned numPulses) {
+  std::lock_guard<std::mutex> lock(wave_mutex);
+  const unsigned size =
+      std::min(numPulses, static_cast<unsigned>(wave_record.size()));
+  std::copy_n(wave_record.begin(), size, pulses);
+  return size;
+}
+
+void gpioMockWaveRecordClear(void) {
+  std::lock_guard<std::mutex> lock(wave_mutex);
+  wave_record.clear();
+}
+
 #endif  // MOCK_GPIO
@@ -43,6 +43,8 @@ using PI_PUD = int;
 // credits to @joan2937
 // https://github.com/joan2937/pigpio/blob/master/pigpio.h
 
+#include <cstdint>
+
 #define PI_INIT_FAILED -1        // gpioInitialise failed
 #define PI_BAD_USER_GPIO -2      // GPIO not 0-31
 #define PI_BAD_GPIO -3           // GPIO not 0-53
@@ -223,15 +225,62 @@ using PI_PUD = int;
 #define PI_PUD_DOWN 1
 #define PI_PUD_UP 2
 
+/* wave_mode: 0-3 */
+
+#define PI_WAVE_MODE_ONE_SHOT 0
+#define PI_WAVE_MODE_REPEAT 1
+#define PI_WAVE_MODE_ONE_SHOT_SYNC 2
+#define PI_WAVE_MODE_REPEAT_SYNC 3
+
+#define PI_WAVE_NOT_FOUND 9998  // Transmitted wave not found
+#define PI_NO_TX_WAVE 9999      // No wave being transmitted
+
+#define PI_WAVE_MAX_PULSES 12000
+
+#define PI_MAX_GPIO 53
+#define PI_MAX_USER_GPIO 31
+
+#define PI_TIMEOUT 2
+
+typedef struct {
+  uint32_t gpioOn;
+  uint32_t gpioOff;
+  uint32_t usDelay;
+} gpioPulse_t;
+
+typedef void (*gpioAlertFuncEx_t)(int      gpio,
+                                  int      level,
+                                  uint32_t tick,
+                                  void*    userdata);
+
 // General
-int  gpioInitialise(void);
-void gpioTerminate(void);
+int      gpioInitialise(void);
+void     gpioTerminate(void);
+uint32_t gpioTick(void);
 
 // Digital
 int gpioSetMode(int gpio, int mode);
 int gpioRead(int gpio);
 int gpioWrite(int gpio, int level);
 
+// Bank 0 (GPIO 0-31)
+uint32_t gpioRead_Bits_0_31(void);
+int      gpioWrite_Bits_0_31_Clear(uint32_t bits);
+int      gpioWrite_Bits_0_31_Set(uint32_t bits);
+
+// Register accesses (mock only, not part of PIGPIO)
+// number of level reads and writes, every bank call counts as one
+uint64_t gpioMockAccesses(void);
+
+// Alert
+int gpioSetAlertFuncEx(unsigned user_gpio, gpioAlertFuncEx_t f, void* userdata);
+int gpioGlitchFilter(unsigned user_gpio, unsigned steady);
+
+// Edge source (mock only, not part of PIGPIO)
+// drive level of input pin from outside, alert function is called on the
+// calling thread if the level changes
+int gpioMockEdge(unsigned gpio, unsigned level);
+
 // SPI
 int i2cOpen(unsigned int i2cBus, unsigned int i2cAddr, unsigned int i2cFlags);
 int i2cClose(unsigned int handle);
@@ -242,6 +291,14 @@ int i2cReadDevice(unsigned int handle, char* buf, unsigned int count);
 int i2cWriteByte(unsigned int handle, unsigned int bVal);
 int i2cReadByte(unsigned int handle);
 
+int spiOpen(unsigned int spiChan, unsigned int baud, unsigned int spiFlags);
+int spiClose(unsigned int handle);
+int spiWrite(unsigned int handle, char* buf, unsigned int count);
+
+// SPI record (mock only, not part of PIGPIO)
+// copy last written SPI transaction, returns its size
+int gpioMockSpiRecord(char* buf, unsigned int count);
+
 // PWM
 int gpioPWM(unsigned int user_gpio, unsigned int dutycycle);
 int gpioGetPWMdutycycle(unsigned int user_gpio);
@@ -256,6 +313,25 @@ int gpioHardwarePWM(unsigned int gpio,
 
 int gpioSetPullUpDown(unsigned gpio, unsigned pud);
 
+// Waveform
+int gpioWaveClear(void);
+int gpioWaveAddNew(void);
+int gpioWaveAddGeneric(unsigned numPulses, gpioPulse_t* pulses);
+int gpioWaveCreate(void);
+int gpioWaveCreatePad(int pctCB, int pctBOOL, int pctTOOL);
+int gpioWaveDelete(unsigned wave_id);
+int gpioWaveTxSend(unsigned wave_id, unsigned wave_mode);
+int gpioWaveTxAt(void);
+int gpioWaveTxBusy(void);
+int gpioWaveTxStop(void);
+int gpioWaveGetMicros(void);
+
+// Waveform recorder (mock only, not part of PIGPIO)
+// every transmitted wave is appended here in transmission order
+unsigned gpioMockWaveRecordSize(void);
+unsigned gpioMockWaveRecord(gpioPulse_t* pulses, unsigned numPulses);
+void     gpioMockWaveRecordClear(void);
+
 #else
 
 #include <pigpio.h>
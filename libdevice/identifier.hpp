@@ -4,10 +4,16 @@
 /** @file identifier.hpp
  *  @brief Devices Registry Instance IDs
  *
- *  Devices Registry Instance IDs
+ *  Devices Registry Instance IDs and compile-time keys
  */
+#include <libalgo/algo.hpp>
 #include <libcore/core.hpp>
 
+#include "digital.hpp"
+#include "float.hpp"
+#include "pwm.hpp"
+#include "stepper.hpp"
+
 NAMESPACE_BEGIN
 
 namespace device {
@@ -15,7 +21,7 @@ namespace id {
 // extern std::string   analog_;
 // static auto          analog = []() {
 //   if (analog_.empty()) {
-//     analog_ = Config::get()->analog<std::string>("key");
+//     analog_ = Config::get()->analog().key;
 //   }
 //   return analog_;
 // };
@@ -24,7 +30,7 @@ namespace stepper {
 extern std::string x_;
 static auto        x = []() {
   if (x_.empty()) {
-    x_ = Config::get()->stepper_x<std::string>("key");
+    x_ = Config::get()->stepper_x().key;
   }
   return x_;
 };
@@ -32,7 +38,7 @@ static auto        x = []() {
 extern std::string y_;
 static auto        y = []() {
   if (y_.empty()) {
-    y_ = Config::get()->stepper_y<std::string>("key");
+    y_ = Config::get()->stepper_y().key;
   }
   return y_;
 };
@@ -40,7 +46,7 @@ static auto        y = []() {
 extern std::string z_;
 static auto        z = []() {
   if (z_.empty()) {
-    z_ = Config::get()->stepper_z<std::string>("key");
+    z_ = Config::get()->stepper_z().key;
   }
   return z_;
 };
@@ -50,7 +56,7 @@ namespace limit_switch {
 extern std::string x_;
 static auto        x = []() {
   if (x_.empty()) {
-    x_ = Config::get()->limit_switch_x<std::string>("key");
+    x_ = Config::get()->limit_switch_x().key;
   }
   return x_;
 };
@@ -58,7 +64,7 @@ static auto        x = []() {
 extern std::string y_;
 static auto        y = []() {
   if (y_.empty()) {
-    y_ = Config::get()->limit_switch_y<std::string>("key");
+    y_ = Config::get()->limit_switch_y().key;
   }
   return y_;
 };
@@ -67,7 +73,7 @@ static auto        y = []() {
 extern std::string z1_;
 static auto        z1 = []() {
   if (z1_.empty()) {
-    z1_ = Config::get()->limit_switch_z1<std::string>("key");
+    z1_ = Config::get()->limit_switch_z1().key;
   }
   return z1_;
 };
@@ -76,7 +82,7 @@ static auto        z1 = []() {
 extern std::string z2_;
 static auto        z2 = []() {
   if (z2_.empty()) {
-    z2_ = Config::get()->limit_switch_z2<std::string>("key");
+    z2_ = Config::get()->limit_switch_z2().key;
   }
   return z2_;
 };
@@ -85,8 +91,7 @@ static auto        z2 = []() {
 extern std::string finger_protection_;
 static auto        finger_protection = []() {
   if (finger_protection_.empty()) {
-    finger_protection_ =
-        Config::get()->limit_switch_finger_protection<std::string>("key");
+    finger_protection_ = Config::get()->limit_switch_finger_protection().key;
   }
   return finger_protection_;
 };
@@ -95,7 +100,7 @@ static auto        finger_protection = []() {
 extern std::string spray_;
 static auto        spray = []() {
   if (spray_.empty()) {
-    spray_ = Config::get()->shift_register<std::string>("spray", "key");
+    spray_ = Config::get()->shift_register().spray.key;
   }
   return spray_;
 };
@@ -103,7 +108,7 @@ static auto        spray = []() {
 extern std::string finger_;
 static auto        finger = []() {
   if (finger_.empty()) {
-    finger_ = Config::get()->finger<std::string>("key");
+    finger_ = Config::get()->finger().key;
   }
   return finger_;
 };
@@ -111,7 +116,7 @@ static auto        finger = []() {
 extern std::string finger_brake_;
 static auto        finger_brake = []() {
   if (finger_brake_.empty()) {
-    finger_brake_ = Config::get()->finger_brake<std::string>("key");
+    finger_brake_ = Config::get()->finger_brake().key;
   }
   return finger_brake_;
 };
@@ -119,7 +124,7 @@ static auto        finger_brake = []() {
 extern std::string finger_infrared_;
 static auto        finger_infrared = []() {
   if (finger_infrared_.empty()) {
-    finger_infrared_ = Config::get()->finger_infrared<std::string>("key");
+    finger_infrared_ = Config::get()->finger_infrared().key;
   }
   return finger_infrared_;
 };
@@ -127,7 +132,7 @@ static auto        finger_infrared = []() {
 extern std::string sonicator_relay_;
 static auto        sonicator_relay = []() {
   if (sonicator_relay_.empty()) {
-    sonicator_relay_ = Config::get()->sonicator_relay<std::string>("key");
+    sonicator_relay_ = Config::get()->sonicator_relay().key;
   }
   return sonicator_relay_;
 };
@@ -136,7 +141,7 @@ namespace ultrasonic {
 extern std::string water_level_;
 static auto        water_level = []() {
   if (water_level_.empty()) {
-    water_level_ = Config::get()->ultrasonic<std::string>("water-level", "key");
+    water_level_ = Config::get()->ultrasonic().water_level.key;
   }
   return water_level_;
 };
@@ -144,8 +149,7 @@ static auto        water_level = []() {
 extern std::string disinfectant_level_;
 static auto        disinfectant_level = []() {
   if (disinfectant_level_.empty()) {
-    disinfectant_level_ =
-        Config::get()->ultrasonic<std::string>("disinfectant-level", "key");
+    disinfectant_level_ = Config::get()->ultrasonic().disinfectant_level.key;
   }
   return disinfectant_level_;
 };
@@ -156,8 +160,7 @@ namespace float_sensor {
 extern std::string water_level_;
 static auto        water_level = []() {
   if (water_level_.empty()) {
-    water_level_ =
-        Config::get()->float_sensor<std::string>("water-level", "key");
+    water_level_ = Config::get()->float_sensor().water_level.key;
   }
   return water_level_;
 };
@@ -165,8 +168,7 @@ static auto        water_level = []() {
 extern std::string disinfectant_level_;
 static auto        disinfectant_level = []() {
   if (disinfectant_level_.empty()) {
-    disinfectant_level_ =
-        Config::get()->float_sensor<std::string>("disinfectant-level", "key");
+    disinfectant_level_ = Config::get()->float_sensor().disinfectant_level.key;
   }
   return disinfectant_level_;
 };
@@ -179,7 +181,7 @@ extern std::string spraying_tending_height_;
 static auto        spraying_tending_height = []() {
   if (spraying_tending_height_.empty()) {
     spraying_tending_height_ =
-        Config::get()->plc_to_pi<std::string>("spraying-tending-height", "key");
+        Config::get()->plc_to_pi().spraying_tending_height.key;
   }
   return spraying_tending_height_;
 };
@@ -190,7 +192,7 @@ static auto        spraying_tending_height = []() {
 static auto spraying_height = []() {
   if (spraying_tending_height_.empty()) {
     spraying_tending_height_ =
-        Config::get()->plc_to_pi<std::string>("spraying-tending-height", "key");
+        Config::get()->plc_to_pi().spraying_tending_height.key;
   }
   return spraying_tending_height_;
 };
@@ -201,7 +203,7 @@ static auto spraying_height = []() {
 static auto tending_height = []() {
   if (spraying_tending_height_.empty()) {
     spraying_tending_height_ =
-        Config::get()->plc_to_pi<std::string>("spraying-tending-height", "key");
+        Config::get()->plc_to_pi().spraying_tending_height.key;
   }
   return spraying_tending_height_;
 };
@@ -209,8 +211,7 @@ static auto tending_height = []() {
 extern std::string cleaning_height_;
 static auto        cleaning_height = []() {
   if (cleaning_height_.empty()) {
-    cleaning_height_ =
-        Config::get()->plc_to_pi<std::string>("cleaning-height", "key");
+    cleaning_height_ = Config::get()->plc_to_pi().cleaning_height.key;
   }
   return cleaning_height_;
 };
@@ -218,7 +219,7 @@ static auto        cleaning_height = []() {
 extern std::string reset_;
 static auto        reset = []() {
   if (reset_.empty()) {
-    reset_ = Config::get()->plc_to_pi<std::string>("reset", "key");
+    reset_ = Config::get()->plc_to_pi().reset.key;
   }
   return reset_;
 };
@@ -226,7 +227,7 @@ static auto        reset = []() {
 extern std::string e_stop_;
 static auto        e_stop = []() {
   if (e_stop_.empty()) {
-    e_stop_ = Config::get()->plc_to_pi<std::string>("e-stop", "key");
+    e_stop_ = Config::get()->plc_to_pi().e_stop.key;
   }
   return e_stop_;
 };
@@ -237,8 +238,7 @@ namespace pi {
 extern std::string tending_ready_;
 static auto        tending_ready = []() {
   if (tending_ready_.empty()) {
-    tending_ready_ =
-        Config::get()->shift_register<std::string>("tending-ready", "key");
+    tending_ready_ = Config::get()->shift_register().tending_ready.key;
   }
   return tending_ready_;
 };
@@ -246,8 +246,7 @@ static auto        tending_ready = []() {
 extern std::string spraying_ready_;
 static auto        spraying_ready = []() {
   if (spraying_ready_.empty()) {
-    spraying_ready_ =
-        Config::get()->shift_register<std::string>("spraying-ready", "key");
+    spraying_ready_ = Config::get()->shift_register().spraying_ready.key;
   }
   return spraying_ready_;
 };
@@ -255,8 +254,7 @@ static auto        spraying_ready = []() {
 extern std::string tending_running_;
 static auto        tending_running = []() {
   if (tending_running_.empty()) {
-    tending_running_ =
-        Config::get()->shift_register<std::string>("tending-running", "key");
+    tending_running_ = Config::get()->shift_register().tending_running.key;
   }
   return tending_running_;
 };
@@ -264,8 +262,7 @@ static auto        tending_running = []() {
 extern std::string spraying_running_;
 static auto        spraying_running = []() {
   if (spraying_running_.empty()) {
-    spraying_running_ =
-        Config::get()->shift_register<std::string>("spraying-running", "key");
+    spraying_running_ = Config::get()->shift_register().spraying_running.key;
   }
   return spraying_running_;
 };
@@ -273,8 +270,7 @@ static auto        spraying_running = []() {
 extern std::string tending_complete_;
 static auto        tending_complete = []() {
   if (tending_complete_.empty()) {
-    tending_complete_ =
-        Config::get()->shift_register<std::string>("tending-complete", "key");
+    tending_complete_ = Config::get()->shift_register().tending_complete.key;
   }
   return tending_complete_;
 };
@@ -282,8 +278,7 @@ static auto        tending_complete = []() {
 extern std::string spraying_complete_;
 static auto        spraying_complete = []() {
   if (spraying_complete_.empty()) {
-    spraying_complete_ =
-        Config::get()->shift_register<std::string>("spraying-complete", "key");
+    spraying_complete_ = Config::get()->shift_register().spraying_complete.key;
   }
   return spraying_complete_;
 };
@@ -292,7 +287,7 @@ static auto        spraying_complete = []() {
 extern std::string water_in_;
 static auto        water_in = []() {
   if (water_in_.empty()) {
-    water_in_ = Config::get()->shift_register<std::string>("water-in", "key");
+    water_in_ = Config::get()->shift_register().water_in.key;
   }
   return water_in_;
 };
@@ -300,7 +295,7 @@ static auto        water_in = []() {
 extern std::string water_out_;
 static auto        water_out = []() {
   if (water_out_.empty()) {
-    water_out_ = Config::get()->shift_register<std::string>("water-out", "key");
+    water_out_ = Config::get()->shift_register().water_out.key;
   }
   return water_out_;
 };
@@ -308,8 +303,7 @@ static auto        water_out = []() {
 extern std::string disinfectant_in_;
 static auto        disinfectant_in = []() {
   if (disinfectant_in_.empty()) {
-    disinfectant_in_ =
-        Config::get()->shift_register<std::string>("disinfectant-in", "key");
+    disinfectant_in_ = Config::get()->shift_register().disinfectant_in.key;
   }
   return disinfectant_in_;
 };
@@ -317,8 +311,7 @@ static auto        disinfectant_in = []() {
 extern std::string disinfectant_out_;
 static auto        disinfectant_out = []() {
   if (disinfectant_out_.empty()) {
-    disinfectant_out_ =
-        Config::get()->shift_register<std::string>("disinfectant-out", "key");
+    disinfectant_out_ = Config::get()->shift_register().disinfectant_out.key;
   }
   return disinfectant_out_;
 };
@@ -326,14 +319,56 @@ static auto        disinfectant_out = []() {
 extern std::string sonicator_relay_;
 static auto        sonicator_relay = []() {
   if (sonicator_relay_.empty()) {
-    sonicator_relay_ =
-        Config::get()->shift_register<std::string>("sonicator-relay", "key");
+    sonicator_relay_ = Config::get()->shift_register().sonicator_relay.key;
   }
   return sonicator_relay_;
 };
 }  // namespace pi
 }  // namespace comm
 }  // namespace id
+
+/**
+ * Compile-time keys of well-known devices
+ *
+ * Bound on creation in initialize_device(), so hot paths get the device
+ * without copying and hashing its id
+ */
+namespace key {
+namespace stepper {
+constexpr algo::registry::key<StepperDevice> x{0};
+constexpr algo::registry::key<StepperDevice> y{1};
+constexpr algo::registry::key<StepperDevice> z{2};
+}  // namespace stepper
+
+namespace limit_switch {
+constexpr algo::registry::key<DigitalInputDevice> x{0};
+constexpr algo::registry::key<DigitalInputDevice> y{1};
+// upper bound
+constexpr algo::registry::key<DigitalInputDevice> z1{2};
+// lower bound
+constexpr algo::registry::key<DigitalInputDevice> z2{3};
+constexpr algo::registry::key<DigitalInputDevice> finger_protection{4};
+}  // namespace limit_switch
+
+namespace comm {
+namespace plc {
+constexpr algo::registry::key<DigitalInputDevice> spraying_tending_height{5};
+constexpr algo::registry::key<DigitalInputDevice> cleaning_height{6};
+constexpr algo::registry::key<DigitalInputDevice> reset{7};
+constexpr algo::registry::key<DigitalInputDevice> e_stop{8};
+}  // namespace plc
+}  // namespace comm
+
+constexpr algo::registry::key<DigitalInputDevice>  finger_infrared{9};
+constexpr algo::registry::key<DigitalOutputDevice> finger_brake{0};
+constexpr algo::registry::key<DigitalOutputDevice> sonicator_relay{1};
+constexpr algo::registry::key<PWMDevice>           finger{0};
+
+namespace float_sensor {
+constexpr algo::registry::key<FloatDevice> water_level{0};
+constexpr algo::registry::key<FloatDevice> disinfectant_level{1};
+}  // namespace float_sensor
+}  // namespace key
 }  // namespace device
 
 NAMESPACE_END
@@ -13,6 +13,7 @@
 #include "PCF8591.hpp"
 
 #include "shift_register.hpp"
+#include "wave.hpp"
 
 NAMESPACE_BEGIN
 
@@ -57,32 +58,35 @@ static ATM_STATUS initialize_plc_to_pi_comm() {
   auto* digital_input_registry = DigitalInputDeviceRegistry::get();
 
   status = digital_input_registry->create(
+      key::comm::plc::spraying_tending_height,
       id::comm::plc::spraying_tending_height(),
-      config->plc_to_pi<PI_PIN>("spraying-tending-height", "pin"),
-      config->plc_to_pi<bool>("spraying-tending-height", "active-state"),
+      config->plc_to_pi().spraying_tending_height.pin,
+      config->plc_to_pi().spraying_tending_height.active_state,
       PI_PUD_DOWN);
   if (status == ATM_ERR) {
     return status;
   }
 
   status = digital_input_registry->create(
-      id::comm::plc::cleaning_height(),
-      config->plc_to_pi<PI_PIN>("cleaning-height", "pin"),
-      config->plc_to_pi<bool>("cleaning-height", "active-state"), PI_PUD_DOWN);
+      key::comm::plc::cleaning_height, id::comm::plc::cleaning_height(),
+      config->plc_to_pi().cleaning_height.pin,
+      config->plc_to_pi().cleaning_height.active_state, PI_PUD_DOWN);
   if (status == ATM_ERR) {
     return status;
   }
 
   status = digital_input_registry->create(
-      id::comm::plc::reset(), config->plc_to_pi<PI_PIN>("reset", "pin"),
-      config->plc_to_pi<bool>("reset", "active-state"), PI_PUD_DOWN);
+      key::comm::plc::reset, id::comm::plc::reset(),
+      config->plc_to_pi().reset.pin,
+      config->plc_to_pi().reset.active_state, PI_PUD_DOWN);
   if (status == ATM_ERR) {
     return status;
   }
 
   status = digital_input_registry->create(
-      id::comm::plc::e_stop(), config->plc_to_pi<PI_PIN>("e-stop", "pin"),
-      config->plc_to_pi<bool>("e-stop", "active-state"), PI_PUD_DOWN);
+      key::comm::plc::e_stop, id::comm::plc::e_stop(),
+      config->plc_to_pi().e_stop.pin,
+      config->plc_to_pi().e_stop.active_state, PI_PUD_DOWN);
   if (status == ATM_ERR) {
     return status;
   }
@@ -98,37 +102,42 @@ static ATM_STATUS initialize_limit_switches() {
   auto* digital_input_registry = DigitalInputDeviceRegistry::get();
 
   status = digital_input_registry->create(
-      id::limit_switch::x(), config->limit_switch_x<PI_PIN>("pin"),
-      config->limit_switch_x<bool>("active-state"), PI_PUD_UP);
+      key::limit_switch::x, id::limit_switch::x(),
+      config->limit_switch_x().pin,
+      config->limit_switch_x().active_state, PI_PUD_UP);
   if (status == ATM_ERR) {
     return status;
   }
 
   status = digital_input_registry->create(
-      id::limit_switch::y(), config->limit_switch_y<PI_PIN>("pin"),
-      config->limit_switch_y<bool>("active-state"), PI_PUD_UP);
+      key::limit_switch::y, id::limit_switch::y(),
+      config->limit_switch_y().pin,
+      config->limit_switch_y().active_state, PI_PUD_UP);
   if (status == ATM_ERR) {
     return status;
   }
 
   status = digital_input_registry->create(
-      id::limit_switch::z1(), config->limit_switch_z1<PI_PIN>("pin"),
-      config->limit_switch_z1<bool>("active-state"), PI_PUD_UP);
+      key::limit_switch::z1, id::limit_switch::z1(),
+      config->limit_switch_z1().pin,
+      config->limit_switch_z1().active_state, PI_PUD_UP);
   if (status == ATM_ERR) {
     return status;
   }
 
   status = digital_input_registry->create(
-      id::limit_switch::z2(), config->limit_switch_z2<PI_PIN>("pin"),
-      config->limit_switch_z2<bool>("active-state"), PI_PUD_UP);
+      key::limit_switch::z2, id::limit_switch::z2(),
+      config->limit_switch_z2().pin,
+      config->limit_switch_z2().active_state, PI_PUD_UP);
   if (status == ATM_ERR) {
     return status;
   }
 
   status = digital_input_registry->create(
+      key::limit_switch::finger_protection,
       id::limit_switch::finger_protection(),
-      config->limit_switch_finger_protection<PI_PIN>("pin"),
-      config->limit_switch_finger_protection<bool>("active-state"), PI_PUD_UP);
+      config->limit_switch_finger_protection().pin,
+      config->limit_switch_finger_protection().active_state, PI_PUD_UP);
   if (status == ATM_ERR) {
     return status;
   }
@@ -145,6 +154,11 @@ static ATM_STATUS initialize_input_digital_devices() {
     return status;
   }
 
+  status = InputAlert::create();
+  if (status == ATM_ERR) {
+    return status;
+  }
+
   status = initialize_limit_switches();
   if (status == ATM_ERR) {
     return status;
@@ -158,9 +172,9 @@ static ATM_STATUS initialize_input_digital_devices() {
   // initialize IR
   auto* digital_input_registry = DigitalInputDeviceRegistry::get();
   status = digital_input_registry->create(
-      id::finger_infrared(),
-      config->finger_infrared<PI_PIN>("pin"),
-      config->finger_infrared<bool>("active-state"), PI_PUD_UP);
+      key::finger_infrared, id::finger_infrared(),
+      config->finger_infrared().pin,
+      config->finger_infrared().active_state, PI_PUD_UP);
   if (status == ATM_ERR) {
     return status;
   }
@@ -181,15 +195,16 @@ static ATM_STATUS initialize_output_digital_devices() {
 
   // initialize finger brake
   status = digital_output_registry->create(
-      id::finger_brake(), config->finger_brake<PI_PIN>("pin"),
-      config->finger_brake<bool>("active-state"), PI_PUD_DOWN);
+      key::finger_brake, id::finger_brake(),
+      config->finger_brake().pin,
+      config->finger_brake().active_state, PI_PUD_DOWN);
 
   if (status == ATM_ERR) {
       return status;
   }
 
   // initialize sonicator relay
-  status = digital_output_registry->create(id::sonicator_relay(), config->sonicator_relay<PI_PIN>("pin"), config->sonicator_relay<bool>("active-state"), PI_PUD_DOWN);
+  status = digital_output_registry->create(key::sonicator_relay, id::sonicator_relay(), config->sonicator_relay().pin, config->sonicator_relay().active_state, PI_PUD_DOWN);
  
   return status;
 }
@@ -207,40 +222,40 @@ static ATM_STATUS initialize_pi_to_plc_comm() {
   // PI to Cleaning Station
   status = shift_register->assign(
       id::comm::pi::water_in(),
-      config->shift_register<byte>("water-in", "address"),
-      config->shift_register<bool>("water-in", "active-state"));
+      config->shift_register().water_in.address,
+      config->shift_register().water_in.active_state);
   if (status == ATM_ERR) {
     return status;
   }
 
   status = shift_register->assign(
       id::comm::pi::water_out(),
-      config->shift_register<byte>("water-out", "address"),
-      config->shift_register<bool>("water-out", "active-state"));
+      config->shift_register().water_out.address,
+      config->shift_register().water_out.active_state);
   if (status == ATM_ERR) {
     return status;
   }
 
   status = shift_register->assign(
       id::comm::pi::disinfectant_in(),
-      config->shift_register<byte>("disinfectant-in", "address"),
-      config->shift_register<bool>("disinfectant-in", "active-state"));
+      config->shift_register().disinfectant_in.address,
+      config->shift_register().disinfectant_in.active_state);
   if (status == ATM_ERR) {
     return status;
   }
 
   status = shift_register->assign(
       id::comm::pi::disinfectant_out(),
-      config->shift_register<byte>("disinfectant-out", "address"),
-      config->shift_register<bool>("disinfectant-out", "active-state"));
+      config->shift_register().disinfectant_out.address,
+      config->shift_register().disinfectant_out.active_state);
   if (status == ATM_ERR) {
     return status;
   }
 
   status = shift_register->assign(
       id::comm::pi::sonicator_relay(),
-      config->shift_register<byte>("sonicator-relay", "address"),
-      config->shift_register<bool>("sonicator-relay", "active-state"));
+      config->shift_register().sonicator_relay.address,
+      config->shift_register().sonicator_relay.active_state);
   if (status == ATM_ERR) {
     return status;
   }
@@ -248,55 +263,55 @@ static ATM_STATUS initialize_pi_to_plc_comm() {
   // PLC to PI
   status = shift_register->assign(
       id::comm::pi::tending_ready(),
-      config->shift_register<byte>("tending-ready", "address"),
-      config->shift_register<bool>("tending-ready", "active-state"));
+      config->shift_register().tending_ready.address,
+      config->shift_register().tending_ready.active_state);
   if (status == ATM_ERR) {
     return status;
   }
 
   status = shift_register->assign(
       id::comm::pi::spraying_ready(),
-      config->shift_register<byte>("spraying-ready", "address"),
-      config->shift_register<bool>("spraying-ready", "active-state"));
+      config->shift_register().spraying_ready.address,
+      config->shift_register().spraying_ready.active_state);
   if (status == ATM_ERR) {
     return status;
   }
 
   status = shift_register->assign(
       id::comm::pi::tending_running(),
-      config->shift_register<byte>("tending-running", "address"),
-      config->shift_register<bool>("tending-running", "active-state"));
+      config->shift_register().tending_running.address,
+      config->shift_register().tending_running.active_state);
   if (status == ATM_ERR) {
     return status;
   }
 
   status = shift_register->assign(
       id::comm::pi::spraying_running(),
-      config->shift_register<byte>("spraying-running", "address"),
-      config->shift_register<bool>("spraying-running", "active-state"));
+      config->shift_register().spraying_running.address,
+      config->shift_register().spraying_running.active_state);
   if (status == ATM_ERR) {
     return status;
   }
 
   status = shift_register->assign(
       id::comm::pi::tending_complete(),
-      config->shift_register<byte>("tending-complete", "address"),
-      config->shift_register<bool>("tending-complete", "active-state"));
+      config->shift_register().tending_complete.address,
+      config->shift_register().tending_complete.active_state);
   if (status == ATM_ERR) {
     return status;
   }
 
   status = shift_register->assign(
       id::comm::pi::spraying_complete(),
-      config->shift_register<byte>("spraying-complete", "address"),
-      config->shift_register<bool>("spraying-complete", "active-state"));
+      config->shift_register().spraying_complete.address,
+      config->shift_register().spraying_complete.active_state);
   if (status == ATM_ERR) {
     return status;
   }
 
   status = shift_register->assign(
-      id::spray(), config->shift_register<byte>("spray", "address"),
-      config->shift_register<bool>("spray", "active-state"));
+      id::spray(), config->shift_register().spray.address,
+      config->shift_register().spray.active_state);
   if (status == ATM_ERR) {
     return status;
   }
@@ -308,9 +323,14 @@ static ATM_STATUS initialize_shift_register_devices() {
   auto*      config = Config::get();
   ATM_STATUS status = ATM_OK;
 
-  status = ShiftRegister::create(config->shift_register<PI_PIN>("latch-pin"),
-                                 config->shift_register<PI_PIN>("clock-pin"),
-                                 config->shift_register<PI_PIN>("data-pin"));
+  status = ShiftRegister::create(
+      config->shift_register().latch_pin,
+      config->shift_register().clock_pin,
+      config->shift_register().data_pin,
+      shift_register::bit_order::msb, config->shift_register().backend,
+      config->shift_register().spi_channel,
+      config->shift_register().spi_baud,
+      config->shift_register().flush_period);
   if (status == ATM_ERR) {
     return status;
   }
@@ -334,13 +354,14 @@ static ATM_STATUS initialize_pwm_devices() {
 
   auto* pwm_registry = PWMDeviceRegistry::get();
 
-  status = pwm_registry->create(id::finger(), config->finger<PI_PIN>("pin"),
-                                config->finger<bool>("active-state"));
+  status = pwm_registry->create(key::finger, id::finger(),
+                                config->finger().pin,
+                                config->finger().active_state);
   if (status == ATM_ERR) {
     return status;
   }
 
-  auto&& finger = pwm_registry->get(id::finger());
+  auto&& finger = pwm_registry->get(key::finger);
 
   if (finger->write(device::digital::value::low) == ATM_ERR) {
     LOG_INFO("Cannot set finger duty cycle...");
@@ -349,71 +370,96 @@ static ATM_STATUS initialize_pwm_devices() {
   return status;
 }
 
-static ATM_STATUS initialize_stepper_devices() {
+template <class Device>
+static ATM_STATUS create_stepper_devices() {
   auto*      config = Config::get();
+  auto*      stepper_registry = StepperRegistry::get();
   ATM_STATUS status = ATM_OK;
 
-  status = StepperRegistry::create();
+  status = stepper_registry->create<Device>(
+      key::stepper::x, id::stepper::x(),
+      config->stepper_x().step_pin,
+      config->stepper_x().dir_pin,
+      config->stepper_x().enable_pin);
   if (status == ATM_ERR) {
     return status;
   }
 
-  auto* stepper_registry = StepperRegistry::get();
+  status = stepper_registry->create<Device>(
+      key::stepper::y, id::stepper::y(),
+      config->stepper_y().step_pin,
+      config->stepper_y().dir_pin,
+      config->stepper_y().enable_pin);
+  if (status == ATM_ERR) {
+    return status;
+  }
+
+  status = stepper_registry->create<Device>(
+      key::stepper::z, id::stepper::z(),
+      config->stepper_z().step_pin,
+      config->stepper_z().dir_pin,
+      config->stepper_z().enable_pin);
 
-  status = stepper_registry->create<LinearSpeedA4988Device>(
-      id::stepper::x(), config->stepper_x<PI_PIN>("step-pin"),
-      config->stepper_x<PI_PIN>("dir-pin"),
-      config->stepper_x<PI_PIN>("enable-pin"));
+  return status;
+}
+
+static ATM_STATUS initialize_stepper_devices() {
+  auto*      config = Config::get();
+  ATM_STATUS status = ATM_OK;
+
+  status = StepperRegistry::create();
   if (status == ATM_ERR) {
     return status;
   }
 
-  status = stepper_registry->create<LinearSpeedA4988Device>(
-      id::stepper::y(), config->stepper_y<PI_PIN>("step-pin"),
-      config->stepper_y<PI_PIN>("dir-pin"),
-      config->stepper_y<PI_PIN>("enable-pin"));
+  status = Wave::create(config->stepper().wave_chunk_duration);
   if (status == ATM_ERR) {
     return status;
   }
 
-  status = stepper_registry->create<LinearSpeedA4988Device>(
-      id::stepper::z(), config->stepper_z<PI_PIN>("step-pin"),
-      config->stepper_z<PI_PIN>("dir-pin"),
-      config->stepper_z<PI_PIN>("enable-pin"));
+  const auto backend = config->stepper().backend;
+
+  auto* stepper_registry = StepperRegistry::get();
+
+  if (config->stepper().speed == stepper::speed::scurve) {
+    status = create_stepper_devices<ScurveSpeedA4988Device>();
+  } else {
+    status = create_stepper_devices<LinearSpeedA4988Device>();
+  }
   if (status == ATM_ERR) {
     return status;
   }
 
   // set additional configurations
-  auto&& stepper_x = stepper_registry->get(id::stepper::x());
-  stepper_x->microsteps(config->stepper_x<const stepper::step>("microsteps"));
-  // stepper_x->rpm(config->stepper_x<double>("rpm"));
-  // stepper_x->acceleration(config->stepper_x<double>("acceleration"));
-  // stepper_x->deceleration(config->stepper_x<double>("deceleration"));
-  stepper_x->step_active_state(config->stepper_x<bool>("step-active-state"));
-  stepper_x->dir_active_state(config->stepper_x<bool>("dir-active-state"));
-  stepper_x->enable_active_state(
-      config->stepper_x<bool>("enable-active-state"));
-
-  auto&& stepper_y = stepper_registry->get(id::stepper::y());
-  stepper_y->microsteps(config->stepper_y<const stepper::step>("microsteps"));
-  // stepper_y->rpm(config->stepper_y<double>("rpm"));
-  // stepper_y->acceleration(config->stepper_y<double>("acceleration"));
-  // stepper_y->deceleration(config->stepper_y<double>("deceleration"));
-  stepper_y->step_active_state(config->stepper_y<bool>("step-active-state"));
-  stepper_y->dir_active_state(config->stepper_y<bool>("dir-active-state"));
-  stepper_y->enable_active_state(
-      config->stepper_y<bool>("enable-active-state"));
-
-  auto&& stepper_z = stepper_registry->get(id::stepper::z());
-  stepper_z->microsteps(config->stepper_z<const stepper::step>("microsteps"));
-  // stepper_z->rpm(config->stepper_z<double>("rpm"));
-  // stepper_z->acceleration(config->stepper_z<double>("acceleration"));
-  // stepper_z->deceleration(config->stepper_z<double>("deceleration"));
-  stepper_z->step_active_state(config->stepper_z<bool>("step-active-state"));
-  stepper_z->dir_active_state(config->stepper_z<bool>("dir-active-state"));
-  stepper_z->enable_active_state(
-      config->stepper_z<bool>("enable-active-state"));
+  auto&& stepper_x = stepper_registry->get(key::stepper::x);
+  stepper_x->microsteps(config->stepper_x().microsteps);
+  // stepper_x->rpm(config->stepper_x().rpm);
+  // stepper_x->acceleration(config->stepper_x().acceleration);
+  // stepper_x->deceleration(config->stepper_x().deceleration);
+  stepper_x->step_active_state(config->stepper_x().step_active_state);
+  stepper_x->dir_active_state(config->stepper_x().dir_active_state);
+  stepper_x->enable_active_state(config->stepper_x().enable_active_state);
+  stepper_x->backend(backend);
+
+  auto&& stepper_y = stepper_registry->get(key::stepper::y);
+  stepper_y->microsteps(config->stepper_y().microsteps);
+  // stepper_y->rpm(config->stepper_y().rpm);
+  // stepper_y->acceleration(config->stepper_y().acceleration);
+  // stepper_y->deceleration(config->stepper_y().deceleration);
+  stepper_y->step_active_state(config->stepper_y().step_active_state);
+  stepper_y->dir_active_state(config->stepper_y().dir_active_state);
+  stepper_y->enable_active_state(config->stepper_y().enable_active_state);
+  stepper_y->backend(backend);
+
+  auto&& stepper_z = stepper_registry->get(key::stepper::z);
+  stepper_z->microsteps(config->stepper_z().microsteps);
+  // stepper_z->rpm(config->stepper_z().rpm);
+  // stepper_z->acceleration(config->stepper_z().acceleration);
+  // stepper_z->deceleration(config->stepper_z().deceleration);
+  stepper_z->step_active_state(config->stepper_z().step_active_state);
+  stepper_z->dir_active_state(config->stepper_z().dir_active_state);
+  stepper_z->enable_active_state(config->stepper_z().enable_active_state);
+  stepper_z->backend(backend);
 
   return status;
 }
@@ -431,21 +477,20 @@ static ATM_STATUS initialize_stepper_devices() {
 
 //   status = ultrasonic_device_registry->create(
 //       id::ultrasonic::water_level(),
-//       config->ultrasonic<PI_PIN>("water-level", "echo-pin"),
-//       config->ultrasonic<PI_PIN>("water-level", "trigger-pin"),
-//       config->ultrasonic<bool>("water-level", "echo-active-state"),
-//       config->ultrasonic<bool>("water-level", "trigger-active-state"));
+//       config->ultrasonic().water_level.echo_pin,
+//       config->ultrasonic().water_level.trigger_pin,
+//       config->ultrasonic().water_level.echo_active_state,
+//       config->ultrasonic().water_level.trigger_active_state);
 //   if (status == ATM_ERR) {
 //     return status;
 //   }
 
 //   status = ultrasonic_device_registry->create(
 //       id::ultrasonic::disinfectant_level(),
-//       config->ultrasonic<PI_PIN>("disinfectant-level", "echo-pin"),
-//       config->ultrasonic<PI_PIN>("disinfectant-level", "trigger-pin"),
-//       config->ultrasonic<bool>("disinfectant-level", "echo-active-state"),
-//       config->ultrasonic<bool>("disinfectant-level",
-//       "trigger-active-state"));
+//       config->ultrasonic().disinfectant_level.echo_pin,
+//       config->ultrasonic().disinfectant_level.trigger_pin,
+//       config->ultrasonic().disinfectant_level.echo_active_state,
+//       config->ultrasonic().disinfectant_level.trigger_active_state);
 //   if (status == ATM_ERR) {
 //     return status;
 //   }
@@ -465,17 +510,18 @@ static ATM_STATUS initialize_float_sensor_devices() {
   auto* float_device_registry = FloatDeviceRegistry::get();
 
   status = float_device_registry->create(
-      id::float_sensor::water_level(),
-      config->float_sensor<PI_PIN>("water-level", "pin"),
-      config->float_sensor<bool>("water-level", "active-state"));
+      key::float_sensor::water_level, id::float_sensor::water_level(),
+      config->float_sensor().water_level.pin,
+      config->float_sensor().water_level.active_state);
   if (status == ATM_ERR) {
     return status;
   }
 
   status = float_device_registry->create(
+      key::float_sensor::disinfectant_level,
       id::float_sensor::disinfectant_level(),
-      config->float_sensor<PI_PIN>("disinfectant-level", "pin"),
-      config->float_sensor<bool>("disinfectant-level", "active-state"));
+      config->float_sensor().disinfectant_level.pin,
+      config->float_sensor().disinfectant_level.active_state);
   if (status == ATM_ERR) {
     return status;
   }
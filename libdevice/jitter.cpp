@@ -0,0 +1,80 @@
+#include "device.hpp"
+
+#include "jitter.hpp"
+
+#include <algorithm>
+#include <bit>
+
+NAMESPACE_BEGIN
+
+namespace device {
+StepJitter::StepJitter() {
+  reset();
+}
+
+void StepJitter::start_move() {
+  move_max_lateness_.store(0, std::memory_order_relaxed);
+}
+
+void StepJitter::record(time_unit scheduled, time_unit actual) {
+  const time_unit lateness = (actual > scheduled) ? actual - scheduled : 0;
+  const std::size_t bucket = std::min<std::size_t>(
+      static_cast<std::size_t>(std::bit_width(lateness)), jitter::buckets - 1);
+
+  steps_.fetch_add(1, std::memory_order_relaxed);
+  lateness_.fetch_add(lateness, std::memory_order_relaxed);
+  histogram_[bucket].fetch_add(1, std::memory_order_relaxed);
+
+  if (lateness > jitter::deadline) {
+    missed_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  update_max(max_lateness_, lateness);
+  update_max(move_max_lateness_, lateness);
+}
+
+void StepJitter::reset() {
+  steps_.store(0, std::memory_order_relaxed);
+  missed_.store(0, std::memory_order_relaxed);
+  lateness_.store(0, std::memory_order_relaxed);
+  max_lateness_.store(0, std::memory_order_relaxed);
+  move_max_lateness_.store(0, std::memory_order_relaxed);
+
+  for (auto& count : histogram_) {
+    count.store(0, std::memory_order_relaxed);
+  }
+}
+
+jitter::snapshot StepJitter::snapshot() const {
+  jitter::snapshot retval;
+
+  retval.steps = steps_.load(std::memory_order_relaxed);
+  retval.missed = missed_.load(std::memory_order_relaxed);
+  retval.mean_lateness =
+      retval.steps > 0
+          ? lateness_.load(std::memory_order_relaxed) / retval.steps
+          : 0;
+  retval.max_lateness = max_lateness_.load(std::memory_order_relaxed);
+  retval.move_max_lateness = move_max_lateness_.load(std::memory_order_relaxed);
+
+  for (std::size_t i = 0; i < jitter::buckets; ++i) {
+    retval.histogram[i] = histogram_[i].load(std::memory_order_relaxed);
+  }
+
+  return retval;
+}
+
+time_unit StepJitter::bucket_floor(std::size_t bucket) {
+  return (bucket == 0) ? 0 : (static_cast<time_unit>(1) << (bucket - 1));
+}
+
+void StepJitter::update_max(std::atomic<time_unit>& max, time_unit value) {
+  time_unit current = max.load(std::memory_order_relaxed);
+
+  while (value > current && !max.compare_exchange_weak(
+                                current, value, std::memory_order_relaxed)) {
+  }
+}
+}  // namespace device
+
+NAMESPACE_END
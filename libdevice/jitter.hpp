@@ -0,0 +1,141 @@
+#ifndef LIB_DEVICE_JITTER_HPP_
+#define LIB_DEVICE_JITTER_HPP_
+
+/** @file jitter.hpp
+ *  @brief Step jitter recorder class definition
+ *
+ * Records how late STEP edges land compared to their scheduled time
+ */
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+#include <libutil/util.hpp>
+
+#include <libcore/core.hpp>
+
+NAMESPACE_BEGIN
+
+namespace device {
+namespace jitter {
+/**
+ * Number of histogram buckets
+ *
+ * Bucket 0 holds lateness below 1 us, bucket i holds [2^(i-1), 2^i) us and
+ * the last bucket holds everything above
+ */
+constexpr std::size_t buckets = 16;
+
+/** Lateness (us) above which a step counts as a missed deadline */
+constexpr time_unit deadline = 50;
+
+/** Lateness histogram */
+typedef std::array<time_unit, buckets> histogram;
+
+/**
+ * @brief Copy of jitter counters.
+ */
+struct snapshot {
+  /** recorded steps */
+  time_unit steps;
+  /** steps later than jitter::deadline */
+  time_unit missed;
+  /** mean lateness (us) */
+  time_unit mean_lateness;
+  /** max lateness since reset (us) */
+  time_unit max_lateness;
+  /** max lateness of current (or last) move (us) */
+  time_unit move_max_lateness;
+  /** lateness histogram */
+  jitter::histogram histogram;
+};
+}  // namespace jitter
+
+/**
+ * @brief Step jitter recorder.
+ *
+ * Written by the thread that pulses the stepper and read by anyone (GUI,
+ * logger). Every counter is a relaxed atomic, so recording never locks and
+ * readers get a slightly torn but consistent enough view.
+ */
+class StepJitter : public StackObj {
+ public:
+  /**
+   * StepJitter Constructor
+   */
+  StepJitter();
+  /**
+   * StepJitter Destructor
+   */
+  ~StepJitter() = default;
+  /**
+   * Begin new move, resets max lateness of the move
+   */
+  void start_move();
+  /**
+   * Record single step
+   *
+   * @param scheduled  time stamp the step is scheduled at (us)
+   * @param actual     time stamp STEP pin goes high (us)
+   */
+  void record(time_unit scheduled, time_unit actual);
+  /**
+   * Reset every counter
+   */
+  void reset();
+  /**
+   * Get copy of counters
+   *
+   * @return jitter snapshot
+   */
+  jitter::snapshot snapshot() const;
+  /**
+   * Get lower bound of histogram bucket
+   *
+   * @param bucket histogram bucket
+   *
+   * @return lower bound in us
+   */
+  static time_unit bucket_floor(std::size_t bucket);
+
+ private:
+  /**
+   * Update max value
+   *
+   * @param max    atomic max value
+   * @param value  value to compare
+   */
+  static void update_max(std::atomic<time_unit>& max, time_unit value);
+
+ private:
+  /**
+   * Recorded steps
+   */
+  std::atomic<time_unit> steps_;
+  /**
+   * Missed deadlines
+   */
+  std::atomic<time_unit> missed_;
+  /**
+   * Sum of lateness
+   */
+  std::atomic<time_unit> lateness_;
+  /**
+   * Max lateness since reset
+   */
+  std::atomic<time_unit> max_lateness_;
+  /**
+   * Max lateness of current move
+   */
+  std::atomic<time_unit> move_max_lateness_;
+  /**
+   * Lateness histogram
+   */
+  std::array<std::atomic<time_unit>, jitter::buckets> histogram_;
+};
+}  // namespace device
+
+NAMESPACE_END
+
+#endif  // LIB_DEVICE_JITTER_HPP_
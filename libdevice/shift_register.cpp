@@ -2,6 +2,8 @@
 
 #include "shift_register.hpp"
 
+#include <chrono>
+
 #include <libutil/util.hpp>
 
 NAMESPACE_BEGIN
@@ -9,71 +11,144 @@ NAMESPACE_BEGIN
 namespace device {
 
 namespace impl {
-const unsigned int ShiftRegisterDeviceImpl::cascade_num = 2;
-const unsigned int ShiftRegisterDeviceImpl::shift_bits = 8;
-
 ShiftRegisterDeviceImpl::ShiftRegisterDeviceImpl(
     PI_PIN                    latch_pin,
     PI_PIN                    clock_pin,
     PI_PIN                    data_pin,
-    shift_register::bit_order order)
+    shift_register::bit_order order,
+    shift_register::backend   backend,
+    unsigned int              spi_channel,
+    unsigned int              spi_baud)
     : latch_pin_{latch_pin},
       clock_pin_{clock_pin},
       data_pin_{data_pin},
       order_{order},
+      backend_{backend},
+      spi_handle_{-1},
       latch_device_{DigitalOutputDevice::create(latch_pin)},
-      clock_device_{DigitalOutputDevice::create(clock_pin)},
-      data_device_{DigitalOutputDevice::create(data_pin)} {
+      // SCLK and MOSI must stay in their SPI mode
+      clock_device_{backend == shift_register::backend::gpio
+                        ? DigitalOutputDevice::create(clock_pin)
+                        : nullptr},
+      data_device_{backend == shift_register::backend::gpio
+                       ? DigitalOutputDevice::create(data_pin)
+                       : nullptr},
+      pending_{0},
+      latched_{0},
+      latched_valid_{false} {
   DEBUG_ONLY_DEFINITION(obj_name_ = "ShiftRegisterDevice");
+
+  if (backend == shift_register::backend::spi) {
+    // latch is driven by latch_pin, not by the chip enable of the channel,
+    // leave chip enable of the other channel to GPIO (flag bits u0 and u1)
+    const unsigned int flags = spi_channel == 0 ? 1U << 6 : 1U << 5;
+    spi_handle_ = spiOpen(spi_channel, spi_baud, flags);
+    if (spi_handle_ < 0) {
+      LOG_ERROR("Failed to open SPI channel {}, result = {}", spi_channel,
+                spi_handle_);
+    }
+  }
+
   massert(active(), "sanity");
 
-  bits_ = new byte[cascade_num];
   reset_bits();
 }
 
 ShiftRegisterDeviceImpl::~ShiftRegisterDeviceImpl() {
-  delete bits_;
+  if (spi_handle_ >= 0) {
+    spiClose(static_cast<unsigned int>(spi_handle_));
+  }
 }
 
 void ShiftRegisterDeviceImpl::reset_bits() {
-  for (unsigned int idx = 0; idx < cascade_num; ++idx) {
-    bits_[idx] = 0;
-  }
+  pending_.store(0, std::memory_order_release);
 }
 
 ATM_STATUS ShiftRegisterDeviceImpl::write(const byte&           pin,
                                           const digital::value& level) {
-  if (pin > cascade_num * shift_bits) {
+  if (set(pin, level) == ATM_ERR) {
     return ATM_ERR;
   }
 
-  unsigned int reg = pin / shift_bits;
+  return latch();
+}
+
+ATM_STATUS ShiftRegisterDeviceImpl::set(const byte&           pin,
+                                        const digital::value& level) {
+  if (pin >= shift_register::cascade_num * shift_register::shift_bits) {
+    return ATM_ERR;
+  }
+
+  const shift_register::word bit = static_cast<shift_register::word>(1) << pin;
+
+  if (level == digital::value::high) {
+    pending_.fetch_or(bit, std::memory_order_acq_rel);
+  } else {
+    pending_.fetch_and(~bit, std::memory_order_acq_rel);
+  }
+
+  return ATM_OK;
+}
+
+void ShiftRegisterDeviceImpl::update(shift_register::word set_bits,
+                                     shift_register::word clear_bits) {
+  shift_register::word current = pending_.load(std::memory_order_relaxed);
+
+  while (!pending_.compare_exchange_weak(current,
+                                         (current & ~clear_bits) | set_bits,
+                                         std::memory_order_acq_rel)) {
+  }
+}
+
+ATM_STATUS ShiftRegisterDeviceImpl::latch() {
+  std::lock_guard<std::mutex> lock(latch_mutex_);
+
+  const shift_register::word pending = pending_.load(std::memory_order_acquire);
 
-  // Determines address for actual register
-  byte address = static_cast<byte>(pin - (shift_bits * reg));
+  if (latched_valid_ && latched_ == pending) {
+    // outputs already have the frame
+    return ATM_OK;
+  }
+
+  // register idx holds pins [idx * shift_bits, (idx + 1) * shift_bits)
+  shift_register::frame frame;
+  for (unsigned int idx = 0; idx < shift_register::cascade_num; ++idx) {
+    frame[idx] =
+        static_cast<byte>(pending >> (idx * shift_register::shift_bits));
+  }
 
   // turn off the output so the pins don't
   // light up while the bits are being shifted in
-  latch_device()->write(digital::value::low);
+  ATM_STATUS status = latch_device()->write(digital::value::low);
 
-  for (unsigned int idx = 0; idx < cascade_num; ++idx) {
-    if (reg == idx) {
-      // turn on the next highest bit in bits
-      bit_write(bits(idx), address, level);
+  if (backend() == shift_register::backend::spi) {
+    if (spi_out(frame) == ATM_ERR) {
+      status = ATM_ERR;
+    }
+  } else {
+    for (const auto& value : frame) {
+      // shift the bits out
+      shift_out(value);
     }
-
-    // shift the bits out
-    shift_out(bits(idx));
   }
 
   // turn on the output
-  latch_device()->write(digital::value::high);
+  if (latch_device()->write(digital::value::high) == ATM_ERR) {
+    status = ATM_ERR;
+  }
 
-  return ATM_OK;
+  latched_ = pending;
+  latched_valid_ = (status == ATM_OK);
+
+  if (FlightRecorder::created()) {
+    FlightRecorder::get()->shift_register(latched_);
+  }
+
+  return status;
 }
 
 void ShiftRegisterDeviceImpl::shift_out(const byte& value) const {
-  for (unsigned int i = 0; i < shift_bits; i++) {
+  for (unsigned int i = 0; i < shift_register::shift_bits; i++) {
     if (order() == shift_register::bit_order::lsb) {
       data_device()->write(!!(value & (1 << i)) ? digital::value::high
                                                 : digital::value::low);
@@ -87,17 +162,43 @@ void ShiftRegisterDeviceImpl::shift_out(const byte& value) const {
   }
 }
 
-void ShiftRegisterDeviceImpl::bit_write(byte&                 value,
-                                        byte                  bit,
-                                        const digital::value& bit_value) {
-  if (bit_value == digital::value::high) {
-    value |= (1UL << bit);
-  } else {
-    value &= ~(1UL << bit);
+ATM_STATUS ShiftRegisterDeviceImpl::spi_out(
+    const shift_register::frame& frame) const {
+  std::array<char, shift_register::cascade_num> buffer;
+
+  for (unsigned int idx = 0; idx < shift_register::cascade_num; ++idx) {
+    byte value = frame[idx];
+
+    // SPI shifts the most significant bit first
+    if (order() == shift_register::bit_order::lsb) {
+      byte reversed = 0;
+      for (unsigned int i = 0; i < shift_register::shift_bits; ++i) {
+        if (value & (1 << i)) {
+          reversed |= static_cast<byte>(1 << (7 - i));
+        }
+      }
+      value = reversed;
+    }
+
+    buffer[idx] = static_cast<char>(value);
   }
+
+  const int res = spiWrite(static_cast<unsigned int>(spi_handle_),
+                           buffer.data(), shift_register::cascade_num);
+
+  if (res == static_cast<int>(shift_register::cascade_num)) {
+    return ATM_OK;
+  }
+
+  LOG_DEBUG("[FAILED] ShiftRegisterDeviceImpl::spi_out, result = {}", res);
+  return ATM_ERR;
 }
 
 bool ShiftRegisterDeviceImpl::active() const {
+  if (backend() == shift_register::backend::spi) {
+    return latch_device()->active() && spi_handle_ >= 0;
+  }
+
   return latch_device()->active() && clock_device()->active() &&
          data_device()->active();
 }
@@ -105,12 +206,38 @@ bool ShiftRegisterDeviceImpl::active() const {
 ShiftRegisterImpl::ShiftRegisterImpl(PI_PIN                    latch_pin,
                                      PI_PIN                    clock_pin,
                                      PI_PIN                    data_pin,
-                                     shift_register::bit_order order)
-    : ShiftRegisterDeviceImpl{latch_pin, clock_pin, data_pin, order} {
+                                     shift_register::bit_order order,
+                                     shift_register::backend   backend,
+                                     unsigned int              spi_channel,
+                                     unsigned int              spi_baud,
+                                     time_unit                 flush_period)
+    : ShiftRegisterDeviceImpl{latch_pin, clock_pin, data_pin,
+                              order,     backend,   spi_channel,
+                              spi_baud},
+      flush_period_{flush_period},
+      running_{true},
+      urgent_{false},
+      requests_{0},
+      served_{0},
+      failures_{0},
+      failed_{false} {
   massert(active(), "sanity");
+
+  thread_ = std::thread(&ShiftRegisterImpl::flusher, this);
 }
 
-ShiftRegisterImpl::~ShiftRegisterImpl() {}
+ShiftRegisterImpl::~ShiftRegisterImpl() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    running_ = false;
+  }
+
+  requested_.notify_one();
+
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
 
 ATM_STATUS ShiftRegisterImpl::assign(const std::string& id,
                                      const byte&        pin,
@@ -124,33 +251,167 @@ ATM_STATUS ShiftRegisterImpl::assign(const std::string& id,
                 static_cast<int>(pin)));
   container_[id] = {pin, active_state};
   // enforce to write low
-  write(id, digital::value::low);
-  return ATM_OK;
+  return write(id, digital::value::low);
 }
 
 ATM_STATUS ShiftRegisterImpl::write(const std::string&    id,
                                     const digital::value& level) {
+  shift_register::word bit = 0;
+  bool                 high = false;
+
+  if (resolve(id, level, bit, high) == ATM_ERR) {
+    return ATM_ERR;
+  }
+
+  update(high ? bit : 0, high ? 0 : bit);
+  request(false);
+
+  return failed() ? ATM_ERR : ATM_OK;
+}
+
+ATM_STATUS ShiftRegisterImpl::batch(
+    std::initializer_list<shift_register::output> outputs) {
+  shift_register::word set_bits = 0;
+  shift_register::word clear_bits = 0;
+
+  for (const auto& [id, level] : outputs) {
+    shift_register::word bit = 0;
+    bool                 high = false;
+
+    if (resolve(id, level, bit, high) == ATM_ERR) {
+      LOG_DEBUG("[FAILED] ShiftRegisterImpl::batch, unknown device {}", id);
+      return ATM_ERR;
+    }
+
+    if (high) {
+      set_bits |= bit;
+      clear_bits &= ~bit;
+    } else {
+      clear_bits |= bit;
+      set_bits &= ~bit;
+    }
+  }
+
+  update(set_bits, clear_bits);
+  request(false);
+
+  return failed() ? ATM_ERR : ATM_OK;
+}
+
+ATM_STATUS ShiftRegisterImpl::write_all(const digital::value& level) {
+  shift_register::word set_bits = 0;
+  shift_register::word clear_bits = 0;
+
+  for (const auto& [id, _] : container_) {
+    shift_register::word bit = 0;
+    bool                 high = false;
+
+    resolve(id, level, bit, high);
+
+    if (high) {
+      set_bits |= bit;
+    } else {
+      clear_bits |= bit;
+    }
+  }
+
+  update(set_bits, clear_bits);
+  request(false);
+
+  return failed() ? ATM_ERR : ATM_OK;
+}
+
+ATM_STATUS ShiftRegisterImpl::flush() {
+  const std::size_t request_id = request(true);
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  flushed_.wait(lock, [this, request_id] {
+    return !running_ || served_ >= request_id;
+  });
+
+  return served_ >= request_id && !failed() ? ATM_OK : ATM_ERR;
+}
+
+ATM_STATUS ShiftRegisterImpl::resolve(const std::string&    id,
+                                      const digital::value& level,
+                                      shift_register::word& bit,
+                                      bool&                 high) const {
   if (auto current_metadata = get(id)) {
     const auto& [address, active_state] = *current_metadata;
+
+    if (address >= shift_register::cascade_num * shift_register::shift_bits) {
+      return ATM_ERR;
+    }
+
     DEBUG_ONLY(LOG_DEBUG(
         "Write ShiftRegister with address {} active_state {} level {}", address,
         active_state, level));
-    if (active_state) {
-      return ShiftRegisterDeviceImpl::write(address, level);
-    }
-    // invert output
-    return ShiftRegisterDeviceImpl::write(address, level == digital::value::high
-                                                       ? digital::value::low
-                                                       : digital::value::high);
+
+    bit = static_cast<shift_register::word>(1) << address;
+    // invert output if active state is low
+    high = (level == digital::value::high) == active_state;
+
+    return ATM_OK;
   }
 
   return ATM_ERR;
 }
 
-void ShiftRegisterImpl::write_all(const digital::value& level) {
-  for (const auto& [id, _] : container_) {
-    write(id, level);
-    sleep_for<time_units::millis>(50);
+std::size_t ShiftRegisterImpl::request(bool urgent) {
+  std::size_t request_id;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    request_id = ++requests_;
+    urgent_ = urgent_ || urgent;
+  }
+
+  requested_.notify_one();
+
+  return request_id;
+}
+
+void ShiftRegisterImpl::flusher() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  time_unit                    last_latch = 0;
+
+  while (true) {
+    requested_.wait(lock,
+                    [this] { return !running_ || requests_ != served_; });
+
+    if (!running_ && requests_ == served_) {
+      break;
+    }
+
+    // coalesce writes until the flush period has passed
+    if (running_ && !urgent_ && flush_period_ > 0 && last_latch != 0) {
+      const time_unit deadline = last_latch + flush_period_;
+      requested_.wait_until(
+          lock,
+          std::chrono::steady_clock::time_point{
+              std::chrono::milliseconds(deadline)},
+          [this] { return !running_ || urgent_; });
+    }
+
+    // every write made before this request is in the pending frame
+    const std::size_t request_id = requests_;
+    urgent_ = false;
+
+    lock.unlock();
+    if (latch() == ATM_ERR) {
+      // outputs are stale, the next request retries the whole frame
+      failed_.store(true, std::memory_order_release);
+      LOG_ERROR("Failed to latch shift register frame {:#06x}, {} failures",
+                pending(),
+                failures_.fetch_add(1, std::memory_order_acq_rel) + 1);
+    } else if (failed_.exchange(false, std::memory_order_acq_rel)) {
+      LOG_INFO("Shift register frame is latched again");
+    }
+    last_latch = millis();
+    lock.lock();
+
+    served_ = request_id;
+    flushed_.notify_all();
   }
 }
 
@@ -10,7 +10,15 @@
 #include <libalgo/algo.hpp>
 #include <libcore/core.hpp>
 
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <initializer_list>
+#include <mutex>
 #include <optional>
+#include <string>
+#include <thread>
 #include <unordered_map>
 #include <utility>
 
@@ -30,12 +38,30 @@ namespace shift_register {
 enum class BitOrder;
 }
 
+// shift_register::backend is defined in libcore/config.hpp
 namespace shift_register {
 enum class bit_order {
   lsb /**< least significant bit */,
   msb /**< most significant bit */
 };
-}
+
+/** Shift register cascade number */
+constexpr unsigned int cascade_num = 2;
+
+/** Shift register bits */
+constexpr unsigned int shift_bits = 8;
+
+/** Bits of every register in the cascade, first one is shifted out first */
+typedef std::array<byte, cascade_num> frame;
+
+/** Whole cascade in one word, bit n is pin n of the cascade */
+typedef uint32_t word;
+
+static_assert(cascade_num * shift_bits <= 32, "cascade must fit in a word");
+
+/** Level of a device that is connected to the shift register */
+typedef std::pair<std::string, digital::value> output;
+}  // namespace shift_register
 
 /** impl::ShiftRegisterImpl singleton class using StaticObj */
 using ShiftRegister = StaticObj<impl::ShiftRegisterImpl>;
@@ -53,7 +79,7 @@ namespace impl {
 class ShiftRegisterDeviceImpl : public StackObj {
  public:
   /**
-   * Write the HIGH/LOW data to ShiftRegisterDeviceImpl
+   * Write the HIGH/LOW data to ShiftRegisterDeviceImpl and latch it right away
    *
    * Taken from :
    * http://www.learningaboutelectronics.com/Articles/Cascade-shift-registers.php
@@ -71,16 +97,25 @@ class ShiftRegisterDeviceImpl : public StackObj {
    *
    * Initialize the shift register device by opening GPIO pins
    *
-   * @param  latch_pin  gpio pin, see Raspberry GPIO pinout for details
-   * @param  clock_pin  gpio pin, see Raspberry GPIO pinout for details
-   * @param  data_pin   gpio pin, see Raspberry GPIO pinout for details
-   * @param  order      order of bit, default MSB (Most Significant Bit)
+   * With shift_register::backend::spi, clock and data pins are owned by the
+   * SPI peripheral (SCLK and MOSI of the channel), so they are not opened
+   *
+   * @param  latch_pin    gpio pin, see Raspberry GPIO pinout for details
+   * @param  clock_pin    gpio pin, see Raspberry GPIO pinout for details
+   * @param  data_pin     gpio pin, see Raspberry GPIO pinout for details
+   * @param  order        order of bit, default MSB (Most Significant Bit)
+   * @param  backend      how the frame is pushed, default GPIO
+   * @param  spi_channel  SPI channel for shift_register::backend::spi
+   * @param  spi_baud     SPI baud rate for shift_register::backend::spi
    */
   ShiftRegisterDeviceImpl(
       PI_PIN                    latch_pin,
       PI_PIN                    clock_pin,
       PI_PIN                    data_pin,
-      shift_register::bit_order order = shift_register::bit_order::msb);
+      shift_register::bit_order order = shift_register::bit_order::msb,
+      shift_register::backend   backend = shift_register::backend::gpio,
+      unsigned int              spi_channel = 0,
+      unsigned int              spi_baud = 1000000);
   /**
    * ShiftRegisterDeviceImpl Destructor
    *
@@ -136,65 +171,75 @@ class ShiftRegisterDeviceImpl : public StackObj {
    */
   inline const shift_register::bit_order& order() const { return order_; }
   /**
-   * Shift out register
+   * Get backend
    *
-   * @param value      value to set
+   * @return backend
    */
-  void shift_out(const byte& value) const;
-
+  inline const shift_register::backend& backend() const { return backend_; }
   /**
-   * Bit Write
-   * Taken from Arduino
+   * Set bit of the pending frame without pushing it
    *
-   * @param value      value to set
-   * @param bit        which bit of the number to write, starting at 0 for the
-   * least-significant (rightmost) bit.
-   * @param bit_value  value to write to the bit
+   * Lock-free, safe to call from any thread
    *
+   * @param  pin   shift register pin/bit
+   * @param  level HIGH/LOW
+   *
+   * @return ATM_OK or ATM_ERR if the pin is out of the cascade
    */
-  static void bit_write(byte& value, byte bit, const digital::value& bit_value);
+  ATM_STATUS set(const byte& pin, const digital::value& level);
   /**
-   * Check if device is active or not
+   * Set and clear bits of the pending frame at once without pushing it
    *
-   * @return active status of device
+   * Lock-free, safe to call from any thread, no latch sees only a part of
+   * the update
+   *
+   * @param  set_bits    bits to set
+   * @param  clear_bits  bits to clear
    */
-  bool active() const;
+  void update(shift_register::word set_bits, shift_register::word clear_bits);
   /**
-   * Get bits with specified index
+   * Get pending frame
    *
-   * @param idx index of bits
-   *
-   * @return bits with specified index
+   * @return pending frame
    */
-  inline const byte& bits(unsigned int idx) const {
-    massert(idx < cascade_num, "sanity");
-    return bits_[idx];
+  inline shift_register::word pending() const {
+    return pending_.load(std::memory_order_acquire);
   }
   /**
-   * Get bits with specified index
+   * Push the pending frame into the cascade and latch it
    *
-   * @param idx index of bits
+   * Nothing is written if the frame has not changed since the last latch
    *
-   * @return bits with specified index
+   * @return ATM_OK or ATM_ERR, but not both
    */
-  inline byte& bits(unsigned int idx) {
-    massert(idx < cascade_num, "sanity");
-    return bits_[idx];
-  }
+  ATM_STATUS latch();
   /**
-   * Reset bits
+   * Shift out register
+   *
+   * @param value      value to set
    */
-  void reset_bits();
+  void shift_out(const byte& value) const;
+  /**
+   * Shift out the whole frame in a single SPI transaction
+   *
+   * @param frame frame to write
+   *
+   * @return ATM_OK or ATM_ERR, but not both
+   */
+  ATM_STATUS spi_out(const shift_register::frame& frame) const;
 
- protected:
   /**
-   * Shift register cascade number
+   * Check if device is active or not
+   *
+   * @return active status of device
    */
-  static const unsigned int cascade_num;
+  bool active() const;
   /**
-   * Shift register bits
+   * Reset bits
    */
-  static const unsigned int shift_bits;
+  void reset_bits();
+
+ protected:
   /**
    * Latch GPIO pin
    */
@@ -211,6 +256,14 @@ class ShiftRegisterDeviceImpl : public StackObj {
    * Bit order
    */
   const shift_register::bit_order order_;
+  /**
+   * Backend
+   */
+  const shift_register::backend backend_;
+  /**
+   * SPI handle, negative if SPI is not opened
+   */
+  int spi_handle_;
   /**
    * Latch digital output device
    */
@@ -224,9 +277,21 @@ class ShiftRegisterDeviceImpl : public StackObj {
    */
   const std::shared_ptr<DigitalOutputDevice> data_device_;
   /**
-   * Last bits of registers
+   * Pending bits of registers, written by anyone
+   */
+  std::atomic<shift_register::word> pending_;
+  /**
+   * Bits of registers that have been latched
+   */
+  shift_register::word latched_;
+  /**
+   * Whether latched_ holds the outputs or not
    */
-  byte* bits_;
+  bool latched_valid_;
+  /**
+   * Serialize shifting out
+   */
+  std::mutex latch_mutex_;
 };
 
 /**
@@ -245,6 +310,14 @@ class ShiftRegisterDeviceImpl : public StackObj {
  * that connected via ShiftRegister in the same manner
  * with other devices (DigitalOutputDevice, etc)
  *
+ * Writers (task thread, homing, liquid refilling listeners, GUI) OR/AND
+ * their bits into the atomic pending frame, then take the flusher mutex only
+ * long enough to post a request. They never wait for the shift-out. A single
+ * flusher thread latches the pending frame at most once per flush period, or
+ * right away on flush(). Latch failures are logged and counted, write() and
+ * flush() report ATM_ERR until a latch succeeds again. Devices must be
+ * assigned before writers start.
+ *
  * @author Ray Andrew
  * @date   June 2020
  */
@@ -262,6 +335,9 @@ class ShiftRegisterImpl : public ShiftRegisterDeviceImpl {
    * Register device with id and virtual pin in the
    * shift register
    *
+   * Not thread-safe, writers look devices up without locking. Every device
+   * must be assigned during initialization, before other threads write
+   *
    * @param id     unique identifier of device
    * @param pin    pin of device in the shift register
    *
@@ -273,20 +349,58 @@ class ShiftRegisterImpl : public ShiftRegisterDeviceImpl {
   /**
    * Write the HIGH/LOW data to ShiftRegisterDeviceImpl
    *
+   * Does not wait for the latch
+   *
    * @param  id    device unique id
    * @param  level HIGH/LOW
    *
-   * @return ATM_OK or ATM_ERR, but not both
+   * @return ATM_OK or ATM_ERR if the device is unknown or the last latch has
+   *         failed (the level is still latched once a latch succeeds)
    */
   ATM_STATUS write(const std::string& id, const digital::value& level);
+  /**
+   * Write the HIGH/LOW data to several devices, they are latched at once
+   *
+   * Nothing is written if any id is unknown. Does not wait for the latch
+   *
+   * @param  outputs levels of devices
+   *
+   * @return ATM_OK or ATM_ERR if any device is unknown or the last latch has
+   *         failed
+   */
+  ATM_STATUS batch(std::initializer_list<shift_register::output> outputs);
   /**
    * Write the HIGH/LOW data to all devices that connected to Shift Register
    *
+   * Every device is latched at once. Does not wait for the latch
+   *
    * @param  level HIGH/LOW
    *
-   * @return ATM_OK or ATM_ERR, but not both
+   * @return ATM_OK or ATM_ERR if the last latch has failed
+   */
+  ATM_STATUS write_all(const digital::value& level);
+  /**
+   * Latch pending frame right away
+   *
+   * Blocks until every write that has been made before is latched
+   *
+   * @return ATM_OK or ATM_ERR if the latch has failed
+   */
+  ATM_STATUS flush();
+  /**
+   * Check whether the last latch has failed
+   *
+   * @return true if outputs may not hold the written levels
    */
-  void write_all(const digital::value& level);
+  inline bool failed() const { return failed_.load(std::memory_order_acquire); }
+  /**
+   * Get number of failed latches since the shift register is created
+   *
+   * @return number of failed latches
+   */
+  inline std::size_t failures() const {
+    return failures_.load(std::memory_order_acquire);
+  }
   /**
    * Check device with unique id
    *
@@ -310,29 +424,111 @@ class ShiftRegisterImpl : public ShiftRegisterDeviceImpl {
    *
    * Initialize the shift register device by opening GPIO pins
    *
-   * @param  latch_pin  gpio pin, see Raspberry GPIO pinout for details
-   * @param  clock_pin  gpio pin, see Raspberry GPIO pinout for details
-   * @param  data_pin   gpio pin, see Raspberry GPIO pinout for details
-   * @param  order      order of bit, default MSB (Most Significant Bit)
+   * @param  latch_pin    gpio pin, see Raspberry GPIO pinout for details
+   * @param  clock_pin    gpio pin, see Raspberry GPIO pinout for details
+   * @param  data_pin     gpio pin, see Raspberry GPIO pinout for details
+   * @param  order        order of bit, default MSB (Most Significant Bit)
+   * @param  backend      how the frame is pushed, default GPIO
+   * @param  spi_channel  SPI channel for shift_register::backend::spi
+   * @param  spi_baud     SPI baud rate for shift_register::backend::spi
+   * @param  flush_period min period between two latches in millis, 0 latches
+   *                      as soon as the frame changes
    */
   ShiftRegisterImpl(
       PI_PIN                    latch_pin,
       PI_PIN                    clock_pin,
       PI_PIN                    data_pin,
-      shift_register::bit_order order = shift_register::bit_order::msb);
+      shift_register::bit_order order = shift_register::bit_order::msb,
+      shift_register::backend   backend = shift_register::backend::gpio,
+      unsigned int              spi_channel = 0,
+      unsigned int              spi_baud = 1000000,
+      time_unit                 flush_period = 0);
   /**
    * ShiftRegisterImpl Destructor
    *
-   * Close the ShiftRegisterImpl that has been initialized
+   * Latch pending frame, stop the flusher, and close the ShiftRegisterImpl
+   * that has been initialized
    */
   virtual ~ShiftRegisterImpl() override;
 
+ protected:
+  /**
+   * Get bit of device with unique id
+   *
+   * @param  id    device unique id
+   * @param  level HIGH/LOW
+   * @param  bit   bit of the device in the frame
+   * @param  high  whether the bit is set or cleared
+   *
+   * @return ATM_OK or ATM_ERR if the device is unknown
+   */
+  ATM_STATUS resolve(const std::string&    id,
+                     const digital::value& level,
+                     shift_register::word& bit,
+                     bool&                 high) const;
+  /**
+   * Wake flusher up
+   *
+   * @param urgent latch without waiting for the flush period
+   *
+   * @return request number to wait for
+   */
+  std::size_t request(bool urgent);
+  /**
+   * Flusher thread
+   */
+  void flusher();
+
  protected:
   /**
    * "Instances"-like container for connected devices
    * with ShiftRegister
    */
   std::unordered_map<std::string, metadata> container_;
+  /**
+   * Min period between two latches in millis
+   */
+  const time_unit flush_period_;
+  /**
+   * Flusher is running
+   */
+  bool running_;
+  /**
+   * Flush has been requested without waiting for the flush period
+   */
+  bool urgent_;
+  /**
+   * Number of flush requests
+   */
+  std::size_t requests_;
+  /**
+   * Number of flush requests that have been latched
+   */
+  std::size_t served_;
+  /**
+   * Guard flusher state, never held while shifting out
+   */
+  std::mutex mutex_;
+  /**
+   * Signaled on flush request
+   */
+  std::condition_variable requested_;
+  /**
+   * Signaled on latch
+   */
+  std::condition_variable flushed_;
+  /**
+   * Number of failed latches
+   */
+  std::atomic<std::size_t> failures_;
+  /**
+   * Last latch has failed
+   */
+  std::atomic<bool> failed_;
+  /**
+   * Flusher thread
+   */
+  std::thread thread_;
 };
 }  // namespace impl
 }  // namespace device
@@ -3,6 +3,7 @@
 #include "stepper.hpp"
 
 #include <cmath>
+#include <limits>
 
 NAMESPACE_BEGIN
 
@@ -32,8 +33,11 @@ StepperDevice::StepperDevice(PI_PIN        step_pin,
   next_move_interval_ = 0;
   acceleration_ = 1000;
   deceleration_ = 1000;
+  jerk_ = 10000;
   direction_ = stepper::direction::forward;
   remaining_steps_ = 0;
+  backend_ = stepper::backend::bitbang;
+  halt_ = false;
   /*  End of movement mechanism variables initialization */
 }
 
@@ -57,6 +61,38 @@ void StepperDevice::deceleration(double deceleration) {
   deceleration_ = deceleration;
 }
 
+void StepperDevice::jerk(double jerk) {
+  jerk_ = jerk;
+}
+
+void StepperDevice::backend(const stepper::backend& backend) {
+  massert(backend != stepper::backend::wave || Wave::get() != nullptr,
+          "sanity");
+  backend_ = backend;
+}
+
+void StepperDevice::write_direction(const stepper::direction& direction) {
+  direction_ = direction;
+
+  switch (direction) {
+    case stepper::direction::forward:
+      dir_device()->write(digital::value::high);
+      break;
+    case stepper::direction::backward:
+      dir_device()->write(digital::value::low);
+      break;
+  }
+}
+
+void StepperDevice::write_step(const digital::value& value) {
+  step_device()->write(value);
+}
+
+void StepperDevice::write_step(DigitalOutputBatch&   batch,
+                               const digital::value& value) {
+  batch.write(step_device(), value);
+}
+
 void StepperDevice::enable() {
   enable_device()->write(digital::value::high);
 }
@@ -78,6 +114,132 @@ void StepperDevice::dir_active_state(const bool& active_state) {
 }
 
 namespace impl {
+/**
+ * Get jerk of S-curve profile in microsteps
+ *
+ * Jerk that is not positive is taken as unlimited, the profile falls back to
+ * the linear ramp
+ *
+ * @param jerk        jerk [steps/s^3]
+ * @param microsteps  microsteps per step
+ *
+ * @return jerk [microsteps/s^3]
+ */
+static double scurve_jerk(double jerk, stepper::step microsteps) {
+  if (jerk <= 0.0) {
+    return std::numeric_limits<double>::infinity();
+  }
+
+  return jerk * static_cast<double>(microsteps);
+}
+
+/**
+ * Get time to change speed from a standstill to given speed with jerk-limited
+ * profile
+ *
+ * @param speed         target speed [steps/s]
+ * @param acceleration  max acceleration [steps/s^2]
+ * @param jerk          jerk [steps/s^3]
+ *
+ * @return time in seconds
+ */
+static double scurve_ramp_time(double speed, double acceleration, double jerk) {
+  if (speed * jerk >= acceleration * acceleration) {
+    // reaches max acceleration
+    return speed / acceleration + acceleration / jerk;
+  }
+
+  return 2.0 * std::sqrt(speed / jerk);
+}
+
+/**
+ * Get steps to change speed from a standstill to given speed with
+ * jerk-limited profile
+ *
+ * Ramp is symmetric, so average speed is half of the target speed
+ *
+ * @param speed         target speed [steps/s]
+ * @param acceleration  max acceleration [steps/s^2]
+ * @param jerk          jerk [steps/s^3]
+ *
+ * @return steps
+ */
+static double scurve_ramp_steps(double speed,
+                                double acceleration,
+                                double jerk) {
+  return speed * scurve_ramp_time(speed, acceleration, jerk) / 2.0;
+}
+
+/**
+ * Get highest speed that can be reached and stopped from in given steps
+ *
+ * @param steps         steps to take
+ * @param speed         max speed [steps/s]
+ * @param acceleration  max acceleration [steps/s^2]
+ * @param deceleration  max deceleration [steps/s^2]
+ * @param jerk          jerk [steps/s^3]
+ *
+ * @return peak speed [steps/s]
+ */
+static double scurve_peak_speed(double steps,
+                                double speed,
+                                double acceleration,
+                                double deceleration,
+                                double jerk) {
+  if (scurve_ramp_steps(speed, acceleration, jerk) +
+          scurve_ramp_steps(speed, deceleration, jerk) <=
+      steps) {
+    return speed;
+  }
+
+  // ramp steps grow monotonically with speed
+  double low = 0.0;
+  double high = speed;
+
+  for (int i = 0; i < 32; ++i) {
+    const double mid = (low + high) / 2.0;
+    if (scurve_ramp_steps(mid, acceleration, jerk) +
+            scurve_ramp_steps(mid, deceleration, jerk) <=
+        steps) {
+      low = mid;
+    } else {
+      high = mid;
+    }
+  }
+
+  return low;
+}
+
+/**
+ * Get time to complete move with jerk-limited profile
+ *
+ * @param steps         steps to take
+ * @param speed         max speed [steps/s]
+ * @param acceleration  max acceleration [steps/s^2]
+ * @param deceleration  max deceleration [steps/s^2]
+ * @param jerk          jerk [steps/s^3]
+ *
+ * @return time in seconds
+ */
+static double scurve_move_time(double steps,
+                               double speed,
+                               double acceleration,
+                               double deceleration,
+                               double jerk) {
+  const double peak =
+      scurve_peak_speed(steps, speed, acceleration, deceleration, jerk);
+
+  if (peak <= 0.0) {
+    return 0.0;
+  }
+
+  const double cruise = steps - scurve_ramp_steps(peak, acceleration, jerk) -
+                        scurve_ramp_steps(peak, deceleration, jerk);
+
+  return scurve_ramp_time(peak, acceleration, jerk) +
+         scurve_ramp_time(peak, deceleration, jerk) + cruise / peak;
+}
+
 /** For constant speed */
 template <>
 void StepperDeviceImpl<stepper::speed::constant>::start_move(long steps,
@@ -107,6 +269,12 @@ void StepperDeviceImpl<stepper::speed::constant>::calc_step_pulse() {
   step_count_++;
 }
 
+template <>
+void StepperDeviceImpl<stepper::speed::constant>::start_brake() {
+  // no ramp, stop right away
+  remaining_steps_ = 0;
+}
+
 /** For linear speed */
 template <>
 void StepperDeviceImpl<stepper::speed::linear>::start_move(long steps,
@@ -189,6 +357,180 @@ void StepperDeviceImpl<stepper::speed::linear>::calc_step_pulse() {
   }
 }
 
+template <>
+void StepperDeviceImpl<stepper::speed::linear>::start_brake() {
+  switch (state()) {
+    case stepper::state::cruising:
+      remaining_steps_ = steps_to_brake();
+      break;
+    case stepper::state::accelerating:
+      // deceleration mirrors the steps taken so far
+      steps_to_brake_ = std::min(
+          remaining_steps(),
+          static_cast<stepper::step>(step_count() * acceleration() /
+                                     deceleration()));
+      remaining_steps_ = steps_to_brake();
+      break;
+    default:
+      break;  // nothing to do if already stopped or braking
+  }
+}
+
+/** For S-curve speed */
+template <>
+void StepperDeviceImpl<stepper::speed::scurve>::start_move(long steps,
+                                                           long time) {
+  pre_start_move(steps);
+
+  // everything is in microsteps
+  const double accel = acceleration() * microsteps();
+  const double decel = deceleration() * microsteps();
+  const double jerk_steps = scurve_jerk(jerk(), microsteps());
+  const double total = static_cast<double>(remaining_steps());
+
+  double speed = rpm() * motor_steps() * microsteps() / 60;
+
+  if (time > 0) {
+    // Find the lowest speed that finishes in the time requested
+    const double t = static_cast<double>(time / (1e+6));  // convert to seconds
+
+    if (scurve_move_time(total, speed, accel, decel, jerk_steps) < t) {
+      double low = 0.0;
+      double high = speed;
+
+      for (int i = 0; i < 32; ++i) {
+        const double mid = (low + high) / 2.0;
+        if (scurve_move_time(total, mid, accel, decel, jerk_steps) > t) {
+          low = mid;
+        } else {
+          high = mid;
+        }
+      }
+
+      speed = high;
+    }
+  }
+
+  speed = scurve_peak_speed(total, speed, accel, decel, jerk_steps);
+
+  steps_to_cruise_ = static_cast<stepper::step>(
+      std::lround(scurve_ramp_steps(speed, accel, jerk_steps)));
+  steps_to_brake_ = static_cast<stepper::step>(
+      std::lround(scurve_ramp_steps(speed, decel, jerk_steps)));
+  if (remaining_steps() < steps_to_cruise() + steps_to_brake()) {
+    steps_to_brake_ = remaining_steps() - steps_to_cruise();
+  }
+
+  // First step is taken after the time to move a single step from a
+  // standstill with constant jerk (s = j * t^3 / 6), or with constant
+  // acceleration (s = a * t^2 / 2) when jerk is unlimited
+  const double start_time = std::isinf(jerk_steps)
+                                ? std::sqrt(2.0 / accel)
+                                : std::cbrt(6.0 / jerk_steps);
+
+  start_speed_ = 1.0 / start_time;
+  cruise_speed_ = std::max(speed, start_speed_);
+  current_speed_ = 0.0;
+  current_acceleration_ = 0.0;
+
+  step_pulse_ = static_cast<stepper::pulse>((1e+6) * start_time);
+  cruise_step_pulse_ = static_cast<stepper::pulse>(1e+6 / cruise_speed_);
+}
+
+template <>
+void StepperDeviceImpl<stepper::speed::scurve>::calc_step_pulse() {
+  // this should not be happening, but avoids strange calculations
+  if (remaining_steps() <= 0) {
+    return;
+  }
+
+  remaining_steps_--;
+  step_count_++;
+
+  const double accel = acceleration() * microsteps();
+  const double decel = deceleration() * microsteps();
+  const double jerk_steps = scurve_jerk(jerk(), microsteps());
+  // time elapsed since previous step
+  const double dt = static_cast<double>(step_pulse()) / (1e+6);
+  // jerk applied in this step
+  const double jerk_dt = jerk_steps * dt;
+
+  switch (state()) {
+    case stepper::state::accelerating:
+      // speed gained while acceleration is ramped down to 0 is a^2 / 2j, ramp
+      // down just in time to land on cruise speed
+      if (cruise_speed_ - current_speed_ <=
+          current_acceleration_ * current_acceleration_ / (2 * jerk_steps)) {
+        current_acceleration_ = std::max(current_acceleration_ - jerk_dt, 0.0);
+      } else {
+        current_acceleration_ =
+            std::min(current_acceleration_ + jerk_dt, accel);
+      }
+      current_speed_ =
+          std::min(current_speed_ + current_acceleration_ * dt, cruise_speed_);
+      break;
+
+    case stepper::state::decelerating:
+      if (remaining_steps() == steps_to_brake()) {
+        // first step of deceleration, from here on it is kept as deceleration,
+        // acceleration that is left ramps out through zero at jerk
+        current_acceleration_ = -current_acceleration_;
+      }
+      if (current_acceleration_ > 0.0 &&
+          current_speed_ - start_speed_ <=
+              current_acceleration_ * current_acceleration_ /
+                  (2 * jerk_steps)) {
+        current_acceleration_ = std::max(current_acceleration_ - jerk_dt, 0.0);
+      } else {
+        current_acceleration_ =
+            std::min(current_acceleration_ + jerk_dt, decel);
+      }
+      current_speed_ =
+          std::max(current_speed_ - current_acceleration_ * dt, start_speed_);
+      break;
+
+    case stepper::state::cruising:
+      current_speed_ = cruise_speed_;
+      current_acceleration_ = 0.0;
+      break;
+
+    default:
+      break;  // no speed changes
+  }
+
+  step_pulse_ = static_cast<stepper::pulse>(
+      1e+6 / std::max(current_speed_, start_speed_));
+}
+
+template <>
+void StepperDeviceImpl<stepper::speed::scurve>::start_brake() {
+  switch (state()) {
+    case stepper::state::cruising:
+    case stepper::state::accelerating: {
+      const double decel = deceleration() * microsteps();
+      const double jerk_steps = scurve_jerk(jerk(), microsteps());
+      // acceleration that is left ramps out at jerk before speed goes down,
+      // speed still goes up by a^2 / 2j over a^3 / 3j^2 more steps
+      const double ramp_out_time = current_acceleration_ / jerk_steps;
+      const double peak =
+          current_speed_ + current_acceleration_ * ramp_out_time / 2.0;
+      const double ramp_out = current_speed_ * ramp_out_time +
+                              current_acceleration_ * ramp_out_time *
+                                  ramp_out_time / 3.0;
+
+      steps_to_brake_ = std::min(
+          remaining_steps() - 1,
+          static_cast<stepper::step>(std::lround(
+              ramp_out + scurve_ramp_steps(peak, decel, jerk_steps))));
+      // one more step, so the next step is the first step of deceleration
+      remaining_steps_ = steps_to_brake() + 1;
+      break;
+    }
+    default:
+      break;  // nothing to do if already stopped or braking
+  }
+}
+
 template <>
 time_unit StepperDeviceImpl<stepper::speed::constant>::time_for_move(
     long steps) {
@@ -228,6 +570,22 @@ time_unit StepperDeviceImpl<stepper::speed::linear>::time_for_move(long steps) {
 
   return static_cast<time_unit>(std::lround(t));
 }
+
+template <>
+time_unit StepperDeviceImpl<stepper::speed::scurve>::time_for_move(long steps) {
+  if (steps <= 0) {
+    return 0;
+  }
+
+  double t = scurve_move_time(
+      static_cast<double>(std::abs(steps)),
+      rpm() * motor_steps() * microsteps() / 60, acceleration() * microsteps(),
+      deceleration() * microsteps(), scurve_jerk(jerk(), microsteps()));
+
+  t *= (1e+6);  // seconds -> micros
+
+  return static_cast<time_unit>(std::lround(t));
+}
 }  // namespace impl
 }  // namespace device
 
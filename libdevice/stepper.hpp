@@ -7,6 +7,7 @@
  * Stepper device using GPIO
  */
 
+#include <atomic>
 #include <cstdlib>
 #include <memory>
 
@@ -18,14 +19,17 @@
 
 #include "gpio.hpp"
 
+#include "bank.hpp"
 #include "digital.hpp"
+#include "jitter.hpp"
+#include "wave.hpp"
 
 NAMESPACE_BEGIN
 
 namespace device {
 // forward declaration
+// stepper::speed and stepper::backend are defined in libcore/config.hpp
 namespace stepper {
-enum class speed;
 enum class state;
 enum class direction;
 }  // namespace stepper
@@ -38,12 +42,6 @@ class StepperDeviceImpl;
 }
 
 namespace stepper {
-/** Speed mode */
-enum class speed {
-  constant, /**< constant speed */
-  linear,   /**< linear speed using equation */
-};
-
 /** Stepper state */
 enum class state { stopped, accelerating, cruising, decelerating };
 
@@ -76,6 +74,10 @@ using ConstantSpeedStepperDevice =
 using LinearSpeedStepperDevice =
     impl::StepperDeviceImpl<stepper::speed::linear>;
 
+/** S-curve speed specific implementation for Basic Stepper Device */
+using ScurveSpeedStepperDevice =
+    impl::StepperDeviceImpl<stepper::speed::scurve>;
+
 /**
  * @brief Stepper Device implementation.
  *
@@ -125,6 +127,26 @@ class StepperDevice : public StackObj {
    * @return remaining steps
    */
   virtual stepper::step stop(void) = 0;
+  /**
+   * Start decelerating to a stop
+   *
+   * Remaining steps are cut to the steps needed to decelerate from current
+   * speed, does nothing if the stepper is already decelerating or stopped
+   */
+  virtual void start_brake() = 0;
+  /**
+   * Request running move to stop at the next step
+   *
+   * Safe to call from any thread (e.g. input alert callback), cleared when
+   * the next move starts
+   */
+  inline void halt() { halt_.store(true, std::memory_order_release); }
+  /**
+   * Check whether halt has been requested or not
+   *
+   * @return halt is requested or not
+   */
+  inline bool halted() const { return halt_.load(std::memory_order_acquire); }
   /**
    * Get current state of stepper
    *
@@ -205,6 +227,20 @@ class StepperDevice : public StackObj {
    * @return current deceleration
    */
   inline double deceleration() const { return deceleration_; }
+  /**
+   * Set jerk (rate of change of acceleration)
+   *
+   * Only used by stepper::speed::scurve
+   *
+   * @param jerk jerk in steps / s^3
+   */
+  virtual void jerk(double jerk);
+  /**
+   * Get jerk
+   *
+   * @return jerk
+   */
+  inline double jerk() const { return jerk_; }
   /**
    * Get stepper direction
    *
@@ -261,6 +297,67 @@ class StepperDevice : public StackObj {
    * @return current rpm from calculation
    */
   inline virtual double current_rpm() const { return 0.0; }
+  /**
+   * Set pulse generation backend
+   *
+   * device::Wave must be initialized before using stepper::backend::wave
+   *
+   * @param backend backend to use
+   */
+  void backend(const stepper::backend& backend);
+  /**
+   * Get pulse generation backend
+   *
+   * @return current backend
+   */
+  inline const stepper::backend& backend() const { return backend_; }
+  /**
+   * Set direction and write it to DIR pin
+   *
+   * Used by coordinated movers that pulse STEP pin by themselves, so
+   * remaining steps and step count are not touched
+   *
+   * @param direction direction to set
+   */
+  void write_direction(const stepper::direction& direction);
+  /**
+   * Write value to STEP pin
+   *
+   * Used by coordinated movers that pulse STEP pin by themselves
+   *
+   * @param value digital value to write
+   */
+  void write_step(const digital::value& value);
+  /**
+   * Queue value of STEP pin into batch
+   *
+   * Used by coordinated movers, so STEP pins of every stepper that is due at
+   * the same tick are written at once
+   *
+   * @param batch  batched writes of GPIO bank 0
+   * @param value  digital value to write
+   */
+  void write_step(DigitalOutputBatch& batch, const digital::value& value);
+  /**
+   * Get tWH(STEP) pulse duration
+   *
+   * @return STEP high min duration in micros
+   */
+  inline static const time_unit& step_high_duration() { return step_high_min; }
+  /**
+   * Get step jitter recorder
+   *
+   * Only bit-banged steps are recorded, wave pulses are timed by DMA
+   *
+   * @return step jitter recorder
+   */
+  inline StepJitter& jitter() { return jitter_; }
+  /**
+   * Get step jitter recorder
+   *
+   * @return step jitter recorder
+   */
+  inline const StepJitter& jitter() const { return jitter_; }
 
  protected:
   /**
@@ -373,6 +470,10 @@ class StepperDevice : public StackObj {
    * Stepper deceleration constant
    */
   double deceleration_;
+  /**
+   * Stepper jerk constant
+   */
+  double jerk_;
   /**
    * Direction state
    */
@@ -401,6 +502,18 @@ class StepperDevice : public StackObj {
    * Step counter, will be resetted for each move sequence
    */
   stepper::step step_count_;
+  /**
+   * Pulse generation backend
+   */
+  stepper::backend backend_;
+  /**
+   * Halt request from other threads
+   */
+  std::atomic<bool> halt_;
+  /**
+   * Step jitter recorder
+   */
+  StepJitter jitter_;
   /* End of movement mechanism variables */
 };
 
@@ -487,6 +600,10 @@ class StepperDeviceImpl : public StepperDevice {
    * @return remaining steps
    */
   virtual stepper::step stop(void) override;
+  /**
+   * Start decelerating to a stop
+   */
+  virtual void start_brake() override;
   /**
    * Get current rpm from calculation
    *
@@ -572,6 +689,16 @@ class StepperDeviceImpl : public StepperDevice {
    * @param steps steps to take
    */
   void pre_start_move(long steps);
+  /**
+   * Yield move for each chunk of device::Wave
+   *
+   * Will compile steps that fit in the pending chunk into pulses
+   *
+   * @param stop_condition will stop if stop_condition is true
+   *
+   * @return time until next chunk is needed
+   */
+  time_unit next_wave(bool stop_condition);
   /* End of movement mechanism */
 
  protected:
@@ -596,6 +723,42 @@ class StepperDeviceImpl : public StepperDevice {
    * Cruise step pulses
    */
   stepper::pulse cruise_step_pulse_;
+  /**
+   * Offset of next step from the beginning of the pending wave chunk
+   *
+   * Negative (by less than the step high time) when the step is due right
+   * before the chunk begins, it is emitted at the beginning of the chunk
+   */
+  long wave_offset_;
+  /**
+   * Steps that have been added to the pending wave chunk
+   */
+  stepper::step wave_steps_;
+  /**
+   * Pulses of the pending wave chunk, reused for every chunk
+   */
+  WaveImpl::pulses wave_pulses_;
+  /* S-curve speed variables */
+  /**
+   * Current speed in steps / s
+   */
+  double current_speed_;
+  /**
+   * Current acceleration (or deceleration) in steps / s^2
+   *
+   * While decelerating it holds the deceleration, it is negative while the
+   * acceleration that was left on brake ramps out
+   */
+  double current_acceleration_;
+  /**
+   * Cruise speed in steps / s
+   */
+  double cruise_speed_;
+  /**
+   * Speed of the first step in steps / s, deceleration does not go below it
+   */
+  double start_speed_;
+  /* End of S-curve speed variables */
 };
 }  // namespace impl
 }  // namespace device
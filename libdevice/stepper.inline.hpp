@@ -3,6 +3,7 @@
 
 #include "stepper.hpp"
 
+#include <algorithm>
 #include <chrono>
 #include <cmath>
 #include <thread>
@@ -26,6 +27,12 @@ StepperDeviceImpl<Speed>::StepperDeviceImpl(PI_PIN        step_pin,
   steps_to_brake_ = 0;
   step_pulse_ = 0;
   cruise_step_pulse_ = 0;
+  wave_offset_ = 0;
+  wave_steps_ = 0;
+  current_speed_ = 0.0;
+  current_acceleration_ = 0.0;
+  cruise_speed_ = 0.0;
+  start_speed_ = 0.0;
   /*  End of movement mechanism variables initialization */
 }
 
@@ -66,15 +73,24 @@ void StepperDeviceImpl<Speed>::pre_start_move(long steps) {
 
   // setup timer
   last_move_end_ = 0;
+  halt_.store(false, std::memory_order_release);
   // initialize steps
   remaining_steps_ = static_cast<stepper::step>(std::abs(steps));
   step_count_ = 0;
   rest_steps_ = 0;
+  wave_offset_ = 0;
+  wave_steps_ = 0;
+
+  jitter_.start_move();
 }
 
 template <stepper::speed Speed>
 time_unit StepperDeviceImpl<Speed>::next(bool stop_condition) {
-  if (stop_condition) {
+  if (backend() == stepper::backend::wave) {
+    return next_wave(stop_condition);
+  }
+
+  if (stop_condition || halted()) {
     stop();
     return 0;
   }
@@ -83,19 +99,22 @@ time_unit StepperDeviceImpl<Speed>::next(bool stop_condition) {
     // original code : delayMicros(next_action_interval, last_action_end);
 
     // while (micros() - start_us < delay_us);
-    while ((micros() - last_move_end()) < (next_move_interval() + 10)) {
-      // not yet running
-      // return -1;
-    }
+    const time_unit scheduled = last_move_end() + next_move_interval() + 10;
 
-    // DIR pin is sampled on rising STEP edge, so it is set first
-    switch (direction()) {
-      case stepper::direction::forward:
-        dir_device()->write(digital::value::high);
-        break;
-      case stepper::direction::backward:
-        dir_device()->write(digital::value::low);
-        break;
+    // sleep until shortly before the next step, then spin
+    wait_until<time_units::micros>(scheduled);
+
+    // DIR pin is sampled on rising STEP edge, so it is set before the first
+    // pulse of the move, it does not change until the next one
+    if (step_count() == 0) {
+      switch (direction()) {
+        case stepper::direction::forward:
+          dir_device()->write(digital::value::high);
+          break;
+        case stepper::direction::backward:
+          dir_device()->write(digital::value::low);
+          break;
+      }
     }
 
     // sleep_until<time_units::micros>(next_move_interval(), last_move_end());
@@ -106,6 +125,11 @@ time_unit StepperDeviceImpl<Speed>::next(bool stop_condition) {
 
     time_unit m = micros();
 
+    // first step of the move has no schedule
+    if (last_move_end() != 0) {
+      jitter_.record(scheduled, m);
+    }
+
     // start pulsing
     step_device()->write(digital::value::high);
     // We should pull HIGH for at least 1-2us (step_high_min)
@@ -127,6 +151,109 @@ time_unit StepperDeviceImpl<Speed>::next(bool stop_condition) {
   return next_move_interval();
 }
 
+template <stepper::speed Speed>
+time_unit StepperDeviceImpl<Speed>::next_wave(bool stop_condition) {
+  massert(Wave::get() != nullptr, "sanity");
+
+  auto* wave = Wave::get();
+
+  if (stop_condition || halted()) {
+    stop();
+    return 0;
+  }
+
+  if (wave->dropped(step_pin())) {
+    // pending chunk could not be committed, its steps never went out
+    step_count_ -= wave_steps_;
+    remaining_steps_ += wave_steps_;
+    wave_steps_ = 0;
+  }
+
+  if (remaining_steps() <= 0) {
+    // push the last chunk out and wait until it is physically transmitted
+    if (wave->pending(step_pin())) {
+      wave->flush();
+    }
+
+    if (wave->pending(step_pin()) || wave->transmitting(step_pin())) {
+      next_move_interval_ = wave->poll_interval();
+    } else {
+      last_move_end_ = 0;
+      next_move_interval_ = 0;
+    }
+
+    return next_move_interval();
+  }
+
+  next_move_interval_ = wave->poll_interval();
+
+  if (step_count() == 0 && wave->transmitting(step_pin())) {
+    // pulses of a halted move are still going out in the old direction
+    return next_move_interval();
+  }
+
+  if (!wave->acquire(step_pin())) {
+    // both buffers are still in flight
+    return next_move_interval();
+  }
+
+  if (step_count() == 0) {
+    // DIR pin is sampled on rising STEP edge, so it is set before any pulse
+    // of this move is queued
+    switch (direction()) {
+      case stepper::direction::forward:
+        dir_device()->write(digital::value::high);
+        break;
+      case stepper::direction::backward:
+        dir_device()->write(digital::value::low);
+        break;
+    }
+  }
+
+  const auto     chunk = static_cast<long>(wave->chunk_duration());
+  const auto     high = static_cast<long>(StepperDevice::step_high_min);
+  const uint32_t mask = static_cast<uint32_t>(1) << step_device()->pin();
+  // respect active state of step pin
+  const uint32_t on = step_device()->active_state() ? mask : 0;
+  const uint32_t off = step_device()->active_state() ? 0 : mask;
+
+  // a committed chunk has taken the steps of the previous call
+  if (!wave->pending(step_pin())) {
+    wave_steps_ = 0;
+  }
+
+  wave_pulses_.clear();
+  long cursor = 0;
+
+  while (remaining_steps() > 0 && wave_offset_ + high < chunk) {
+    // save value because calcStepPulse() will overwrite it
+    const long pulse = static_cast<long>(step_pulse());
+    calc_step_pulse();
+
+    // step that is due before the chunk begins goes out right away
+    const long start = std::max(wave_offset_, cursor);
+
+    wave_pulses_.push_back(
+        {0, 0, static_cast<uint32_t>(start - cursor)});  // gap
+    wave_pulses_.push_back({on, off, static_cast<uint32_t>(high)});
+    wave_pulses_.push_back({off, on, 0});
+
+    cursor = start + high;
+    wave_offset_ += std::max(pulse, 2 * high);
+    ++wave_steps_;
+  }
+
+  // carry the remainder to the next chunk, the schedule does not drift
+  wave_offset_ -= chunk;
+
+  if (wave->add(step_pin(), wave_pulses_) == ATM_ERR) {
+    stop();
+    return 0;
+  }
+
+  return next_move_interval();
+}
+
 template <stepper::speed Speed>
 void StepperDeviceImpl<Speed>::move(long steps, bool stop_condition) {
   start_move(steps);
@@ -140,6 +267,18 @@ template <stepper::speed Speed>
 stepper::step StepperDeviceImpl<Speed>::stop() {
   stepper::step retval = remaining_steps();
   remaining_steps_ = 0;
+  if (backend() == stepper::backend::wave) {
+    // waveform is shared between steppers, only pulses of this pin leave the
+    // pending chunk, chunks in flight are taken as they are and the next move
+    // waits for them before it touches DIR
+    auto* wave = Wave::get();
+    if (wave->drop(step_pin()) || wave->dropped(step_pin())) {
+      step_count_ -= wave_steps_;
+      retval += wave_steps_;
+    }
+    wave_steps_ = 0;
+    next_move_interval_ = 0;
+  }
   return retval;
 }
 
@@ -0,0 +1,208 @@
+#include "device.hpp"
+
+#include "wave.hpp"
+
+NAMESPACE_BEGIN
+
+namespace device {
+namespace impl {
+const std::size_t WaveImpl::max_in_flight = 2;
+
+WaveImpl::WaveImpl(time_unit chunk_duration)
+    : chunk_duration_{chunk_duration}, contributors_{0}, dropped_{0} {
+  DEBUG_ONLY_DEFINITION(obj_name_ = "WaveImpl");
+  massert(chunk_duration > 0, "sanity");
+  gpioWaveClear();
+}
+
+WaveImpl::~WaveImpl() {
+  stop();
+}
+
+bool WaveImpl::acquire(const PI_PIN& pin) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  reclaim();
+
+  if (contributors_ & mask(pin)) {
+    // every other contributor has had its turn, close the pending chunk
+    return commit() == ATM_OK;
+  }
+
+  return true;
+}
+
+ATM_STATUS WaveImpl::add(const PI_PIN& pin, pulses& pulses) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  if (static_cast<std::size_t>(pin) >= max_pins) {
+    LOG_ERROR("Pin {} cannot be part of the wave", pin);
+    return ATM_ERR;
+  }
+
+  auto& pending = pending_[static_cast<std::size_t>(pin)];
+
+  if (pending.empty()) {
+    // hand the empty buffer back, no pulse is copied
+    pending.swap(pulses);
+  } else {
+    pending.insert(pending.end(), pulses.begin(), pulses.end());
+  }
+
+  pulses.clear();
+  contributors_ |= mask(pin);
+
+  return ATM_OK;
+}
+
+bool WaveImpl::drop(const PI_PIN& pin) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  if (static_cast<std::size_t>(pin) >= max_pins ||
+      !(contributors_ & mask(pin))) {
+    return false;
+  }
+
+  pending_[static_cast<std::size_t>(pin)].clear();
+  contributors_ &= ~mask(pin);
+
+  return true;
+}
+
+ATM_STATUS WaveImpl::flush() {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  reclaim();
+
+  if (contributors_ == 0) {
+    return ATM_OK;
+  }
+
+  return commit();
+}
+
+void WaveImpl::stop() {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  gpioWaveTxStop();
+
+  for (const auto& chunk : in_flight_) {
+    gpioWaveDelete(static_cast<unsigned>(chunk.id));
+  }
+
+  in_flight_.clear();
+  discard();
+}
+
+bool WaveImpl::dropped(const PI_PIN& pin) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  if (!(dropped_ & mask(pin))) {
+    return false;
+  }
+
+  dropped_ &= ~mask(pin);
+  return true;
+}
+
+bool WaveImpl::pending(const PI_PIN& pin) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return contributors_ & mask(pin);
+}
+
+bool WaveImpl::transmitting(const PI_PIN& pin) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  reclaim();
+
+  for (const auto& chunk : in_flight_) {
+    if (chunk.contributors & mask(pin)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool WaveImpl::busy() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  reclaim();
+  return contributors_ != 0 || !in_flight_.empty();
+}
+
+ATM_STATUS WaveImpl::commit() {
+  if (in_flight_.size() >= max_in_flight) {
+    return ATM_ERR;
+  }
+
+  for (std::size_t pin = 0; pin < max_pins; ++pin) {
+    auto& pending = pending_[pin];
+
+    if (pending.empty()) {
+      continue;
+    }
+
+    if (gpioWaveAddGeneric(static_cast<unsigned>(pending.size()),
+                           pending.data()) < 0) {
+      LOG_ERROR("Cannot add {} pulses of pin {} to the wave", pending.size(),
+                pin);
+      discard();
+      return ATM_ERR;
+    }
+
+    pending.clear();
+  }
+
+  // pad chunk so consecutive chunks are back to back
+  gpioPulse_t padding[] = {{0, 0, static_cast<uint32_t>(chunk_duration())}};
+  if (gpioWaveAddGeneric(1, padding) < 0) {
+    LOG_ERROR("Cannot pad the wave to {} micros", chunk_duration());
+    discard();
+    return ATM_ERR;
+  }
+
+  // half of the resources for each buffer
+  int wave_id = gpioWaveCreatePad(50, 50, 0);
+  if (wave_id < 0) {
+    LOG_ERROR("Cannot create wave, status {}", wave_id);
+    discard();
+    return ATM_ERR;
+  }
+
+  if (gpioWaveTxSend(static_cast<unsigned>(wave_id),
+                     PI_WAVE_MODE_ONE_SHOT_SYNC) < 0) {
+    LOG_ERROR("Cannot transmit wave {}", wave_id);
+    gpioWaveDelete(static_cast<unsigned>(wave_id));
+    discard();
+    return ATM_ERR;
+  }
+
+  in_flight_.push_back({wave_id, contributors_});
+  contributors_ = 0;
+  gpioWaveAddNew();
+
+  return ATM_OK;
+}
+
+void WaveImpl::discard() {
+  for (auto& pending : pending_) {
+    pending.clear();
+  }
+
+  // steps of the contributors have been counted already
+  dropped_ |= contributors_;
+  contributors_ = 0;
+  gpioWaveAddNew();
+}
+
+void WaveImpl::reclaim() {
+  const int current = gpioWaveTxAt();
+
+  while (!in_flight_.empty() && in_flight_.front().id != current) {
+    gpioWaveDelete(static_cast<unsigned>(in_flight_.front().id));
+    in_flight_.pop_front();
+  }
+}
+}  // namespace impl
+}  // namespace device
+
+NAMESPACE_END
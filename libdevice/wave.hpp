@@ -0,0 +1,254 @@
+#ifndef LIB_DEVICE_WAVE_HPP_
+#define LIB_DEVICE_WAVE_HPP_
+
+/** @file wave.hpp
+ *  @brief Wave (DMA pulse train) transmitter class definition
+ *
+ * Wave transmitter using Pigpio waveform API
+ */
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+#include <libutil/util.hpp>
+
+#include <libcore/core.hpp>
+
+#include "gpio.hpp"
+
+NAMESPACE_BEGIN
+
+namespace device {
+// forward declaration
+namespace impl {
+class WaveImpl;
+}
+
+/** impl::WaveImpl singleton class using StaticObj */
+using Wave = StaticObj<impl::WaveImpl>;
+
+namespace impl {
+/**
+ * @brief Wave transmitter implementation.
+ *
+ * Pigpio can only transmit one waveform at a time, so every device that
+ * wants to emit pulses through DMA has to contribute its pulses into the same
+ * chunk. A chunk is a fixed time window, pulses inside the window are merged
+ * by Pigpio based on their timestamp.
+ *
+ * Chunks are double buffered, while one chunk is being transmitted the next
+ * one is queued with PI_WAVE_MODE_ONE_SHOT_SYNC so it starts exactly when the
+ * current one ends.
+ *
+ * Contribution protocol:
+ * - device calls acquire() before adding its pulses
+ * - if the device has already contributed to the pending chunk, the chunk
+ *   is committed first (every other device has had its turn)
+ * - acquire() returns false when both buffers are still in flight
+ *
+ * Pulses of every pin are kept apart until the chunk is committed, so a
+ * single stepper can drop its pulses from the pending chunk without touching
+ * the other ones. Chunks that are in flight are transmitted as they are,
+ * every chunk remembers its contributors so a pin knows when its last pulse
+ * has left.
+ *
+ * When a chunk cannot be committed its pulses are lost, every contributor
+ * is notified through dropped() so it can take its steps back.
+ */
+class WaveImpl : public StackObj {
+  template <class WaveImpl>
+  template <typename... Args>
+  friend ATM_STATUS StaticObj<WaveImpl>::create(Args&&... args);
+
+ public:
+  /**
+   * Pulses container
+   */
+  typedef std::vector<gpioPulse_t> pulses;
+  /**
+   * Acquire pending chunk for given pin
+   *
+   * @param pin GPIO pin that will contribute pulses
+   *
+   * @return true if pin can add its pulses to the pending chunk
+   */
+  bool acquire(const PI_PIN& pin);
+  /**
+   * Add pulses of given pin to the pending chunk
+   *
+   * Pulses are relative to the beginning of the chunk and must not exceed
+   * chunk duration. They are moved out, caller gets back an empty buffer
+   * that keeps its capacity
+   *
+   * @param pin     GPIO pin that contributes pulses
+   * @param pulses  pulses to add
+   *
+   * @return ATM_OK or ATM_ERR if the pin cannot be part of the wave
+   */
+  ATM_STATUS add(const PI_PIN& pin, pulses& pulses);
+  /**
+   * Drop pulses of given pin from the pending chunk
+   *
+   * @param pin GPIO pin
+   *
+   * @return true if the pin had pulses in the pending chunk
+   */
+  bool drop(const PI_PIN& pin);
+  /**
+   * Commit pending chunk if there is any
+   *
+   * @return ATM_OK or ATM_ERR (both buffers are still in flight)
+   */
+  ATM_STATUS flush();
+  /**
+   * Stop transmission and drop all chunks
+   *
+   * Pulses of the chunks in flight are cut wherever DMA is, contributors
+   * cannot tell how many of them went out
+   */
+  void stop();
+  /**
+   * Take notice of dropped pulses of given pin
+   *
+   * Notice is cleared once it is taken
+   *
+   * @param pin GPIO pin
+   *
+   * @return true if pulses of the pin have been dropped on commit
+   */
+  bool dropped(const PI_PIN& pin);
+  /**
+   * Check whether given pin has pulses in the pending chunk
+   *
+   * @param pin GPIO pin
+   *
+   * @return pending or not
+   */
+  bool pending(const PI_PIN& pin) const;
+  /**
+   * Check whether given pin has pulses in a chunk that is in flight
+   *
+   * @param pin GPIO pin
+   *
+   * @return transmitting or not
+   */
+  bool transmitting(const PI_PIN& pin);
+  /**
+   * Check whether there is a pending or transmitting chunk
+   *
+   * @return busy or not
+   */
+  bool busy();
+  /**
+   * Get duration of single chunk
+   *
+   * @return chunk duration in micros
+   */
+  inline const time_unit& chunk_duration() const { return chunk_duration_; }
+  /**
+   * Get poll interval for the contributors
+   *
+   * All contributors must use the same interval so they stay in lock-step
+   *
+   * @return poll interval in micros
+   */
+  inline time_unit poll_interval() const { return chunk_duration() / 2; }
+
+ private:
+  /**
+   * WaveImpl Constructor
+   *
+   * Clear all waveforms that have been created before
+   *
+   * @param chunk_duration duration of single chunk in micros
+   */
+  explicit WaveImpl(time_unit chunk_duration = 5000);
+  /**
+   * WaveImpl Destructor
+   *
+   * Stop transmission and clear all waveforms
+   */
+  ~WaveImpl();
+  /**
+   * Commit pending chunk
+   *
+   * Lock must be held by the caller
+   *
+   * @return ATM_OK or ATM_ERR, but not both
+   */
+  ATM_STATUS commit();
+  /**
+   * Drop pending chunk and notify its contributors
+   *
+   * Lock must be held by the caller
+   */
+  void discard();
+  /**
+   * Delete waves that have been transmitted
+   *
+   * Lock must be held by the caller
+   */
+  void reclaim();
+  /**
+   * Get bit mask of given pin
+   *
+   * @param pin GPIO pin
+   *
+   * @return bit mask
+   */
+  static inline uint32_t mask(const PI_PIN& pin) {
+    return static_cast<uint32_t>(1) << static_cast<unsigned int>(pin);
+  }
+
+ private:
+  /**
+   * Chunk that has been handed to DMA
+   */
+  struct chunk {
+    /** wave id */
+    int id;
+    /** mask of pins that have pulses in the chunk */
+    uint32_t contributors;
+  };
+  /**
+   * Max chunks in flight (double buffer)
+   */
+  static const std::size_t max_in_flight;
+  /**
+   * Number of pins that fit in the contributor mask
+   */
+  static constexpr std::size_t max_pins = 32;
+  /**
+   * Duration of single chunk in micros
+   */
+  const time_unit chunk_duration_;
+  /**
+   * Mask of pins that have contributed to the pending chunk
+   */
+  uint32_t contributors_;
+  /**
+   * Mask of pins whose pulses have been dropped on commit
+   */
+  uint32_t dropped_;
+  /**
+   * Pulses of every pin in the pending chunk, buffers are reused
+   */
+  std::array<pulses, max_pins> pending_;
+  /**
+   * Chunks that are being transmitted or queued
+   */
+  std::deque<chunk> in_flight_;
+  /**
+   * Mutex
+   */
+  mutable std::mutex mutex_;
+};
+}  // namespace impl
+}  // namespace device
+
+NAMESPACE_END
+
+#endif  // LIB_DEVICE_WAVE_HPP_
@@ -2,6 +2,8 @@
 
 #include "fault-window.hpp"
 
+#include <algorithm>
+
 #include "util.hpp"
 
 NAMESPACE_BEGIN
@@ -12,7 +14,9 @@ FaultWindow::FaultWindow(machine::tending*       tsm,
                          float                   width,
                          float                   height,
                          const ImGuiWindowFlags& flags)
-    : Window{"Fault", width, height, flags}, tsm_{tsm} {}
+    : Window{"Fault", width, height, flags},
+      tsm_{tsm},
+      listed_{static_cast<std::size_t>(-1)} {}
 
 FaultWindow::~FaultWindow() {}
 
@@ -74,6 +78,7 @@ void FaultWindow::show([[maybe_unused]] Manager* manager) {
 
     if (util::button("FAULT\nTRIGGER", id++, fault, size)) {
       LOG_ERROR("[FAULT] fault trigger");
+      machine::util::record_fault(flight::fault::manual);
       state->fault(true);
       tsm()->fault();
     }
@@ -101,6 +106,35 @@ void FaultWindow::show([[maybe_unused]] Manager* manager) {
     }
   }
   ImGui::NextColumn();
+  ImGui::Columns(1);
+
+  show_bundles();
+}
+
+void FaultWindow::show_bundles() {
+  if (!PostMortem::created()) {
+    return;
+  }
+
+  auto* post_mortem = PostMortem::get();
+
+  // directory is only listed again once another bundle is written
+  if (const std::size_t written = post_mortem->written();
+      written != listed_) {
+    postmortem::list(post_mortem->directory(), bundles_);
+    listed_ = written;
+  }
+
+  ImGui::Separator();
+  ImGui::Text("Post-mortem bundles (%zu)%s", bundles_.size(),
+              post_mortem->pending() ? ", writing..." : "");
+
+  const std::size_t size = std::min(bundles_.size(), shown_bundles);
+  for (std::size_t idx = 0; idx < size; ++idx) {
+    ImGui::Text("%s (%.1f KiB)",
+                bundles_[idx].path.filename().string().c_str(),
+                static_cast<double>(bundles_[idx].size) / 1024.0);
+  }
 }
 }  // namespace gui
 
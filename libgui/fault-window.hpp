@@ -1,6 +1,9 @@
 #ifndef LIB_GUI_FAULT_WINDOW_HPP_
 #define LIB_GUI_FAULT_WINDOW_HPP_
 
+#include <cstddef>
+#include <vector>
+
 #include <libcore/core.hpp>
 #include <libmachine/machine.hpp>
 
@@ -44,12 +47,28 @@ class FaultWindow : public Window {
    * @return state machine
    */
   inline machine::tending* tsm() { return tsm_; }
+  /**
+   * Show latest post-mortem bundles
+   */
+  void show_bundles();
 
  private:
+  /**
+   * Number of bundles shown
+   */
+  static constexpr std::size_t shown_bundles = 5;
   /**
    * State machine
    */
   machine::tending* tsm_;
+  /**
+   * Latest post-mortem bundles, newest first
+   */
+  std::vector<postmortem::bundle> bundles_;
+  /**
+   * Number of written bundles when the directory was listed
+   */
+  std::size_t listed_;
 };
 }  // namespace gui
 
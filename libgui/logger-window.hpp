@@ -2,7 +2,11 @@
 #define LIB_GUI_LOGGER_WINDOW_HPP_
 
 #include <array>
+#include <bitset>
+#include <cstddef>
 #include <mutex>
+#include <string>
+#include <vector>
 
 #include <spdlog/details/null_mutex.h>
 #include <spdlog/sinks/base_sink.h>
@@ -23,6 +27,17 @@ class LoggerWindow;
 using LoggerWindowMT = LoggerWindow<std::mutex>;
 using LoggerWindowST = LoggerWindow<spdlog::details::null_mutex>;
 
+/**
+ * @brief Logger window.
+ *
+ * Spdlog sink that keeps the latest messages in preallocated slots of a ring,
+ * sinking a message never allocates. Render thread only keeps the sequences
+ * of the shown messages and renders the visible ones, so render cost does not
+ * depend on how many messages are buffered
+ *
+ * Messages are indexed as they arrive, by level and by a signature of their
+ * trigrams, so changing the level or searching does not scan every message
+ */
 template <typename Mutex>
 class LoggerWindow : public Window, public spdlog::sinks::base_sink<Mutex> {
  public:
@@ -52,48 +67,181 @@ class LoggerWindow : public Window, public spdlog::sinks::base_sink<Mutex> {
    * Buffer Size
    */
   static constexpr std::size_t BufferSize = 1000;
+  /**
+   * Max message length, longer message is truncated
+   */
+  static constexpr std::size_t MessageSize = 256;
+  /**
+   * Bits of trigram signature of a message
+   */
+  static constexpr std::size_t SignatureSize = 512;
+  /**
+   * No sequence
+   */
+  static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+  /**
+   * Trigram signature, bit of hash of every lowercase trigram is set
+   */
+  typedef std::bitset<SignatureSize> Signature;
   /**
    * Buffer type
    */
   typedef struct BufferType {
-    std::string               message;
     spdlog::level::level_enum level;
+    std::size_t               size;
+    Signature                 signature;
+    char                      message[MessageSize];
   } BufferType;
+  /**
+   * @brief Ascending sequences of messages.
+   *
+   * Overwritten sequences are dropped from the front without moving the
+   * others until they take up a whole buffer, so it never allocates after
+   * construction
+   */
+  class Sequences {
+   public:
+    /**
+     * Sequences constructor
+     */
+    Sequences() : begin_{0} {
+      // live sequences, overwritten ones and one frame of new ones
+      sequences_.reserve(3 * BufferSize);
+    }
+    /**
+     * Get number of sequences
+     *
+     * @return number of sequences
+     */
+    inline std::size_t size() const { return sequences_.size() - begin_; }
+    /**
+     * Check whether there is any sequence or not
+     *
+     * @return true if there is no sequence
+     */
+    inline bool empty() const { return size() == 0; }
+    /**
+     * Get sequence on specified index
+     *
+     * @param idx index
+     *
+     * @return sequence
+     */
+    inline std::size_t operator[](std::size_t idx) const {
+      massert(idx < size(), "sanity");
+      return sequences_[begin_ + idx];
+    }
+    /**
+     * Push sequence, must be greater than the last one
+     *
+     * @param seq sequence
+     */
+    inline void push(std::size_t seq) { sequences_.push_back(seq); }
+    /**
+     * Remove every sequence
+     */
+    inline void clear() {
+      sequences_.clear();
+      begin_ = 0;
+    }
+    /**
+     * Drop overwritten sequences
+     *
+     * @param tail sequence of oldest message
+     */
+    void prune(std::size_t tail);
+    /**
+     * Find sequence
+     *
+     * @param seq sequence
+     *
+     * @return index of first sequence that is not less than seq
+     */
+    std::size_t find(std::size_t seq) const;
+
+   private:
+    /**
+     * Sequences, starts at begin_
+     */
+    std::vector<std::size_t> sequences_;
+    /**
+     * First valid index of sequences_
+     */
+    std::size_t begin_;
+  };
   /**
    * Buffer container Type
    */
   typedef std::array<BufferType, BufferSize> Buffer;
   /**
-   * Get string buffer
+   * Get message on specified sequence
    *
-   * @return string buffer
-   */
-  inline Buffer& buffer() { return buffer_; }
-  /**
-   * Get string buffer (const)
+   * Sink mutex must be held
+   *
+   * @param seq sequence of message
    *
-   * @return string buffer (const)
+   * @return message
    */
-  inline const Buffer& buffer() const { return buffer_; }
+  inline const BufferType& buffer(std::size_t seq) const {
+    massert(seq >= tail() && seq < head(), "sanity");
+    return buffer_[seq % BufferSize];
+  }
   /**
-   * Get string on specified index
+   * Get sequence of next message
+   *
+   * @return sequence of next message
    */
-  inline const BufferType& buffer(std::size_t idx) const {
-    massert(idx < count(), "sanity");
-    return buffer_[idx];
-  }
+  inline const std::size_t& head() const { return head_; }
   /**
-   * Get buffer count
+   * Get sequence of oldest message that has not been overwritten
    *
-   * @return buffer count
+   * @return sequence of oldest message
    */
-  inline const std::size_t& count() const { return count_; }
+  inline std::size_t tail() const {
+    return head_ > BufferSize ? head_ - BufferSize : 0;
+  }
   /**
    * Get log level to show
    *
    * @return log level to show
    */
   inline const spdlog::level::level_enum& level() const { return level_; }
+  /**
+   * Get trigram signature of a text
+   *
+   * @param text text
+   * @param size length of text
+   *
+   * @return signature
+   */
+  static Signature signature(const char* text, std::size_t size);
+  /**
+   * Update sequences of shown and matched messages with new messages
+   *
+   * Sink mutex must be held
+   */
+  void filter();
+  /**
+   * Check whether message contains the query or not, case insensitive
+   *
+   * @param payload message
+   *
+   * @return true if message contains the query
+   */
+  bool matches(const BufferType& payload) const;
+  /**
+   * Move to next or previous match
+   *
+   * @param forward move to next match if true, previous one otherwise
+   */
+  void jump(bool forward);
+  /**
+   * Render message
+   *
+   * @param payload message
+   * @param matched message contains the query
+   */
+  void render(const BufferType& payload, bool matched) const;
 
  protected:
   /**
@@ -107,13 +255,62 @@ class LoggerWindow : public Window, public spdlog::sinks::base_sink<Mutex> {
 
  private:
   /**
-   * Text Buffer
+   * Text Buffer, preallocated message slots
    */
   Buffer buffer_;
   /**
-   * Num of item in buffer
+   * Sequence of next message, total number of messages
+   */
+  std::size_t head_;
+  /**
+   * Sequences of messages of each level
+   */
+  std::array<Sequences, spdlog::level::n_levels> levels_;
+  /**
+   * Sequences of shown messages, only accessed by render thread
+   */
+  Sequences filtered_;
+  /**
+   * Sequence of next message to filter
+   */
+  std::size_t filtered_head_;
+  /**
+   * Level filtered_ has been built for
+   */
+  spdlog::level::level_enum filtered_level_;
+  /**
+   * Sequences of shown messages that contain the query, only accessed by
+   * render thread
+   */
+  Sequences matches_;
+  /**
+   * Sequence of next message to search
+   */
+  std::size_t matched_head_;
+  /**
+   * Query matches_ has been built for
+   */
+  std::string searched_;
+  /**
+   * Signature of searched_
+   */
+  Signature searched_signature_;
+  /**
+   * Sequence of current match, npos if there is none
+   */
+  std::size_t match_;
+  /**
+   * Scroll to current match on next frame
+   */
+  bool jump_;
+  /**
+   * Show matches only
+   */
+  bool matches_only_;
+  /**
+   * Query to search
    */
-  std::size_t count_;
+  std::string query_;
   /**
    * Current level to show
    */
@@ -3,6 +3,9 @@
 
 #include "logger-window.hpp"
 
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
 #include <cstring>
 
 #include <external/imgui/misc/cpp/imgui_stdlib.h>
@@ -17,7 +20,13 @@ LoggerWindow<Mutex>::LoggerWindow(float                   width,
                                   float                   height,
                                   const ImGuiWindowFlags& flags)
     : Window{"Logger", width, height, ImGuiWindowFlags_AlwaysVerticalScrollbar},
-      count_{0},
+      head_{0},
+      filtered_head_{0},
+      filtered_level_{spdlog::level::trace},
+      matched_head_{0},
+      match_{npos},
+      jump_{false},
+      matches_only_{false},
       level_{spdlog::level::trace} {}
 
 template <typename Mutex>
@@ -28,8 +37,6 @@ LoggerWindow<Mutex>::~LoggerWindow() {
 template <typename Mutex>
 void LoggerWindow<Mutex>::show(Manager* manager) {
   // const ImGuiInputTextFlags flags = ImGuiInputTextFlags_ReadOnly;
-  const ImVec2 window_size = ImGui::GetWindowSize();
-  float        wrap_width = window_size.x - 24;
   // const float  footer_height_to_reserve =
   //     ImGui::GetStyle().ItemSpacing.y + ImGui::GetFrameHeightWithSpacing();
   ImGui::PushFont(manager->logging_font());
@@ -63,54 +70,81 @@ void LoggerWindow<Mutex>::show(Manager* manager) {
   }
 
   {
+    ImGui::SetNextItemWidth(200);
+    if (ImGui::InputTextWithHint("##search", "search", &query_,
+                                 ImGuiInputTextFlags_EnterReturnsTrue)) {
+      jump(true);
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("<")) {
+      jump(false);
+    }
+    ImGui::SameLine();
+    if (ImGui::Button(">")) {
+      jump(true);
+    }
+    ImGui::SameLine();
+    ImGui::Checkbox("matches only", &matches_only_);
+    ImGui::SameLine();
+  }
+
+  {
+    std::lock_guard<Mutex> lock(this->mutex_);
+    filter();
+  }
+
+  {
+    const std::size_t idx = matches_.find(match_);
+    if (idx < matches_.size() && matches_[idx] == match_) {
+      ImGui::Text("%zu/%zu", idx + 1, matches_.size());
+    } else {
+      ImGui::Text("%zu matches", matches_.size());
+    }
+  }
+
+  {
+    // one line per message, clipper needs a fixed line height
     ImGui::BeginChild("ScrollingRegion", ImVec2{0, -FLT_MIN}, false,
-                      ImGuiWindowFlags_NoScrollbar);
-    ImGui::SetScrollX(0);
+                      ImGuiWindowFlags_HorizontalScrollbar);
 
-    ImGui::PushTextWrapPos(ImGui::GetCursorPos().x + wrap_width);
     ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing,
                         ImVec2(4, 1));  // Tighten spacing
-    for (std::size_t i = 0; i < count(); ++i) {
-      const auto& payload = buffer(i);
-      ImVec4      color;
-      bool        has_color = false;
-
-      if ((level() != spdlog::level::trace) && (payload.level != level()))
-        continue;
-
-      if (payload.level == spdlog::level::err) {
-        // red
-        color = util::color::red;
-        has_color = true;
-      }
 
-      if (payload.level == spdlog::level::info) {
-        // blue
-        color = util::color::blue;
-        has_color = true;
-      }
+    const Sequences& rows = matches_only_ ? matches_ : filtered_;
+    const bool       jumped = jump_;
 
-      if (payload.level == spdlog::level::debug) {
-        // green
-        color = util::color::green;
-        has_color = true;
-      }
+    if (jump_) {
+      // center current match
+      const float height = ImGui::GetTextLineHeightWithSpacing();
+      ImGui::SetScrollY(
+          std::max(0.0f, static_cast<float>(rows.find(match_)) * height -
+                             (ImGui::GetWindowHeight() - height) / 2));
+      jump_ = false;
+    }
 
-      // render level
-      if (has_color)
-        ImGui::PushStyleColor(ImGuiCol_Text, color);
-      ImGui::Text("[%s]", spdlog::level::to_string_view(payload.level));
-      if (has_color)
-        ImGui::PopStyleColor();
+    ImGuiListClipper clipper;
+    clipper.Begin(static_cast<int>(rows.size()));
+    while (clipper.Step()) {
+      // visible messages only, sink waits for a few lines at most
+      std::lock_guard<Mutex> lock(this->mutex_);
 
-      ImGui::SameLine();
+      for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row) {
+        const std::size_t seq = rows[static_cast<std::size_t>(row)];
 
-      // render message
-      ImGui::Text(payload.message.c_str(), wrap_width);
+        if (seq < tail()) {
+          // overwritten since filtered, dropped next frame
+          ImGui::NewLine();
+          continue;
+        }
+
+        render(buffer(seq), matches(buffer(seq)));
+      }
     }
+    clipper.End();
+
     ImGui::PopStyleVar();
 
-    if (ImGui::GetScrollY() >= ImGui::GetScrollMaxY()) {
+    if (!jumped && ImGui::GetScrollY() >= ImGui::GetScrollMaxY()) {
       ImGui::SetScrollHereY(1.0f);
     }
 
@@ -120,12 +154,191 @@ void LoggerWindow<Mutex>::show(Manager* manager) {
 }
 
 template <typename Mutex>
-void LoggerWindow<Mutex>::sink_it_(const spdlog::details::log_msg& msg) {
-  if (count() + 1 >= LoggerWindow::BufferSize) {
-    count_ = 0;
+void LoggerWindow<Mutex>::Sequences::prune(std::size_t tail) {
+  while (begin_ < sequences_.size() && sequences_[begin_] < tail) {
+    ++begin_;
+  }
+
+  if (begin_ >= BufferSize) {
+    sequences_.erase(sequences_.begin(),
+                     sequences_.begin() + static_cast<std::ptrdiff_t>(begin_));
+    begin_ = 0;
   }
+}
+
+template <typename Mutex>
+std::size_t LoggerWindow<Mutex>::Sequences::find(std::size_t seq) const {
+  const auto begin = sequences_.begin() + static_cast<std::ptrdiff_t>(begin_);
+  return static_cast<std::size_t>(
+      std::lower_bound(begin, sequences_.end(), seq) - begin);
+}
+
+template <typename Mutex>
+typename LoggerWindow<Mutex>::Signature LoggerWindow<Mutex>::signature(
+    const char* text,
+    std::size_t size) {
+  Signature retval;
+
+  for (std::size_t i = 0; i + 3 <= size; ++i) {
+    // FNV-1a of lowercase trigram
+    std::uint32_t hash = 2166136261u;
+    for (std::size_t j = i; j < i + 3; ++j) {
+      hash ^= static_cast<std::uint32_t>(
+          std::tolower(static_cast<unsigned char>(text[j])));
+      hash *= 16777619u;
+    }
+    retval.set(hash % SignatureSize);
+  }
+
+  return retval;
+}
+
+template <typename Mutex>
+void LoggerWindow<Mutex>::filter() {
+  const bool refilter = filtered_level_ != level();
+
+  if (refilter) {
+    filtered_.clear();
+    filtered_head_ = 0;
+    filtered_level_ = level();
+  }
+
+  if (refilter || searched_ != query_) {
+    matches_.clear();
+    matched_head_ = 0;
+    searched_ = query_;
+    searched_signature_ = signature(searched_.data(), searched_.size());
+    match_ = npos;
+  }
+
+  filtered_.prune(tail());
+  matches_.prune(tail());
+
+  // new messages of the level from its index, nothing else is visited
+  const std::size_t from = std::max(filtered_head_, tail());
+
+  if (level() == spdlog::level::trace) {
+    for (std::size_t seq = from; seq < head(); ++seq) {
+      filtered_.push(seq);
+    }
+  } else {
+    const Sequences& sequences = levels_[level()];
+
+    for (std::size_t idx = sequences.find(from); idx < sequences.size();
+         ++idx) {
+      filtered_.push(sequences[idx]);
+    }
+  }
+
+  filtered_head_ = head();
+
+  if (!searched_.empty()) {
+    for (std::size_t idx = filtered_.find(std::max(matched_head_, tail()));
+         idx < filtered_.size(); ++idx) {
+      if (matches(buffer(filtered_[idx]))) {
+        matches_.push(filtered_[idx]);
+      }
+    }
+  }
+
+  matched_head_ = head();
+}
+
+template <typename Mutex>
+bool LoggerWindow<Mutex>::matches(const BufferType& payload) const {
+  if (searched_.empty() ||
+      (payload.signature & searched_signature_) != searched_signature_) {
+    return false;
+  }
+
+  // signature may be a false positive
+  return std::search(payload.message, payload.message + payload.size,
+                     searched_.begin(), searched_.end(),
+                     [](char lhs, char rhs) {
+                       return std::tolower(static_cast<unsigned char>(lhs)) ==
+                              std::tolower(static_cast<unsigned char>(rhs));
+                     }) != payload.message + payload.size;
+}
+
+template <typename Mutex>
+void LoggerWindow<Mutex>::jump(bool forward) {
+  if (matches_.empty()) {
+    return;
+  }
+
+  std::size_t idx = matches_.find(match_);
+
+  if (forward) {
+    if (idx < matches_.size() && matches_[idx] == match_) {
+      ++idx;
+    }
+    idx = idx < matches_.size() ? idx : 0;
+  } else {
+    idx = idx > 0 ? idx - 1 : matches_.size() - 1;
+  }
+
+  match_ = matches_[idx];
+  jump_ = true;
+}
+
+template <typename Mutex>
+void LoggerWindow<Mutex>::render(const BufferType& payload,
+                                 bool              matched) const {
+  ImVec4 color;
+  bool   has_color = false;
+
+  if (payload.level == spdlog::level::err) {
+    // red
+    color = util::color::red;
+    has_color = true;
+  }
+
+  if (payload.level == spdlog::level::info) {
+    // blue
+    color = util::color::blue;
+    has_color = true;
+  }
+
+  if (payload.level == spdlog::level::debug) {
+    // green
+    color = util::color::green;
+    has_color = true;
+  }
+
+  // render level
+  if (has_color)
+    ImGui::PushStyleColor(ImGuiCol_Text, color);
+  ImGui::Text("[%s]", spdlog::level::to_string_view(payload.level).data());
+  if (has_color)
+    ImGui::PopStyleColor();
+
+  ImGui::SameLine();
+
+  // render message, message is not a format
+  if (matched)
+    ImGui::PushStyleColor(ImGuiCol_Text, util::color::yellow);
+  ImGui::TextUnformatted(payload.message, payload.message + payload.size);
+  if (matched)
+    ImGui::PopStyleColor();
+}
+
+template <typename Mutex>
+void LoggerWindow<Mutex>::sink_it_(const spdlog::details::log_msg& msg) {
+  auto&             payload = buffer_[head_ % BufferSize];
+  const std::size_t size = std::min(msg.payload.size(), MessageSize - 1);
+
+  std::memcpy(payload.message, msg.payload.data(), size);
+  // keep one line per message
+  std::replace(payload.message, payload.message + size, '\n', ' ');
+  payload.message[size] = '\0';
+  payload.size = size;
+  payload.level = msg.level;
+  payload.signature = signature(payload.message, size);
+
+  levels_[msg.level].prune(tail());
+  levels_[msg.level].push(head_);
 
-  buffer_[count_++] = {std::move(fmt::to_string(msg.payload)), msg.level};
+  ++head_;
 }
 
 template <typename Mutex>
@@ -14,9 +14,7 @@ ManualMovementWindow::ManualMovementWindow(machine::tending*       tsm,
                                            float                   width,
                                            float                   height,
                                            const ImGuiWindowFlags& flags)
-    : Window{"Manual Movement", width, height, flags},
-      tsm_{tsm},
-      thread_pool_{1} {}
+    : Window{"Manual Movement", width, height, flags}, tsm_{tsm} {}
 
 ManualMovementWindow::~ManualMovementWindow() {}
 
@@ -33,11 +31,12 @@ void ManualMovementWindow::show(Manager* manager) {
 
   const ImVec2 button_size = util::size::h_wide(94);
 
-  const double x_manual = config->fault_manual_movement<double>("x");
-  const double y_manual = config->fault_manual_movement<double>("y");
-  const double z_manual = config->fault_manual_movement<double>("z");
+  const auto   manual = config->fault_manual_movement();
+  const double x_manual = manual.x;
+  const double y_manual = manual.y;
+  const double z_manual = manual.z;
 
-  const bool disabled = !state->manual_mode() || !movement->ready();
+  const bool disabled = !state->manual_mode() || !movement->snapshot().ready;
 
   ImGui::PushFont(manager->button_font());
   if (disabled) {
@@ -51,43 +50,31 @@ void ManualMovementWindow::show(Manager* manager) {
       ImGui::Separator();
 
     if (ImGui::Button("X+", button_size)) {
-      thread_pool().enqueue([this, x_manual]() {
-        move<mechanism::movement::unit::mm>(x_manual, 0.0, 0.0);
-      });
+      move<mechanism::movement::unit::mm>(x_manual, 0.0, 0.0);
     }
 
     if (ImGui::Button("X-", button_size)) {
-      thread_pool().enqueue([this, x_manual]() {
-        move<mechanism::movement::unit::mm>(-x_manual, 0.0, 0.0);
-      });
+      move<mechanism::movement::unit::mm>(-x_manual, 0.0, 0.0);
     }
   }
   ImGui::NextColumn();
   {
     if (ImGui::Button("Y+", button_size)) {
-      thread_pool().enqueue([this, y_manual]() {
-        move<mechanism::movement::unit::mm>(0.0, y_manual, 0.0);
-      });
+      move<mechanism::movement::unit::mm>(0.0, y_manual, 0.0);
     }
 
     if (ImGui::Button("Y-", button_size)) {
-      thread_pool().enqueue([this, y_manual]() {
-        move<mechanism::movement::unit::mm>(0.0, -y_manual, 0.0);
-      });
+      move<mechanism::movement::unit::mm>(0.0, -y_manual, 0.0);
     }
   }
   ImGui::NextColumn();
   {
     if (ImGui::Button("Z+", button_size)) {
-      thread_pool().enqueue([this, z_manual]() {
-        move<mechanism::movement::unit::mm>(0.0, 0.0, z_manual);
-      });
+      move<mechanism::movement::unit::mm>(0.0, 0.0, z_manual);
     }
 
     if (ImGui::Button("Z-", button_size)) {
-      thread_pool().enqueue([this, z_manual]() {
-        move<mechanism::movement::unit::mm>(0.0, 0.0, -z_manual);
-      });
+      move<mechanism::movement::unit::mm>(0.0, 0.0, -z_manual);
     }
   }
   ImGui::NextColumn();
@@ -95,14 +82,35 @@ void ManualMovementWindow::show(Manager* manager) {
   ImGui::Columns(1);
   ImGui::Separator();
   if (ImGui::Button("HOME", button_size)) {
-    thread_pool().enqueue([movement]() mutable { movement->homing(); });
+    motion_ = mechanism::MotionExecutor::get()->homing_async();
   }
 
   if (disabled) {
     ImGui::PopItemFlag();
     ImGui::PopStyleVar();
   }
+
+  const bool moving = motion_.has_value() && !motion_->done();
+
+  if (!moving) {
+    ImGui::PushItemFlag(ImGuiItemFlags_Disabled, true);
+    ImGui::PushStyleVar(ImGuiStyleVar_Alpha, ImGui::GetStyle().Alpha * 0.5f);
+  }
+
+  // decelerate instead of cutting the pulses
+  if (ImGui::Button("STOP", button_size)) {
+    motion_->cancel();
+  }
+
+  if (!moving) {
+    ImGui::PopItemFlag();
+    ImGui::PopStyleVar();
+  }
   ImGui::PopFont();
+
+  if (motion_.has_value()) {
+    ImGui::ProgressBar(motion_->progress(), ImVec2(-FLT_MIN, 0.0f));
+  }
 }
 }  // namespace gui
 
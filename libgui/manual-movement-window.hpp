@@ -1,9 +1,11 @@
 #ifndef LIB_GUI_MANUAL_MOVEMENT_WINDOW_HPP_
 #define LIB_GUI_MANUAL_MOVEMENT_WINDOW_HPP_
 
-#include <libalgo/algo.hpp>
+#include <optional>
+
 #include <libcore/core.hpp>
 #include <libmachine/machine.hpp>
+#include <libmechanism/mechanism.hpp>
 
 #include "window.hpp"
 
@@ -46,13 +48,7 @@ class ManualMovementWindow : public Window {
    */
   inline machine::tending* tsm() { return tsm_; }
   /**
-   * Get thread pool
-   *
-   * @return thread pool
-   */
-  inline algo::ThreadPool& thread_pool() { return thread_pool_; }
-  /**
-   * Move single or multi steppers at once
+   * Queue single or multi steppers move to motion executor
    *
    * @tparam Unit movement unit (cm / mm)
    *
@@ -61,17 +57,17 @@ class ManualMovementWindow : public Window {
    * @param z  length of z-axis
    */
   template <mechanism::movement::unit Unit>
-  inline void move(Point x, Point y, Point z) const {
+  inline void move(Point x, Point y, Point z) {
     massert(State::get() != nullptr, "sanity");
     massert(Config::get() != nullptr, "sanity");
 
     auto*       state = State::get();
     const auto* config = Config::get();
-    auto&&      movement = mechanism::movement_mechanism();
+    auto*       executor = mechanism::MotionExecutor::get();
 
-    movement->motor_profile(
+    executor->motor_profile(
         config->fault_speed_profile(state->speed_profile()));
-    movement->move<Unit>(x, y, z);
+    motion_ = executor->move_async<Unit>(x, y, z);
   }
 
  private:
@@ -80,9 +76,9 @@ class ManualMovementWindow : public Window {
    */
   machine::tending* tsm_;
   /**
-   * Movement thread pool
+   * Last queued move or homing
    */
-  algo::ThreadPool thread_pool_;
+  std::optional<mechanism::executor::handle> motion_;
 };
 }  // namespace gui
 
@@ -20,8 +20,8 @@ void MovementWindow::show([[maybe_unused]] Manager* manager) {
   massert(mechanism::movement_mechanism() != nullptr, "sanity");
   massert(mechanism::movement_mechanism()->active(), "sanity");
 
-  auto*  state = State::get();
-  auto&& movement = mechanism::movement_mechanism();
+  // single consistent reading, never blocks the motion thread
+  const auto snapshot = mechanism::movement_mechanism()->snapshot();
 
   ImGui::Columns(3, NULL, /* v_borders */ true);
   {
@@ -29,17 +29,20 @@ void MovementWindow::show([[maybe_unused]] Manager* manager) {
       ImGui::Separator();
 
     ImGui::Text("X");
-    ImGui::Text("%f", state->x());
+    ImGui::Text("%f", snapshot.axes[0].position);
+    ImGui::Text("%f mm/s", snapshot.axes[0].velocity);
   }
   ImGui::NextColumn();
   {
     ImGui::Text("Y");
-    ImGui::Text("%f", state->y());
+    ImGui::Text("%f", snapshot.axes[1].position);
+    ImGui::Text("%f mm/s", snapshot.axes[1].velocity);
   }
   ImGui::NextColumn();
   {
     ImGui::Text("Z");
-    ImGui::Text("%f", state->z());
+    ImGui::Text("%f", snapshot.axes[2].position);
+    ImGui::Text("%f mm/s", snapshot.axes[2].velocity);
   }
   ImGui::NextColumn();
   ImGui::Separator();
@@ -48,7 +51,7 @@ void MovementWindow::show([[maybe_unused]] Manager* manager) {
   // Typically we would use ImVec2(-1.0f,0.0f) or ImVec2(-FLT_MIN,0.0f) to use
   // all available width, or ImVec2(width,0.0f) for a specified width.
   // ImVec2(0.0f,0.0f) uses ItemWidth.
-  ImGui::Text("Move Progress");
+  ImGui::Text("Move Progress (segment %zu)", snapshot.segment);
   ImGui::Separator();
 
   ImGui::PushID(0);
@@ -58,7 +61,7 @@ void MovementWindow::show([[maybe_unused]] Manager* manager) {
   //                       (ImVec4)ImColor::HSV(2 / 7.0f, 0.7f, 0.7f));
   // ImGui::PushStyleColor(ImGuiCol_FrameBgActive,
   //                       (ImVec4)ImColor::HSV(2 / 7.0f, 0.8f, 0.8f));
-  ImGui::ProgressBar(movement->progress(), ImVec2(-FLT_MIN, 0.0f));
+  ImGui::ProgressBar(snapshot.progress, ImVec2(-FLT_MIN, 0.0f));
   ImGui::PopStyleColor(1);
   ImGui::PopID();
   // ImGui::SameLine(0.0f, ImGui::GetStyle().ItemInnerSpacing.x);
@@ -22,9 +22,9 @@ void PLCTriggerWindow::show([[maybe_unused]] Manager* manager) {
 
   auto*  input_registry = device::DigitalInputDeviceRegistry::get();
   auto&& spraying_tending_height =
-      input_registry->get(device::id::comm::plc::spraying_tending_height());
+      input_registry->get(device::key::comm::plc::spraying_tending_height);
   auto&& cleaning_height =
-      input_registry->get(device::id::comm::plc::cleaning_height());
+      input_registry->get(device::key::comm::plc::cleaning_height);
 
   const ImVec2 size{-FLT_MIN, 32.0f};
   unsigned int status_id = 0;
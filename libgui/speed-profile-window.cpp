@@ -28,7 +28,7 @@ void SpeedProfileWindow::show([[maybe_unused]] Manager* manager) {
   const auto&  current_speed = state->speed_profile();
 
   const bool disabled =
-      !tsm()->is_no_task() && (!state->fault() || !movement->ready());
+      !tsm()->is_no_task() && (!state->fault() || !movement->snapshot().ready);
 
   if (disabled) {
     ImGui::PushItemFlag(ImGuiItemFlags_Disabled, true);
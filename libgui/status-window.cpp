@@ -62,6 +62,8 @@ void StatusWindow::show([[maybe_unused]] Manager* manager) {
   ImGui::Columns(1);
   util::status_button("FAULT", status_id++, state->fault(), size);
   util::status_button("HOMING", status_id++, state->homing(), size);
+  ImGui::Text("Last homing : %llu ms",
+              static_cast<unsigned long long>(state->homing_duration()));
 
   ImGui::PopStyleVar();
 }
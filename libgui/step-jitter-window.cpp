@@ -0,0 +1,79 @@
+#include "gui.hpp"
+
+#include "step-jitter-window.hpp"
+
+#include <libdevice/device.hpp>
+#include <libmechanism/mechanism.hpp>
+
+NAMESPACE_BEGIN
+
+namespace gui {
+/**
+ * Show step jitter of single stepper
+ *
+ * @param axis    axis name
+ * @param jitter  step jitter recorder
+ */
+static void show_jitter(const char* axis, const device::StepJitter& jitter) {
+  const device::jitter::snapshot snapshot = jitter.snapshot();
+
+  float histogram[device::jitter::buckets];
+  for (std::size_t i = 0; i < device::jitter::buckets; ++i) {
+    histogram[i] = static_cast<float>(snapshot.histogram[i]);
+  }
+
+  ImGui::Text("%s", axis);
+  ImGui::Text("Steps    : %llu",
+              static_cast<unsigned long long>(snapshot.steps));
+  ImGui::Text("Missed   : %llu",
+              static_cast<unsigned long long>(snapshot.missed));
+  ImGui::Text("Mean     : %llu us",
+              static_cast<unsigned long long>(snapshot.mean_lateness));
+  ImGui::Text("Max      : %llu us",
+              static_cast<unsigned long long>(snapshot.max_lateness));
+  ImGui::Text("Move max : %llu us",
+              static_cast<unsigned long long>(snapshot.move_max_lateness));
+
+  ImGui::PushID(axis);
+  ImGui::PlotHistogram("##histogram", histogram,
+                       static_cast<int>(device::jitter::buckets), 0,
+                       "lateness (log2 us)", 0.0f, FLT_MAX,
+                       ImVec2(-FLT_MIN, 60.0f));
+  ImGui::PopID();
+}
+
+StepJitterWindow::StepJitterWindow(float                   width,
+                                   float                   height,
+                                   const ImGuiWindowFlags& flags)
+    : Window{"Step Jitter", width, height, flags} {}
+
+StepJitterWindow::~StepJitterWindow() {}
+
+void StepJitterWindow::show([[maybe_unused]] Manager* manager) {
+  massert(mechanism::movement_mechanism() != nullptr, "sanity");
+  massert(mechanism::movement_mechanism()->active(), "sanity");
+
+  auto&& movement = mechanism::movement_mechanism();
+
+  ImGui::Text("Missed deadline: later than %llu us",
+              static_cast<unsigned long long>(device::jitter::deadline));
+  ImGui::Separator();
+
+  ImGui::Columns(3, NULL, /* v_borders */ true);
+  {
+    show_jitter("X", movement->jitter_x());
+  }
+  ImGui::NextColumn();
+  {
+    show_jitter("Y", movement->jitter_y());
+  }
+  ImGui::NextColumn();
+  {
+    show_jitter("Z", movement->jitter_z());
+  }
+  ImGui::NextColumn();
+  ImGui::Columns(1, NULL, /* v_borders */ true);
+}
+}  // namespace gui
+
+NAMESPACE_END
@@ -5,6 +5,7 @@
 #include <chrono>
 #include <ctime>
 
+#include <libcore/core.hpp>
 #include <libutil/util.hpp>
 
 #include "util.hpp"
@@ -27,6 +28,8 @@ void SystemInfoWindow::show([[maybe_unused]] Manager* manager) {
 
   ImGui::Text("%.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate,
               ImGui::GetIO().Framerate);
+
+  ImGui::Text("Config revision %u", Config::get()->revision());
 }
 }  // namespace gui
 
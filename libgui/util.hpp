@@ -17,6 +17,7 @@ namespace color {
 extern ImVec4 red;
 extern ImVec4 green;
 extern ImVec4 blue;
+extern ImVec4 yellow;
 }  // namespace color
 
 bool button(const char*   label,
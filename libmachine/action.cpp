@@ -11,6 +11,7 @@ NAMESPACE_BEGIN
 namespace action {
 void shutdown_hook() {
   LOG_INFO("Shutting down...");
+  destroy_mechanism();
   auto&& movement = mechanism::movement_mechanism();
   if (movement != nullptr) {
     movement->disable_motors();
@@ -80,15 +80,19 @@ template <typename Event,
           typename SourceState,
           typename TargetState>
 void job::operator()(Event const&, FSM& fsm, SourceState&, TargetState&) const {
+  massert(Config::get() != nullptr, "sanity");
   massert(State::get() != nullptr, "sanity");
   massert(device::DigitalOutputDeviceRegistry::get() != nullptr, "sanity");
   massert(mechanism::movement_mechanism() != nullptr, "sanity");
   massert(mechanism::movement_mechanism()->active(), "sanity");
   massert(device::ShiftRegister::get() != nullptr, "sanity");
 
-  auto*  state = State::get();
-  auto*  shift_register = device::ShiftRegister::get();
-  auto&& movement = mechanism::movement_mechanism();
+  auto* state = State::get();
+  auto* shift_register = device::ShiftRegister::get();
+  auto* executor = mechanism::MotionExecutor::get();
+
+  // whole job runs on the same config revision
+  const auto settings = Config::get()->snapshot();
 
   if (state->fault())
     return;
@@ -102,7 +106,11 @@ void job::operator()(Event const&, FSM& fsm, SourceState&, TargetState&) const {
     return;
 
   LOG_INFO("Moving to spraying position...");
-  movement->move_to_spraying_position();
+  executor
+      ->run([settings](mechanism::Movement& movement) {
+        movement.move_to_spraying_position(*settings);
+      })
+      .wait();
 
   if (state->fault())
     return;
@@ -121,7 +129,11 @@ void job::operator()(Event const&, FSM& fsm, SourceState&, TargetState&) const {
     return;
 
   LOG_INFO("Follow spraying paths...");
-  movement->follow_spraying_paths();
+  executor
+      ->run([settings](mechanism::Movement& movement) {
+        movement.follow_spraying_paths(*settings);
+      })
+      .wait();
 
   if (state->fault())
     return;
@@ -133,17 +145,17 @@ void job::operator()(Event const&, FSM& fsm, SourceState&, TargetState&) const {
     return;
 
   LOG_INFO("Homing...");
-  movement->homing();
+  executor->homing(settings);
 
   if (state->fault())
     return;
 
-  shift_register->write(device::id::comm::pi::spraying_running(),
-                        device::digital::value::low);
+  // PLC sees both signals change at once
+  shift_register->batch(
+      {{device::id::comm::pi::spraying_running(), device::digital::value::low},
+       {device::id::comm::pi::spraying_complete(),
+        device::digital::value::high}});
   state->spraying_running(false);
-
-  shift_register->write(device::id::comm::pi::spraying_complete(),
-                        device::digital::value::high);
   state->spraying_complete(true);
 }
 
@@ -160,6 +172,8 @@ void complete::operator()(Event const&, FSM& fsm, SourceState&, TargetState&) {
 
   LOG_INFO("Spraying is completed...");
 
+  machine::util::report_step_jitter();
+
   // shift_register->write(device::id::comm::pi::spraying_ready(),
   //                       device::digital::value::low);
   // state->spraying_ready(false);
@@ -189,12 +203,15 @@ void job::operator()(Event const&, FSM& fsm, SourceState&, TargetState&) const {
   massert(mechanism::movement_mechanism()->active(), "sanity");
   massert(device::ShiftRegister::get() != nullptr, "sanity");
 
-  auto*        config = Config::get();
-  auto*        pwm_registry = device::PWMDeviceRegistry::get();
-  auto*        state = State::get();
-  auto*        shift_register = device::ShiftRegister::get();
-  const auto&& movement = mechanism::movement_mechanism();
-  auto&&       finger = pwm_registry->get(device::id::finger());
+  auto*  config = Config::get();
+  auto*  pwm_registry = device::PWMDeviceRegistry::get();
+  auto*  state = State::get();
+  auto*  shift_register = device::ShiftRegister::get();
+  auto*  executor = mechanism::MotionExecutor::get();
+  auto&& finger = pwm_registry->get(device::key::finger);
+
+  // whole job runs on the same config revision
+  const auto settings = config->snapshot();
 
   if (state->fault())
     return;
@@ -208,7 +225,11 @@ void job::operator()(Event const&, FSM& fsm, SourceState&, TargetState&) const {
     return;
 
   LOG_INFO("Moving to tending position...");
-  movement->move_to_tending_position();
+  executor
+      ->run([settings](mechanism::Movement& movement) {
+        movement.move_to_tending_position(*settings);
+      })
+      .wait();
 
   if (state->fault())
     return;
@@ -219,7 +240,11 @@ void job::operator()(Event const&, FSM& fsm, SourceState&, TargetState&) const {
     return;
 
   LOG_INFO("Moving finger down...");
-  movement->move_finger_down();
+  executor
+      ->run([settings](mechanism::Movement& movement) {
+        movement.move_finger_down(*settings);
+      })
+      .wait();
 
   if (state->fault())
     return;
@@ -230,7 +255,11 @@ void job::operator()(Event const&, FSM& fsm, SourceState&, TargetState&) const {
     return;
 
   LOG_INFO("Following edge paths...");
-  movement->follow_tending_paths_edge();
+  executor
+      ->run([settings](mechanism::Movement& movement) {
+        movement.follow_tending_paths_edge(*settings);
+      })
+      .wait();
 
   if (state->fault())
     return;
@@ -241,7 +270,11 @@ void job::operator()(Event const&, FSM& fsm, SourceState&, TargetState&) const {
     return;
 
   LOG_INFO("Turning on the motor...");
-  movement->rotate_finger();
+  executor
+      ->run([settings](mechanism::Movement& movement) {
+        movement.rotate_finger(*settings);
+      })
+      .wait();
 
   if (state->fault())
     return;
@@ -252,7 +285,11 @@ void job::operator()(Event const&, FSM& fsm, SourceState&, TargetState&) const {
     return;
 
   LOG_INFO("Follow zigzag paths...");
-  movement->follow_tending_paths_zigzag();
+  executor
+      ->run([settings](mechanism::Movement& movement) {
+        movement.follow_tending_paths_zigzag(*settings);
+      })
+      .wait();
 
   if (state->fault())
     return;
@@ -262,24 +299,24 @@ void job::operator()(Event const&, FSM& fsm, SourceState&, TargetState&) const {
   if (state->fault())
     return;
 
+  // homing is queued behind the finger brake, nothing runs in between
   LOG_INFO("Stop finger...");
-  movement->stop_finger();
-
-  if (state->fault())
-    return;
+  executor->run([settings](mechanism::Movement& movement) {
+    movement.stop_finger(*settings);
+  });
 
   LOG_INFO("Homing...");
-  movement->homing();
+  executor->homing(settings);
 
   if (state->fault())
     return;
 
-  shift_register->write(device::id::comm::pi::tending_running(),
-                        device::digital::value::low);
+  // PLC sees both signals change at once
+  shift_register->batch(
+      {{device::id::comm::pi::tending_running(), device::digital::value::low},
+       {device::id::comm::pi::tending_complete(),
+        device::digital::value::high}});
   state->tending_running(false);
-
-  shift_register->write(device::id::comm::pi::tending_complete(),
-                        device::digital::value::high);
   state->tending_complete(true);
 }
 
@@ -296,6 +333,8 @@ void complete::operator()(Event const&, FSM& fsm, SourceState&, TargetState&) {
 
   LOG_INFO("Tending is completed...");
 
+  machine::util::report_step_jitter();
+
   // shift_register->write(device::id::comm::pi::tending_ready(),
   //                       device::digital::value::low);
   // state->tending_ready(false);
@@ -331,10 +370,14 @@ void job::operator()(Event const&, FSM& fsm, SourceState&, TargetState&) const {
   auto*  state = State::get();
   auto*  digital_output_registry = device::DigitalOutputDeviceRegistry::get();
   auto*  shift_register = device::ShiftRegister::get();
-  auto&& movement = mechanism::movement_mechanism();
+  auto*  executor = mechanism::MotionExecutor::get();
 
   auto&& sonicator_relay =
-      digital_output_registry->get(device::id::sonicator_relay());
+      digital_output_registry->get(device::key::sonicator_relay);
+
+  // whole job runs on the same config revision
+  const auto  settings = config->snapshot();
+  const auto& stations = settings->mechanisms.cleaning.stations;
 
   if (state->fault())
     return;
@@ -343,23 +386,34 @@ void job::operator()(Event const&, FSM& fsm, SourceState&, TargetState&) const {
   state->cleaning_running(true);
 
   LOG_INFO("Homing finger...");
-  movement->homing_finger();
+  executor
+      ->run([settings](mechanism::Movement& movement) {
+        movement.homing_finger(*settings);
+      })
+      .wait();
 
   if (state->fault())
     return;
 
-  for (const auto& [x, y, time, sonicator] : config->cleaning_stations()) {
+  for (std::size_t idx = 0; idx < stations.size(); ++idx) {
+    const auto& [x, y, time, sonicator] = stations[idx];
+
     if (state->fault())
       return;
 
+    // finger goes down as soon as the station is reached, stop or fault
+    // cancels both
     LOG_INFO("Moving to cleaning station with x:{} y:{}", x, y);
-    movement->move<mechanism::movement::unit::mm>(x, y, 0.0);
-
-    if (state->fault())
-      return;
+    executor->run([settings, idx](mechanism::Movement& movement) {
+      movement.move_to_cleaning_station(*settings, idx);
+    });
 
     LOG_INFO("Moving finger down");
-    movement->move_finger_down();
+    executor
+        ->run([settings](mechanism::Movement& movement) {
+          movement.move_finger_down(*settings);
+        })
+        .wait();
 
     if (state->fault())
       return;
@@ -391,7 +445,11 @@ void job::operator()(Event const&, FSM& fsm, SourceState&, TargetState&) const {
       return;
 
     LOG_INFO("Moving finger up");
-    movement->move_finger_up();
+    executor
+        ->run([settings](mechanism::Movement& movement) {
+          movement.move_finger_up(*settings);
+        })
+        .wait();
 
     if (state->fault())
       return;
@@ -419,6 +477,8 @@ void complete::operator()(Event const&, FSM& fsm, SourceState&, TargetState&) {
 
   LOG_INFO("Cleaning is completed...");
 
+  machine::util::report_step_jitter();
+
   // state->cleaning_ready(false);
 
   sleep_for<time_units::millis>(3000);
@@ -2,7 +2,9 @@
 
 #include "fault-listener.hpp"
 
+#include <chrono>
 #include <thread>
+#include <vector>
 
 #include <libdevice/device.hpp>
 #include <libutil/util.hpp>
@@ -10,7 +12,7 @@
 NAMESPACE_BEGIN
 
 namespace machine {
-FaultListener::FaultListener(tending* tsm) : tsm_{tsm} {}
+FaultListener::FaultListener(tending* tsm) : tsm_{tsm}, edges_{0} {}
 
 FaultListener::~FaultListener() {
   running_ = false;
@@ -46,38 +48,118 @@ void FaultListener::stop() {
 void FaultListener::execute() {
   massert(State::get() != nullptr, "sanity");
   massert(device::DigitalInputDeviceRegistry::get() != nullptr, "sanity");
+  massert(device::InputAlert::get() != nullptr, "sanity");
   massert(tsm()->is_ready(), "sanity");
 
   auto* state = State::get();
   auto* digital_input_registry = device::DigitalInputDeviceRegistry::get();
+  auto* input_alert = device::InputAlert::get();
 
   auto&& limit_switch_x =
-      digital_input_registry->get(device::id::limit_switch::x());
+      digital_input_registry->get(device::key::limit_switch::x);
   auto&& limit_switch_y =
-      digital_input_registry->get(device::id::limit_switch::y());
+      digital_input_registry->get(device::key::limit_switch::y);
   auto&& finger_protection = digital_input_registry->get(
-      device::id::limit_switch::finger_protection());
+      device::key::limit_switch::finger_protection);
   auto&& spraying_tending_height = digital_input_registry->get(
-      device::id::comm::plc::spraying_tending_height());
+      device::key::comm::plc::spraying_tending_height);
   auto&& cleaning_height =
-      digital_input_registry->get(device::id::comm::plc::cleaning_height());
-  auto&& e_stop = digital_input_registry->get(device::id::comm::plc::e_stop());
+      digital_input_registry->get(device::key::comm::plc::cleaning_height);
+  auto&& e_stop = digital_input_registry->get(device::key::comm::plc::e_stop);
+  auto&& movement = mechanism::movement_mechanism();
+
+  // inputs are checked on their edges instead of polling them
+  std::vector<device::alert::subscription> subscriptions;
+  for (auto&& device : {limit_switch_x, limit_switch_y, finger_protection,
+                        spraying_tending_height, cleaning_height, e_stop}) {
+    // e-stop and limit switches x and y halt the steppers right from the
+    // alert, the fault is latched by this thread afterwards
+    const bool halts = device == e_stop;
+    const bool halts_unless_homing =
+        device == limit_switch_x || device == limit_switch_y;
+
+    subscriptions.push_back(input_alert->subscribe(
+        device, device::alert::edge::either,
+        [this, state, movement, halts,
+         halts_unless_homing](const device::alert::event& event) {
+          if (movement != nullptr &&
+              event.value == device::digital::value::high &&
+              !state->fault() &&
+              (halts || (halts_unless_homing && !state->homing()))) {
+            movement->halt();
+          }
+          {
+            std::lock_guard<std::mutex> lock(mutex());
+            ++edges_;
+          }
+          state->notify_all();
+        }));
+  }
+
+  // halt request is held until the edges that have been seen are handled,
+  // then state->fault() (or nothing, for a glitch) takes over
+  const auto release_halt = [this, &movement](std::size_t handled) {
+    std::lock_guard<std::mutex> lock(mutex());
+    if (movement != nullptr && edges_ == handled) {
+      movement->clear_halt();
+    }
+  };
+
+  // inputs that cannot be watched are polled instead
+  bool polling = false;
+  for (const auto& subscription : subscriptions) {
+    polling = polling || subscription == 0;
+  }
+
+  if (polling) {
+    LOG_WARN("Some fault inputs cannot be watched, polling them instead");
+  }
+
+  const device::DigitalInputBank inputs{
+      limit_switch_x,          limit_switch_y,  finger_protection,
+      spraying_tending_height, cleaning_height, e_stop};
+
+  std::size_t edges = 0;
+  bool        active = false;
 
   while (running() && state->running()) {
     {
       std::unique_lock<std::mutex> lock(mutex());
-      state->signal().wait(lock, [this, state] {
-        return !state->running() || !(tsm()->is_no_task() || state->fault());
-      });
+      // task transitions are not always signaled, re-check them periodically
+      state->signal().wait_for(
+          lock,
+          std::chrono::milliseconds(polling ? fault_listener::poll_period
+                                            : fault_listener::recheck_period),
+          [this, state, edges, active] {
+            return !state->running() || edges_ != edges ||
+                   active != !(tsm()->is_no_task() || state->fault());
+          });
+      edges = edges_;
     }
 
     if (!running() || !state->running()) {
-      return;
+      break;
+    }
+
+    active = !(tsm()->is_no_task() || state->fault());
+
+    if (!active) {
+      release_halt(edges);
+      continue;
+    }
+
+    const bool fault = state->fault();
+    // every input at once
+    const auto levels = inputs.read();
+
+    if (FlightRecorder::created()) {
+      FlightRecorder::get()->inputs(levels.values);
     }
 
     // case 1: e-stop button is pressed
-    if (!state->fault() && e_stop->read_bool()) {
+    if (!state->fault() && levels.high(e_stop)) {
       LOG_ERROR("[FAULT] E-stop button is pressed");
+      util::record_fault(flight::fault::e_stop);
       state->fault(true);
       tsm()->fault();
     }
@@ -86,21 +168,24 @@ void FaultListener::execute() {
     //         limit switches are turning on while moving
     //         except for homing
     if (!state->fault() && !state->homing() &&
-        (limit_switch_x->read_bool() || limit_switch_y->read_bool())) {
+        (levels.high(limit_switch_x) || levels.high(limit_switch_y))) {
       LOG_ERROR("[FAULT] Limit switch x or y are touched");
+      util::record_fault(flight::fault::limit_switch);
       state->fault(true);
       tsm()->fault();
     }
 
     if (!state->fault() && !state->homing()) {
-      if (limit_switch_x->read_bool()) {
+      if (levels.high(limit_switch_x)) {
         LOG_ERROR("[FAULT] Limit switch x is touched");
+        util::record_fault(flight::fault::limit_switch_x);
         state->fault(true);
         tsm()->fault();
       }
 
-      if (limit_switch_y->read_bool()) {
+      if (levels.high(limit_switch_y)) {
         LOG_ERROR("[FAULT] Limit switch y is touched");
+        util::record_fault(flight::fault::limit_switch_y);
         state->fault(true);
         tsm()->fault();
       }
@@ -111,16 +196,18 @@ void FaultListener::execute() {
     //           and the special limit switch for checking the finger
     if (!state->fault() &&
         (state->spraying_running() || state->tending_running())) {
-      if (!state->fault() && !spraying_tending_height->read_bool()) {
+      if (!state->fault() && !levels.high(spraying_tending_height)) {
         LOG_ERROR(
             "[FAULT] Spraying/Tending height is changed while running spray "
             "or tending task");
+        util::record_fault(flight::fault::spraying_tending_height);
         state->fault(true);
         tsm()->fault();
       }
 
-      if (!state->fault() && finger_protection->read_bool()) {
+      if (!state->fault() && levels.high(finger_protection)) {
         LOG_ERROR("[FAULT] Finger protection limit switch is touched");
+        util::record_fault(flight::fault::finger_protection);
         state->fault(true);
         tsm()->fault();
       }
@@ -128,13 +215,32 @@ void FaultListener::execute() {
 
     // case 3.2: at tending and spraying height
     if (!state->fault() && state->cleaning_running()) {
-      if (!cleaning_height->read_bool()) {
+      if (!levels.high(cleaning_height)) {
         LOG_ERROR(
             "[FAULT] Cleaning height is changed while running cleaning task");
+        util::record_fault(flight::fault::cleaning_height);
         state->fault(true);
         tsm()->fault();
       }
     }
+
+    if (!fault && state->fault()) {
+      report_motion_snapshot();
+    }
+
+    release_halt(edges);
+
+    active = !(tsm()->is_no_task() || state->fault());
+  }
+
+  if (movement != nullptr) {
+    movement->clear_halt();
+  }
+
+  for (const auto& subscription : subscriptions) {
+    if (subscription != 0) {
+      input_alert->unsubscribe(subscription);
+    }
   }
 }
 }  // namespace machine
@@ -8,6 +8,13 @@
 NAMESPACE_BEGIN
 
 namespace machine {
+namespace fault_listener {
+/** Period (ms) to re-check the inputs while no edge comes */
+constexpr time_unit recheck_period = 100;
+/** Period (ms) to poll the inputs if one of them cannot be watched */
+constexpr time_unit poll_period = 1;
+}  // namespace fault_listener
+
 class FaultListener : public Listener {
  public:
   /**
@@ -56,6 +63,10 @@ class FaultListener : public Listener {
    * Mutex
    */
   std::mutex mutex_;
+  /**
+   * Number of input edges, guarded by mutex
+   */
+  std::size_t edges_;
 };
 }  // namespace machine
 
@@ -10,13 +10,13 @@ NAMESPACE_BEGIN
 namespace guard {
 bool e_stop::check() const {
   auto*  input_registry = device::DigitalInputDeviceRegistry::get();
-  auto&& e_stop = input_registry->get(device::id::comm::plc::e_stop());
+  auto&& e_stop = input_registry->get(device::key::comm::plc::e_stop);
   return e_stop->read_bool();
 }
 
 bool reset::check() const {
   auto*  input_registry = device::DigitalInputDeviceRegistry::get();
-  auto&& reset = input_registry->get(device::id::comm::plc::reset());
+  auto&& reset = input_registry->get(device::key::comm::plc::reset);
   return reset->read_bool();
 }
 
@@ -51,7 +51,7 @@ bool spraying_tending::check() const {
   massert(device::DigitalInputDeviceRegistry::get() != nullptr, "sanity");
   auto*  input_registry = device::DigitalInputDeviceRegistry::get();
   auto&& spraying_tending_height =
-      input_registry->get(device::id::comm::plc::spraying_tending_height());
+      input_registry->get(device::key::comm::plc::spraying_tending_height);
   return spraying_tending_height->read_bool();
 }
 
@@ -59,7 +59,7 @@ bool cleaning::check() const {
   massert(device::DigitalInputDeviceRegistry::get() != nullptr, "sanity");
   auto*  input_registry = device::DigitalInputDeviceRegistry::get();
   auto&& cleaning_height =
-      input_registry->get(device::id::comm::plc::cleaning_height());
+      input_registry->get(device::key::comm::plc::cleaning_height);
   return cleaning_height->read_bool();
 }
 }  // namespace height
@@ -2,6 +2,9 @@
 
 #include "restart-fault-listener.hpp"
 
+#include <chrono>
+
+#include <libdevice/device.hpp>
 #include <libutil/util.hpp>
 
 NAMESPACE_BEGIN
@@ -43,11 +46,18 @@ void RestartFaultListener::execute() {
   massert(State::get() != nullptr, "sanity");
   massert(tsm()->is_ready(), "sanity");
   massert(device::DigitalInputDeviceRegistry::get() != nullptr, "sanity");
+  massert(device::InputAlert::get() != nullptr, "sanity");
 
   auto* state = State::get();
   auto* digital_input_registry = device::DigitalInputDeviceRegistry::get();
+  auto* input_alert = device::InputAlert::get();
+
+  auto&& reset = digital_input_registry->get(device::key::comm::plc::reset);
 
-  auto&& reset = digital_input_registry->get(device::id::comm::plc::reset());
+  // restart button wakes the listener up instead of polling it
+  const auto subscription = input_alert->subscribe(
+      reset, device::alert::edge::rising,
+      [state](const device::alert::event&) { state->notify_all(); });
 
   while (running() && state->running()) {
     {
@@ -57,17 +67,25 @@ void RestartFaultListener::execute() {
     }
 
     if (!running() || !state->running()) {
-      return;
+      break;
+    }
+
+    {
+      std::unique_lock<std::mutex> lock(mutex());
+      // break if fault is changed from other threads, poll if the pin cannot
+      // be watched
+      state->signal().wait_for(
+          lock,
+          std::chrono::milliseconds(
+              subscription != 0 ? restart_fault_listener::recheck_period
+                                : restart_fault_listener::poll_period),
+          [state, &reset] {
+            return !state->running() || !state->fault() || reset->read_bool();
+          });
     }
 
-    while (!reset->read_bool()) {
-      if (state->fault()) {
-        // sleep a bit
-        sleep_for<time_units::millis>(50);
-      } else {
-        // break if fault is changed from other threads
-        break;
-      }
+    if (!reset->read_bool()) {
+      continue;
     }
 
     if (state->fault()) {
@@ -79,6 +97,10 @@ void RestartFaultListener::execute() {
     // else there are threads that win the restart condition
     // we need to break
   }
+
+  if (subscription != 0) {
+    input_alert->unsubscribe(subscription);
+  }
 }
 }  // namespace machine
 
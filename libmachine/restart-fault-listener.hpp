@@ -8,6 +8,13 @@
 NAMESPACE_BEGIN
 
 namespace machine {
+namespace restart_fault_listener {
+/** Period (ms) to re-check reset button while no edge comes */
+constexpr time_unit recheck_period = 1000;
+/** Period (ms) to poll reset button if it cannot be watched */
+constexpr time_unit poll_period = 50;
+}  // namespace restart_fault_listener
+
 class RestartFaultListener : public Listener {
  public:
   /**
@@ -19,10 +19,38 @@ TendingDef::tending_fsm const& TendingDef::rebind() const {
 
 void TendingDef::start() {
   rebind().process_event(event::start{});
+  record_state();
 }
 
 void TendingDef::stop() {
   rebind().process_event(event::stop{});
+  record_state();
+}
+
+flight::state TendingDef::flight_state() const {
+  if (rebind().is_in_state<fault::manual>()) {
+    return flight::state::fault_manual;
+  } else if (rebind().is_in_state<fault>()) {
+    return flight::state::fault;
+  } else if (rebind().is_in_state<running::no_task>()) {
+    return flight::state::no_task;
+  } else if (rebind().is_in_state<running::spraying>()) {
+    return flight::state::spraying;
+  } else if (rebind().is_in_state<running::tending>()) {
+    return flight::state::tending;
+  } else if (rebind().is_in_state<running::cleaning>()) {
+    return flight::state::cleaning;
+  } else if (is_terminated()) {
+    return flight::state::terminated;
+  }
+
+  return flight::state::initial;
+}
+
+void TendingDef::record_state() const {
+  if (FlightRecorder::created()) {
+    FlightRecorder::get()->state(flight_state());
+  }
 }
 
 bool TendingDef::is_ready() const {
@@ -43,6 +71,7 @@ bool TendingDef::is_no_task() const {
 
 void TendingDef::start_spraying() {
   rebind().process_event(event::spraying::start{});
+  record_state();
 }
 
 void TendingDef::run_spraying() {
@@ -51,6 +80,7 @@ void TendingDef::run_spraying() {
 
 void TendingDef::start_tending() {
   rebind().process_event(event::tending::start{});
+  record_state();
 }
 
 void TendingDef::run_tending() {
@@ -59,6 +89,7 @@ void TendingDef::run_tending() {
 
 void TendingDef::start_cleaning() {
   rebind().process_event(event::cleaning::start{});
+  record_state();
 }
 
 void TendingDef::run_cleaning() {
@@ -67,18 +98,22 @@ void TendingDef::run_cleaning() {
 
 void TendingDef::task_completed() {
   rebind().process_event(event::task_complete{});
+  record_state();
 }
 
 void TendingDef::fault() {
   rebind().process_event(event::fault::trigger{});
+  record_state();
 }
 
 void TendingDef::fault_manual() {
   rebind().process_event(event::fault::manual{});
+  record_state();
 }
 
 void TendingDef::restart() {
   rebind().process_event(event::fault::restart{});
+  record_state();
 }
 }  // namespace machine
 
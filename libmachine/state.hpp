@@ -302,12 +302,22 @@ struct TendingDef : public StackObj,
    * @return machine is terminated or not
    */
   bool is_terminated() const;
+  /**
+   * Get current state for flight recorder
+   *
+   * @return flight recorder state
+   */
+  flight::state flight_state() const;
   /**
    * Get thread pool instance
    *
    * @return instance of algo::ThreadPool
    */
   inline algo::ThreadPool& thread_pool() { return thread_pool_; }
+  /**
+   * Write current state to flight recorder
+   */
+  void record_state() const;
   /**
    * Version of state machine
    */
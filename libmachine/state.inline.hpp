@@ -20,12 +20,13 @@ void TendingDef::running::no_task::on_enter(Event const&&, FSM& fsm) const {
   massert(State::get() != nullptr, "sanity");
   massert(mechanism::movement_mechanism() != nullptr, "sanity");
   massert(mechanism::movement_mechanism()->active(), "sanity");
+  massert(mechanism::MotionExecutor::get()->running(), "sanity");
   massert(device::ShiftRegister::get() != nullptr, "sanity");
 
   root_machine(fsm).thread_pool().enqueue([&fsm]() mutable -> void {
-    auto*  state = State::get();
-    auto*  shift_register = device::ShiftRegister::get();
-    auto&& movement = mechanism::movement_mechanism();
+    auto* state = State::get();
+    auto* shift_register = device::ShiftRegister::get();
+    auto* executor = mechanism::MotionExecutor::get();
 
     if (state->fault()) {
       // root_machine(fsm).fault();
@@ -48,7 +49,7 @@ void TendingDef::running::no_task::on_enter(Event const&&, FSM& fsm) const {
     }
 
     LOG_INFO("Homing...");
-    movement->homing();
+    executor->homing();
 
     if (state->fault()) {
       // root_machine(fsm).fault();
@@ -115,18 +116,19 @@ void TendingDef::running::spraying::preparation::on_enter(Event&&, FSM& fsm) {
   massert(State::get() != nullptr, "sanity");
   massert(mechanism::movement_mechanism() != nullptr, "sanity");
   massert(mechanism::movement_mechanism()->active(), "sanity");
+  massert(mechanism::MotionExecutor::get()->running(), "sanity");
   massert(device::ShiftRegister::get() != nullptr, "sanity");
 
-  auto*  state = State::get();
-  auto*  shift_register = device::ShiftRegister::get();
-  auto&& movement = mechanism::movement_mechanism();
+  auto* state = State::get();
+  auto* shift_register = device::ShiftRegister::get();
+  auto* executor = mechanism::MotionExecutor::get();
 
   LOG_INFO("Spraying preparation...");
 
   machine::util::reset_spraying();
 
   LOG_INFO("Homing to make sure ready to spray...");
-  movement->homing();
+  executor->homing();
 
   root_machine(fsm).run_spraying();
 }
@@ -163,18 +165,19 @@ void TendingDef::running::tending::preparation::on_enter(Event&&, FSM& fsm) {
   massert(State::get() != nullptr, "sanity");
   massert(mechanism::movement_mechanism() != nullptr, "sanity");
   massert(mechanism::movement_mechanism()->active(), "sanity");
+  massert(mechanism::MotionExecutor::get()->running(), "sanity");
   massert(device::ShiftRegister::get() != nullptr, "sanity");
 
-  auto*  state = State::get();
-  auto*  shift_register = device::ShiftRegister::get();
-  auto&& movement = mechanism::movement_mechanism();
+  auto* state = State::get();
+  auto* shift_register = device::ShiftRegister::get();
+  auto* executor = mechanism::MotionExecutor::get();
 
   LOG_INFO("Tending preparation...");
 
   machine::util::reset_tending();
 
   LOG_INFO("Homing to make sure ready to tend...");
-  movement->homing();
+  executor->homing();
 
   root_machine(fsm).run_tending();
 }
@@ -210,18 +213,19 @@ void TendingDef::running::cleaning::preparation::on_enter(Event&&, FSM& fsm) {
   massert(State::get() != nullptr, "sanity");
   massert(mechanism::movement_mechanism() != nullptr, "sanity");
   massert(mechanism::movement_mechanism()->active(), "sanity");
+  massert(mechanism::MotionExecutor::get()->running(), "sanity");
   massert(device::ShiftRegister::get() != nullptr, "sanity");
 
-  auto*  state = State::get();
-  auto*  shift_register = device::ShiftRegister::get();
-  auto&& movement = mechanism::movement_mechanism();
+  auto* state = State::get();
+  auto* shift_register = device::ShiftRegister::get();
+  auto* executor = mechanism::MotionExecutor::get();
 
   LOG_INFO("Cleaning preparation...");
 
   machine::util::reset_cleaning();
 
   LOG_INFO("Homing to make sure ready to clean...");
-  movement->homing();
+  executor->homing();
 
   root_machine(fsm).run_cleaning();
 }
@@ -100,6 +100,7 @@ void TaskListener::execute() {
         LOG_ERROR("[FAULT] Last task: cleaning");
       }
       state->homing(false);
+      util::record_fault(flight::fault::timeout);
       state->fault(true);
       tsm()->fault();
     } else {
@@ -9,39 +9,93 @@ NAMESPACE_BEGIN
 namespace machine {
 namespace util {
 void prepare_execution_state() {
+  massert(Config::get() != nullptr, "sanity");
   massert(State::get() != nullptr, "sanity");
   massert(device::ShiftRegister::get() != nullptr, "sanity");
   massert(mechanism::movement_mechanism() != nullptr, "sanity");
   massert(mechanism::movement_mechanism()->active(), "sanity");
 
-  // auto*  state = State::get();
-  // auto*  shift_register = device::ShiftRegister::get();
-  auto&& movement = mechanism::movement_mechanism();
+  // auto* state = State::get();
+  // auto* shift_register = device::ShiftRegister::get();
+  auto* executor = mechanism::MotionExecutor::get();
 
-  movement->stop_finger();
-  movement->disable_motors();
+  const auto settings = Config::get()->snapshot();
+
+  executor
+      ->run([settings](mechanism::Movement& movement) {
+        movement.stop_finger(*settings);
+        movement.disable_motors();
+      })
+      .wait();
 
   // shift_register->write_all(device::digital::value::low);
   // state->reset_ui();
 }
 
 void reset_task_state() {
+  massert(Config::get() != nullptr, "sanity");
   massert(State::get() != nullptr, "sanity");
   massert(device::ShiftRegister::get() != nullptr, "sanity");
   massert(mechanism::movement_mechanism() != nullptr, "sanity");
   massert(mechanism::movement_mechanism()->active(), "sanity");
 
-  auto*  state = State::get();
-  auto*  shift_register = device::ShiftRegister::get();
-  auto&& movement = mechanism::movement_mechanism();
+  auto* state = State::get();
+  auto* shift_register = device::ShiftRegister::get();
+  auto* executor = mechanism::MotionExecutor::get();
+
+  const auto settings = Config::get()->snapshot();
 
-  movement->stop_finger();
-  movement->disable_motors();
+  // stop aborts running move and disables the motors
+  executor->stop();
+  executor
+      ->run([settings](mechanism::Movement& movement) {
+        movement.stop_finger(*settings);
+      })
+      .wait();
 
   shift_register->write_all(device::digital::value::low);
+  // outputs must be low before the next task begins
+  shift_register->flush();
   state->reset_ui();
 }
 
+void report_step_jitter() {
+  massert(mechanism::movement_mechanism() != nullptr, "sanity");
+  massert(mechanism::movement_mechanism()->active(), "sanity");
+
+  auto&& movement = mechanism::movement_mechanism();
+
+  movement->log_jitter();
+  movement->reset_jitter();
+}
+
+void report_motion_snapshot() {
+  massert(mechanism::movement_mechanism() != nullptr, "sanity");
+  massert(mechanism::movement_mechanism()->active(), "sanity");
+
+  const auto snapshot = mechanism::movement_mechanism()->snapshot();
+  const auto& x = snapshot.axes[0];
+  const auto& y = snapshot.axes[1];
+  const auto& z = snapshot.axes[2];
+
+  LOG_INFO(
+      "Motion #{} at {} us: x={}mm ({}mm/s), y={}mm ({}mm/s), z={}mm "
+      "({}mm/s), segment={}, progress={}, ready={}, braking={}",
+      snapshot.version, snapshot.time, x.position, x.velocity, y.position,
+      y.velocity, z.position, z.velocity, snapshot.segment, snapshot.progress,
+      snapshot.ready, snapshot.braking);
+}
+
+void record_fault(flight::fault reason) {
+  if (FlightRecorder::created()) {
+    FlightRecorder::get()->fault(reason);
+  }
+
+  if (PostMortem::created()) {
+    PostMortem::get()->request(reason);
+  }
+}
+
 void reset_task_ready() {
   massert(State::get() != nullptr, "sanity");
   massert(device::ShiftRegister::get() != nullptr, "sanity");
@@ -49,10 +103,9 @@ void reset_task_ready() {
   // auto* state = State::get();
   auto* shift_register = device::ShiftRegister::get();
 
-  shift_register->write(device::id::comm::pi::spraying_ready(),
-                        device::digital::value::high);
-  shift_register->write(device::id::comm::pi::tending_ready(),
-                        device::digital::value::high);
+  shift_register->batch(
+      {{device::id::comm::pi::spraying_ready(), device::digital::value::high},
+       {device::id::comm::pi::tending_ready(), device::digital::value::high}});
 
   // state->spraying_ready(true);
   // state->tending_ready(true);
@@ -70,12 +123,11 @@ void reset_spraying() {
   //                       device::digital::value::low);
   // state->spraying_ready(false);
 
-  shift_register->write(device::id::comm::pi::spraying_running(),
-                        device::digital::value::low);
+  shift_register->batch(
+      {{device::id::comm::pi::spraying_running(), device::digital::value::low},
+       {device::id::comm::pi::spraying_complete(),
+        device::digital::value::low}});
   state->spraying_running(false);
-
-  shift_register->write(device::id::comm::pi::spraying_complete(),
-                        device::digital::value::low);
   state->spraying_complete(false);
 }
 
@@ -90,12 +142,11 @@ void reset_tending() {
   //                       device::digital::value::low);
   // state->tending_ready(false);
 
-  shift_register->write(device::id::comm::pi::tending_running(),
-                        device::digital::value::low);
+  shift_register->batch(
+      {{device::id::comm::pi::tending_running(), device::digital::value::low},
+       {device::id::comm::pi::tending_complete(),
+        device::digital::value::low}});
   state->tending_running(false);
-
-  shift_register->write(device::id::comm::pi::tending_complete(),
-                        device::digital::value::low);
   state->tending_complete(false);
 }
 
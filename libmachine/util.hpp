@@ -19,6 +19,30 @@ void prepare_execution_state();
  */
 void reset_task_state();
 
+/**
+ * Dump step jitter to the log and reset it
+ *
+ * Called at the end of every task, so each dump covers a single task
+ */
+void report_step_jitter();
+
+/**
+ * Dump last motion snapshot to the log
+ *
+ * Never waits for the motion thread, so it is safe to call on fault
+ */
+void report_motion_snapshot();
+
+/**
+ * Write fault reason to the flight recorder and request post-mortem bundle,
+ * if there are ones
+ *
+ * Call before raising the fault, so the bundle has the state it interrupts
+ *
+ * @param reason fault reason
+ */
+void record_fault(flight::fault reason);
+
 /**
  * Will reset ready state to true
  *
@@ -0,0 +1,442 @@
+#include "mechanism.hpp"
+
+#include "executor.hpp"
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+
+#include <cerrno>
+#include <cstring>
+#include <exception>
+
+NAMESPACE_BEGIN
+
+namespace mechanism {
+namespace executor {
+handle::handle(const std::shared_ptr<executor::task>& task,
+               impl::MotionExecutorImpl*              executor)
+    : task_{task}, executor_{executor} {}
+
+result handle::wait() const {
+  return task_->future.get();
+}
+
+bool handle::done() const {
+  return task_->status.load(std::memory_order_acquire) == status::done;
+}
+
+void handle::cancel() const {
+  executor_->cancel(task_);
+}
+
+float handle::progress() const {
+  switch (task_->status.load(std::memory_order_acquire)) {
+    case status::queued:
+      return 0.0f;
+    case status::running:
+      return executor_->progress();
+    case status::done:
+      break;
+  }
+
+  return task_->progress.load(std::memory_order_acquire);
+}
+}  // namespace executor
+
+namespace impl {
+/**
+ * Configure calling thread for real-time motion
+ *
+ * Failures are logged only, the executor still works without privileges
+ *
+ * @param priority     SCHED_FIFO priority, 0 to keep default scheduling
+ * @param cpu          CPU to pin the thread to, -1 to keep default affinity
+ * @param lock_memory  lock process memory to avoid page faults
+ */
+static void configure_thread(int priority, int cpu, bool lock_memory) {
+  if (lock_memory) {
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+      LOG_ERROR("Failed to lock memory: {}", std::strerror(errno));
+    } else {
+      LOG_INFO("Memory is locked");
+    }
+  }
+
+  if (priority > 0) {
+    sched_param param{};
+    param.sched_priority = priority;
+
+    const int err = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    if (err != 0) {
+      LOG_ERROR("Failed to set SCHED_FIFO priority {}: {}", priority,
+                std::strerror(err));
+    } else {
+      LOG_INFO("Motion executor runs with SCHED_FIFO priority {}", priority);
+    }
+  }
+
+  if (cpu >= 0) {
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(cpu, &cpus);
+
+    const int err =
+        pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpus);
+    if (err != 0) {
+      LOG_ERROR("Failed to pin motion executor to CPU {}: {}", cpu,
+                std::strerror(err));
+    } else {
+      LOG_INFO("Motion executor is pinned to CPU {}", cpu);
+    }
+  }
+}
+
+MotionExecutorImpl::MotionExecutorImpl(
+    const std::shared_ptr<Movement>& movement,
+    int                              priority,
+    int                              cpu,
+    bool                             lock_memory)
+    : movement_{movement},
+      priority_{priority},
+      cpu_{cpu},
+      lock_memory_{lock_memory} {
+  pushed_ = 0;
+  pending_stops_ = 0;
+  running_ = false;
+  posted_ = 0;
+  notifying_ = false;
+}
+
+MotionExecutorImpl::~MotionExecutorImpl() {
+  join();
+}
+
+ATM_STATUS MotionExecutorImpl::start() {
+  massert(movement_ != nullptr, "sanity");
+
+  if (movement_ == nullptr || !movement_->active()) {
+    return ATM_ERR;
+  }
+
+  std::lock_guard<std::mutex> lock(producer_mutex_);
+
+  if (running()) {
+    return ATM_OK;
+  }
+
+  running_.store(true, std::memory_order_release);
+  notifying_.store(true, std::memory_order_release);
+  notifier_ = std::thread(&MotionExecutorImpl::notify, this);
+  thread_ = std::thread(&MotionExecutorImpl::loop, this);
+
+  return ATM_OK;
+}
+
+void MotionExecutorImpl::join() {
+  {
+    std::lock_guard<std::mutex> lock(producer_mutex_);
+
+    if (!running()) {
+      return;
+    }
+
+    running_.store(false, std::memory_order_release);
+  }
+
+  // running command must not hold the shutdown
+  movement_->abort();
+
+  pushed_.fetch_add(1, std::memory_order_release);
+  pushed_.notify_one();
+
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+
+  // executor thread does not post anymore, run what it has left
+  notifying_.store(false, std::memory_order_release);
+  posted_.fetch_add(1, std::memory_order_release);
+  posted_.notify_one();
+
+  if (notifier_.joinable()) {
+    notifier_.join();
+  }
+
+  movement_->clear_abort();
+}
+
+executor::handle MotionExecutorImpl::homing_async(
+    std::shared_ptr<const config::Settings> settings,
+    executor::callback                      on_complete) {
+  executor::command command;
+  command.type = executor::type::homing;
+  command.settings = std::move(settings);
+  return submit(std::move(command), std::move(on_complete));
+}
+
+executor::result MotionExecutorImpl::homing(
+    std::shared_ptr<const config::Settings> settings) {
+  return homing_async(std::move(settings)).wait();
+}
+
+executor::handle MotionExecutorImpl::stop() {
+  executor::command command;
+  command.type = executor::type::stop;
+  return submit(std::move(command));
+}
+
+executor::handle MotionExecutorImpl::motor_profile(
+    const config::MechanismSpeed& speed_profile) {
+  executor::command command;
+  command.type = executor::type::motor_profile;
+  command.speed_profile = speed_profile;
+  return submit(std::move(command));
+}
+
+executor::handle MotionExecutorImpl::run(
+    std::function<void(Movement&)> routine) {
+  executor::command command;
+  command.type = executor::type::run;
+  command.routine = std::move(routine);
+  return submit(std::move(command));
+}
+
+executor::handle MotionExecutorImpl::submit(executor::command&& command,
+                                            executor::callback  on_complete) {
+  command.task = std::make_shared<executor::task>();
+  command.task->future = command.task->completion.get_future().share();
+  command.task->status = executor::status::queued;
+  command.task->cancelled = false;
+  command.task->progress = 0.0f;
+  command.task->on_complete = std::move(on_complete);
+
+  executor::handle handle{command.task, this};
+
+  std::unique_lock<std::mutex> lock(producer_mutex_);
+
+  if (!running()) {
+    lock.unlock();
+
+    if (auto callback = complete(command, executor::result::cancelled)) {
+      callback(executor::result::cancelled);
+    }
+
+    return handle;
+  }
+
+  if (command.type == executor::type::stop) {
+    // abort right away instead of waiting for the running command
+    pending_stops_.fetch_add(1, std::memory_order_acq_rel);
+    movement_->abort();
+  }
+
+  while (!queue_.push(std::move(command))) {
+    std::this_thread::yield();
+  }
+
+  pushed_.fetch_add(1, std::memory_order_release);
+  pushed_.notify_one();
+
+  return handle;
+}
+
+void MotionExecutorImpl::cancel(const std::shared_ptr<executor::task>& task) {
+  std::lock_guard<std::mutex> lock(current_mutex_);
+
+  task->cancelled.store(true, std::memory_order_release);
+
+  if (current_ == task) {
+    // decelerate instead of abort, so steppers do not lose steps
+    movement_->brake();
+  }
+}
+
+executor::callback MotionExecutorImpl::complete(executor::command& command,
+                                                executor::result   result) {
+  auto& task = command.task;
+
+  command.routine = nullptr;
+
+  executor::callback callback = std::move(task->on_complete);
+  task->on_complete = nullptr;
+
+  task->status.store(executor::status::done, std::memory_order_release);
+  task->completion.set_value(result);
+
+  return callback;
+}
+
+void MotionExecutorImpl::finish(executor::command& command,
+                                executor::result   result) {
+  executor::completion completion;
+  completion.on_complete = complete(command, result);
+  completion.result = result;
+
+  // drop the task now, waiters may already hold the result
+  command.task = nullptr;
+
+  if (!completion.on_complete) {
+    return;
+  }
+
+  while (!completions_.push(std::move(completion))) {
+    std::this_thread::yield();
+  }
+
+  posted_.fetch_add(1, std::memory_order_release);
+  posted_.notify_one();
+}
+
+void MotionExecutorImpl::loop() {
+  configure_thread(priority_, cpu_, lock_memory_);
+
+  // calibrate after scheduling is set, wake-up latency depends on it
+  const time_unit guard_band = util::timer::calibrate();
+  LOG_INFO("Timer guard band is calibrated to {} ns", guard_band);
+
+  LOG_INFO("Motion executor is started");
+
+  executor::command command;
+
+  while (true) {
+    // must be read before pop, so push after failed pop wakes the wait
+    const unsigned int pushed = pushed_.load(std::memory_order_acquire);
+
+    if (queue_.pop(command)) {
+      if (command.type != executor::type::stop &&
+          pending_stops_.load(std::memory_order_acquire) > 0) {
+        finish(command, executor::result::cancelled);
+        continue;
+      }
+
+      bool cancelled = false;
+
+      {
+        std::lock_guard<std::mutex> lock(current_mutex_);
+
+        cancelled = command.task->cancelled.load(std::memory_order_acquire);
+
+        if (!cancelled) {
+          current_ = command.task;
+          movement_->clear_brake();
+          command.task->status.store(executor::status::running,
+                                     std::memory_order_release);
+        }
+      }
+
+      if (cancelled) {
+        finish(command, executor::result::cancelled);
+        continue;
+      }
+
+      const executor::result result = execute(command);
+
+      // statistics of this thread only cover the command that just ran
+      if (const auto stats = util::timer::statistics(); stats.waits > 0) {
+        LOG_DEBUG(
+            "Timer waits: {}, sleeps: {}, late: {}, mean overshoot: {} ns, "
+            "max overshoot: {} ns, spin: {} ns",
+            stats.waits, stats.sleeps, stats.late, stats.mean_overshoot,
+            stats.max_overshoot, stats.spin);
+        util::timer::reset_statistics();
+      }
+
+      {
+        std::lock_guard<std::mutex> lock(current_mutex_);
+        current_ = nullptr;
+        movement_->clear_brake();
+      }
+
+      command.task->progress.store(movement_->progress(),
+                                   std::memory_order_release);
+      finish(command, result);
+      continue;
+    }
+
+    if (!running()) {
+      break;
+    }
+
+    pushed_.wait(pushed, std::memory_order_acquire);
+  }
+
+  while (queue_.pop(command)) {
+    finish(command, executor::result::cancelled);
+  }
+
+  LOG_INFO("Motion executor is stopped");
+}
+
+void MotionExecutorImpl::notify() {
+  executor::completion completion;
+
+  while (true) {
+    // must be read before pop, so post after failed pop wakes the wait
+    const unsigned int posted = posted_.load(std::memory_order_acquire);
+
+    if (completions_.pop(completion)) {
+      completion.on_complete(completion.result);
+      completion.on_complete = nullptr;
+      continue;
+    }
+
+    if (!notifying_.load(std::memory_order_acquire)) {
+      break;
+    }
+
+    posted_.wait(posted, std::memory_order_acquire);
+  }
+}
+
+executor::result MotionExecutorImpl::execute(executor::command& command) {
+  executor::result result = executor::result::completed;
+
+  try {
+    switch (command.type) {
+      case executor::type::move:
+        if (command.unit == movement::unit::cm) {
+          movement_->move<movement::unit::cm>(command.x, command.y, command.z);
+        } else {
+          movement_->move<movement::unit::mm>(command.x, command.y, command.z);
+        }
+        break;
+      case executor::type::homing: {
+        // homing outside of a job takes the latest config revision
+        const auto settings = command.settings != nullptr
+                                  ? command.settings
+                                  : Config::get()->snapshot();
+        movement_->homing(*settings);
+        break;
+      }
+      case executor::type::stop:
+        movement_->stop();
+        movement_->disable_motors();
+        if (pending_stops_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+          movement_->clear_abort();
+        }
+        return result;
+      case executor::type::motor_profile:
+        movement_->motor_profile(command.speed_profile);
+        return result;
+      case executor::type::run:
+        command.routine(*movement_);
+        break;
+    }
+  } catch (const std::exception& e) {
+    LOG_ERROR("Motion command failed: {}", e.what());
+    movement_->stop();
+    movement_->disable_motors();
+    return executor::result::aborted;
+  }
+
+  if (movement_->interrupted()) {
+    result = executor::result::aborted;
+  }
+
+  return result;
+}
+}  // namespace impl
+}  // namespace mechanism
+
+NAMESPACE_END
@@ -0,0 +1,462 @@
+#ifndef LIB_MECHANISM_EXECUTOR_HPP_
+#define LIB_MECHANISM_EXECUTOR_HPP_
+
+/** @file executor.hpp
+ *  @brief Motion executor class definition
+ *
+ * Dedicated real-time thread that owns the movement mechanism
+ */
+
+#include <atomic>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <libalgo/algo.hpp>
+#include <libcore/core.hpp>
+
+#include "movement.hpp"
+
+NAMESPACE_BEGIN
+
+namespace mechanism {
+// forward declaration
+namespace impl {
+class MotionExecutorImpl;
+}
+
+/** impl::MotionExecutorImpl singleton class using StaticObj */
+using MotionExecutor = StaticObj<impl::MotionExecutorImpl>;
+
+namespace executor {
+/** Number of commands that can be queued */
+constexpr std::size_t queue_capacity = 64;
+
+/**
+ * Command type
+ *
+ * move          : move with Movement::move
+ * homing        : home with Movement::homing
+ * stop          : abort running command and cancel queued ones
+ * motor_profile : set speed profile with Movement::motor_profile
+ * run           : run any other movement routine
+ */
+enum class type { move, homing, stop, motor_profile, run };
+
+/**
+ * Command result
+ *
+ * completed : command has been executed
+ * aborted   : command has been interrupted by stop or fault
+ * cancelled : command has been dropped before executed
+ */
+enum class result { completed, aborted, cancelled };
+
+/**
+ * Command status
+ *
+ * queued  : command is waiting in the queue
+ * running : command is being executed
+ * done    : command has a result
+ */
+enum class status { queued, running, done };
+
+/**
+ * Completion callback
+ *
+ * Runs on the completion thread, or on the calling thread when the command is
+ * cancelled before it reaches the executor. No executor lock is held, so it
+ * may submit or cancel commands, but it must not join the executor.
+ */
+typedef std::function<void(result)> callback;
+
+/**
+ * @brief Shared state of submitted command.
+ */
+struct task {
+  /** completion of the command */
+  std::promise<result> completion;
+  /** future of completion */
+  std::shared_future<result> future;
+  /** command status */
+  std::atomic<executor::status> status;
+  /** command has been cancelled */
+  std::atomic<bool> cancelled;
+  /** move progress when the command is done */
+  std::atomic<float> progress;
+  /** completion callback */
+  callback on_complete;
+};
+
+/**
+ * @brief Callback of finished command, posted to the completion thread.
+ */
+struct completion {
+  /** completion callback */
+  callback on_complete;
+  /** command result */
+  executor::result result;
+};
+
+/**
+ * @brief Handle of submitted command.
+ *
+ * Copyable, every copy refers to the same command
+ */
+class handle {
+  friend class impl::MotionExecutorImpl;
+
+ public:
+  /**
+   * Wait until command is done
+   *
+   * @return command result
+   */
+  result wait() const;
+  /**
+   * Check whether command is done or not
+   *
+   * @return done or not
+   */
+  bool done() const;
+  /**
+   * Cancel command
+   *
+   * Queued command is dropped, running command decelerates to a stop
+   * (see Movement::brake)
+   */
+  void cancel() const;
+  /**
+   * Get progress of command
+   *
+   * For command that runs several moves, progress of current move is given
+   *
+   * @return progress from 0.0 to 1.0
+   */
+  float progress() const;
+
+ private:
+  /**
+   * handle Constructor
+   *
+   * @param task      shared state of the command
+   * @param executor  executor the command is submitted to
+   */
+  handle(const std::shared_ptr<executor::task>& task,
+         impl::MotionExecutorImpl*              executor);
+
+ private:
+  /**
+   * Shared state of the command
+   */
+  std::shared_ptr<executor::task> task_;
+  /**
+   * Executor the command is submitted to
+   */
+  impl::MotionExecutorImpl* executor_;
+};
+
+/**
+ * @brief Motion command.
+ */
+struct command {
+  /** command type */
+  executor::type type;
+  /** unit of move command */
+  movement::unit unit;
+  /** x-axis of move command */
+  Point x;
+  /** y-axis of move command */
+  Point y;
+  /** z-axis of move command */
+  Point z;
+  /** speed profile of motor_profile command */
+  config::MechanismSpeed speed_profile;
+  /** config snapshot of homing command */
+  std::shared_ptr<const config::Settings> settings;
+  /** routine of run command */
+  std::function<void(Movement&)> routine;
+  /** shared state of the command */
+  std::shared_ptr<executor::task> task;
+};
+}  // namespace executor
+
+namespace impl {
+/**
+ * @brief Motion executor implementation.
+ *
+ * Every motion runs on a single thread so stepper state has one owner and the
+ * pulse timing does not compete with GUI and listener threads. The thread
+ * locks the process memory, runs with real-time priority (SCHED_FIFO), and
+ * can be pinned to one CPU.
+ *
+ * Commands are fed through a lock-free SPSC queue. Submissions from several
+ * threads are serialized by the producer mutex, the executor thread itself
+ * only locks between commands.
+ *
+ * Completion callbacks never run on the executor thread. It posts them
+ * through another SPSC queue to the completion thread, so a callback that
+ * logs, blocks, or submits more commands does not hold the next motion.
+ *
+ * Stop does not wait in the queue: running command is aborted at once and
+ * every command queued before the stop is cancelled. Cancel through
+ * executor::handle only affects its own command and lets a running move
+ * decelerate instead.
+ */
+class MotionExecutorImpl : public StackObj {
+  template <class MotionExecutorImpl>
+  template <typename... Args>
+  friend ATM_STATUS StaticObj<MotionExecutorImpl>::create(Args&&... args);
+  friend class executor::handle;
+
+ public:
+  /**
+   * Start executor thread
+   *
+   * @return ATM_STATUS ATM_OK or ATM_ERR, but not both
+   */
+  ATM_STATUS start();
+  /**
+   * Stop executor and completion thread
+   *
+   * Queued commands are cancelled. Must not be called from a completion
+   * callback
+   */
+  void join();
+  /**
+   * Queue move command
+   *
+   * @tparam Unit movement unit (cm / mm)
+   *
+   * @param x            length of x-axis
+   * @param y            length of y-axis
+   * @param z            length of z-axis
+   * @param on_complete  completion callback
+   *
+   * @return completion handle
+   */
+  template <movement::unit Unit>
+  executor::handle move_async(Point              x,
+                              Point              y,
+                              Point              z,
+                              executor::callback on_complete = nullptr);
+  /**
+   * Move and wait until the move is done
+   *
+   * @tparam Unit movement unit (cm / mm)
+   *
+   * @param x  length of x-axis
+   * @param y  length of y-axis
+   * @param z  length of z-axis
+   *
+   * @return command result
+   */
+  template <movement::unit Unit>
+  executor::result move(Point x, Point y, Point z);
+  /**
+   * Queue homing command
+   *
+   * @param settings    config snapshot of the job, latest revision if null
+   * @param on_complete completion callback
+   *
+   * @return completion handle
+   */
+  executor::handle homing_async(
+      std::shared_ptr<const config::Settings> settings = nullptr,
+      executor::callback                      on_complete = nullptr);
+  /**
+   * Home and wait until homing is done
+   *
+   * @param settings config snapshot of the job, latest revision if null
+   *
+   * @return command result
+   */
+  executor::result homing(
+      std::shared_ptr<const config::Settings> settings = nullptr);
+  /**
+   * Abort running command and cancel queued commands
+   *
+   * @return completion handle
+   */
+  executor::handle stop();
+  /**
+   * Queue speed profile change
+   *
+   * @param speed_profile speed profile configuration
+   *
+   * @return completion handle
+   */
+  executor::handle motor_profile(const config::MechanismSpeed& speed_profile);
+  /**
+   * Queue movement routine
+   *
+   * @param routine routine to run, e.g. &Movement::disable_motors
+   *
+   * @return completion handle
+   */
+  executor::handle run(std::function<void(Movement&)> routine);
+  /**
+   * Check whether executor thread is running or not
+   *
+   * @return running or not
+   */
+  inline bool running() const {
+    return running_.load(std::memory_order_acquire);
+  }
+  /**
+   * Get progress of running move
+   *
+   * @return progress from 0.0 to 1.0
+   */
+  inline float progress() const { return movement_->snapshot().progress; }
+
+ private:
+  /**
+   * MotionExecutorImpl Constructor
+   *
+   * @param movement     movement mechanism to own
+   * @param priority     SCHED_FIFO priority, 0 to keep default scheduling
+   * @param cpu          CPU to pin the thread to, -1 to keep default affinity
+   * @param lock_memory  lock process memory to avoid page faults
+   */
+  MotionExecutorImpl(const std::shared_ptr<Movement>& movement,
+                     int                              priority,
+                     int                              cpu,
+                     bool                             lock_memory);
+  /**
+   * MotionExecutorImpl Destructor
+   *
+   * Joins executor thread
+   */
+  ~MotionExecutorImpl();
+  /**
+   * Push command to the queue
+   *
+   * @param command command to push
+   *
+   * @return completion handle
+   */
+  executor::handle submit(executor::command&& command,
+                          executor::callback  on_complete = nullptr);
+  /**
+   * Cancel command
+   *
+   * @param task shared state of the command
+   */
+  void cancel(const std::shared_ptr<executor::task>& task);
+  /**
+   * Set result of command and notify its waiters
+   *
+   * Callback is not invoked, caller runs or posts it after its locks are
+   * released
+   *
+   * @param command  command that is done
+   * @param result   command result
+   *
+   * @return completion callback of the command, may be empty
+   */
+  static executor::callback complete(executor::command& command,
+                                     executor::result   result);
+  /**
+   * Complete command and post its callback to the completion thread
+   *
+   * Executor thread only
+   *
+   * @param command  command that is done
+   * @param result   command result
+   */
+  void finish(executor::command& command, executor::result result);
+  /**
+   * Executor thread loop
+   */
+  void loop();
+  /**
+   * Completion thread loop
+   *
+   * Runs posted callbacks until the executor thread has stopped
+   */
+  void notify();
+  /**
+   * Execute single command
+   *
+   * @param command command to execute
+   *
+   * @return command result
+   */
+  executor::result execute(executor::command& command);
+
+ private:
+  /**
+   * Movement mechanism
+   */
+  std::shared_ptr<Movement> movement_;
+  /**
+   * SCHED_FIFO priority
+   */
+  const int priority_;
+  /**
+   * CPU affinity
+   */
+  const int cpu_;
+  /**
+   * Lock process memory or not
+   */
+  const bool lock_memory_;
+  /**
+   * Command queue
+   */
+  algo::SpscQueue<executor::command, executor::queue_capacity> queue_;
+  /**
+   * Serialize producers
+   */
+  std::mutex producer_mutex_;
+  /**
+   * Incremented on every push, executor thread waits on it
+   */
+  std::atomic<unsigned int> pushed_;
+  /**
+   * Stop commands that have not been executed
+   */
+  std::atomic<unsigned int> pending_stops_;
+  /**
+   * Guard running command against cancel from other threads
+   */
+  std::mutex current_mutex_;
+  /**
+   * Shared state of running command
+   */
+  std::shared_ptr<executor::task> current_;
+  /**
+   * Executor thread is running or not
+   */
+  std::atomic<bool> running_;
+  /**
+   * Executor thread
+   */
+  std::thread thread_;
+  /**
+   * Callbacks posted by the executor thread
+   */
+  algo::SpscQueue<executor::completion, executor::queue_capacity>
+      completions_;
+  /**
+   * Incremented on every post, completion thread waits on it
+   */
+  std::atomic<unsigned int> posted_;
+  /**
+   * Completion thread is running or not
+   */
+  std::atomic<bool> notifying_;
+  /**
+   * Completion thread
+   */
+  std::thread notifier_;
+};
+}  // namespace impl
+}  // namespace mechanism
+
+NAMESPACE_END
+
+#endif  // LIB_MECHANISM_EXECUTOR_HPP_
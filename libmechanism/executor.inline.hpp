@@ -0,0 +1,34 @@
+#ifndef LIB_MECHANISM_EXECUTOR_INLINE_HPP_
+#define LIB_MECHANISM_EXECUTOR_INLINE_HPP_
+
+#include "executor.hpp"
+
+NAMESPACE_BEGIN
+
+namespace mechanism {
+namespace impl {
+template <movement::unit Unit>
+executor::handle MotionExecutorImpl::move_async(
+    Point              x,
+    Point              y,
+    Point              z,
+    executor::callback on_complete) {
+  executor::command command;
+  command.type = executor::type::move;
+  command.unit = Unit;
+  command.x = x;
+  command.y = y;
+  command.z = z;
+  return submit(std::move(command), std::move(on_complete));
+}
+
+template <movement::unit Unit>
+executor::result MotionExecutorImpl::move(Point x, Point y, Point z) {
+  return move_async<Unit>(x, y, z).wait();
+}
+}  // namespace impl
+}  // namespace mechanism
+
+NAMESPACE_END
+
+#endif  // LIB_MECHANISM_EXECUTOR_INLINE_HPP_
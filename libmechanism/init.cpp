@@ -4,6 +4,7 @@
 
 #include <memory>
 
+#include "executor.hpp"
 #include "liquid-refilling.hpp"
 #include "movement.hpp"
 
@@ -23,7 +24,7 @@ static ATM_STATUS initialize_movement_mechanism() {
   auto movement_builder = MovementBuilder::get();
   status = movement_builder->setup_x(
       device::id::stepper::x(),
-      config->stepper_x<const device::stepper::step>("steps-per-mm"),
+      config->stepper_x().steps_per_mm,
       device::id::limit_switch::x());
   if (status == ATM_ERR) {
     return ATM_ERR;
@@ -31,7 +32,7 @@ static ATM_STATUS initialize_movement_mechanism() {
 
   status = movement_builder->setup_y(
       device::id::stepper::y(),
-      config->stepper_y<const device::stepper::step>("steps-per-mm"),
+      config->stepper_y().steps_per_mm,
       device::id::limit_switch::y());
   if (status == ATM_ERR) {
     return ATM_ERR;
@@ -39,7 +40,7 @@ static ATM_STATUS initialize_movement_mechanism() {
 
   status = movement_builder->setup_z(
       device::id::stepper::z(),
-      config->stepper_z<const device::stepper::step>("steps-per-mm"),
+      config->stepper_z().steps_per_mm,
       device::id::limit_switch::z1(), device::id::limit_switch::z2());
   if (status == ATM_ERR) {
     return ATM_ERR;
@@ -57,6 +58,29 @@ static ATM_STATUS initialize_movement_mechanism() {
   massert(movement_mechanism() != nullptr, "sanity");
   massert(movement_mechanism()->active(), "sanity");
 
+  const auto  settings = config->snapshot();
+  const auto& movement_config = settings->mechanisms.movement;
+
+  movement_mechanism()->mode(movement_config.mode);
+
+  // compile configured paths before the first job needs them
+  movement_mechanism()->compile_programs();
+
+  status = MotionExecutor::create(movement_mechanism(),
+                                  movement_config.executor.priority,
+                                  movement_config.executor.cpu,
+                                  movement_config.executor.lock_memory);
+  if (status == ATM_ERR) {
+    return ATM_ERR;
+  }
+
+  massert(MotionExecutor::get() != nullptr, "sanity");
+
+  status = MotionExecutor::get()->start();
+  if (status == ATM_ERR) {
+    return ATM_ERR;
+  }
+
   status = LiquidRefilling::create();
 
   if (status == ATM_ERR) {
@@ -76,8 +100,8 @@ static ATM_STATUS initialize_movement_mechanism() {
       device::id::comm::pi::disinfectant_out());
 
   liquid_refill_mechanism->setup_draining_time(
-      config->liquid_refilling<unsigned int>("water", "draining-time"),
-      config->liquid_refilling<unsigned int>("disinfectant", "draining-time"));
+      settings->mechanisms.liquid_refilling.water_draining_time,
+      settings->mechanisms.liquid_refilling.disinfectant_draining_time);
 
   massert(LiquidRefilling::get()->active(), "sanity");
 
@@ -95,6 +119,11 @@ ATM_STATUS initialize_mechanism() {
   return status;
 }
 
-void destroy_mechanism() {}
+void destroy_mechanism() {
+  // executor is not created if initialization failed before it
+  if (MotionExecutor::get() != nullptr) {
+    MotionExecutor::get()->join();
+  }
+}
 
 NAMESPACE_END
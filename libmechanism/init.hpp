@@ -21,6 +21,8 @@ ATM_STATUS initialize_mechanism();
 
 /**
  * Destroy mechanisms
+ *
+ * Stops the motion executor thread
  */
 void destroy_mechanism();
 
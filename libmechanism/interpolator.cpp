@@ -0,0 +1,216 @@
+#include "mechanism.hpp"
+
+#include "interpolator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+NAMESPACE_BEGIN
+
+namespace mechanism {
+Interpolator::Interpolator() {
+  delta_.fill(0);
+  abs_delta_.fill(0);
+  error_.fill(0);
+  step_count_.fill(0);
+  master_steps_ = 0;
+  master_count_ = 0;
+  remaining_steps_ = 0;
+  steps_to_cruise_ = 0;
+  steps_to_brake_ = 0;
+  entry_steps_ = 0;
+  exit_steps_ = 0;
+  rest_steps_ = 0;
+  deceleration_ = 0.0;
+  step_pulse_ = 0;
+  cruise_step_pulse_ = 0;
+}
+
+void Interpolator::start(const steps& steps, const steppers& steppers) {
+  device::stepper::step master_steps = 0;
+
+  for (std::size_t axis = 0; axis < interpolator::axes; ++axis) {
+    master_steps = std::max(master_steps, std::abs(steps[axis]));
+  }
+
+  // master clock limits (in microsteps of dominant axis), none of the axes
+  // can exceed its own limits
+  interpolator::profile profile{std::numeric_limits<double>::max(),
+                                std::numeric_limits<double>::max(),
+                                std::numeric_limits<double>::max(), 0.0, 0.0};
+
+  for (std::size_t axis = 0; axis < interpolator::axes; ++axis) {
+    if (steps[axis] == 0) {
+      continue;
+    }
+
+    const auto* stepper = steppers[axis];
+    // how much faster master clock is compared to this axis
+    const double ratio = static_cast<double>(master_steps) /
+                         static_cast<double>(std::abs(steps[axis]));
+    const double microsteps = static_cast<double>(stepper->microsteps());
+
+    profile.speed = std::min(
+        profile.speed,
+        ratio * microsteps * stepper->rpm() * stepper->motor_steps() / 60.0);
+    profile.acceleration = std::min(
+        profile.acceleration, ratio * microsteps * stepper->acceleration());
+    profile.deceleration = std::min(
+        profile.deceleration, ratio * microsteps * stepper->deceleration());
+  }
+
+  start(steps, profile);
+}
+
+void Interpolator::start(const steps&                 steps,
+                         const interpolator::profile& profile) {
+  delta_ = steps;
+  master_steps_ = 0;
+
+  for (std::size_t axis = 0; axis < interpolator::axes; ++axis) {
+    abs_delta_[axis] = std::abs(steps[axis]);
+    step_count_[axis] = 0;
+    master_steps_ = std::max(master_steps_, abs_delta_[axis]);
+  }
+
+  master_count_ = 0;
+  remaining_steps_ = master_steps_;
+  rest_steps_ = 0;
+
+  if (master_steps_ == 0) {
+    step_pulse_ = 0;
+    return;
+  }
+
+  // error starts at half of the master steps so the slave steps are centered
+  for (std::size_t axis = 0; axis < interpolator::axes; ++axis) {
+    error_[axis] = master_steps_ / 2;
+  }
+
+  const double speed = profile.speed;
+  const double acceleration = profile.acceleration;
+  const double deceleration = profile.deceleration;
+
+  deceleration_ = deceleration;
+  const double entry = std::min(profile.entry, speed);
+  const double exit = std::min(profile.exit, speed);
+
+  // position of entry and exit speed in the acceleration and deceleration
+  // series, the series continue from there instead of from a standstill
+  entry_steps_ = static_cast<device::stepper::step>(entry * entry /
+                                                    (2 * acceleration));
+  exit_steps_ =
+      static_cast<device::stepper::step>(exit * exit / (2 * deceleration));
+
+  // how many steps from entry to target speed
+  steps_to_cruise_ = static_cast<device::stepper::step>(
+      (speed * speed - entry * entry) / (2 * acceleration));
+  // how many steps are needed from cruise speed to exit speed
+  steps_to_brake_ = static_cast<device::stepper::step>(
+      (speed * speed - exit * exit) / (2 * deceleration));
+
+  if (remaining_steps_ < steps_to_cruise_ + steps_to_brake_) {
+    // cannot reach max speed, will need to brake early
+    // peak is the squared speed where acceleration and deceleration meet
+    const double peak =
+        (2 * acceleration * deceleration * remaining_steps_ +
+         deceleration * entry * entry + acceleration * exit * exit) /
+        (acceleration + deceleration);
+    steps_to_cruise_ = static_cast<device::stepper::step>(
+        (peak - entry * entry) / (2 * acceleration));
+    steps_to_cruise_ =
+        std::clamp(steps_to_cruise_, static_cast<device::stepper::step>(0),
+                   remaining_steps_);
+    steps_to_brake_ = remaining_steps_ - steps_to_cruise_;
+  }
+
+  if (entry_steps_ > 0) {
+    step_pulse_ = static_cast<device::stepper::pulse>(1e+6 / entry);
+  } else {
+    // Initial pulse (c0) including error correction factor 0.676 [us]
+    step_pulse_ = static_cast<device::stepper::pulse>(
+        (1e+6) * 0.676 * std::sqrt(2.0 / acceleration));
+  }
+  cruise_step_pulse_ = static_cast<device::stepper::pulse>(1e+6 / speed);
+}
+
+unsigned int Interpolator::next() {
+  if (remaining_steps_ <= 0) {
+    return 0;
+  }
+
+  unsigned int mask = 0;
+
+  for (std::size_t axis = 0; axis < interpolator::axes; ++axis) {
+    error_[axis] += abs_delta_[axis];
+    if (error_[axis] >= master_steps_) {
+      error_[axis] -= master_steps_;
+      ++step_count_[axis];
+      mask |= (1U << axis);
+    }
+  }
+
+  calc_step_pulse();
+
+  return mask;
+}
+
+device::stepper::step Interpolator::stop() {
+  device::stepper::step retval = remaining_steps_;
+  remaining_steps_ = 0;
+  return retval;
+}
+
+void Interpolator::brake() {
+  if (remaining_steps_ <= 0) {
+    return;
+  }
+
+  if (exit_steps_ == 0 && remaining_steps_ <= steps_to_brake_) {
+    // already decelerating to a stop
+    return;
+  }
+
+  const double speed = 1e+6 / static_cast<double>(step_pulse_);
+
+  steps_to_brake_ =
+      std::min(remaining_steps_, static_cast<device::stepper::step>(
+                                     speed * speed / (2 * deceleration_)));
+  remaining_steps_ = steps_to_brake_;
+  exit_steps_ = 0;
+}
+
+float Interpolator::progress() const {
+  if (master_steps_ == 0) {
+    return 1.0f;
+  }
+
+  return static_cast<float>(master_count_) / static_cast<float>(master_steps_);
+}
+
+void Interpolator::calc_step_pulse() {
+  remaining_steps_--;
+  master_count_++;
+
+  if (remaining_steps_ > 0 && remaining_steps_ <= steps_to_brake_) {
+    // decelerating
+    const device::stepper::step n = -4 * (remaining_steps_ + exit_steps_) + 1;
+    step_pulse_ = step_pulse_ - (2 * step_pulse_ + rest_steps_) / n;
+    rest_steps_ = (2 * step_pulse_ + rest_steps_) % n;
+  } else if (master_count_ <= steps_to_cruise_) {
+    // accelerating
+    if (master_count_ < steps_to_cruise_) {
+      const device::stepper::step n = 4 * (master_count_ + entry_steps_) + 1;
+      step_pulse_ = step_pulse_ - (2 * step_pulse_ + rest_steps_) / n;
+      rest_steps_ = (2 * step_pulse_ + rest_steps_) % n;
+    } else {
+      // The series approximates target, set the final value to what it should
+      // be instead
+      step_pulse_ = cruise_step_pulse_;
+    }
+  }
+}
+}  // namespace mechanism
+
+NAMESPACE_END
@@ -0,0 +1,218 @@
+#ifndef LIB_MECHANISM_INTERPOLATOR_HPP_
+#define LIB_MECHANISM_INTERPOLATOR_HPP_
+
+/** @file interpolator.hpp
+ *  @brief Multi-axis DDA interpolator class definition
+ *
+ * Coordinated multi-axis interpolator with single master step clock
+ */
+
+#include <array>
+
+#include <libcore/core.hpp>
+#include <libdevice/device.hpp>
+
+NAMESPACE_BEGIN
+
+namespace mechanism {
+namespace interpolator {
+/** Number of interpolated axes (x, y, z) */
+constexpr std::size_t axes = 3;
+
+/**
+ * @brief Master clock profile.
+ *
+ * Every value is in master steps (steps of dominant axis)
+ */
+struct profile {
+  /** cruise speed [steps/s] */
+  double speed;
+  /** acceleration [steps/s^2] */
+  double acceleration;
+  /** deceleration [steps/s^2] */
+  double deceleration;
+  /** speed when entering the move [steps/s] */
+  double entry;
+  /** speed when leaving the move [steps/s] */
+  double exit;
+};
+}  // namespace interpolator
+
+/**
+ * @brief Multi-axis DDA interpolator.
+ *
+ * Dominant axis (the one with the most steps) is driven by the master step
+ * clock using linear speed profile (same recurrence as
+ * device::LinearSpeedStepperDevice). The other axes are derived with integer
+ * DDA (Bresenham), so every move is a straight line and the per-step work is a
+ * few integer operations.
+ *
+ * Speed and acceleration of the master clock are limited so that none of the
+ * axes exceeds its own rpm, acceleration, or deceleration.
+ */
+class Interpolator : public StackObj {
+ public:
+  /**
+   * Steps for each axis
+   */
+  typedef std::array<device::stepper::step, interpolator::axes> steps;
+  /**
+   * Steppers for each axis
+   */
+  typedef std::array<const device::StepperDevice*, interpolator::axes>
+      steppers;
+  /**
+   * Interpolator Constructor
+   */
+  Interpolator();
+  /**
+   * Plan a straight line move
+   *
+   * @param steps     steps to take for each axis (signed)
+   * @param steppers  stepper of each axis to get speed limits from
+   */
+  void start(const steps& steps, const steppers& steppers);
+  /**
+   * Plan a straight line move with given master clock profile
+   *
+   * Entry and exit speed allow consecutive moves to be blended without
+   * stopping in between
+   *
+   * @param steps    steps to take for each axis (signed)
+   * @param profile  master clock profile
+   */
+  void start(const steps& steps, const interpolator::profile& profile);
+  /**
+   * Advance master clock by one step
+   *
+   * @return bit mask of axes that must be pulsed (bit 0 is x-axis)
+   */
+  unsigned int next();
+  /**
+   * Stop the move
+   *
+   * @return remaining steps of the dominant axis
+   */
+  device::stepper::step stop();
+  /**
+   * Start decelerating to a stop
+   *
+   * Remaining master steps are cut to the steps needed to decelerate from
+   * current speed, does nothing if already decelerating to a stop
+   */
+  void brake();
+  /**
+   * Check whether the move has been completed or not
+   *
+   * @return ready or not
+   */
+  inline bool ready() const { return remaining_steps_ <= 0; }
+  /**
+   * Get current step pulse of master clock
+   *
+   * @return time until next master step in micros
+   */
+  inline const device::stepper::pulse& step_pulse() const {
+    return step_pulse_;
+  }
+  /**
+   * Get direction of given axis
+   *
+   * @param axis axis index
+   *
+   * @return direction of given axis
+   */
+  inline device::stepper::direction direction(std::size_t axis) const {
+    return delta_[axis] >= 0 ? device::stepper::direction::forward
+                             : device::stepper::direction::backward;
+  }
+  /**
+   * Get step count of given axis
+   *
+   * @param axis axis index
+   *
+   * @return steps that have been taken by given axis
+   */
+  inline const device::stepper::step& step_count(std::size_t axis) const {
+    return step_count_[axis];
+  }
+  /**
+   * Get move progress
+   *
+   * @return progress from 0.0 to 1.0
+   */
+  float progress() const;
+
+ private:
+  /**
+   * Calculate the step pulse of master clock for each step
+   */
+  void calc_step_pulse();
+
+ private:
+  /**
+   * Signed steps of each axis
+   */
+  steps delta_;
+  /**
+   * Absolute steps of each axis
+   */
+  steps abs_delta_;
+  /**
+   * DDA error accumulator of each axis
+   */
+  steps error_;
+  /**
+   * Step count of each axis
+   */
+  steps step_count_;
+  /**
+   * Steps of dominant axis
+   */
+  device::stepper::step master_steps_;
+  /**
+   * Master step count
+   */
+  device::stepper::step master_count_;
+  /**
+   * Remaining steps of master clock
+   */
+  device::stepper::step remaining_steps_;
+  /**
+   * Master steps to cruise
+   */
+  device::stepper::step steps_to_cruise_;
+  /**
+   * Master steps to brake
+   */
+  device::stepper::step steps_to_brake_;
+  /**
+   * Virtual step index of entry speed in acceleration series
+   */
+  device::stepper::step entry_steps_;
+  /**
+   * Virtual step index of exit speed in deceleration series
+   */
+  device::stepper::step exit_steps_;
+  /**
+   * calculation remainder to be fed into successive steps to increase accuracy
+   */
+  device::stepper::step rest_steps_;
+  /**
+   * Master deceleration [steps/s^2]
+   */
+  double deceleration_;
+  /**
+   * Current master step pulse
+   */
+  device::stepper::pulse step_pulse_;
+  /**
+   * Cruise master step pulse
+   */
+  device::stepper::pulse cruise_step_pulse_;
+};
+}  // namespace mechanism
+
+NAMESPACE_END
+
+#endif  // LIB_MECHANISM_INTERPOLATOR_HPP_
@@ -29,8 +29,14 @@
 #include "init.hpp"
 
 // 4.1. Movement Mechanism
+#include "interpolator.hpp"
+#include "planner.hpp"
+#include "program.hpp"
+#include "position.hpp"
 #include "movement.hpp"
 #include "movement.inline.hpp"
+#include "executor.hpp"
+#include "executor.inline.hpp"
 
 // 4.2. Liquid refilling Mechanism
 #include "liquid-refilling.hpp"
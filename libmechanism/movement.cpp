@@ -4,6 +4,7 @@
 
 #include <cmath>
 #include <thread>
+#include <utility>
 
 #include <libutil/util.hpp>
 
@@ -118,7 +119,9 @@ std::shared_ptr<Movement>& MovementBuilderImpl::build() {
 }  // namespace impl
 
 Movement::Movement(const impl::MovementBuilderImpl* builder)
-    : builder_{builder} {
+    : builder_{builder},
+      position_{{builder->steps_per_mm_x(), builder->steps_per_mm_y(),
+                 builder->steps_per_mm_z()}} {
   active_ = true;
   ready_ = true;
   next_move_interval_ = 0;
@@ -126,6 +129,13 @@ Movement::Movement(const impl::MovementBuilderImpl* builder)
   event_timer_x_ = 0;
   event_timer_y_ = 0;
   event_timer_z_ = 0;
+  mode_ = movement::mode::independent;
+  abort_ = false;
+  brake_ = false;
+  halt_ = false;
+  braked_ = false;
+  segment_ = 0;
+  last_snapshot_ = {};
 
   setup_stepper();
   if (active()) {
@@ -135,9 +145,26 @@ Movement::Movement(const impl::MovementBuilderImpl* builder)
   if (active()) {
     setup_finger();
   }
+
+  massert(State::get() != nullptr, "sanity");
+
+  // coordinate is derived from step counters from now on
+  State::get()->position_source(&position_);
+
+  if (active()) {
+    // homing and other overwrites of the position are published right away
+    position_.observe([this] { publish_snapshot(micros(), true); });
+    publish_snapshot(micros(), true);
+  }
 }
 
-Movement::~Movement() {}
+Movement::~Movement() {
+  position_.observe(nullptr);
+
+  if (State::get() != nullptr) {
+    State::get()->position_source(nullptr);
+  }
+}
 
 void Movement::setup_stepper() {
   auto*  stepper_registry = device::StepperRegistry::get();
@@ -254,18 +281,93 @@ void Movement::stop(void) {
   [[maybe_unused]] auto step_x = stop_x();
   [[maybe_unused]] auto step_y = stop_y();
   [[maybe_unused]] auto step_z = stop_z();
+  [[maybe_unused]] auto step_master = interpolator_.stop();
+  // steppers have taken back their pending pulses, cut the chunks in flight
+  if (device::Wave::get() != nullptr) {
+    device::Wave::get()->stop();
+  }
   ready_ = true;
+  publish_snapshot(micros(), true);
 }
 
-void Movement::start_move(const long& x, const long& y, const long& z) {
+bool Movement::interrupted() const {
   massert(State::get() != nullptr, "sanity");
 
   auto* state = State::get();
 
-  if (state->fault() && !state->manual_mode()) {
+  return aborted() || halted() ||
+         (state->fault() && !state->manual_mode()) ||
+         (braking() && ready());
+}
+
+void Movement::mode(const movement::mode& mode) {
+  massert(ready(), "sanity");
+  mode_ = mode;
+}
+
+/**
+ * Dump step jitter of single stepper to the log
+ *
+ * @param axis    axis name
+ * @param jitter  step jitter recorder
+ */
+static void log_axis_jitter(const char*               axis,
+                            const device::StepJitter& jitter) {
+  const device::jitter::snapshot snapshot = jitter.snapshot();
+
+  LOG_INFO(
+      "Step jitter {}: steps {}, missed {}, mean {} us, max {} us, last move "
+      "max {} us",
+      axis, snapshot.steps, snapshot.missed, snapshot.mean_lateness,
+      snapshot.max_lateness, snapshot.move_max_lateness);
+
+  std::string histogram;
+
+  for (std::size_t i = 0; i < device::jitter::buckets; ++i) {
+    if (snapshot.histogram[i] == 0) {
+      continue;
+    }
+
+    histogram += fmt::format(" >={}us:{}", device::StepJitter::bucket_floor(i),
+                             snapshot.histogram[i]);
+  }
+
+  if (!histogram.empty()) {
+    LOG_INFO("Step jitter {} histogram:{}", axis, histogram);
+  }
+}
+
+void Movement::reset_jitter() const {
+  stepper_x()->jitter().reset();
+  stepper_y()->jitter().reset();
+  stepper_z()->jitter().reset();
+}
+
+void Movement::log_jitter() const {
+  log_axis_jitter("x", jitter_x());
+  log_axis_jitter("y", jitter_y());
+  log_axis_jitter("z", jitter_z());
+}
+
+void Movement::start_move(const long& x, const long& y, const long& z) {
+  if (interrupted()) {
+    return;
+  }
+
+  braked_ = false;
+  segment_ = 0;
+
+  if (mode() == movement::mode::interpolated) {
+    start_interpolated_move(x, y, z);
     return;
   }
 
+  start_independent_move(x, y, z);
+}
+
+void Movement::start_independent_move(const long& x,
+                                      const long& y,
+                                      const long& z) {
 #if defined(SYNC_DRIVER)
   const time_unit time_x = stepper_x()->time_for_move(x);
   const time_unit time_y = stepper_y()->time_for_move(y);
@@ -274,7 +376,7 @@ void Movement::start_move(const long& x, const long& y, const long& z) {
   // find which motor would take the longest to finish,
   const time_unit move_time = std::max(time_x, std::max(time_y, time_z));
 
-  LOG_DEBUG("Will move about {} micros", move_time);
+  LOG_DEFER_DEBUG("Will move about {} micros", move_time);
 
   // start moving x
   if (x == 0) {
@@ -331,64 +433,148 @@ void Movement::start_move(const long& x, const long& y, const long& z) {
   next_move_interval_ = 1;
 }
 
-void Movement::update_x() const {
-  auto steps = stepper_x()->step_count();
-  auto remaining_steps = stepper_x()->remaining_steps();
+void Movement::write_direction(const long& x,
+                               const long& y,
+                               const long& z) const {
+  stepper_x()->write_direction((x >= 0) ? device::stepper::direction::forward
+                                        : device::stepper::direction::backward);
+  stepper_y()->write_direction((y >= 0) ? device::stepper::direction::forward
+                                        : device::stepper::direction::backward);
+  stepper_z()->write_direction((z >= 0) ? device::stepper::direction::forward
+                                        : device::stepper::direction::backward);
+}
+
+void Movement::start_jitter() const {
+  stepper_x()->jitter().start_move();
+  stepper_y()->jitter().start_move();
+  stepper_z()->jitter().start_move();
+}
+
+void Movement::start_brake() {
+  braked_ = true;
 
-  if (remaining_steps == 0) {
+  if (mode() == movement::mode::interpolated || !interpolator_.ready()) {
+    interpolator_.brake();
     return;
   }
 
-  if ((steps % builder()->steps_per_mm_x()) == 0) {
-    if (stepper_x()->direction() == device::stepper::direction::forward) {
-      State::get()->inc_x();
-    } else {
-      State::get()->dec_x();
-    }
-  }
+  stepper_x()->start_brake();
+  stepper_y()->start_brake();
+  stepper_z()->start_brake();
 }
 
-void Movement::update_y() const {
-  auto steps = stepper_y()->step_count();
-  auto remaining_steps = stepper_y()->remaining_steps();
+void Movement::start_interpolated_move(const long& x,
+                                       const long& y,
+                                       const long& z) {
+  write_direction(x, y, z);
+  start_jitter();
 
-  if (remaining_steps == 0) {
-    return;
+  interpolator_.start(
+      {x, y, z}, {stepper_x().get(), stepper_y().get(), stepper_z().get()});
+
+  ready_ = interpolator_.ready();
+  last_move_end_ = 0;
+  next_move_interval_ = ready() ? 0 : 1;
+}
+
+void Movement::start_planned_move(const planner::segment& segment,
+                                  bool                    continuous) {
+  const auto& steps = segment.steps;
+
+  // last pulse of the previous segment is the gap before the first step
+  const time_unit interval =
+      continuous ? static_cast<time_unit>(interpolator_.step_pulse()) : 1;
+
+  write_direction(steps[0], steps[1], steps[2]);
+  start_jitter();
+
+  interpolator_.start(steps, segment.profile);
+
+  ready_ = interpolator_.ready();
+  if (!continuous) {
+    last_move_end_ = 0;
   }
+  next_move_interval_ = ready() ? 0 : interval;
+}
 
-  if ((steps % builder()->steps_per_mm_y()) == 0) {
-    if (stepper_y()->direction() == device::stepper::direction::forward) {
-      State::get()->inc_y();
-    } else {
-      State::get()->dec_y();
+void Movement::update_position(const device::stepper::step& steps_x,
+                               const device::stepper::step& steps_y,
+                               const device::stepper::step& steps_z) {
+  position_.step(0, stepper_x()->step_count() - steps_x,
+                 stepper_x()->direction());
+  position_.step(1, stepper_y()->step_count() - steps_y,
+                 stepper_y()->direction());
+  position_.step(2, stepper_z()->step_count() - steps_z,
+                 stepper_z()->direction());
+}
+
+void Movement::update_interpolated_position(unsigned int mask) {
+  for (std::size_t axis = 0; axis < interpolator::axes; ++axis) {
+    if (mask & (1U << axis)) {
+      position_.step(axis, 1, interpolator_.direction(axis));
     }
   }
 }
 
-void Movement::update_z() const {
-  auto steps = stepper_z()->step_count();
-  auto remaining_steps = stepper_z()->remaining_steps();
+void Movement::publish_snapshot(time_unit now, bool force) {
+  const time_unit elapsed = now - last_snapshot_.time;
 
-  if (remaining_steps == 0) {
+  if (!force && elapsed < movement::snapshot_period) {
     return;
   }
 
-  if ((steps % builder()->steps_per_mm_z()) == 0) {
-    if (stepper_z()->direction() == device::stepper::direction::forward) {
-      State::get()->inc_z();
-    } else {
-      State::get()->dec_z();
+  const Coordinate coordinate = position_.position();
+  const std::array<Point, interpolator::axes> position = {
+      coordinate.x, coordinate.y, coordinate.z};
+
+  movement::snapshot snapshot = last_snapshot_;
+
+  snapshot.version = last_snapshot_.version + 1;
+  snapshot.time = now;
+
+  for (std::size_t axis = 0; axis < interpolator::axes; ++axis) {
+    auto&       current = snapshot.axes[axis];
+    const auto& last = last_snapshot_.axes[axis];
+
+    current.steps = position_.steps(axis);
+    current.position = position[axis];
+    current.moving = !ready() && current.steps != last.steps;
+
+    if (!current.moving) {
+      current.velocity = 0.0;
+    } else if (elapsed >= movement::snapshot_period) {
+      // forced snapshots are too close to the previous one to be accurate
+      current.velocity = (current.position - last.position) * 1e+6 /
+                         static_cast<double>(elapsed);
     }
   }
-}
 
-void Movement::update_position() const {
-  update_x();
-  update_y();
-  update_z();
+  snapshot.segment = segment_;
+  snapshot.progress = progress();
+  snapshot.ready = ready();
+  snapshot.braking = braking();
+
+  snapshot_.store(snapshot);
+  last_snapshot_ = snapshot;
+
+  if (FlightRecorder::created()) {
+    std::array<int64_t, interpolator::axes> steps;
+    std::array<float, interpolator::axes>   speed;
+
+    for (std::size_t axis = 0; axis < interpolator::axes; ++axis) {
+      steps[axis] = snapshot.axes[axis].steps;
+      speed[axis] = static_cast<float>(snapshot.axes[axis].velocity);
+    }
+
+    FlightRecorder::get()->motion(steps, speed);
+  }
 }
 
 float Movement::progress() const {
+  if (mode() == movement::mode::interpolated || !interpolator_.ready()) {
+    return interpolator_.progress();
+  }
+
   const auto& step_remain_x = stepper_x()->remaining_steps();
   const auto& step_remain_y = stepper_y()->remaining_steps();
   const auto& step_remain_z = stepper_z()->remaining_steps();
@@ -434,10 +620,21 @@ float Movement::progress() const {
 }
 
 time_unit Movement::next() {
-  while ((micros() - last_move_end()) < next_move_interval()) {
-    // not yet running
+  if (mode() == movement::mode::interpolated) {
+    return next_interpolated();
   }
 
+  return next_independent();
+}
+
+time_unit Movement::next_independent() {
+  if (braking()) {
+    start_brake();
+  }
+
+  // sleep until shortly before the next step, then spin
+  wait_until<time_units::micros>(last_move_end() + next_move_interval());
+
   // bool next_x = false;
   // bool next_y = false;
   // bool next_z = false;
@@ -446,6 +643,11 @@ time_unit Movement::next() {
   // std::future<time_unit> timer_y;
   // std::future<time_unit> timer_z;
 
+  // step count before pulsing to track the position
+  const device::stepper::step steps_x = stepper_x()->step_count();
+  const device::stepper::step steps_y = stepper_y()->step_count();
+  const device::stepper::step steps_z = stepper_z()->step_count();
+
   if (event_timer_x() <= next_move_interval()) {
     // with thread version
     // next_x = true;
@@ -491,7 +693,7 @@ time_unit Movement::next() {
   //   event_timer_z_ = timer_z.get();
   // }
 
-  update_position();
+  update_position(steps_x, steps_y, steps_z);
   // auto x = State::get()->x();
   // auto y = State::get()->y();
   // auto z = State::get()->z();
@@ -519,85 +721,400 @@ time_unit Movement::next() {
 
   ready_ = (next_move_interval() == 0);
 
+  publish_snapshot(last_move_end(), ready());
+
+  return next_move_interval();
+}
+
+time_unit Movement::next_interpolated() {
+  if (braking()) {
+    start_brake();
+  }
+
+  const time_unit scheduled = last_move_end() + next_move_interval();
+
+  // sleep until shortly before the next step, then spin
+  wait_until<time_units::micros>(scheduled);
+
+  if (interpolator_.ready()) {
+    // end of move
+    last_move_end_ = 0;
+    next_move_interval_ = 0;
+    ready_ = true;
+    publish_snapshot(micros(), true);
+    return next_move_interval();
+  }
+
+  // save value because next() will overwrite it
+  const auto         pulse = static_cast<time_unit>(interpolator_.step_pulse());
+  const unsigned int mask = interpolator_.next();
+
+  time_unit m = micros();
+
+  // first step of the move has no schedule
+  if (last_move_end() != 0) {
+    if (mask & (1U << 0)) {
+      stepper_x()->jitter().record(scheduled, m);
+    }
+    if (mask & (1U << 1)) {
+      stepper_y()->jitter().record(scheduled, m);
+    }
+    if (mask & (1U << 2)) {
+      stepper_z()->jitter().record(scheduled, m);
+    }
+  }
+
+  // start pulsing every stepper that is due at once, in one register write
+  device::DigitalOutputBatch batch;
+
+  if (mask & (1U << 0)) {
+    stepper_x()->write_step(batch, device::digital::value::high);
+  }
+  if (mask & (1U << 1)) {
+    stepper_y()->write_step(batch, device::digital::value::high);
+  }
+  if (mask & (1U << 2)) {
+    stepper_z()->write_step(batch, device::digital::value::high);
+  }
+
+  batch.commit();
+
+  // We should pull HIGH for at least 1-2us (step_high_min)
+  sleep_for<time_units::micros>(device::StepperDevice::step_high_duration());
+
+  if (mask & (1U << 0)) {
+    stepper_x()->write_step(batch, device::digital::value::low);
+  }
+  if (mask & (1U << 1)) {
+    stepper_y()->write_step(batch, device::digital::value::low);
+  }
+  if (mask & (1U << 2)) {
+    stepper_z()->write_step(batch, device::digital::value::low);
+  }
+
+  batch.commit();
+  // end of pulsing
+
+  update_interpolated_position(mask);
+
+  // account for interpolator and pulsing execution time
+  last_move_end_ = micros();
+  m = last_move_end() - m;
+  next_move_interval_ = (pulse > m) ? pulse - m : 1;
+
+  if (interpolator_.ready()) {
+    next_move_interval_ = 0;
+  }
+
+  ready_ = (next_move_interval() == 0);
+
+  publish_snapshot(last_move_end(), ready());
+
   return next_move_interval();
 }
 
-void Movement::move_to_spraying_position() {
+void Movement::move_to_spraying_position(const config::Settings& settings) {
   LOG_DEBUG("Move to spraying position...");
-  const auto& iter = Config::get()->spraying_position();
+  const auto& iter = settings.mechanisms.spraying.position;
   move<movement::unit::mm>(iter.first, iter.second, 0.0);
   // reset position so imaginary homing equals tending position
   State::get()->coordinate({0.0, 0.0, 0.0});
 }
 
-void Movement::move_to_tending_position() {
+void Movement::move_to_tending_position(const config::Settings& settings) {
   LOG_DEBUG("Move to tending position...");
-  const auto& iter = Config::get()->tending_position();
+  const auto& iter = settings.mechanisms.tending.position;
   move<movement::unit::mm>(iter.first, iter.second, 0.0);
   // reset position so imaginary homing equals tending position
   State::get()->coordinate({0.0, 0.0, 0.0});
 }
 
-void Movement::follow_spraying_paths() {
-  massert(Config::get() != nullptr, "sanity");
+void Movement::follow_spraying_paths(const config::Settings& settings) {
+  LOG_DEBUG("Following spraying paths...");
+  follow_path(settings, program::path::spraying, 0.0);
+}
+
+void Movement::follow_tending_paths_edge(const config::Settings& settings) {
+  massert(State::get() != nullptr, "sanity");
+
+  LOG_DEBUG("Following tending paths edge...");
+  follow_path(settings, program::path::tending_edge, State::get()->z());
+}
+
+void Movement::follow_tending_paths_zigzag(const config::Settings& settings) {
+  massert(State::get() != nullptr, "sanity");
+
+  LOG_DEBUG("Following tending paths zigzag...");
+  follow_path(settings, program::path::tending_zigzag, State::get()->z());
+}
+
+void Movement::move_to_cleaning_station(const config::Settings& settings,
+                                        std::size_t             idx) {
   massert(State::get() != nullptr, "sanity");
 
-  auto* config = Config::get();
   auto* state = State::get();
 
-  motor_profile(config->spraying_speed_profile(state->speed_profile()));
+  const auto& cleaning = settings.mechanisms.cleaning;
 
-  LOG_DEBUG("Following spraying paths...");
-  for (const auto& iter : Config::get()->spraying_path()) {
-    if (state->fault())
-      return;
-    LOG_DEBUG("Move to x={}mm y={}mm", iter.first, iter.second);
-    move<movement::unit::mm>(iter.first, iter.second, 0.0);
+  if (idx >= cleaning.stations.size()) {
+    LOG_ERROR("Cleaning station {} does not exist", idx);
+    return;
   }
 
-  revert_motor_params();
+  LOG_DEBUG("Moving to cleaning station {}...", idx);
+
+  if (!streams_programs(settings)) {
+    const auto& [x, y, time, sonicator] = cleaning.stations[idx];
+
+    motor_profile(cleaning.speed.get(state->speed_profile()));
+    move<movement::unit::mm>(x, y, 0.0);
+    revert_motor_params(settings);
+    return;
+  }
+
+  const auto compiled = cached_program(settings, program::path::cleaning,
+                                       state->speed_profile());
+
+  motor_profile(compiled->speed());
+
+  // stream the compiled segment if the previous station is where we are
+  auto       from = idx;
+  const auto current = current_steps();
+  if (idx > 0 && current[0] == compiled->waypoint(idx - 1)[0] &&
+      current[1] == compiled->waypoint(idx - 1)[1] && current[2] == 0) {
+    from = idx - 1;
+  }
+
+  follow_program(*compiled, from, idx, 0.0);
+
+  revert_motor_params(settings);
 }
 
-void Movement::follow_tending_paths_edge() {
-  massert(Config::get() != nullptr, "sanity");
+/**
+ * Get waypoints and speed profile of configured path
+ *
+ * @param mechanisms  mechanisms config
+ * @param path        configured path
+ * @param stations    storage of cleaning station waypoints
+ *
+ * @return waypoints in mm and speed profile
+ */
+static std::pair<const config::path_container*, const config::SpeedProfile*>
+configured_path(const config::Mechanisms& mechanisms,
+                const program::path&      path,
+                config::path_container&   stations) {
+  switch (path) {
+    case program::path::spraying:
+      return {&mechanisms.spraying.path, &mechanisms.spraying.speed};
+    case program::path::tending_edge:
+      return {&mechanisms.tending.path_edge, &mechanisms.tending.speed};
+    case program::path::tending_zigzag:
+      return {&mechanisms.tending.path_zigzag, &mechanisms.tending.speed};
+    case program::path::cleaning:
+      break;
+  }
+
+  for (const auto& [x, y, time, sonicator] : mechanisms.cleaning.stations) {
+    stations.emplace_back(x, y);
+  }
+
+  return {&stations, &mechanisms.cleaning.speed};
+}
+
+bool Movement::streams_programs(const config::Settings& settings) const {
+  const auto& stepper = settings.devices.stepper;
+
+  return settings.mechanisms.movement.look_ahead &&
+         stepper.backend == device::stepper::backend::bitbang &&
+         stepper.speed != device::stepper::speed::scurve;
+}
+
+void Movement::follow_path(const config::Settings& settings,
+                           const program::path&    path,
+                           Point                   z) {
   massert(State::get() != nullptr, "sanity");
 
-  auto* config = Config::get();
-  auto* state = State::get();
+  const auto speed = State::get()->speed_profile();
 
-  motor_profile(config->tending_speed_profile(state->speed_profile()));
+  if (streams_programs(settings)) {
+    const auto compiled = cached_program(settings, path, speed);
 
-  LOG_DEBUG("Following tending paths edge...");
+    motor_profile(compiled->speed());
+    follow_program(*compiled, 0, compiled->size() - 1, z);
+  } else {
+    config::path_container stations;
+    const auto [waypoints, speed_profile] =
+        configured_path(settings.mechanisms, path, stations);
+
+    motor_profile(speed_profile->get(speed));
+    follow_waypoints(*waypoints, z);
+  }
+
+  revert_motor_params(settings);
+}
 
-  for (const auto& iter : config->tending_path_edge()) {
-    if (state->fault())
+void Movement::follow_waypoints(const config::path_container& waypoints,
+                                Point                         z) {
+  for (const auto& iter : waypoints) {
+    if (interrupted()) {
       return;
+    }
     LOG_DEBUG("Move to x={}mm y={}mm", iter.first, iter.second);
-    move<movement::unit::mm>(iter.first, iter.second, state->z());
+    move<movement::unit::mm>(iter.first, iter.second, z);
   }
+}
+
+std::shared_ptr<const Program> Movement::cached_program(
+    const config::Settings& settings,
+    const program::path&    path,
+    const config::speed&    speed) {
+  const auto& mechanisms = settings.mechanisms;
+
+  std::lock_guard<std::mutex> lock(programs_mutex_);
 
-  revert_motor_params();
+  auto& cached = programs_[static_cast<std::size_t>(path)]
+                          [static_cast<std::size_t>(speed)];
+
+  if (cached != nullptr && cached->revision() == settings.revision) {
+    return cached;
+  }
+
+  config::path_container stations;
+  const auto [waypoints, speed_profile] =
+      configured_path(mechanisms, path, stations);
+
+  // finger goes down at every cleaning station
+  const double junction_deviation =
+      path == program::path::cleaning
+          ? 0.0
+          : mechanisms.movement.junction_deviation;
+
+  cached = Program::create(settings.revision, *waypoints, steps_per_mm(),
+                           junction_deviation, speed_profile->get(speed),
+                           steppers());
+
+  return cached;
 }
 
-void Movement::follow_tending_paths_zigzag() {
+void Movement::compile_programs() {
   massert(Config::get() != nullptr, "sanity");
+
+  const auto settings = Config::get()->snapshot();
+  const auto start = micros();
+
+  if (!streams_programs(*settings)) {
+    LOG_INFO("Paths of config revision {} are followed waypoint by waypoint",
+             settings->revision);
+    return;
+  }
+
+  for (const auto& path :
+       {program::path::spraying, program::path::tending_edge,
+        program::path::tending_zigzag, program::path::cleaning}) {
+    for (const auto& speed :
+         {config::speed::slow, config::speed::normal, config::speed::fast}) {
+      cached_program(*settings, path, speed);
+    }
+  }
+
+  LOG_INFO("Programs of config revision {} are compiled in {} us",
+           settings->revision, micros() - start);
+}
+
+void Movement::follow_program(const Program& program,
+                              std::size_t    from,
+                              std::size_t    to,
+                              Point          z) {
   massert(State::get() != nullptr, "sanity");
 
-  auto* config = Config::get();
   auto* state = State::get();
 
-  motor_profile(config->tending_speed_profile(state->speed_profile()));
+  if (program.empty() || state->fault()) {
+    return;
+  }
+
+  massert(from <= to && to < program.size(), "sanity");
 
-  LOG_DEBUG("Following tending paths zigzag...");
+  const Interpolator::steps current = current_steps();
+  const Interpolator::steps start = {
+      program.waypoint(from)[0], program.waypoint(from)[1],
+      convert_length_to_steps<movement::unit::mm>(z,
+                                                  builder()->steps_per_mm_z())};
+
+  enable_motors();
+
+  const time_unit begin = micros();
+  bool            continuous = false;
 
-  for (const auto& iter : config->tending_path_zigzag()) {
-    if (state->fault())
+  segment_ = 0;
+
+  if (current != start) {
+    // wherever the mechanism is, move to the first waypoint is planned now
+    Planner          planner(steps_per_mm(), 0.0, program.speed(), steppers(),
+                             current);
+    planner::segment segment;
+
+    planner.push(start);
+    planner.finish();
+
+    if (planner.pop(segment) && !follow_segment(segment, continuous)) {
+      disable_motors();
       return;
-    LOG_DEBUG("Move to x={}mm y={}mm", iter.first, iter.second);
-    move<movement::unit::mm>(iter.first, iter.second, state->z());
+    }
+    continuous = true;
+  }
+
+  const auto& segments = program.segments();
+
+  for (std::size_t idx = program.end(from); idx < program.end(to); ++idx) {
+    if (!follow_segment(segments[idx], continuous)) {
+      disable_motors();
+      return;
+    }
+    continuous = true;
+  }
+
+  if (from == 0 && to + 1 == program.size()) {
+    LOG_DEFER_INFO("Path is finished in {} us (planned {} us, naive {} us)",
+                   micros() - begin, program.planned_time(),
+                   program.naive_time());
   }
 
-  revert_motor_params();
+  state->coordinate({program.path()[to].first, program.path()[to].second, z});
+
+  disable_motors();
+}
+
+bool Movement::follow_segment(const planner::segment& segment,
+                              bool                    continuous) {
+  if (interrupted()) {
+    return false;
+  }
+
+  ++segment_;
+  start_planned_move(segment, continuous);
+  while (!ready()) {
+    if (interrupted()) {
+      stop();
+      return false;
+    }
+    next_interpolated();
+  }
+
+  return true;
+}
+
+Interpolator::steps Movement::current_steps() const {
+  massert(State::get() != nullptr, "sanity");
+
+  auto* state = State::get();
+
+  return {convert_length_to_steps<movement::unit::mm>(
+              state->x(), builder()->steps_per_mm_x()),
+          convert_length_to_steps<movement::unit::mm>(
+              state->y(), builder()->steps_per_mm_y()),
+          convert_length_to_steps<movement::unit::mm>(
+              state->z(), builder()->steps_per_mm_z())};
 }
 
 void Movement::motor_profile(
@@ -607,83 +1124,53 @@ void Movement::motor_profile(
   stepper_x()->rpm(speed_profile.x.rpm);
   stepper_x()->acceleration(speed_profile.x.acceleration);
   stepper_x()->deceleration(speed_profile.x.deceleration);
+  stepper_x()->jerk(speed_profile.x.jerk);
 
   stepper_y()->rpm(speed_profile.y.rpm);
   stepper_y()->acceleration(speed_profile.y.acceleration);
   stepper_y()->deceleration(speed_profile.y.deceleration);
+  stepper_y()->jerk(speed_profile.y.jerk);
 
   stepper_z()->rpm(speed_profile.z.rpm);
   stepper_z()->acceleration(speed_profile.z.acceleration);
   stepper_z()->deceleration(speed_profile.z.deceleration);
+  stepper_z()->jerk(speed_profile.z.jerk);
 }
 
-void Movement::revert_motor_params() const {
-  massert(Config::get() != nullptr, "sanity");
+void Movement::revert_motor_params(const config::Settings& settings) const {
   massert(State::get() != nullptr, "sanity");
 
-  auto* config = Config::get();
   auto* state = State::get();
 
   LOG_INFO("Reverting to default motors' parameters (homing)...");
 
-  motor_profile(config->homing_speed_profile(state->speed_profile()));
+  motor_profile(settings.mechanisms.homing.speed.get(state->speed_profile()));
 }
 
-void Movement::move_finger_up() {
-  massert(Config::get() != nullptr, "sanity");
+void Movement::move_finger_up(const config::Settings& settings) {
   massert(State::get() != nullptr, "sanity");
 
-  auto* config = Config::get();
   auto* state = State::get();
 
-  if (state->fault() && !state->manual_mode()) {
+  if (interrupted()) {
     state->homing(false);
     stop();
     return;
   }
 
   // set speed profile
-  motor_profile(config->homing_speed_profile(state->speed_profile()));
+  motor_profile(settings.mechanisms.homing.speed.get(state->speed_profile()));
 
   LOG_DEBUG("Lifting finger...");
 
   enable_motors();
 
-  bool z_completed =
-      limit_switch_z_top()->read().value_or(device::digital::value::low) ==
-      device::digital::value::high;
-  while ((!state->fault() || (state->fault() && state->manual_mode())) &&
-         !z_completed) {
-    if (state->fault() && !state->manual_mode()) {
+  while (!seek_limit_switches(0, 0, -1200, device::digital::value::high)) {
+    if (interrupted()) {
       state->homing(false);
       stop();
       return;
     }
-
-    z_completed =
-        limit_switch_z_top()->read().value_or(device::digital::value::low) ==
-        device::digital::value::high;
-    if (z_completed) {
-      stepper_z()->stop();
-    } else {
-      start_move(0, 0, -1200);
-      while (!ready()) {
-        if (state->fault() && !state->manual_mode()) {
-          state->homing(false);
-          stop();
-          return;
-        }
-
-        if (limit_switch_z_top()->read().value_or(
-                device::digital::value::low) == device::digital::value::high) {
-          stepper_z()->stop();
-          z_completed = true;
-          ready_ = true;
-        } else {
-          next();
-        }
-      }
-    }
   }
 
   disable_motors();
@@ -691,62 +1178,30 @@ void Movement::move_finger_up() {
   state->z(0.0);
 }
 
-void Movement::move_finger_down() {
-  massert(Config::get() != nullptr, "sanity");
+void Movement::move_finger_down(const config::Settings& settings) {
   massert(State::get() != nullptr, "sanity");
 
-  auto* config = Config::get();
   auto* state = State::get();
 
-  if (state->fault() && !state->manual_mode()) {
+  if (interrupted()) {
     state->homing(false);
     stop();
     return;
   }
 
   // set speed profile
-  motor_profile(config->homing_speed_profile(state->speed_profile()));
+  motor_profile(settings.mechanisms.homing.speed.get(state->speed_profile()));
 
   LOG_DEBUG("Lowering finger...");
 
   enable_motors();
 
-  bool z_completed =
-      limit_switch_z_bottom()->read().value_or(device::digital::value::low) ==
-      device::digital::value::high;
-
-  while ((!state->fault() || (state->fault() && state->manual_mode())) &&
-         !z_completed) {
-    if (state->fault() && !state->manual_mode()) {
+  while (!seek_limit_switches(0, 0, 1200, device::digital::value::high)) {
+    if (interrupted()) {
       state->homing(false);
       stop();
       return;
     }
-
-    z_completed =
-        limit_switch_z_bottom()->read().value_or(device::digital::value::low) ==
-        device::digital::value::high;
-    if (z_completed) {
-      stepper_z()->stop();
-    } else {
-      start_move(0, 0, 1200);
-      while (!ready()) {
-        if (state->fault() && !state->manual_mode()) {
-          state->homing(false);
-          stop();
-          return;
-        }
-
-        if (limit_switch_z_bottom()->read().value_or(
-                device::digital::value::low) == device::digital::value::high) {
-          stepper_z()->stop();
-          z_completed = true;
-          ready_ = true;
-        } else {
-          next();
-        }
-      }
-    }
   }
 
   disable_motors();
@@ -754,46 +1209,45 @@ void Movement::move_finger_down() {
   state->z(52.0);
 }
 
-void Movement::rotate_finger() const {
-  massert(Config::get() != nullptr, "sanity");
+void Movement::rotate_finger(const config::Settings& settings) const {
   massert(State::get() != nullptr, "sanity");
 
-  auto* config = Config::get();
   auto* state = State::get();
 
   const auto& speed_profile =
-      config->tending_speed_profile(state->speed_profile());
+      settings.mechanisms.tending.speed.get(state->speed_profile());
   LOG_DEBUG("Rotating finger...");
   if (finger()->duty_cycle(speed_profile.duty_cycle) == ATM_ERR) {
     LOG_DEBUG("Cannot set finger duty cycle...");
   }
 }
 
-void Movement::stop_finger() const {
-  auto* config = Config::get();
+void Movement::stop_finger(const config::Settings& settings) const {
   LOG_DEBUG("Stopping finger...");
   finger()->write(device::digital::value::low);
   finger_brake()->write(device::digital::value::high);
-  sleep_for<time_units::millis>(
-      config->finger_brake<unsigned long>("duration"));
+  sleep_for<time_units::millis>(settings.devices.finger.brake.duration);
   finger_brake()->write(device::digital::value::low);
 }
 
-void Movement::homing_finger() const {
-  massert(Config::get() != nullptr, "sanity");
-
-  auto* config = Config::get();
+void Movement::homing_finger(const config::Settings& settings) const {
+  massert(State::get() != nullptr, "sanity");
 
   const auto& speed_profile =
-      config->homing_speed_profile(State::get()->speed_profile());
+      settings.mechanisms.homing.speed.get(State::get()->speed_profile());
 
   LOG_DEBUG("Starting to homing finger");
   LOG_DEBUG("Setting to homing duty cycle");
   finger()->duty_cycle(speed_profile.duty_cycle);
   sleep_for<time_units::seconds>(2);
   while (true) {
+    if (interrupted()) {
+      LOG_DEBUG("Homing finger is interrupted");
+      stop_finger(settings);
+      return;
+    }
     if (finger_infrared()->read_bool()) {
-      stop_finger();
+      stop_finger(settings);
       break;
     }
     // add delay
@@ -802,133 +1256,88 @@ void Movement::homing_finger() const {
   LOG_DEBUG("Homing finger is finished");
 }
 
-void Movement::homing() {
-  massert(Config::get() != nullptr, "sanity");
+void Movement::homing(const config::Settings& settings) {
   massert(State::get() != nullptr, "sanity");
 
-  auto* config = Config::get();
   auto* state = State::get();
 
+  const auto& homing_config = settings.mechanisms.homing;
+  const auto& speed_profile = homing_config.speed.get(state->speed_profile());
+
   LOG_DEBUG("Homing is started...");
 
+  const time_unit start = millis();
+
   state->homing(true);
 
-  if (state->fault() && !state->manual_mode()) {
+  if (interrupted()) {
     state->homing(false);
     stop();
     return;
   }
 
   // set speed profile
-  motor_profile(config->homing_speed_profile(state->speed_profile()));
+  motor_profile(speed_profile);
 
   // homing z
-  move_finger_up();
+  move_finger_up(settings);
 
   // enabling motor
   enable_motors();
 
-  // homing y
-  bool is_y_completed =
-      limit_switch_y()->read().value_or(device::digital::value::low) ==
-      device::digital::value::high;
-
-  while ((!state->fault() || (state->fault() && state->manual_mode())) &&
-         !is_y_completed) {
-    if (state->fault() && !state->manual_mode()) {
+  // homing x and y at once, fast seek until both limit switches are hit
+  while (!seek_limit_switches(convert_length_to_steps<movement::unit::mm>(
+                                  -1500.0, builder()->steps_per_mm_x()),
+                              convert_length_to_steps<movement::unit::mm>(
+                                  -1200.0, builder()->steps_per_mm_y()),
+                              0, device::digital::value::high)) {
+    if (interrupted()) {
       state->homing(false);
       stop();
       return;
     }
-
-    long steps_y = 0;
-
-    if (limit_switch_y()->read().value_or(device::digital::value::low) ==
-        device::digital::value::high) {
-      is_y_completed = true;
-      stepper_y()->stop();
-    } else {
-      steps_y = convert_length_to_steps<movement::unit::mm>(
-          -1200.0, builder()->steps_per_mm_y());
-    }
-
-    start_move(0, steps_y, 0);
-    while (!ready()) {
-      if (state->fault() && !state->manual_mode()) {
-        state->homing(false);
-        stop();
-        return;
-      }
-
-      bool y_complete =
-          limit_switch_y()->read().value_or(device::digital::value::low) ==
-          device::digital::value::high;
-      if (y_complete) {
-        is_y_completed = true;
-        stepper_y()->stop();
-      }
-      if (y_complete) {
-        ready_ = true;
-      } else {
-        next();
-      }
-    }
   }
 
-  if (state->fault() && !state->manual_mode()) {
-    state->homing(false);
-    stop();
-    return;
-  }
-
-  // homing x
-  bool is_x_completed =
-      limit_switch_x()->read().value_or(device::digital::value::low) ==
-      device::digital::value::high;
-
-  while ((!state->fault() || (state->fault() && state->manual_mode())) &&
-         !is_x_completed) {
-    if (state->fault() && !state->manual_mode()) {
+  // back off the limit switches
+  const double backoff = homing_config.backoff;
+
+  start_independent_move(
+      convert_length_to_steps<movement::unit::mm>(backoff,
+                                                  builder()->steps_per_mm_x()),
+      convert_length_to_steps<movement::unit::mm>(backoff,
+                                                  builder()->steps_per_mm_y()),
+      0);
+  while (!ready()) {
+    if (interrupted()) {
       state->homing(false);
       stop();
       return;
     }
 
-    long steps_x = 0;
-
-    if (limit_switch_x()->read().value_or(device::digital::value::low) ==
-        device::digital::value::high) {
-      is_x_completed = true;
-      stepper_x()->stop();
-    } else {
-      steps_x = convert_length_to_steps<movement::unit::mm>(
-          -1500.0, builder()->steps_per_mm_x());
-    }
-
-    start_move(steps_x, 0, 0);
-    while (!ready()) {
-      if (state->fault() && !state->manual_mode()) {
-        state->homing(false);
-        stop();
-        return;
-      }
+    next_independent();
+  }
 
-      bool x_complete =
-          limit_switch_x()->read().value_or(device::digital::value::low) ==
-          device::digital::value::high;
-      if (x_complete) {
-        is_x_completed = true;
-        stepper_x()->stop();
-      }
-      if (x_complete) {
-        ready_ = true;
-      } else {
-        next();
-      }
+  // re-approach slowly, the limit switches are hit at the same speed
+  auto approach_speed = speed_profile;
+  approach_speed.x.rpm *= homing_config.approach_ratio;
+  approach_speed.y.rpm *= homing_config.approach_ratio;
+  motor_profile(approach_speed);
+
+  while (!seek_limit_switches(convert_length_to_steps<movement::unit::mm>(
+                                  -2.0 * backoff, builder()->steps_per_mm_x()),
+                              convert_length_to_steps<movement::unit::mm>(
+                                  -2.0 * backoff, builder()->steps_per_mm_y()),
+                              0, device::digital::value::high)) {
+    if (interrupted()) {
+      state->homing(false);
+      stop();
+      return;
     }
   }
 
-  if (state->fault() && !state->manual_mode()) {
+  motor_profile(speed_profile);
+
+  if (interrupted()) {
     state->homing(false);
     stop();
     return;
@@ -937,7 +1346,7 @@ void Movement::homing() {
   // set state to 0,0,0
   state->reset_coordinate();
 
-  if (state->fault() && !state->manual_mode()) {
+  if (interrupted()) {
     state->homing(false);
     stop();
     return;
@@ -946,7 +1355,7 @@ void Movement::homing() {
   // move a bit (5mm for each axis)
   move<movement::unit::mm>(5.0, 5.0, 5.0);
 
-  if (state->fault() && !state->manual_mode()) {
+  if (interrupted()) {
     state->homing(false);
     stop();
     return;
@@ -955,7 +1364,7 @@ void Movement::homing() {
   // set state to 0,0,0
   state->reset_coordinate();
 
-  if (state->fault() && !state->manual_mode()) {
+  if (interrupted()) {
     state->homing(false);
     stop();
     return;
@@ -964,9 +1373,128 @@ void Movement::homing() {
   // disabling motor
   disable_motors();
 
+  state->homing_duration(millis() - start);
   state->homing(false);
 
-  LOG_DEBUG("Homing is finished...");
+  LOG_INFO("Homing is finished in {} ms...", state->homing_duration());
+}
+
+bool Movement::seek_limit_switches(long                   x,
+                                   long                   y,
+                                   long                   z,
+                                   device::digital::value value) {
+  massert(device::InputAlert::get() != nullptr, "sanity");
+
+  auto* input_alert = device::InputAlert::get();
+
+  const std::array<std::shared_ptr<device::StepperDevice>, interpolator::axes>
+      steppers = {stepper_x(), stepper_y(), stepper_z()};
+  const std::array<std::shared_ptr<device::DigitalInputDevice>,
+                   interpolator::axes>
+      limit_switches = {
+          limit_switch_x(), limit_switch_y(),
+          (z < 0) ? limit_switch_z_top() : limit_switch_z_bottom()};
+
+  std::array<long, interpolator::axes>              steps = {x, y, z};
+  std::array<std::atomic<bool>, interpolator::axes> completed;
+  std::array<device::alert::subscription, interpolator::axes> subscriptions{};
+
+  const auto reached =
+      [value](const std::shared_ptr<device::DigitalInputDevice>& device) {
+        return device->read().value_or(device::digital::value::low) == value;
+      };
+
+  bool is_completed = true;
+  for (std::size_t axis = 0; axis < interpolator::axes; ++axis) {
+    completed[axis] = (steps[axis] == 0) || reached(limit_switches[axis]);
+    if (completed[axis]) {
+      steps[axis] = 0;
+    }
+    is_completed = is_completed && completed[axis];
+  }
+
+  if (is_completed) {
+    return true;
+  }
+
+  start_independent_move(steps[0], steps[1], steps[2]);
+
+  // each axis is halted straight from the alert of its own limit switch, the
+  // other ones keep moving
+  const auto edge = (value == device::digital::value::high)
+                        ? device::alert::edge::rising
+                        : device::alert::edge::falling;
+
+  for (std::size_t axis = 0; axis < interpolator::axes; ++axis) {
+    if (steps[axis] == 0) {
+      continue;
+    }
+
+    subscriptions[axis] = input_alert->subscribe(
+        limit_switches[axis], edge,
+        [&steppers, &completed, axis](const device::alert::event&) {
+          steppers[axis]->halt();
+          completed[axis].store(true, std::memory_order_release);
+        });
+
+    // edge might have come before the subscription
+    if (reached(limit_switches[axis])) {
+      steppers[axis]->halt();
+      completed[axis] = true;
+    }
+  }
+
+  // limit switches that cannot be watched are read at once
+  device::DigitalInputBank polled;
+  bool                     polling = false;
+  for (std::size_t axis = 0; axis < interpolator::axes; ++axis) {
+    if (steps[axis] != 0 && subscriptions[axis] == 0) {
+      polled.add(limit_switches[axis]);
+      polling = true;
+    }
+  }
+
+  bool interrupt = false;
+  while (!ready()) {
+    if (interrupted()) {
+      interrupt = true;
+      break;
+    }
+
+    // fall back to polling if the pin cannot be watched
+    if (polling) {
+      const auto levels = polled.read();
+
+      for (std::size_t axis = 0; axis < interpolator::axes; ++axis) {
+        if (steps[axis] != 0 && subscriptions[axis] == 0 && !completed[axis] &&
+            levels.high(limit_switches[axis]) ==
+                (value == device::digital::value::high)) {
+          steppers[axis]->halt();
+          completed[axis] = true;
+        }
+      }
+    }
+
+    next_independent();
+  }
+
+  for (const auto& subscription : subscriptions) {
+    if (subscription != 0) {
+      input_alert->unsubscribe(subscription);
+    }
+  }
+
+  if (interrupt) {
+    stop();
+    return false;
+  }
+
+  is_completed = true;
+  for (const auto& axis : completed) {
+    is_completed = is_completed && axis.load(std::memory_order_acquire);
+  }
+
+  return is_completed;
 }
 
 void Movement::enable_motors() const {
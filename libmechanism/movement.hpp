@@ -7,16 +7,27 @@
  * Movement mechanism
  */
 
+#include <array>
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <string>
 
+#include <libutil/util.hpp>
+
 #include <libcore/core.hpp>
 #include <libdevice/device.hpp>
 
+#include "interpolator.hpp"
+#include "planner.hpp"
+#include "position.hpp"
+#include "program.hpp"
+
 NAMESPACE_BEGIN
 
 namespace mechanism {
 // forward declaration
+// movement::mode is defined in libcore/config.hpp
 namespace movement {
 enum class unit;
 }
@@ -27,6 +38,46 @@ class Movement;
 
 namespace movement {
 enum class unit { cm, mm };
+
+/** Min period between two published motion snapshots (us) */
+constexpr time_unit snapshot_period = 10000;
+
+/**
+ * @brief Motion state of single axis.
+ */
+struct axis_snapshot {
+  /** absolute steps */
+  device::stepper::step steps;
+  /** position in mm */
+  Point position;
+  /** velocity in mm/s */
+  double velocity;
+  /** axis has been stepping since previous snapshot */
+  bool moving;
+};
+
+/**
+ * @brief Motion snapshot.
+ *
+ * Published by the motion thread at most once per movement::snapshot_period
+ * (and at the end of every move), every field is read at once
+ */
+struct snapshot {
+  /** number of the snapshot, increases on every publish */
+  uint64_t version;
+  /** time stamp of the snapshot (us) */
+  time_unit time;
+  /** x, y, and z axis */
+  std::array<axis_snapshot, interpolator::axes> axes;
+  /** index of running segment of current path, 0 outside paths */
+  std::size_t segment;
+  /** progress of running move */
+  float progress;
+  /** ready to start new move */
+  bool ready;
+  /** brake has been requested */
+  bool braking;
+};
 }  // namespace movement
 
 using MovementBuilder = StaticObj<impl::MovementBuilderImpl>;
@@ -349,8 +400,73 @@ class Movement : public StackObj {
   device::stepper::step stop_z(void);
   /**
    * Stop all steppers
+   *
+   * DMA output is cut as well, so the position of a stepper that streams
+   * pulses through device::Wave is not reliable until it is homed again
    */
   void stop(void);
+  /**
+   * Request running move to be aborted
+   *
+   * Safe to call from any thread, every move returns early until the request
+   * is cleared
+   */
+  inline void abort() { abort_.store(true, std::memory_order_release); }
+  /**
+   * Clear abort request
+   */
+  inline void clear_abort() { abort_.store(false, std::memory_order_release); }
+  /**
+   * Check whether abort has been requested or not
+   *
+   * @return abort is requested or not
+   */
+  inline bool aborted() const { return abort_.load(std::memory_order_acquire); }
+  /**
+   * Request running move to decelerate to a stop
+   *
+   * Safe to call from any thread. Unlike abort(), steppers follow their
+   * deceleration ramp, then every move returns early until the request is
+   * cleared
+   */
+  inline void brake() { brake_.store(true, std::memory_order_release); }
+  /**
+   * Clear brake request
+   */
+  inline void clear_brake() { brake_.store(false, std::memory_order_release); }
+  /**
+   * Check whether brake has been requested or not
+   *
+   * @return brake is requested or not
+   */
+  inline bool braking() const { return brake_.load(std::memory_order_acquire); }
+  /**
+   * Request running move to be halted by a fault input
+   *
+   * Safe to call from any thread, input alerts call it as soon as the edge is
+   * seen. Every move returns early until the fault listener has latched the
+   * fault and clears the request
+   */
+  inline void halt() { halt_.store(true, std::memory_order_release); }
+  /**
+   * Clear halt request
+   */
+  inline void clear_halt() { halt_.store(false, std::memory_order_release); }
+  /**
+   * Check whether halt has been requested or not
+   *
+   * @return halt is requested or not
+   */
+  inline bool halted() const { return halt_.load(std::memory_order_acquire); }
+  /**
+   * Check whether running move must be stopped or not
+   *
+   * Move is stopped on abort or halt request, on fault (except in manual
+   * mode), or once it has come to rest after brake request
+   *
+   * @return interrupted or not
+   */
+  bool interrupted() const;
   /**
    * Check if movement mechanism is active or not
    *
@@ -367,12 +483,19 @@ class Movement : public StackObj {
   inline const bool& ready() const { return ready_; }
   /**
    * Homing all stepper
+   *
+   * Z-axis is lifted first, then x-axis and y-axis are homed at once with
+   * fast seek, backoff, and slow re-approach
+   *
+   * @param settings configuration snapshot of the job
    */
-  void homing();
+  void homing(const config::Settings& settings);
   /**
    * Homing finger
+   *
+   * @param settings configuration snapshot of the job
    */
-  void homing_finger() const;
+  void homing_finger(const config::Settings& settings) const;
   /**
    * Check is home or not
    *
@@ -381,40 +504,89 @@ class Movement : public StackObj {
   bool is_home() const;
   /**
    * Rotate finger
+   *
+   * @param settings configuration snapshot of the job
    */
-  void rotate_finger() const;
+  void rotate_finger(const config::Settings& settings) const;
   /**
    * Stop finger
+   *
+   * @param settings configuration snapshot of the job
    */
-  void stop_finger() const;
+  void stop_finger(const config::Settings& settings) const;
   /**
    * Move finger down
+   *
+   * @param settings configuration snapshot of the job
    */
-  void move_finger_down();
+  void move_finger_down(const config::Settings& settings);
   /**
    * Move finger up
+   *
+   * @param settings configuration snapshot of the job
    */
-  void move_finger_up();
+  void move_finger_up(const config::Settings& settings);
   /**
    * Move to position zero spraying
+   *
+   * @param settings configuration snapshot of the job
    */
-  void move_to_spraying_position();
+  void move_to_spraying_position(const config::Settings& settings);
   /**
    * Move to position zero tending
+   *
+   * @param settings configuration snapshot of the job
    */
-  void move_to_tending_position();
+  void move_to_tending_position(const config::Settings& settings);
   /**
    * Move according to spraying paths
+   *
+   * @param settings configuration snapshot of the job
    */
-  void follow_spraying_paths();
+  void follow_spraying_paths(const config::Settings& settings);
   /**
    * Move according to edge tending paths
+   *
+   * @param settings configuration snapshot of the job
    */
-  void follow_tending_paths_edge();
+  void follow_tending_paths_edge(const config::Settings& settings);
   /**
    * Move according to zigzag tending paths
+   *
+   * @param settings configuration snapshot of the job
+   */
+  void follow_tending_paths_zigzag(const config::Settings& settings);
+  /**
+   * Move to cleaning station
+   *
+   * Compiled segment is streamed if the mechanism is at the previous station
+   *
+   * @param settings configuration snapshot of the job
+   * @param idx      index of cleaning station
+   */
+  void move_to_cleaning_station(const config::Settings& settings,
+                                std::size_t             idx);
+  /**
+   * Get compiled program of configured path
+   *
+   * Programs are cached per path and speed profile, and compiled again once
+   * the config revision changes
+   *
+   * @param settings  config snapshot of the path
+   * @param path      configured path
+   * @param speed     speed profile
+   *
+   * @return compiled program
+   */
+  std::shared_ptr<const Program> cached_program(
+      const config::Settings& settings,
+      const program::path&    path,
+      const config::speed&    speed);
+  /**
+   * Compile program of every configured path and speed profile of the active
+   * config revision
    */
-  void follow_tending_paths_zigzag();
+  void compile_programs();
   /**
    * Enable all motors
    */
@@ -429,6 +601,60 @@ class Movement : public StackObj {
    * @param speed_profile speed profile configuration
    **/
   void motor_profile(const config::MechanismSpeed& speed_profile) const;
+  /**
+   * Set movement mode
+   *
+   * Must not be changed while moving
+   *
+   * @param mode movement mode to set
+   */
+  void mode(const movement::mode& mode);
+  /**
+   * Get movement mode
+   *
+   * @return current movement mode
+   */
+  inline const movement::mode& mode() const { return mode_; }
+  /**
+   * Get step jitter of x-axis stepper
+   *
+   * @return step jitter recorder
+   */
+  inline const device::StepJitter& jitter_x() const {
+    return stepper_x()->jitter();
+  }
+  /**
+   * Get step jitter of y-axis stepper
+   *
+   * @return step jitter recorder
+   */
+  inline const device::StepJitter& jitter_y() const {
+    return stepper_y()->jitter();
+  }
+  /**
+   * Get step jitter of z-axis stepper
+   *
+   * @return step jitter recorder
+   */
+  inline const device::StepJitter& jitter_z() const {
+    return stepper_z()->jitter();
+  }
+  /**
+   * Reset step jitter of every stepper
+   */
+  void reset_jitter() const;
+  /**
+   * Dump step jitter of every stepper to the log
+   */
+  void log_jitter() const;
+  /**
+   * Get last motion snapshot
+   *
+   * Never blocks the motion thread, safe to call from any thread
+   *
+   * @return motion snapshot
+   */
+  inline movement::snapshot snapshot() const { return snapshot_.load(); }
 
  private:
   /**
@@ -580,6 +806,16 @@ class Movement : public StackObj {
    * @param z  length of z-axis
    */
   void start_move(const long& x, const long& y, const long& z);
+  /**
+   * Setup independent move action for steppers regardless of the mode
+   *
+   * Every stepper runs its own speed profile
+   *
+   * @param x  steps of x-axis
+   * @param y  steps of y-axis
+   * @param z  steps of z-axis
+   */
+  void start_independent_move(const long& x, const long& y, const long& z);
   /**
    * Yield move for each step
    *
@@ -588,6 +824,162 @@ class Movement : public StackObj {
    * @return time until next change is needed
    */
   time_unit next();
+  /**
+   * Yield independent move for each step
+   *
+   * @return time until next change is needed
+   */
+  time_unit next_independent();
+  /**
+   * Move axes at once until their limit switches have given value
+   *
+   * Each axis is halted from the input alert of its own limit switch, the
+   * other ones keep moving. Z-axis uses top limit switch when moving up
+   * (negative steps), otherwise bottom limit switch
+   *
+   * @param x      steps of x-axis, 0 keeps x-axis still
+   * @param y      steps of y-axis, 0 keeps y-axis still
+   * @param z      steps of z-axis, 0 keeps z-axis still
+   * @param value  limit switch value that stops the axis
+   *
+   * @return true if every limit switch of moving axes has the value
+   */
+  bool seek_limit_switches(long                   x,
+                           long                   y,
+                           long                   z,
+                           device::digital::value value);
+  /**
+   * Setup interpolated move action for steppers
+   *
+   * @param x  steps of x-axis
+   * @param y  steps of y-axis
+   * @param z  steps of z-axis
+   */
+  void start_interpolated_move(const long& x, const long& y, const long& z);
+  /**
+   * Setup planned segment move action for steppers
+   *
+   * @param segment     planned segment
+   * @param continuous  continue from the previous segment without stopping
+   */
+  void start_planned_move(const planner::segment& segment, bool continuous);
+  /**
+   * Write direction of every stepper
+   *
+   * DIR pin is sampled on rising STEP edge, so it must be set before any pulse
+   *
+   * @param x  steps of x-axis
+   * @param y  steps of y-axis
+   * @param z  steps of z-axis
+   */
+  void write_direction(const long& x, const long& y, const long& z) const;
+  /**
+   * Begin new move on step jitter of every stepper
+   *
+   * Used by interpolated moves that pulse STEP pins by themselves
+   */
+  void start_jitter() const;
+  /**
+   * Publish motion snapshot
+   *
+   * Does nothing if the previous one is younger than
+   * movement::snapshot_period, unless forced
+   *
+   * @param now    current time stamp (us)
+   * @param force  publish regardless of the period
+   */
+  void publish_snapshot(time_unit now, bool force);
+  /**
+   * Start deceleration of running move
+   *
+   * Called for each step while brake is requested, does nothing once the
+   * move is decelerating
+   */
+  void start_brake();
+  /**
+   * Check whether configured paths can be streamed as compiled programs
+   *
+   * Compiled segments are pulsed by the interpolator with bit-banged steps
+   * and trapezoid ramps. Without look-ahead, with wave backend, or with
+   * S-curve speed, paths are followed waypoint by waypoint with move()
+   *
+   * @param settings config snapshot of the path
+   *
+   * @return true if compiled programs are used
+   */
+  bool streams_programs(const config::Settings& settings) const;
+  /**
+   * Follow configured path
+   *
+   * @param settings  config snapshot of the path
+   * @param path      configured path, anything but cleaning
+   * @param z         z-axis coordinate during the path
+   */
+  void follow_path(const config::Settings& settings,
+                   const program::path&    path,
+                   Point                   z);
+  /**
+   * Follow waypoints one by one with move(), stop at every waypoint
+   *
+   * @param waypoints  waypoints in mm
+   * @param z          z-axis coordinate during the path
+   */
+  void follow_waypoints(const config::path_container& waypoints, Point z);
+  /**
+   * Follow compiled program as one continuous motion
+   *
+   * Move to waypoint `from` is planned on the fly if the mechanism is not
+   * there, then segments up to waypoint `to` are streamed
+   *
+   * @param program  compiled program
+   * @param from     index of first waypoint
+   * @param to       index of last waypoint
+   * @param z        z-axis coordinate during the program
+   */
+  void follow_program(const Program& program,
+                      std::size_t    from,
+                      std::size_t    to,
+                      Point          z);
+  /**
+   * Execute planned segment
+   *
+   * @param segment     planned segment
+   * @param continuous  segment follows the previous one without a gap
+   *
+   * @return false if the move is interrupted
+   */
+  bool follow_segment(const planner::segment& segment, bool continuous);
+  /**
+   * Get current coordinate from State in absolute steps
+   *
+   * @return current position
+   */
+  Interpolator::steps current_steps() const;
+  /**
+   * Get conversion of mm to steps for each axis
+   *
+   * @return steps per mm
+   */
+  inline Interpolator::steps steps_per_mm() const {
+    return {builder()->steps_per_mm_x(), builder()->steps_per_mm_y(),
+            builder()->steps_per_mm_z()};
+  }
+  /**
+   * Get stepper of each axis
+   *
+   * @return steppers
+   */
+  inline Interpolator::steppers steppers() const {
+    return {stepper_x().get(), stepper_y().get(), stepper_z().get()};
+  }
+  /**
+   * Yield interpolated move for each master step
+   *
+   * Every stepper that is due in this master step is pulsed at once
+   *
+   * @return time until next change is needed
+   */
+  time_unit next_interpolated();
   /**
    * Get event timers of x-axis stepper
    *
@@ -621,27 +1013,31 @@ class Movement : public StackObj {
     return next_move_interval_;
   }
   /**
-   * Update position of x
-   */
-  void update_x() const;
-  /**
-   * Update position of y
-   */
-  void update_y() const;
-  /**
-   * Update position of z
+   * Update position after pulsing steppers
+   *
+   * Never locks, only the step counters are updated
+   *
+   * @param steps_x  step count of x-axis stepper before pulsing
+   * @param steps_y  step count of y-axis stepper before pulsing
+   * @param steps_z  step count of z-axis stepper before pulsing
    */
-  void update_z() const;
+  void update_position(const device::stepper::step& steps_x,
+                       const device::stepper::step& steps_y,
+                       const device::stepper::step& steps_z);
   /**
-   * Update position
+   * Update position from interpolator step
+   *
+   * @param mask bit mask of axes that have been pulsed
    */
-  void update_position() const;
+  void update_interpolated_position(unsigned int mask);
   /**
    * Reverting motor params
    *
    * Reverting to homing speed profile
+   *
+   * @param settings configuration snapshot of the job
    */
-  void revert_motor_params() const;
+  void revert_motor_params(const config::Settings& settings) const;
 
  private:
   /**
@@ -668,12 +1064,62 @@ class Movement : public StackObj {
    * When next state change is due for each motor
    */
   time_unit last_move_end_;
+  /**
+   * Movement mode
+   */
+  movement::mode mode_;
+  /**
+   * Interpolator for interpolated mode
+   */
+  Interpolator interpolator_;
+  /**
+   * Abort request from other threads
+   */
+  std::atomic<bool> abort_;
+  /**
+   * Brake request from other threads
+   */
+  std::atomic<bool> brake_;
+  /**
+   * Halt request from fault inputs
+   */
+  std::atomic<bool> halt_;
+  /**
+   * Running move has been braked before reaching its target
+   */
+  bool braked_;
+  /**
+   * Index of running segment of current path
+   */
+  std::size_t segment_;
+  /**
+   * Last published snapshot, owned by the motion thread
+   */
+  movement::snapshot last_snapshot_;
+  /**
+   * Published snapshot
+   */
+  util::SeqLock<movement::snapshot> snapshot_;
+  /**
+   * Compiled program of each path and speed profile
+   */
+  std::array<std::array<std::shared_ptr<const Program>, program::speeds>,
+             program::paths>
+      programs_;
+  /**
+   * Guard compiled programs
+   */
+  std::mutex programs_mutex_;
 
  private:
   /**
    * Instance of impl::MovementBuilderImpl to reduce verbosity
    */
   const impl::MovementBuilderImpl* builder_;
+  /**
+   * Step counter of each axis, source of State coordinate
+   */
+  StepPosition position_;
   /**
    * Check wether movement mechanism is usable or not
    */
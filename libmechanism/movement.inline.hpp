@@ -12,16 +12,17 @@ template <movement::unit Unit>
 long Movement::convert_length_to_steps(
     double                       length,
     const device::stepper::step& steps_per_mm) {
+  // round the steps, not the length, so sub-millimetre lengths are kept
   if (Unit == movement::unit::cm) {
-    return static_cast<long>(std::lround(length) * steps_per_mm * 10);
+    return std::lround(length * 10 * static_cast<double>(steps_per_mm));
   } else {
-    return static_cast<long>(std::lround(length) * steps_per_mm);
+    return std::lround(length * static_cast<double>(steps_per_mm));
   }
 }
 
 template <movement::unit Unit>
 void Movement::move(Point x, Point y, Point z) {
-  if (ready()) {
+  if (ready() && !interrupted()) {
     // enabling motor
     enable_motors();
 
@@ -31,9 +32,9 @@ void Movement::move(Point x, Point y, Point z) {
     auto current_y = state->y();
     auto current_z = state->z();
 
-    LOG_DEBUG("Current X {}, Next X {}", current_x, x);
-    LOG_DEBUG("Current Y {}, Next Y {}", current_y, y);
-    LOG_DEBUG("Current Z {}, Next Z {}", current_z, z);
+    LOG_DEFER_DEBUG("Current X {}, Next X {}", current_x, x);
+    LOG_DEFER_DEBUG("Current Y {}, Next Y {}", current_y, y);
+    LOG_DEFER_DEBUG("Current Z {}, Next Z {}", current_z, z);
 
     long steps_x;
     long steps_y;
@@ -53,18 +54,26 @@ void Movement::move(Point x, Point y, Point z) {
                                               builder()->steps_per_mm_z());
     }
 
-    LOG_INFO("Starting to move steps_x={}, steps_y={}, steps_z={}...", steps_x,
-             steps_y, steps_z);
+    LOG_DEFER_INFO("Starting to move steps_x={}, steps_y={}, steps_z={}...",
+                   steps_x, steps_y, steps_z);
     start_move(steps_x, steps_y, steps_z);  // will trigger ready to false
     while (!ready()) {
-      if (state->fault() && !state->manual_mode()) {
+      if (interrupted()) {
         stop();
         return;
       } else {
         next();
       }
     }
-    LOG_INFO("Move is finished");
+
+    if (braked_) {
+      // position has been tracked step by step, target is not reached
+      LOG_DEFER_INFO("Move is braked");
+      disable_motors();
+      return;
+    }
+
+    LOG_DEFER_INFO("Move is finished");
 
     if (state->manual_mode()) {
       state->coordinate({x + current_x, y + current_y, z + current_z});
@@ -0,0 +1,301 @@
+#include "mechanism.hpp"
+
+#include "planner.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+NAMESPACE_BEGIN
+
+namespace mechanism {
+/**
+ * Get time needed to move with trapezoid profile
+ *
+ * @param length        length of the move
+ * @param speed         cruise speed
+ * @param acceleration  acceleration
+ * @param deceleration  deceleration
+ * @param entry         speed when entering the move
+ * @param exit          speed when leaving the move
+ *
+ * @return time in seconds
+ */
+static double trapezoid_time(double length,
+                             double speed,
+                             double acceleration,
+                             double deceleration,
+                             double entry,
+                             double exit) {
+  const double accel_length =
+      (speed * speed - entry * entry) / (2 * acceleration);
+  const double decel_length =
+      (speed * speed - exit * exit) / (2 * deceleration);
+
+  if (accel_length + decel_length <= length) {
+    return (speed - entry) / acceleration + (speed - exit) / deceleration +
+           (length - accel_length - decel_length) / speed;
+  }
+
+  // cannot reach cruise speed
+  const double peak = std::sqrt(
+      (2 * acceleration * deceleration * length +
+       deceleration * entry * entry + acceleration * exit * exit) /
+      (acceleration + deceleration));
+
+  return (peak - entry) / acceleration + (peak - exit) / deceleration;
+}
+
+/**
+ * Get limit of given direction, none of the axes can exceed its own limit
+ *
+ * @param unit        unit direction
+ * @param axis_limit  limit of each axis
+ *
+ * @return limit along the direction
+ */
+static double limit(const planner::vector& unit,
+                    const planner::vector& axis_limit) {
+  double retval = std::numeric_limits<double>::max();
+  for (std::size_t axis = 0; axis < interpolator::axes; ++axis) {
+    if (unit[axis] != 0.0) {
+      retval = std::min(retval, axis_limit[axis] / std::abs(unit[axis]));
+    }
+  }
+  return retval;
+}
+
+/**
+ * Get max speed at the junction of two segments
+ *
+ * @param prev                unit direction of previous segment
+ * @param next                unit direction of next segment
+ * @param max_acceleration    max acceleration of each axis
+ * @param junction_deviation  max deviation from sharp corner
+ *
+ * @return max junction speed
+ */
+static double junction_speed(const planner::vector& prev,
+                             const planner::vector& next,
+                             const planner::vector& max_acceleration,
+                             double                 junction_deviation) {
+  // angle between the reversed previous direction and the next direction
+  double cos_theta = 0.0;
+  for (std::size_t axis = 0; axis < interpolator::axes; ++axis) {
+    cos_theta -= prev[axis] * next[axis];
+  }
+
+  if (cos_theta > 0.999999) {
+    // reversal, must stop
+    return 0.0;
+  }
+
+  if (cos_theta < -0.999999) {
+    // straight line, no speed change needed
+    return std::numeric_limits<double>::max();
+  }
+
+  // acceleration along the junction, every axis has its own limit
+  planner::vector junction_unit;
+  double          norm = 0.0;
+  for (std::size_t axis = 0; axis < interpolator::axes; ++axis) {
+    junction_unit[axis] = next[axis] - prev[axis];
+    norm += junction_unit[axis] * junction_unit[axis];
+  }
+  norm = std::sqrt(norm);
+  for (std::size_t axis = 0; axis < interpolator::axes; ++axis) {
+    junction_unit[axis] /= norm;
+  }
+
+  const double acceleration = limit(junction_unit, max_acceleration);
+  const double sin_theta_d2 = std::sqrt(0.5 * (1.0 - cos_theta));
+
+  return std::sqrt(acceleration * junction_deviation * sin_theta_d2 /
+                   (1.0 - sin_theta_d2));
+}
+
+Planner::Planner(const Interpolator::steps&    steps_per_mm,
+                 double                        junction_deviation,
+                 const config::MechanismSpeed& speed,
+                 const Interpolator::steppers& steppers,
+                 const Interpolator::steps&    start)
+    : steps_per_mm_{steps_per_mm},
+      junction_deviation_{junction_deviation},
+      waypoint_{start} {
+  const std::array<const config::Speed*, interpolator::axes> axis_speed = {
+      &speed.x, &speed.y, &speed.z};
+
+  for (std::size_t axis = 0; axis < interpolator::axes; ++axis) {
+    // full steps to mm
+    const double to_mm = static_cast<double>(steppers[axis]->microsteps()) /
+                         static_cast<double>(steps_per_mm_[axis]);
+
+    max_speed_[axis] = axis_speed[axis]->rpm *
+                       static_cast<double>(steppers[axis]->motor_steps()) *
+                       to_mm / 60.0;
+    max_acceleration_[axis] = axis_speed[axis]->acceleration * to_mm;
+    max_deceleration_[axis] = axis_speed[axis]->deceleration * to_mm;
+  }
+
+  unit_.fill(0.0);
+  has_unit_ = false;
+  head_ = 0;
+  tail_ = 0;
+  finished_ = false;
+  cancelled_ = false;
+  planned_time_ = 0.0;
+  naive_time_ = 0.0;
+}
+
+bool Planner::push(const Interpolator::steps& waypoint) {
+  Interpolator::steps delta;
+  planner::vector     unit;
+  double              length = 0.0;
+
+  for (std::size_t axis = 0; axis < interpolator::axes; ++axis) {
+    delta[axis] = waypoint[axis] - waypoint_[axis];
+    unit[axis] = static_cast<double>(delta[axis]) /
+                 static_cast<double>(steps_per_mm_[axis]);
+    length += unit[axis] * unit[axis];
+  }
+
+  if (length == 0.0) {
+    // duplicated waypoint
+    return true;
+  }
+
+  length = std::sqrt(length);
+
+  for (std::size_t axis = 0; axis < interpolator::axes; ++axis) {
+    unit[axis] /= length;
+  }
+
+  // every axis runs its own profile from a standstill, the slowest wins
+  double naive_time = 0.0;
+  for (std::size_t axis = 0; axis < interpolator::axes; ++axis) {
+    if (delta[axis] != 0) {
+      naive_time = std::max(
+          naive_time,
+          trapezoid_time(std::abs(unit[axis]) * length, max_speed_[axis],
+                         max_acceleration_[axis], max_deceleration_[axis], 0.0,
+                         0.0));
+    }
+  }
+
+  const double speed = limit(unit, max_speed_);
+
+  massert(!full(), "pop before pushing into a full buffer");
+
+  if (cancelled_ || full()) {
+    return false;
+  }
+
+  // previous segment that has been popped already exits at a standstill
+  double max_entry = 0.0;
+  if (has_unit_ && head_ != tail_) {
+    max_entry = std::min(
+        std::min(block(tail_ - 1).speed, speed),
+        junction_speed(unit_, unit, max_acceleration_, junction_deviation_));
+  }
+
+  block(tail_) = {delta,
+                  unit,
+                  length,
+                  speed,
+                  limit(unit, max_acceleration_),
+                  limit(unit, max_deceleration_),
+                  max_entry,
+                  0.0};
+  ++tail_;
+
+  replan();
+
+  naive_time_ += naive_time;
+
+  waypoint_ = waypoint;
+  unit_ = unit;
+  has_unit_ = true;
+
+  return true;
+}
+
+void Planner::finish() {
+  finished_ = true;
+}
+
+void Planner::cancel() {
+  cancelled_ = true;
+}
+
+bool Planner::pop(planner::segment& segment) {
+  if (cancelled_ || head_ == tail_) {
+    return false;
+  }
+
+  const planner::block& current = block(head_);
+  // exit speed becomes the fixed entry speed of the next segment
+  const double exit = (head_ + 1 < tail_) ? block(head_ + 1).entry : 0.0;
+
+  device::stepper::step master_steps = 0;
+  for (std::size_t axis = 0; axis < interpolator::axes; ++axis) {
+    master_steps = std::max(master_steps, std::abs(current.steps[axis]));
+  }
+
+  // mm to master steps
+  const double ratio = static_cast<double>(master_steps) / current.length;
+
+  segment = {current.steps,
+             {current.speed * ratio, current.acceleration * ratio,
+              current.deceleration * ratio, current.entry * ratio,
+              exit * ratio}};
+
+  planned_time_ +=
+      trapezoid_time(current.length, current.speed, current.acceleration,
+                     current.deceleration, current.entry, exit);
+
+  ++head_;
+
+  return true;
+}
+
+bool Planner::full() const {
+  return tail_ - head_ >= planner::buffer_size;
+}
+
+time_unit Planner::planned_time() const {
+  return static_cast<time_unit>(std::lround(planned_time_ * 1e+6));
+}
+
+time_unit Planner::naive_time() const {
+  return static_cast<time_unit>(std::lround(naive_time_ * 1e+6));
+}
+
+void Planner::replan() {
+  if (head_ == tail_) {
+    return;
+  }
+
+  // backward pass: every segment must be able to decelerate to its exit, the
+  // newest one to a standstill, entry of the oldest one is fixed
+  double exit = 0.0;
+  for (std::size_t i = tail_; i-- > head_ + 1;) {
+    auto& current = block(i);
+    current.entry =
+        std::min(current.max_entry,
+                 std::sqrt(exit * exit + 2 * current.deceleration *
+                                             current.length));
+    exit = current.entry;
+  }
+
+  // forward pass: every segment must be able to accelerate from its entry
+  for (std::size_t i = head_; i + 1 < tail_; ++i) {
+    const auto& current = block(i);
+    auto&       next = block(i + 1);
+    next.entry = std::min(next.entry,
+                          std::sqrt(current.entry * current.entry +
+                                    2 * current.acceleration * current.length));
+  }
+}
+}  // namespace mechanism
+
+NAMESPACE_END
@@ -0,0 +1,238 @@
+#ifndef LIB_MECHANISM_PLANNER_HPP_
+#define LIB_MECHANISM_PLANNER_HPP_
+
+/** @file planner.hpp
+ *  @brief Look-ahead trajectory planner class definition
+ *
+ * Plan the path into a bounded segment buffer while it is being executed, so
+ * consecutive segments are blended
+ */
+
+#include <array>
+
+#include <libcore/core.hpp>
+#include <libdevice/device.hpp>
+
+#include "interpolator.hpp"
+
+NAMESPACE_BEGIN
+
+namespace mechanism {
+namespace planner {
+/** Number of segments that can be planned ahead */
+constexpr std::size_t buffer_size = 32;
+
+/** Vector in mm for each axis */
+typedef std::array<double, interpolator::axes> vector;
+
+/**
+ * @brief Planned segment.
+ *
+ * Straight line between two consecutive waypoints
+ */
+struct segment {
+  /** steps to take for each axis (signed) */
+  Interpolator::steps steps;
+  /** master clock profile */
+  interpolator::profile profile;
+};
+
+/**
+ * @brief Buffered segment that can still be replanned.
+ *
+ * Every value is in mm, mm/s, and mm/s^2
+ */
+struct block {
+  /** steps to take for each axis (signed) */
+  Interpolator::steps steps;
+  /** unit direction */
+  vector unit;
+  /** length */
+  double length;
+  /** cruise speed */
+  double speed;
+  /** acceleration */
+  double acceleration;
+  /** deceleration */
+  double deceleration;
+  /** max entry speed allowed by the junction */
+  double max_entry;
+  /** planned entry speed */
+  double entry;
+};
+}  // namespace planner
+
+/**
+ * @brief Look-ahead trajectory planner.
+ *
+ * Every segment of the path is a straight line that is executed by
+ * mechanism::Interpolator. Instead of stopping at every waypoint, the speed at
+ * the junction of two segments is limited by the junction deviation (how far
+ * the path may deviate from the sharp corner) and the per-axis acceleration.
+ *
+ * Waypoints are pushed into a bounded ring of segments and popped one by one.
+ * Planner is not thread-safe, the caller pops before pushing into a full ring
+ * (see Program). On every push junction speeds of the buffered
+ * segments are propagated backward (so every segment is able to decelerate to
+ * the next junction, the last one to a standstill) and forward (so every
+ * segment is able to accelerate from the previous junction). Entry speed of
+ * the oldest buffered segment is fixed once its predecessor has been popped.
+ *
+ * Popped segment never has to stop at its exit unless the buffer is empty
+ * behind it.
+ *
+ * All calculations are in mm, mm/s, and mm/s^2, and converted to master steps
+ * when the segment is popped.
+ */
+class Planner : public StackObj {
+ public:
+  /**
+   * Planner Constructor
+   *
+   * @param steps_per_mm        steps conversion to mm for each axis
+   * @param junction_deviation  max deviation from sharp corner in mm, 0 stops
+   *                            at every corner
+   * @param speed               speed profile of the mechanism
+   * @param steppers            stepper of each axis to get microsteps and
+   *                            motor steps
+   * @param start               starting position in absolute steps
+   */
+  Planner(const Interpolator::steps&    steps_per_mm,
+          double                        junction_deviation,
+          const config::MechanismSpeed& speed,
+          const Interpolator::steppers& steppers,
+          const Interpolator::steps&    start);
+  /**
+   * Push next waypoint
+   *
+   * Buffer must not be full, pop first
+   *
+   * @param waypoint waypoint in absolute steps
+   *
+   * @return false if planning has been cancelled or the buffer is full
+   */
+  bool push(const Interpolator::steps& waypoint);
+  /**
+   * Mark the end of the path
+   */
+  void finish();
+  /**
+   * Cancel planning, remaining segments are dropped
+   */
+  void cancel();
+  /**
+   * Pop oldest segment
+   *
+   * Exit speed of the segment is only final once the path has been finished
+   * or the buffer is full
+   *
+   * @param segment popped segment
+   *
+   * @return false if planning has been cancelled or the buffer is empty
+   */
+  bool pop(planner::segment& segment);
+  /**
+   * Check whether the buffer is full or not
+   *
+   * push() fails while it is full
+   *
+   * @return true if the buffer is full
+   */
+  bool full() const;
+  /**
+   * Get estimated cycle time of popped segments
+   *
+   * @return cycle time in micros
+   */
+  time_unit planned_time() const;
+  /**
+   * Get estimated cycle time of pushed segments if every waypoint starts and
+   * ends at standstill and every axis runs its own profile
+   *
+   * @return cycle time in micros
+   */
+  time_unit naive_time() const;
+
+ private:
+  /**
+   * Replan entry speed of every buffered segment
+   */
+  void replan();
+  /**
+   * Get buffered block
+   *
+   * @param index monotonic index of the block
+   *
+   * @return block
+   */
+  inline planner::block& block(std::size_t index) {
+    return buffer_[index % planner::buffer_size];
+  }
+
+ private:
+  /**
+   * Conversion of mm to steps for each axis
+   */
+  const Interpolator::steps steps_per_mm_;
+  /**
+   * Max deviation from sharp corner in mm
+   */
+  const double junction_deviation_;
+  /**
+   * Max speed of each axis in mm
+   */
+  planner::vector max_speed_;
+  /**
+   * Max acceleration of each axis in mm
+   */
+  planner::vector max_acceleration_;
+  /**
+   * Max deceleration of each axis in mm
+   */
+  planner::vector max_deceleration_;
+  /**
+   * Last pushed waypoint
+   */
+  Interpolator::steps waypoint_;
+  /**
+   * Unit direction of last pushed segment
+   */
+  planner::vector unit_;
+  /**
+   * Whether a segment has been pushed or not
+   */
+  bool has_unit_;
+  /**
+   * Segment ring buffer
+   */
+  std::array<planner::block, planner::buffer_size> buffer_;
+  /**
+   * Index of oldest buffered segment
+   */
+  std::size_t head_;
+  /**
+   * Index after newest buffered segment
+   */
+  std::size_t tail_;
+  /**
+   * Path has been finished
+   */
+  bool finished_;
+  /**
+   * Planning has been cancelled
+   */
+  bool cancelled_;
+  /**
+   * Estimated cycle time of popped segments in seconds
+   */
+  double planned_time_;
+  /**
+   * Estimated cycle time of naive path in seconds
+   */
+  double naive_time_;
+};
+}  // namespace mechanism
+
+NAMESPACE_END
+
+#endif  // LIB_MECHANISM_PLANNER_HPP_
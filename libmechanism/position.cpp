@@ -0,0 +1,39 @@
+#include "mechanism.hpp"
+
+#include "position.hpp"
+
+#include <cmath>
+
+NAMESPACE_BEGIN
+
+namespace mechanism {
+StepPosition::StepPosition(const Interpolator::steps& steps_per_mm)
+    : steps_per_mm_{steps_per_mm} {
+  for (auto& counter : steps_) {
+    counter.store(0, std::memory_order_relaxed);
+  }
+}
+
+Coordinate StepPosition::position() const {
+  return {static_cast<Point>(steps(0)) / static_cast<Point>(steps_per_mm_[0]),
+          static_cast<Point>(steps(1)) / static_cast<Point>(steps_per_mm_[1]),
+          static_cast<Point>(steps(2)) / static_cast<Point>(steps_per_mm_[2])};
+}
+
+void StepPosition::position(const Coordinate& coordinate) {
+  const std::array<Point, interpolator::axes> mm = {coordinate.x, coordinate.y,
+                                                    coordinate.z};
+
+  for (std::size_t axis = 0; axis < interpolator::axes; ++axis) {
+    const Point steps = mm[axis] * static_cast<Point>(steps_per_mm_[axis]);
+    steps_[axis].store(static_cast<device::stepper::step>(std::lround(steps)),
+                       std::memory_order_relaxed);
+  }
+
+  if (observer_) {
+    observer_();
+  }
+}
+}  // namespace mechanism
+
+NAMESPACE_END
@@ -0,0 +1,115 @@
+#ifndef LIB_MECHANISM_POSITION_HPP_
+#define LIB_MECHANISM_POSITION_HPP_
+
+/** @file position.hpp
+ *  @brief Step position class definition
+ *
+ * Lock-free position tracking with step counter of each axis
+ */
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <utility>
+
+#include <libcore/core.hpp>
+#include <libdevice/device.hpp>
+
+#include "interpolator.hpp"
+
+NAMESPACE_BEGIN
+
+namespace mechanism {
+/**
+ * @brief Step position.
+ *
+ * Every axis keeps an absolute signed step counter, that is written by the
+ * thread that pulses the steppers only and read by anyone. Writer never locks
+ * nor notifies, coordinate in mm is derived when it is read.
+ *
+ * Overwriting the position (e.g. homing) is not a step, observer is called
+ * after it so the readers can be told.
+ */
+class StepPosition : public PositionSource {
+ public:
+  /**
+   * StepPosition Constructor
+   *
+   * @param steps_per_mm  steps conversion to mm for each axis
+   */
+  explicit StepPosition(const Interpolator::steps& steps_per_mm);
+  /**
+   * StepPosition Destructor
+   */
+  ~StepPosition() = default;
+  /**
+   * Count steps of an axis
+   *
+   * @param axis       axis index (x, y, z)
+   * @param steps      steps that have been taken
+   * @param direction  direction of the steps
+   */
+  inline void step(std::size_t                axis,
+                   device::stepper::step      steps,
+                   device::stepper::direction direction) {
+    // single writer, so no read-modify-write is needed
+    auto& counter = steps_[axis];
+    counter.store(counter.load(std::memory_order_relaxed) +
+                      (direction == device::stepper::direction::forward
+                           ? steps
+                           : -steps),
+                  std::memory_order_relaxed);
+  }
+  /**
+   * Get absolute steps of an axis
+   *
+   * @param axis axis index (x, y, z)
+   *
+   * @return absolute steps
+   */
+  inline device::stepper::step steps(std::size_t axis) const {
+    return steps_[axis].load(std::memory_order_relaxed);
+  }
+  /**
+   * Read current position
+   *
+   * @return current coordinate in mm
+   */
+  virtual Coordinate position() const override;
+  /**
+   * Overwrite current position
+   *
+   * @param coordinate new coordinate in mm
+   */
+  virtual void position(const Coordinate& coordinate) override;
+  /**
+   * Set observer of position overwrites
+   *
+   * Called on the thread that overwrites the position, while the state is
+   * locked
+   *
+   * @param observer observer, empty to remove it
+   */
+  inline void observe(std::function<void()> observer) {
+    observer_ = std::move(observer);
+  }
+
+ private:
+  /**
+   * Conversion of mm to steps for each axis
+   */
+  const Interpolator::steps steps_per_mm_;
+  /**
+   * Absolute step counter of each axis
+   */
+  std::array<std::atomic<device::stepper::step>, interpolator::axes> steps_;
+  /**
+   * Observer of position overwrites
+   */
+  std::function<void()> observer_;
+};
+}  // namespace mechanism
+
+NAMESPACE_END
+
+#endif  // LIB_MECHANISM_POSITION_HPP_
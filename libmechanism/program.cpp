@@ -0,0 +1,67 @@
+#include "mechanism.hpp"
+
+#include "program.hpp"
+
+#include <cmath>
+
+NAMESPACE_BEGIN
+
+namespace mechanism {
+Program::Program(unsigned int                  revision,
+                 const config::path_container& path,
+                 const Interpolator::steps&    steps_per_mm,
+                 double                        junction_deviation,
+                 const config::MechanismSpeed& speed,
+                 const Interpolator::steppers& steppers)
+    : revision_{revision},
+      speed_{speed},
+      path_{path},
+      planned_time_{0},
+      naive_time_{0} {
+  if (path_.empty()) {
+    return;
+  }
+
+  waypoints_.reserve(path_.size());
+  ends_.reserve(path_.size());
+
+  for (const auto& [x, y] : path_) {
+    // round absolute position, never the delta
+    waypoints_.push_back(
+        {std::lround(x * static_cast<double>(steps_per_mm[0])),
+         std::lround(y * static_cast<double>(steps_per_mm[1])), 0});
+  }
+
+  Planner          planner(steps_per_mm, junction_deviation, speed, steppers,
+                           waypoints_.front());
+  planner::segment segment;
+
+  ends_.push_back(0);
+
+  for (std::size_t idx = 1; idx < waypoints_.size(); ++idx) {
+    // pop before push blocks, so every segment sees a full look-ahead
+    if (planner.full() && planner.pop(segment)) {
+      segments_.push_back(segment);
+    }
+
+    planner.push(waypoints_[idx]);
+
+    // duplicated waypoint is not planned
+    ends_.push_back(ends_.back() +
+                    (waypoints_[idx] != waypoints_[idx - 1] ? 1 : 0));
+  }
+
+  planner.finish();
+
+  while (planner.pop(segment)) {
+    segments_.push_back(segment);
+  }
+
+  massert(segments_.size() == ends_.back(), "sanity");
+
+  planned_time_ = planner.planned_time();
+  naive_time_ = planner.naive_time();
+}
+}  // namespace mechanism
+
+NAMESPACE_END
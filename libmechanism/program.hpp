@@ -0,0 +1,199 @@
+#ifndef LIB_MECHANISM_PROGRAM_HPP_
+#define LIB_MECHANISM_PROGRAM_HPP_
+
+/** @file program.hpp
+ *  @brief Motion program class definition
+ *
+ * Configured path that is compiled into planned segments in step space
+ */
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include <libcore/core.hpp>
+#include <libdevice/device.hpp>
+
+#include "interpolator.hpp"
+#include "planner.hpp"
+
+NAMESPACE_BEGIN
+
+namespace mechanism {
+namespace program {
+/** Configured path */
+enum class path { spraying, tending_edge, tending_zigzag, cleaning };
+
+/** Number of configured paths */
+constexpr std::size_t paths = 4;
+
+/** Number of speed profiles */
+constexpr std::size_t speeds = 3;
+}  // namespace program
+
+/**
+ * @brief Motion program.
+ *
+ * Path in mm that is compiled once into absolute waypoints in steps and
+ * segments that have been planned by mechanism::Planner, ramp of every
+ * segment is already known. Executing the program only streams the segments.
+ *
+ * Every waypoint is rounded from its absolute position, segment deltas are
+ * the differences of the rounded waypoints, so the fraction of a step that is
+ * lost by one segment is carried by the next one instead of accumulating.
+ *
+ * Waypoints move x and y only, z-axis stays wherever it is when the program
+ * starts. Program starts and ends at a standstill at its first and last
+ * waypoints.
+ *
+ * Immutable once compiled, can be shared between jobs
+ */
+class Program : public StackObj {
+ public:
+  /**
+   * Create shared_ptr<Program>
+   *
+   * Pass every args to Program()
+   *
+   * @param args arguments that will be passed to Program()
+   */
+  MAKE_STD_SHARED(Program)
+
+ public:
+  /**
+   * Get config revision the program has been compiled from
+   *
+   * @return config revision
+   */
+  inline unsigned int revision() const { return revision_; }
+  /**
+   * Get speed profile of the program
+   *
+   * @return speed profile
+   */
+  inline const config::MechanismSpeed& speed() const { return speed_; }
+  /**
+   * Get path in mm
+   *
+   * @return path
+   */
+  inline const config::path_container& path() const { return path_; }
+  /**
+   * Get number of waypoints
+   *
+   * @return number of waypoints
+   */
+  inline std::size_t size() const { return waypoints_.size(); }
+  /**
+   * Check whether the program has any waypoint or not
+   *
+   * @return true if there is no waypoint
+   */
+  inline bool empty() const { return waypoints_.empty(); }
+  /**
+   * Get waypoint in absolute steps
+   *
+   * @param idx index of waypoint
+   *
+   * @return waypoint, z-axis is always 0
+   */
+  inline const Interpolator::steps& waypoint(std::size_t idx) const {
+    massert(idx < waypoints_.size(), "sanity");
+    return waypoints_[idx];
+  }
+  /**
+   * Get planned segments
+   *
+   * @return segments
+   */
+  inline const std::vector<planner::segment>& segments() const {
+    return segments_;
+  }
+  /**
+   * Get index after the last segment that ends at the waypoint
+   *
+   * Segments from waypoint `from` to waypoint `to` are [end(from), end(to))
+   *
+   * @param idx index of waypoint
+   *
+   * @return index of segment
+   */
+  inline std::size_t end(std::size_t idx) const {
+    massert(idx < ends_.size(), "sanity");
+    return ends_[idx];
+  }
+  /**
+   * Get estimated time of every segment
+   *
+   * @return cycle time in micros
+   */
+  inline time_unit planned_time() const { return planned_time_; }
+  /**
+   * Get estimated time of every segment if every waypoint starts and ends at
+   * standstill and every axis runs its own profile
+   *
+   * @return cycle time in micros
+   */
+  inline time_unit naive_time() const { return naive_time_; }
+
+ protected:
+  /**
+   * Program Constructor
+   *
+   * Compile the path
+   *
+   * @param revision            config revision of the path
+   * @param path                path in mm
+   * @param steps_per_mm        steps conversion to mm for each axis
+   * @param junction_deviation  max deviation from sharp corner in mm, 0 stops
+   *                            at every waypoint
+   * @param speed               speed profile of the program
+   * @param steppers            stepper of each axis to get microsteps and
+   *                            motor steps
+   */
+  Program(unsigned int                  revision,
+          const config::path_container& path,
+          const Interpolator::steps&    steps_per_mm,
+          double                        junction_deviation,
+          const config::MechanismSpeed& speed,
+          const Interpolator::steppers& steppers);
+
+ private:
+  /**
+   * Config revision
+   */
+  const unsigned int revision_;
+  /**
+   * Speed profile
+   */
+  const config::MechanismSpeed speed_;
+  /**
+   * Path in mm
+   */
+  const config::path_container path_;
+  /**
+   * Waypoints in absolute steps
+   */
+  std::vector<Interpolator::steps> waypoints_;
+  /**
+   * Index after the last segment of each waypoint
+   */
+  std::vector<std::size_t> ends_;
+  /**
+   * Planned segments
+   */
+  std::vector<planner::segment> segments_;
+  /**
+   * Estimated cycle time in micros
+   */
+  time_unit planned_time_;
+  /**
+   * Estimated naive cycle time in micros
+   */
+  time_unit naive_time_;
+};
+}  // namespace mechanism
+
+NAMESPACE_END
+
+#endif  // LIB_MECHANISM_PROGRAM_HPP_
@@ -0,0 +1,113 @@
+#ifndef LIB_UTIL_SEQLOCK_HPP_
+#define LIB_UTIL_SEQLOCK_HPP_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/** @file seqlock.hpp
+ *  @brief Sequence lock
+ */
+
+namespace util {
+/**
+ * @brief Sequence lock.
+ *
+ * Single writer publishes a copy of the value, any number of readers copy it
+ * back without locking. Writer never waits, reader retries only if it has
+ * raced with a publish, which is rare if the value is published at a bounded
+ * rate.
+ *
+ * Value is stored in atomic words, so torn reads are detected instead of
+ * being undefined behavior.
+ *
+ * @tparam T  trivially copyable value
+ */
+template <typename T>
+class SeqLock {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "Value of SeqLock must be trivially copyable");
+
+ public:
+  /**
+   * SeqLock Constructor
+   *
+   * @param value initial value
+   */
+  explicit SeqLock(const T& value = T{}) : sequence_{0} { store(value); }
+  /**
+   * Publish new value
+   *
+   * Must be called from single writer only
+   *
+   * @param value new value
+   */
+  void store(const T& value) {
+    const std::uint64_t sequence = sequence_.load(std::memory_order_relaxed);
+    std::array<std::uint64_t, words> buffer{};
+
+    std::memcpy(buffer.data(), &value, sizeof(T));
+
+    // odd sequence marks publish in progress
+    sequence_.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for (std::size_t i = 0; i < words; ++i) {
+      data_[i].store(buffer[i], std::memory_order_relaxed);
+    }
+
+    sequence_.store(sequence + 2, std::memory_order_release);
+  }
+  /**
+   * Copy last published value
+   *
+   * @return last published value
+   */
+  T load() const {
+    std::array<std::uint64_t, words> buffer;
+    std::uint64_t                    before;
+    std::uint64_t                    after;
+
+    do {
+      before = sequence_.load(std::memory_order_acquire);
+
+      for (std::size_t i = 0; i < words; ++i) {
+        buffer[i] = data_[i].load(std::memory_order_relaxed);
+      }
+
+      std::atomic_thread_fence(std::memory_order_acquire);
+      after = sequence_.load(std::memory_order_relaxed);
+    } while ((before & 1) != 0 || before != after);
+
+    T retval;
+    std::memcpy(&retval, buffer.data(), sizeof(T));
+    return retval;
+  }
+  /**
+   * Get number of publishes
+   *
+   * @return number of publishes
+   */
+  inline std::uint64_t version() const {
+    return sequence_.load(std::memory_order_acquire) / 2;
+  }
+
+ private:
+  /** Number of 64-bit words to hold the value */
+  static constexpr std::size_t words =
+      (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+  /**
+   * Sequence number, odd while publishing
+   */
+  std::atomic<std::uint64_t> sequence_;
+  /**
+   * Value words
+   */
+  std::array<std::atomic<std::uint64_t>, words> data_;
+};
+}  // namespace util
+
+#endif  // LIB_UTIL_SEQLOCK_HPP_
@@ -2,13 +2,152 @@
 
 #include "timer.hpp"
 
+#include <time.h>
+
+#include <algorithm>
+#include <cerrno>
 #include <chrono>
 #include <thread>
+#include <vector>
+
+namespace util {
+namespace timer {
+// every thread that waits keeps its own guard band and statistics, so
+// waits of other threads neither share cache lines nor mix the numbers
+
+/** Guard band before calibration, large enough for non real-time threads */
+static thread_local time_unit guard_band_{100000};
+/** Number of waits */
+static thread_local time_unit waits_{0};
+/** Waits that slept before spinning */
+static thread_local time_unit sleeps_{0};
+/** Sleeps that woke up after the deadline */
+static thread_local time_unit late_{0};
+/** Sum of overshoot in nanos */
+static thread_local time_unit overshoot_{0};
+/** Max overshoot in nanos */
+static thread_local time_unit max_overshoot_{0};
+/** Total spin in nanos */
+static thread_local time_unit spin_{0};
+
+/**
+ * Sleep until absolute monotonic time
+ *
+ * @param deadline time stamp in nanos
+ */
+static void sleep_until_nanos(time_unit deadline) {
+  timespec ts;
+  ts.tv_sec = static_cast<time_t>(deadline / 1000000000);
+  ts.tv_nsec = static_cast<long>(deadline % 1000000000);
+
+  // restart on signal, the deadline is absolute so it does not drift
+  while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) ==
+         EINTR) {
+  }
+}
+
+/**
+ * Wait until absolute monotonic time with sleep then spin
+ *
+ * @param deadline time stamp in nanos
+ */
+static void wait_until_nanos(time_unit deadline) {
+  time_unit now = nanos();
+
+  if (now >= deadline) {
+    return;
+  }
+
+  ++waits_;
+
+  if (deadline - now > guard_band_) {
+    sleep_until_nanos(deadline - guard_band_);
+    ++sleeps_;
+
+    now = nanos();
+    if (now > deadline) {
+      ++late_;
+    }
+  }
+
+  const time_unit spin_start = now;
+
+  while (now < deadline) {
+    now = nanos();
+  }
+
+  const time_unit overshoot = now - deadline;
+
+  spin_ += now - spin_start;
+  overshoot_ += overshoot;
+  max_overshoot_ = std::max(max_overshoot_, overshoot);
+}
+
+time_unit calibrate(unsigned int samples) {
+  // sleep long enough to let the CPU go idle, like between two slow steps
+  static constexpr time_unit period = 200000;
+  // extra margin on top of the measured latency
+  static constexpr time_unit margin = 5000;
+  static constexpr time_unit min_guard_band = 10000;
+  static constexpr time_unit max_guard_band = 1000000;
+
+  if (samples == 0) {
+    return guard_band();
+  }
+
+  std::vector<time_unit> latencies;
+  latencies.reserve(samples);
+
+  for (unsigned int i = 0; i < samples; ++i) {
+    const time_unit target = nanos() + period;
+    sleep_until_nanos(target);
+    latencies.push_back(nanos() - target);
+  }
+
+  // 99th percentile, the rare late wake-ups are left to the statistics
+  std::sort(latencies.begin(), latencies.end());
+  const time_unit latency = latencies[(latencies.size() - 1) * 99 / 100];
+
+  guard_band_ = std::clamp(latency + margin, min_guard_band, max_guard_band);
+
+  reset_statistics();
+
+  return guard_band();
+}
+
+time_unit guard_band() {
+  return guard_band_;
+}
+
+stats statistics() {
+  stats retval;
+
+  retval.guard_band = guard_band_;
+  retval.waits = waits_;
+  retval.sleeps = sleeps_;
+  retval.late = late_;
+  retval.mean_overshoot = waits_ > 0 ? overshoot_ / waits_ : 0;
+  retval.max_overshoot = max_overshoot_;
+  retval.spin = spin_;
+
+  return retval;
+}
+
+void reset_statistics() {
+  waits_ = 0;
+  sleeps_ = 0;
+  late_ = 0;
+  overshoot_ = 0;
+  max_overshoot_ = 0;
+  spin_ = 0;
+}
+}  // namespace timer
+}  // namespace util
 
 time_unit seconds() {
   uint64_t s = static_cast<uint64_t>(
       std::chrono::duration_cast<std::chrono::seconds>(
-          std::chrono::high_resolution_clock::now().time_since_epoch())
+          std::chrono::steady_clock::now().time_since_epoch())
           .count());
   return static_cast<time_unit>(s);
 }
@@ -26,14 +165,14 @@ void sleep_until<time_units::seconds>(time_unit time, time_unit start_time) {
     start = seconds();
   }
 
-  std::this_thread::sleep_until(std::chrono::high_resolution_clock::time_point{
+  std::this_thread::sleep_until(std::chrono::steady_clock::time_point{
       std::chrono::seconds(start + time)});
 }
 
 time_unit millis() {
   uint64_t ms = static_cast<uint64_t>(
       std::chrono::duration_cast<std::chrono::milliseconds>(
-          std::chrono::high_resolution_clock::now().time_since_epoch())
+          std::chrono::steady_clock::now().time_since_epoch())
           .count());
   return static_cast<time_unit>(ms);
 }
@@ -51,14 +190,14 @@ void sleep_until<time_units::millis>(time_unit time, time_unit start_time) {
     start = millis();
   }
 
-  std::this_thread::sleep_until(std::chrono::high_resolution_clock::time_point{
+  std::this_thread::sleep_until(std::chrono::steady_clock::time_point{
       std::chrono::milliseconds(start + time)});
 }
 
 time_unit micros() {
   uint64_t us = static_cast<uint64_t>(
       std::chrono::duration_cast<std::chrono::microseconds>(
-          std::chrono::high_resolution_clock::now().time_since_epoch())
+          std::chrono::steady_clock::now().time_since_epoch())
           .count());
   return static_cast<time_unit>(us);
 }
@@ -76,14 +215,19 @@ void sleep_until<time_units::micros>(time_unit time, time_unit start_time) {
     start = micros();
   }
 
-  std::this_thread::sleep_until(std::chrono::high_resolution_clock::time_point{
+  std::this_thread::sleep_until(std::chrono::steady_clock::time_point{
       std::chrono::microseconds(start + time)});
 }
 
+template <>
+void wait_until<time_units::micros>(time_unit deadline) {
+  util::timer::wait_until_nanos(deadline * 1000);
+}
+
 time_unit nanos() {
   uint64_t ns = static_cast<uint64_t>(
       std::chrono::duration_cast<std::chrono::nanoseconds>(
-          std::chrono::high_resolution_clock::now().time_since_epoch())
+          std::chrono::steady_clock::now().time_since_epoch())
           .count());
   return static_cast<time_unit>(ns);
 }
@@ -101,6 +245,11 @@ void sleep_until<time_units::nanos>(time_unit time, time_unit start_time) {
     start = nanos();
   }
 
-  std::this_thread::sleep_until(std::chrono::high_resolution_clock::time_point{
+  std::this_thread::sleep_until(std::chrono::steady_clock::time_point{
       std::chrono::nanoseconds(start + time)});
 }
+
+template <>
+void wait_until<time_units::nanos>(time_unit deadline) {
+  util::timer::wait_until_nanos(deadline);
+}
@@ -3,6 +3,9 @@
 
 /** @file timer.hpp
  *  @brief Timer helper definitions
+ *
+ * Every time stamp is taken from monotonic clock, so it can only be used to
+ * measure intervals and deadlines
  */
 
 #include <cstdlib>
@@ -90,4 +93,83 @@ void sleep_until<time_units::micros>(time_unit time, time_unit start_time);
 template <>
 void sleep_until<time_units::nanos>(time_unit time, time_unit start_time);
 
+/**
+ * @brief Wait until absolute deadline
+ *
+ * Sleeps with clock_nanosleep(TIMER_ABSTIME) until the guard band before the
+ * deadline, then spins for the rest. Deadline that has passed returns at once.
+ * Meant for step deadlines only, sleep_for and sleep_until never spin.
+ *
+ * @tparam TimeUnits time units can be micros or nanos
+ *
+ * @param  deadline  time stamp from micros() or nanos()
+ */
+template <time_units TimeUnits>
+void wait_until(time_unit deadline);
+
+template <>
+void wait_until<time_units::micros>(time_unit deadline);
+
+template <>
+void wait_until<time_units::nanos>(time_unit deadline);
+
+namespace util {
+namespace timer {
+/**
+ * @brief Timer statistics.
+ *
+ * Collected by every wait_until call of the calling thread since its last
+ * reset
+ */
+struct stats {
+  /** spin window before every deadline in nanos */
+  time_unit guard_band;
+  /** number of waits */
+  time_unit waits;
+  /** waits that slept before spinning */
+  time_unit sleeps;
+  /** sleeps that woke up after the deadline (guard band is too small) */
+  time_unit late;
+  /** mean overshoot after the deadline in nanos */
+  time_unit mean_overshoot;
+  /** max overshoot after the deadline in nanos */
+  time_unit max_overshoot;
+  /** total time spent spinning in nanos */
+  time_unit spin;
+};
+
+/**
+ * @brief Learn the guard band from wake-up latency of calling thread
+ *
+ * Must be called from the thread that will wait (after its scheduling policy
+ * has been set), guard band only applies to that thread and its statistics
+ * are reset afterwards
+ *
+ * @param  samples number of sleeps to measure
+ *
+ * @return guard band in nanos
+ */
+time_unit calibrate(unsigned int samples = 200);
+
+/**
+ * @brief Get guard band of calling thread
+ *
+ * @return guard band in nanos
+ */
+time_unit guard_band();
+
+/**
+ * @brief Get timer statistics of calling thread
+ *
+ * @return timer statistics
+ */
+stats statistics();
+
+/**
+ * @brief Reset timer statistics of calling thread
+ */
+void reset_statistics();
+}  // namespace timer
+}  // namespace util
+
 #endif  // LIB_CORE_TIMER_HPP_
@@ -33,6 +33,7 @@
 #include "macros.hpp"
 #include "math.hpp"
 #include "pair.hpp"
+#include "seqlock.hpp"
 #include "time.hpp"
 #include "timer.hpp"
 